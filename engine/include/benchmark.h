@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct Engine;
+
+// ─── Benchmark runner ─────────────────────────────────────────────────────────
+// Replays a camera path through each scene of a manifest at a fixed timestep
+// and reports per-frame CPU, GPU and frame times. Each scene gets a freshly
+// initialised engine, so no scene inherits another's caches, and its load time
+// is measured cold (the pipeline cache file aside).
+//
+// Manifest: text, `#` starts a comment. `scene` opens an entry, and every
+// `file` line adds a glTF to it. `path` names the camera path; without one
+// (or if it can't be read) the camera orbits the scene bounds once.
+//
+//   scene sponza
+//   file  assets/Sponza/glTF/Sponza.gltf
+//   path  assets/benchmarks/sponza.campath
+//
+// Paths resolve like the engine's assets, from the working directory upwards.
+// A scene with a file that can't be found is reported as skipped.
+//
+// Per scene: warmupFrames at the path's first pose (pipelines, caches, the
+// GPU clocks settle) and then one frame per fixedDeltaTime until the path ends.
+// Dynamic resolution is held off, so every frame renders at full resolution.
+// Output:
+//
+//   - <prefix>.json   per scene: load/init time, peak VRAM, hitches (frame
+//                     telemetry), render resolution and, for cpu, gpu and
+//                     frame interval: avg, p50, p95, p99 and worst ms
+//   - <prefix>.csv    one row per measured frame
+//
+// CPU is engine_draw_frame's wall time. Frame is the interval between frame
+// starts, which includes the present wait. Windowed runs ask for immediate
+// present, so vsync doesn't cap them. GPU is the GPU profiler's frame
+// root. Peak VRAM is the largest VMA device-local usage seen during the run.
+struct BenchmarkScene {
+    std::string              name;
+    std::vector<std::string> files;
+    std::string              cameraPath;
+};
+
+struct BenchmarkConfig {
+    std::string manifest = "assets/benchmarks/scenes.txt";
+    std::string outputPrefix = "benchmark";
+    bool        headless = false;      // offscreen, as --headless
+    uint32_t    width = 1920;          // headless target
+    uint32_t    height = 1080;
+    float       fixedDeltaTime = 1.0f / 60.0f;
+    uint32_t    warmupFrames = 60;
+    float       orbitSeconds = 20.0f;  // length of the fallback orbit
+};
+
+bool benchmark_load_manifest(const std::string& file, std::vector<BenchmarkScene>& scenes);
+
+// Runs every scene and writes the reports. Leaves `e` cleaned up; returns the
+// process exit code
+int benchmark_run(Engine* e, const BenchmarkConfig& config);
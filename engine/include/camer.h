@@ -57,6 +57,9 @@ struct Camera {
     float panSensitivity{ 0.01f };   // world-units per pixel (scaled by distance)
     float scrollSensitivity{ 0.10f };   // fraction of distance per notch
 
+    // ── Sub-pixel projection offset (TAA), in NDC ─────────────
+    glm::vec2 jitter{ 0.0f };
+
     // ── Smooth FPS velocity ───────────────────────────────────
     // velocity is lerped toward the target each frame so movement
     // feels weighty rather than instant start/stop.
@@ -88,7 +91,11 @@ struct Camera {
     //   radius — half-diagonal of the model's bounding box
     void focusOn(glm::vec3 center, float radius);
 
-    // View / projection helpers used by draw_geometry
+    // Place the camera directly (camera path playback). Angles in degrees
+    void setPose(glm::vec3 newPosition, float newYaw, float newPitch, float newFov);
+
+    // View / projection helpers used by draw_geometry — the projection
+    // includes `jitter`
     glm::mat4 getViewMatrix() const;
     glm::mat4 getProjectionMatrix(float aspect,
         float nearPlane = 0.05f,
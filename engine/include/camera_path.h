@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct Engine;
+struct Camera;
+
+// ─── Camera paths ─────────────────────────────────────────────────────────────
+// A flythrough is a list of timed camera poses. Playback samples it at any time
+// with a Catmull-Rom spline through the positions and angles, so a path
+// recorded at a few keys per second replays smoothly at any timestep.
+//
+// The recorder takes a key every `interval` seconds of wall time while the
+// user flies the camera. Playback at a fixed step therefore runs at the
+// recorded speed regardless of frame rate.
+//
+// File format: text, one key per line, `#` starts a comment:
+//
+//   time x y z yaw pitch fov          (seconds, world units, degrees)
+struct CameraKey {
+    float     time = 0.0f;
+    glm::vec3 position{ 0.0f };
+    float     yaw = -90.0f;
+    float     pitch = 0.0f;
+    float     fov = 45.0f;
+};
+
+struct CameraPath {
+    std::vector<CameraKey> keys;     // ascending time
+
+    float duration() const { return keys.empty() ? 0.0f : keys.back().time; }
+};
+
+struct CameraPathState {
+    // Playback: the benchmark runner poses the camera itself, so the frame
+    // keeps input off it and advances time by `step` rather than wall time
+    bool  playing = false;
+    float step = 1.0f / 60.0f;
+
+    // Recording
+    bool        recording = false;
+    float       interval = 0.1f;     // seconds between keys
+    float       elapsed = 0.0f;
+    float       sinceKey = 0.0f;
+    CameraPath  path;
+    std::string lastSaved;           // file the last recording went to
+};
+
+bool camera_path_load(const std::string& file, CameraPath& path);
+bool camera_path_save(const std::string& file, const CameraPath& path);
+
+// The pose at `time`, clamped to the path's ends
+CameraKey camera_path_sample(const CameraPath& path, float time);
+void      camera_path_apply(Camera& camera, const CameraKey& key);
+
+// A deterministic stand-in for scenes without a recorded path: one turn
+// around the bounds at eye height, looking at the centre
+CameraPath camera_path_orbit(glm::vec3 boundsMin, glm::vec3 boundsMax, float seconds);
+
+// Recorder, driven from the debug UI. stop writes the keys to `file`
+void camera_path_record_start(Engine* e);
+void camera_path_record_stop(Engine* e, const std::string& file);
+
+// Per frame, after the camera has moved: takes a key when one is due
+void camera_path_record_frame(Engine* e);
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+#include "types.h"
+
+struct Engine;
+
+// ─── Clustered lighting ───────────────────────────────────────────────────────
+// Point and spot lights on top of the sun, at a cost that follows the lights
+// near each pixel rather than the scene total:
+//
+//   1. the light list is rewritten every frame into a mapped storage buffer
+//      (one per frame in flight) and reached through its device address
+//   2. a compute pass splits the view into a 16x9 screen grid times 24
+//      logarithmic depth slices, builds each cluster's view-space AABB and
+//      tests every light's bounding sphere against it, 64 lights at a time
+//      through shared memory. Each cluster owns a fixed slab of
+//      CLUSTER_MAX_LIGHTS indices; lights past that are dropped and counted.
+//   3. shade_pbr() finds its cluster from gl_FragCoord and view depth and
+//      walks only that cluster's list. The grid addresses and slicing
+//      constants ride at the end of CameraData, so the forward, GPU-culled and
+//      visibility-buffer shaders all pick them up without new push constants.
+//
+// The per-cluster counts are copied back every frame for the heatmap in the
+// debug UI; the same counts can tint the shaded image directly.
+constexpr uint32_t CLUSTER_GRID_X = 16;
+constexpr uint32_t CLUSTER_GRID_Y = 9;
+constexpr uint32_t CLUSTER_GRID_Z = 24;
+constexpr uint32_t CLUSTER_COUNT = CLUSTER_GRID_X * CLUSTER_GRID_Y * CLUSTER_GRID_Z;
+constexpr uint32_t CLUSTER_MAX_LIGHTS = 128;     // index slab per cluster
+constexpr uint32_t CLUSTER_STAT_WORDS = 4;       // {indices, max count, overflowed clusters, pad}
+constexpr uint32_t MAX_CLUSTERED_LIGHTS = 16384;
+
+enum class LightType : uint32_t { Point = 0, Spot = 1 };
+
+// Mirrors ClusterLight in shaders/clustered_lights.glsl (scalar layout)
+struct GpuLight {
+    glm::vec3 position;
+    float     range;                   // radius where the falloff reaches zero
+    glm::vec3 color;
+    float     intensity;
+    glm::vec3 direction;               // spot axis, unit length
+    LightType type;
+    float     spotCosInner;            // full intensity inside this cone
+    float     spotCosOuter;            // zero outside this one
+    float     pad[2];
+};
+static_assert(sizeof(GpuLight) == 64, "GpuLight must match clustered_lights.glsl");
+
+// cluster_lights.comp
+struct ClusterCullPushConstants {
+    VkDeviceAddress lights;
+    VkDeviceAddress counts;            // CLUSTER_COUNT counts, then the stat words
+    VkDeviceAddress indices;           // CLUSTER_MAX_LIGHTS per cluster
+    glm::uvec4      grid;              // x, y, z, max lights per cluster
+    glm::vec2       projScale;         // projection [0][0], [1][1] (y flipped)
+    float           sliceNear;         // far edge of slice 0 sits above this
+    float           sliceFar;          // slices end here; the last one runs on
+    float           cameraFar;
+    uint32_t        lightCount;
+};
+
+// Demo light set, scattered over CullScene's world bounds
+struct ClusteredLightSource {
+    glm::vec3 basePosition;
+    float     phase;                   // animation offset
+    float     speed;
+};
+
+struct ClusteredLightingState {
+    bool     enabled = true;
+    uint32_t lightCount = 256;         // requested; regenerated when it changes
+    uint32_t seed = 1;
+    float    rangeScale = 0.05f;       // light range as a fraction of the scene diagonal
+    float    intensity = 6.0f;
+    float    spotFraction = 0.25f;
+    bool     animate = true;
+    float    sliceNear = 1.0f;         // view depth where log slicing starts
+    float    sliceFar = 400.0f;
+    bool     heatmapOverlay = false;
+    float    heatmapMax = 32.0f;       // count shown at full red
+    uint32_t heatmapSlice = 0;         // depth slice drawn by the debug UI
+
+    // ── Pipeline
+    VkPipelineLayout cullLayout = VK_NULL_HANDLE;
+    VkPipeline       cullPipeline = VK_NULL_HANDLE;
+
+    // ── Lights
+    std::vector<ClusteredLightSource> sources;
+    std::vector<GpuLight>             lights;
+    uint32_t                          generatedCount = UINT32_MAX;
+    uint32_t                          generatedSeed = 0;
+    glm::vec3                         generatedMin{ 0.0f }, generatedMax{ 0.0f };
+    float                             time = 0.0f;
+    std::vector<AllocatedBuffer>      lightBuffers;     // per frame in flight, mapped
+
+    // ── Grid — written by this frame's cull, read by its fragments
+    AllocatedBuffer clusterCounts{};
+    AllocatedBuffer clusterIndices{};
+
+    // ── Counts readback, per frame in flight
+    std::vector<uint8_t>         frameRecorded;
+    std::vector<AllocatedBuffer> readbackBuffers;         // counts + stat words, mapped
+
+    // ── Stats shown in the debug UI (one frame-in-flight behind)
+    uint32_t              indexCount = 0;
+    uint32_t              maxPerCluster = 0;
+    uint32_t              overflowClusters = 0;
+    uint32_t              occupiedClusters = 0;
+    std::vector<uint32_t> counts;                         // CLUSTER_COUNT, x fastest
+};
+
+// Pipeline, grid buffers, light buffers and readback — after init_descriptors
+void init_clustered_lighting(Engine* e);
+
+// Reads back the slot's counts, then (re)generates, animates and
+// uploads this frame's lights
+void clustered_lighting_begin_frame(Engine* e);
+
+// Fills the cluster fields at the end of CameraData — from update_uniform_buffers
+void write_cluster_camera_data(const Engine* e, CameraData& cam);
+
+// Clears and rebuilds the grid. Synchronises its own buffers and leaves them
+// readable by fragment shaders.
+void draw_cluster_light_culling(Engine* e, VkCommandBuffer cmd);
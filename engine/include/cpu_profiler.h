@@ -0,0 +1,107 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+// ─── CPU zones ────────────────────────────────────────────────────────────────
+// CPU_ZONE("name") times the rest of the enclosing block. The call site's name,
+// file and line live in a static record, so a zone stores only a pointer and
+// two timestamps. On x86 the timestamps are raw TSC reads. steady_clock costs
+// several times more on some systems. Ticks are converted to nanoseconds at
+// export, against steady_clock sampled at the capture's start and end.
+//
+// Each thread writes into a ring buffer of its own, so recording takes no lock
+// and never contends. A thread is registered when it is named or records its
+// first zone, but its ring is only allocated on the first zone. When a thread
+// exits, its ring is parked for the next thread to reuse (up to
+// CPU_ZONE_SPARE_RINGS) or freed. During a capture this waits until the
+// capture has been exported.
+//
+// Zones only record during a capture. Otherwise a zone costs one relaxed
+// atomic load. cpu_profiler_capture starts a capture at once. It ends after N
+// calls to cpu_profiler_frame, the main loop's frame boundary, and then writes:
+//
+//   - <path>          Chrome trace JSON (chrome://tracing, ui.perfetto.dev)
+//   - <path>.folded   collapsed stacks with self time in µs, for flamegraph.pl
+//                     and speedscope
+//
+// A ring holds the last CPU_ZONE_RING zones of its thread. Older ones are
+// overwritten and counted as dropped. Build with SYNCHRONA_ZONES=0 (the CMake
+// option SYNCHRONA_PROFILE_ZONES) and CPU_ZONE expands to nothing.
+#ifndef SYNCHRONA_ZONES
+#define SYNCHRONA_ZONES 1
+#endif
+
+constexpr uint32_t CPU_ZONE_RING = 1u << 15;     // zones per thread, power of two
+constexpr uint32_t CPU_ZONE_SPARE_RINGS = 8;     // rings of exited threads kept for reuse
+
+struct CpuZoneSite {
+    const char* name;
+    const char* file;
+    uint32_t    line;
+};
+
+extern std::atomic<bool> g_cpuZonesCapturing;
+
+inline uint64_t cpu_zone_ticks()
+{
+#if defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+}
+
+// Appends one finished zone to the calling thread's ring
+void cpu_zone_record(const CpuZoneSite* site, uint64_t begin, uint64_t end);
+
+struct CpuZoneScope {
+    const CpuZoneSite* site;
+    uint64_t           begin;        // ticks; 0: no capture when the zone opened
+
+    explicit CpuZoneScope(const CpuZoneSite* s)
+        : site(s), begin(g_cpuZonesCapturing.load(std::memory_order_relaxed) ? cpu_zone_ticks() : 0) {}
+    ~CpuZoneScope() { if (begin) cpu_zone_record(site, begin, cpu_zone_ticks()); }
+
+    CpuZoneScope(const CpuZoneScope&) = delete;
+    CpuZoneScope& operator=(const CpuZoneScope&) = delete;
+};
+
+#if SYNCHRONA_ZONES
+#define CPU_ZONE_JOIN2(a, b) a##b
+#define CPU_ZONE_JOIN(a, b) CPU_ZONE_JOIN2(a, b)
+#define CPU_ZONE(name)                                                                        \
+    static constexpr CpuZoneSite CPU_ZONE_JOIN(cpuZoneSite_, __LINE__){ name, __FILE__, __LINE__ }; \
+    CpuZoneScope CPU_ZONE_JOIN(cpuZone_, __LINE__)(&CPU_ZONE_JOIN(cpuZoneSite_, __LINE__))
+#else
+#define CPU_ZONE(name) ((void)0)
+#endif
+
+struct CpuProfilerStatus {
+    bool        capturing = false;
+    uint32_t    framesLeft = 0;
+    std::string lastPath;            // last trace written
+    uint64_t    lastZones = 0;
+    uint64_t    lastDropped = 0;     // overwritten before export
+    uint32_t    lastThreads = 0;
+};
+
+// Names the calling thread in the trace ("main", "job worker 3")
+void cpu_profiler_thread_name(const char* name);
+
+// Starts recording now, for `frames` frames; does nothing if one is running
+void cpu_profiler_capture(uint32_t frames, const char* path);
+
+// The main loop's frame boundary: counts down a capture and exports it
+void cpu_profiler_frame();
+
+CpuProfilerStatus cpu_profiler_status();
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "shadow_cascades.h"
+
+struct Engine;
+
+// ─── Frustum ──────────────────────────────────────────────────────────────────
+// Six inward-facing planes (xyz = normal, w = distance) pulled straight out of a
+// view-projection matrix, using Vulkan's 0 <= z <= w clip volume — the same
+// volume the rasterizer clips against. Works for the perspective camera and the
+// orthographic light.
+struct Frustum {
+    glm::vec4 planes[6];
+};
+
+Frustum frustum_from_matrix(const glm::mat4& viewProj);
+
+// ─── Cull scene ───────────────────────────────────────────────────────────────
+// World-space bounds of every surface in Engine::testMeshes, flattened in asset
+// order and stored structure-of-arrays so one SIMD lane = one surface.
+// Arrays are padded to CULL_LANES with empty bounds so the kernels never need a
+// scalar tail; padded lanes are never read back.
+constexpr uint32_t CULL_LANES = 8;
+
+struct CullScene {
+    std::vector<float> aabbCX, aabbCY, aabbCZ;   // AABB centre
+    std::vector<float> aabbEX, aabbEY, aabbEZ;   // AABB half extents
+    std::vector<float> sphereX, sphereY, sphereZ, sphereR;
+
+    std::vector<uint32_t> assetFirstSurface;     // flat index of each asset's surface 0
+    glm::vec3 worldMin{ 0.0f }, worldMax{ 0.0f }; // union of every AABB
+    uint32_t count = 0;                          // live surfaces
+    uint32_t padded = 0;                         // count rounded up to CULL_LANES
+};
+
+// One visibility byte per flat surface for a single view
+struct CullView {
+    std::vector<uint8_t> visible;
+    uint32_t visibleCount = 0;
+};
+
+struct CullingState {
+    bool      enabled = true;
+    CullScene scene;
+    CullView  camera;      // main colour pass
+    CullView  shadow;      // sun, frustum around every cascade (lightViewProj)
+    CullView  cascades[MAX_SHADOW_CASCADES];      // casters per shadow cascade
+    float     cpuMs = 0.0f;
+};
+
+// Minimum surfaces per job before the work is spread across the pool
+constexpr uint32_t CULL_PARALLEL_BATCH = 2048;
+
+// Rebuild world bounds — call whenever testMeshes or a worldTransform changes
+void build_cull_scene(Engine* e);
+
+void cull_view(Engine* e, const Frustum& frustum, CullView& out);
+
+// Culls the scene against e->cameraViewProj, e->lightViewProj and each active
+// shadow cascade
+void run_frustum_culling(Engine* e);
+
+// Name of the kernel the build selected ("AVX2", "SSE2" or "scalar")
+const char* cull_simd_name();
+
+inline bool cull_is_visible(const CullView& view, uint32_t flatIndex)
+{
+    return flatIndex >= view.visible.size() || view.visible[flatIndex] != 0;
+}
@@ -5,6 +5,7 @@
 #include "imgui.h"
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_vulkan.h"
+#include "log.h"
 
 struct Engine;  // forward declare — debug_ui.h must not include engine.h (circular)
 
@@ -13,6 +14,7 @@ struct DebugUIState {
     bool show_performance = false;
     bool show_scene_debug = false;
     bool show_renderer_stats = false;
+    bool show_gpu_profiler = false;
     bool show_memory_stats = false;
     bool show_log_console = false;
     bool show_input_debug = false;
@@ -20,16 +22,16 @@ struct DebugUIState {
     bool show_imgui_demo = false;
     bool show_background_ctrl = true;   // compute shader switcher — on by default
 
-    // ── Frame time rolling buffers ────────────────────────────────────────
-    std::vector<float> frameTimes = std::vector<float>(128, 0.0f);
-    std::vector<float> fpsHistory = std::vector<float>(128, 0.0f);
-    float minFrameTime = 0.0f;
-    float maxFrameTime = 0.0f;
-    float avgFrameTime = 0.0f;
+    // ── CPU trace capture ─────────────────────────────────────────────────
+    int traceFrames = 60;
+
+    // ── Camera path recorder ──────────────────────────────────────────────
+    char cameraPathFile[256] = "camera.campath";
 
     // ── Log console ───────────────────────────────────────────────────────
-    std::vector<std::string> logMessages;
+    // Lines come from the logger's own console buffer (log.h)
     bool           autoScrollLog = true;
+    int            logShowLevel = (int)LogLevel::Trace;
     ImGuiTextFilter logFilter;
 
     // ── Style ─────────────────────────────────────────────────────────────
@@ -42,7 +44,7 @@ extern DebugUIState g_debugUI;
 // ── Public API ────────────────────────────────────────────────────────────────
 void debug_ui_init(Engine* e);
 void debug_ui_shutdown();
-void debug_ui_update(float deltaTime);
+// Logs under the UI category; shows in the console like any other message
 void debug_ui_log(const char* fmt, ...);
 void debug_ui_log(const std::string& msg);
 
@@ -53,6 +55,7 @@ void debug_ui_render(Engine* e);
 void debug_ui_render_performance_window();
 void debug_ui_render_scene_debug_window(Engine* e);
 void debug_ui_render_renderer_stats_window(Engine* e);
+void debug_ui_render_gpu_profiler_window(Engine* e);
 void debug_ui_render_memory_stats_window(Engine* e);
 void debug_ui_render_log_console_window();
 void debug_ui_render_input_debug_window();
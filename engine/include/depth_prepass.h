@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Depth pre-pass ───────────────────────────────────────────────────────────
+// Optional mode for draw_geometry. Opaque and alpha-masked surfaces first fill
+// the MSAA depth buffer with a position-only pipeline (masked ones through a
+// small alpha-test fragment shader), then the colour pass re-draws them with
+// depth test EQUAL and depth writes off, so the PBR shader runs at most once
+// per sample. Blended surfaces keep the regular mesh pipeline.
+//
+// Both passes must produce identical depth: the vertex shaders share the same
+// transform and declare gl_Position invariant.
+struct DepthPrepassState {
+    bool enabled = false;
+
+    VkPipeline depthPipeline = VK_NULL_HANDLE;    // position only, no fragment stage
+    VkPipeline maskedPipeline = VK_NULL_HANDLE;   // position + uv, alpha test
+    VkPipeline equalPipeline = VK_NULL_HANDLE;    // mesh shading, EQUAL, no depth write
+
+    // ── Single-sampled counterparts for TAA mode (taa.h)
+    VkPipeline depthPipelineTaa = VK_NULL_HANDLE;
+    VkPipeline maskedPipelineTaa = VK_NULL_HANDLE;
+    VkPipeline equalPipelineTaa = VK_NULL_HANDLE;
+};
+
+// Pipelines — after init_mesh_pipelines (shares its layout)
+void init_depth_prepass(Engine* e);
+
+// Clears depthImage and fills it from renderQueue.depth; leaves it ready for
+// the colour pass to load
+void draw_depth_prepass(Engine* e, VkCommandBuffer cmd);
@@ -6,6 +6,7 @@
 #include <span>
 #include <deque>
 #include <iostream>
+#include "log.h"
 
 struct DescriptorLayoutBuilder
 {
@@ -36,11 +37,11 @@ struct DescriptorAllocator
     VkDescriptorPool pool = VK_NULL_HANDLE;
 
     DescriptorAllocator() {
-        std::cout << "[CTOR] DescriptorAllocator constructed at " << this << "\n";
+        LOG_CAT(Core, Trace, "DescriptorAllocator constructed at " << this);
     }
 
     DescriptorAllocator(const DescriptorAllocator& other) {
-        std::cout << "[COPY CTOR] Copying DescriptorAllocator from " << &other << " to " << this << "\n";
+        LOG_CAT(Core, Trace, "Copying DescriptorAllocator from " << &other << " to " << this);
         pool = other.pool;
     }
 
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <cstdint>
+#include <vulkan/vulkan_core.h>
+#include "render_queue.h"
+
+struct Engine;
+struct MeshAsset;
+struct GeoSurface;
+
+// ─── Static draw cache ────────────────────────────────────────────────────────
+// Opaque static surfaces and static shadow casters are recorded once into
+// reusable secondary buffers and replayed every frame with vkCmdExecuteCommands.
+// Each frame in flight owns its own copy, so a stale copy is re-recorded only
+// once its frame fence has passed — never while the GPU may still read it.
+//
+// A copy is valid while its key matches: scene version (bumped by
+// mark_scene_dirty), the pipeline handle, and a hash of every value baked into
+// the recording (lighting push constants, viewport, light matrix). Blended and
+// non-static surfaces stay in the per-frame render queue.
+//
+// Cached passes skip CPU culling — the whole static set is drawn every frame,
+// into every shadow cascade. Each cascade has its own recording, keyed by its
+// light matrix, so a cascade only re-records when its matrix moves. While the
+// shadow cache (shadow_cache.h) is on it owns the static casters instead.
+struct DrawCacheKey {
+    uint64_t   sceneVersion = 0;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    uint64_t   paramsHash = 0;
+
+    bool operator==(const DrawCacheKey&) const = default;
+};
+
+struct CachedPass {
+    VkCommandBuffer  cmd = VK_NULL_HANDLE;
+    DrawCacheKey     key;
+    bool             valid = false;
+    RenderQueueStats stats;                    // what the recording contains
+    uint32_t         triangles = 0;
+};
+
+// Must equal FRAME_OVERLAP (checked in draw_cache.cpp)
+constexpr uint32_t DRAW_CACHE_SLOTS = 3;
+
+struct DrawCacheState {
+    bool     enabled = false;
+    uint64_t sceneVersion = 1;
+
+    // Static packets, sorted by state only (no view depth)
+    uint64_t         builtVersion = 0;
+    RenderPipelineId builtPipeline = RenderPipelineId::Mesh;   // opaque colour pipeline
+    RenderQueue      staticOpaque;
+    RenderQueue      staticShadow;
+
+    VkCommandPool pools[DRAW_CACHE_SLOTS] = {};   // one per frame in flight
+    CachedPass    opaque[DRAW_CACHE_SLOTS];
+    CachedPass    shadow[DRAW_CACHE_SLOTS][MAX_SHADOW_CASCADES];
+
+    // ── Stats
+    uint32_t rebuilds = 0;                     // total re-recordings
+    float    lastRecordMs = 0.0f;
+    bool     hitOpaque = false;                // this frame replayed without recording
+    bool     hitShadow = false;                // every active cascade
+};
+
+void init_draw_cache(Engine* e);
+
+// Invalidates every cached pass — call after changing meshes, transforms or
+// materials. build_cull_scene calls it.
+void mark_scene_dirty(Engine* e);
+
+// Returns this frame's cached secondary, re-recording it if its key changed.
+// Returns VK_NULL_HANDLE when there is nothing static to draw.
+VkCommandBuffer draw_cache_opaque(Engine* e, RenderQueueStats& stats, uint32_t& triangles);
+VkCommandBuffer draw_cache_shadow(Engine* e, uint32_t cascade, RenderQueueStats& stats);
+
+// Whether the per-frame queues should leave this surface to the cache
+bool draw_cache_owns(const Engine* e, const MeshAsset& mesh, const GeoSurface& surf, bool shadowPass);
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Dynamic resolution ───────────────────────────────────────────────────────
+// The frame renders into the top-left drawExtent of the full-size draw targets.
+// Only viewports, scissors and render areas shrink; nothing is reallocated.
+//
+// Each frame, the GPU time of the last completed frame (the gpu_profiler's
+// "frame" root) moves the render scale
+// toward targetMs. Pixel cost goes with scale², so the ideal step is
+// sqrt(target / measured). The step is damped, and the scale holds still inside
+// a deadband so the extent, and with it the draw cache, doesn't change every
+// frame. Extents are whole multiples of gcd(width, height) of the draw image,
+// which means 16x9 pixel steps at 4K and an aspect ratio that never drifts.
+//
+// draw_upscale reconstructs the swapchain image from that sub-rect
+// (shaders/upscale.frag). It uses a 4x4 Lanczos-2 kernel stretched along local
+// edges, then contrast-adaptive sharpening.
+constexpr uint32_t DRS_HISTORY = 240;
+
+struct UpscalePushConstants {
+    glm::vec2 srcSize;       // active sub-rect of drawImage, pixels
+    uint32_t  sourceIndex;   // drawImage in the sampler2D array
+    float     sharpness;     // 0 = reconstruction only
+};
+
+struct DynamicResolutionState {
+    bool  enabled = true;
+    float targetMs = 16.6f;
+    float minScale = 0.5f;           // per axis
+    float maxScale = 1.0f;
+    float sharpness = 0.5f;
+    float scale = 1.0f;              // current, before quantisation
+
+    VkPipelineLayout upscaleLayout = VK_NULL_HANDLE;
+    VkPipeline       upscalePipeline = VK_NULL_HANDLE;
+    uint32_t         sourceBindlessIndex = 7;   // drawImage
+
+    // ── GPU timing, from the profiler's results
+    int lastResultFrame = -1;        // gp.resultFrame already consumed
+    int discardBefore = 0;           // earlier frames ran another path or AA mode
+
+    // ── Stats shown in the debug UI
+    float    gpuMs = 0.0f;           // last completed frame
+    float    smoothedMs = 0.0f;
+    uint32_t extentChanges = 0;
+    float    scaleHistory[DRS_HISTORY] = {};
+    float    gpuMsHistory[DRS_HISTORY] = {};
+    uint32_t historyHead = 0;        // oldest sample
+};
+
+// Upscale pipeline — after init_swapchain and init_descriptors
+void init_dynamic_resolution(Engine* e);
+
+// Call after gpu_profiler_begin_frame, before anything reads drawExtent: takes
+// the resolved frame's GPU time and picks this frame's render extent
+void dynamic_resolution_begin_frame(Engine* e);
+
+// Fills target (swapchain extent, COLOR_ATTACHMENT_OPTIMAL) from the drawExtent
+// sub-rect of the image at sourceIndex (SHADER_READ_ONLY_OPTIMAL) — drawImage,
+// or the TAA history
+void draw_upscale(Engine* e, VkCommandBuffer cmd, VkImageView target, uint32_t sourceIndex);
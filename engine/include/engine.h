@@ -15,6 +15,7 @@
 #include <iostream>
 #include <unordered_map>
 #include <string>
+#include <memory>
 
 #include <GLFW/glfw3.h>
 #include <glm/vec4.hpp>
@@ -28,13 +29,40 @@
 #include "graphics_pipeline.h"
 #include "ibl.h"
 #include "raytrace.h"
+#include "jobs.h"
+#include "culling.h"
+#include "gpu_culling.h"
+#include "software_occlusion.h"
+#include "render_queue.h"
+#include "parallel_record.h"
+#include "draw_cache.h"
+#include "depth_prepass.h"
+#include "shadow_cascades.h"
+#include "shadow_cache.h"
+#include "render_graph.h"
+#include "dynamic_resolution.h"
+#include "taa.h"
+#include "frame_pacing.h"
+#include "frame_scheduler.h"
+#include "gpu_profiler.h"
+#include "headless.h"
+#include "telemetry.h"
+#include "camera_path.h"
+#include "benchmark.h"
+#include "cpu_profiler.h"
+#include "visibility_buffer.h"
+#include "clustered_lighting.h"
+#include "shader_bundle.h"
+#include "pipeline_cache.h"
+#include "pipeline_service.h"
 
 // ─── Vulkan error check ───────────────────────────────────────────────────────
 #define VK_CHECK(x)                                                         \
     do {                                                                    \
         VkResult err = x;                                                   \
         if (err != VK_SUCCESS) {                                            \
-            std::cerr << "Vulkan error in " << #x << ": " << err << "\n";  \
+            LOG_CAT(Vulkan, Error, "Vulkan error in " << #x << ": " << err); \
+            log_flush();                                                    \
             std::abort();                                                   \
         }                                                                   \
     } while (0)
@@ -62,7 +90,8 @@ struct ScenePushConstants {
 // ─── Compute effect ───────────────────────────────────────────────────────────
 struct ComputeEffect {
     const char* name;
-    VkPipeline         pipeline;
+    VkPipeline         pipeline;      // null while `variant` compiles
+    PipelineVariant    variant;
     VkPipelineLayout   layout;
     ScenePushConstants effectData;
 };
@@ -81,12 +110,14 @@ struct FrameData {
     VkCommandBuffer  mainCommandBuffer;
     VkSemaphore      swapchainSemaphore;
     VkSemaphore      renderSemaphore;
-    VkFence          renderFence;
     DeletionQueue    deletionQueue;
     DescriptorAllocator frameDescriptors;
 
     // Per-frame camera UBO — one per frame so triple-buffering doesn't race
     AllocatedBuffer  cameraBuffer{};
+
+    // One pool per job-system thread for secondary buffers
+    std::vector<ThreadCommandPool> threadPools;
 };
 
 constexpr unsigned int FRAME_OVERLAP = 3;
@@ -120,8 +151,9 @@ struct Engine {
     std::vector<AllocatedImage> sceneTextures;
     uint32_t nextBindlessTextureIndex = 13;
 
-    AllocatedImage drawImage{};
+    AllocatedImage drawImage{};        // drawImage, msaaImage, depthImage: render-graph transients
     VkExtent2D     drawExtent{3840,  2160};
+    RenderGraphState renderGraph;
 
     std::vector<VkSemaphore> imageAvailableSemaphores;
     std::vector<VkSemaphore> renderFinishedSemaphores;
@@ -133,7 +165,6 @@ struct Engine {
     VkPipeline       gradientPipeline = VK_NULL_HANDLE;
     VkPipelineLayout gradientPipelineLayout = VK_NULL_HANDLE;
 
-    VkFence          immFence = VK_NULL_HANDLE;
     VkCommandBuffer  immCommandBuffer = VK_NULL_HANDLE;
     VkCommandPool    immCommandPool = VK_NULL_HANDLE;
     VkDescriptorPool imguiDescriptorPool = VK_NULL_HANDLE;
@@ -143,20 +174,28 @@ struct Engine {
 
     MemoryStats memoryStats{};
     Utils       util;
+    ShaderBundle       shaderBundle;
+    PipelineCacheState pipelineCache;
+    std::unique_ptr<PipelineServiceState> pipelineService;
 
     bool displayShadowMap = false;
     bool filterPCF = true;
     float zNear = 1.0f;
     float zFar = 96.0f;
     std::vector<std::string> sceneNames;
+    std::vector<std::string> sceneFiles;    // glTF files init_default_data loads; empty = New Sponza
+    float                    sceneLoadMs = 0.0f;
     int32_t sceneIndex = 0;
 
     AllocatedImage   shadowMapImage{};
     VkSampler        shadowMapSampler = VK_NULL_HANDLE;
     VkPipeline       shadowPipeline = VK_NULL_HANDLE;
     VkPipelineLayout shadowPipelineLayout = VK_NULL_HANDLE;
-    uint32_t       shadowMapBindlessIndex = 5;  // slots 0-4 reserved
-    glm::mat4        lightViewProj = glm::mat4(1.0f);  // updated every frame
+    uint32_t       shadowMapBindlessIndex = 0;  // slot in the layered-texture array (binding 4)
+    glm::mat4        lightViewProj = glm::mat4(1.0f);  // around all cascades, updated every frame
+    ShadowCascadeState shadowCascades;
+    ShadowCacheState   shadowCache;
+    glm::mat4        cameraViewProj = glm::mat4(1.0f); // same, for CPU culling
 
 
     PipelineBuilder  pipelineBuilder;
@@ -164,6 +203,7 @@ struct Engine {
     VkPipeline       trianglePipeline = VK_NULL_HANDLE;
     VkPipelineLayout meshPipelineLayout = VK_NULL_HANDLE;
     VkPipeline       meshPipeline = VK_NULL_HANDLE;
+    VkPipeline       meshPipelineTaa = VK_NULL_HANDLE;    // 1x, colour + velocity
 
     GPUMeshBuffers   rectangle{};
     AllocatedBuffer  vertexBuffer{};
@@ -243,6 +283,9 @@ struct Engine {
 
     //skybox 
     VkPipeline       skyboxPipeline = VK_NULL_HANDLE;
+    VkPipeline       skyboxPipelineTaa = VK_NULL_HANDLE;
+    VkPipeline       skyboxPipelineVis = VK_NULL_HANDLE;      // depth-tested, single-sampled
+    VkPipeline       skyboxPipelineVisTaa = VK_NULL_HANDLE;
     VkPipelineLayout skyboxPipelineLayout = VK_NULL_HANDLE;
     float            skyTime = 0.0f;
     float            cloudCoverage = 0.6f;
@@ -256,6 +299,32 @@ struct Engine {
     uint32_t lastDrawCalls = 0;
     uint32_t lastTriangles = 0;
 
+    // ── CPU frustum culling + worker pool
+    CullingState               culling;
+    std::unique_ptr<JobSystem> jobs;
+
+    // ── Two-phase Hi-Z occlusion culling (GPU-driven colour pass)
+    GpuCullingState gpuCulling;
+
+    // ── CPU occlusion against a small software depth buffer
+    SoftwareOcclusionState swOcclusion;
+
+    // ── Sorted draw packets for the CPU-driven passes
+    RenderQueueState renderQueue;
+    ParallelRecordState parallelRecord;
+    DrawCacheState drawCache;
+    DepthPrepassState depthPrepass;
+    DynamicResolutionState dynamicRes;
+    FramePacingState       framePacing;
+    FrameSchedulerState    scheduler;
+    GpuProfilerState       gpuProfiler;
+    HeadlessState          headless;
+    CameraPathState        cameraPath;
+    TelemetryState         telemetry;
+    TaaState taa;
+    VisibilityBufferState visibility;
+    ClusteredLightingState clusteredLighting;
+
     uint32_t mipLevels = 1;
 
     // renderer tweakables
@@ -269,6 +338,7 @@ struct Engine {
 	std::vector<BLAS> blasHandles;
     VkCommandBuffer acceleration_structure_buffer;
 	std::vector<vk::raii::Buffer> blasBuffers;
+    bool rayTracingSupported = false;      // acceleration structure + ray query; set by init_vulkan
     VkAccelerationStructureKHR tlasHandle{ VK_NULL_HANDLE };
     AllocatedBuffer tlasStorage;
     AllocatedBuffer tlasInstanceBuffer;
@@ -302,10 +372,16 @@ void init_sync_structures(Engine* e);
 void init_pipelines(Engine* e);
 void init_background_pipelines(Engine* e);
 void init_mesh_pipelines(Engine* e);
+// From the shader bundle or a loose .spv; a missing shader is fatal
+VkShaderModule load_shader_or_exit(Engine* e, const char* path);
 void init_imgui(Engine* e);
 void init_default_data(Engine* e);
 void init_debug_ui(Engine* e);
 void init_depth_image(Engine* e, uint32_t width, uint32_t height);
+void init_job_system(Engine* e);
+
+// `relative` under the working directory or the nearest parent that has it
+std::filesystem::path find_asset(const std::filesystem::path& relative);
 
 // Frame
 FrameData& get_current_frame(Engine* e);
@@ -364,6 +440,10 @@ void calculateTangents(std::vector<Vertex>& vertices, const std::vector<uint32_t
 void  init_shadow_map(Engine* e, uint32_t width, uint32_t height);
 void init_shadow_pipeline(Engine* e);
 void draw_shadow_pass(Engine* e, VkCommandBuffer cmd);
+// Draws a queue's casters into one cascade layer; withDrawCache adds the
+// draw cache's static recording. Adds to stats.
+void draw_shadow_layer(Engine* e, VkCommandBuffer cmd, VkImageView target, const RenderQueue& queue,
+    uint32_t cascade, VkAttachmentLoadOp loadOp, bool withDrawCache, RenderQueueStats& stats);
 void draw_skybox(Engine* e, VkCommandBuffer cmd);
 
 
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Frame pacing ─────────────────────────────────────────────────────────────
+// Present mode, frame-rate cap and input-to-present latency. Frames in flight
+// belong to the frame scheduler (frame_scheduler.h).
+//
+// The present mode is chosen at runtime from what the surface supports.
+// Changing it rebuilds the swapchain through the resize path. A frame cap
+// sleeps to within spinMs of the deadline and then spins, because OS sleeps
+// overshoot by about a scheduler tick. The deadline advances by whole periods,
+// so one late frame doesn't shift every frame after it.
+//
+// With VK_KHR_present_id + present_wait, every present carries an id. Latency
+// is the time from the frame's input sample to that id reaching the display.
+// Low-latency mode also blocks before input is sampled until the previous
+// present has landed, so input is read as late as possible. Without the
+// extensions the latency shown is an estimate: (frames in flight + 1) × the
+// mean frame interval.
+constexpr uint32_t PACING_HISTORY = 240;
+
+struct PendingPresent {
+    uint64_t id;
+    std::chrono::high_resolution_clock::time_point input;
+};
+
+struct FramePacingState {
+    // ── Settings
+    VkPresentModeKHR presentMode = VK_PRESENT_MODE_FIFO_KHR;      // requested
+    float    frameCap = 0.0f;        // fps, 0 = uncapped
+    float    spinMs = 1.0f;          // tail of the wait that busy-spins
+    bool     lowLatency = false;     // needs present wait
+
+    // ── Swapchain
+    VkPresentModeKHR              activePresentMode = VK_PRESENT_MODE_FIFO_KHR;
+    std::vector<VkPresentModeKHR> supportedModes;
+
+    // ── Present id / wait (VK_KHR_present_id + VK_KHR_present_wait)
+    bool                   presentWaitSupported = false;   // set by init_vulkan
+    VkSwapchainKHR         swapchain = VK_NULL_HANDLE;      // the ids below belong to
+    PFN_vkWaitForPresentKHR pfnWaitForPresent = nullptr;
+    uint64_t               presentId = 0;            // last id handed out
+    VkPresentIdKHR         presentIdInfo{ .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR };
+    std::deque<PendingPresent> pending;
+
+    // ── Timing
+    std::chrono::high_resolution_clock::time_point deadline{};
+    std::chrono::high_resolution_clock::time_point lastFrame{};
+    std::chrono::high_resolution_clock::time_point input{};   // this frame's input sample
+
+    // ── Stats shown in the debug UI
+    float    intervalHistory[PACING_HISTORY] = {};    // ms between frame starts
+    float    latencyHistory[PACING_HISTORY] = {};     // ms, measured or estimated
+    uint32_t historyHead = 0;        // oldest sample
+    float    meanIntervalMs = 0.0f;
+    float    intervalStdDevMs = 0.0f;
+    float    worstIntervalMs = 0.0f;
+    float    latencyMs = 0.0f;       // smoothed
+    bool     latencyMeasured = false;
+    float    limiterWaitMs = 0.0f;   // time the cap held the last frame
+};
+
+const char* present_mode_name(VkPresentModeKHR mode);
+
+// Loads vkWaitForPresentKHR when init_vulkan enabled present wait — after
+// init_vulkan, before init_swapchain
+void init_frame_pacing(Engine* e);
+
+// First thing in engine_draw_frame, before input is read. Applies the frame
+// cap and the low-latency wait. Also collects
+// finished presents and stamps this frame's input time
+void frame_pacing_begin_frame(Engine* e);
+
+// Chains this frame's present id into presentInfo, if supported. Call right
+// before vkQueuePresentKHR; the id is recorded as pending
+void frame_pacing_present(Engine* e, VkPresentInfoKHR& presentInfo);
+
+// Asks for a new present mode; the swapchain is rebuilt before the next frame
+void frame_pacing_set_present_mode(Engine* e, VkPresentModeKHR mode);
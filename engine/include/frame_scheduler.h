@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Frame scheduler ──────────────────────────────────────────────────────────
+// One engine-wide timeline semaphore orders all GPU work. Every graphics-queue
+// submission signals the next value: each frame, and each immediate_submit. A
+// value being reached means everything submitted up to it is done, because a
+// semaphore signal covers all earlier work on its queue. Per-frame fences and
+// the immediate-submit fence are gone. The acquire and present semaphores stay
+// binary, as WSI requires.
+//
+// Before a frame starts, the CPU waits for the value the frame framesInFlight
+// back signalled. framesInFlight can change at runtime from 1 to FRAME_OVERLAP,
+// because per-frame resources are still sized for FRAME_OVERLAP. Waiting on a
+// newer frame always covers the slot's own previous use.
+//
+// Resources that recorded frames may still read go to frame_scheduler_retire.
+// It frees them once the timeline passes the next value to be signalled, with
+// no vkDeviceWaitIdle. Async compute or transfer queues would wait on and
+// signal the same timeline.
+struct RetiredResource {
+    uint64_t              value;     // free once the timeline reaches this
+    std::function<void()> destroy;
+};
+
+struct FrameSchedulerState {
+    VkSemaphore timeline = VK_NULL_HANDLE;
+    uint64_t    submitted = 0;                 // last value handed to a submission
+    uint64_t    completed = 0;                 // last value seen reached
+    std::vector<uint64_t> slotValue;           // per frame slot: value it last signalled
+    uint32_t    framesInFlight = 3;            // 1..FRAME_OVERLAP
+
+    std::deque<RetiredResource> retired;
+
+    // ── Stats shown in the debug UI — CPU time blocked, per cause
+    float    gpuWaitMs = 0.0f;                 // waiting for a frame in flight
+    float    acquireWaitMs = 0.0f;             // inside vkAcquireNextImageKHR
+    uint32_t retiredLastFrame = 0;
+};
+
+// Creates the timeline — after init_sync_structures, before any immediate_submit
+void init_frame_scheduler(Engine* e);
+
+// Frame start: waits for the frame framesInFlight back, then frees what it retired
+void frame_scheduler_begin_frame(Engine* e);
+
+// Signal info for the next timeline value. The caller submits it; a frame
+// also records it as its slot's value
+VkSemaphoreSubmitInfo frame_scheduler_signal(Engine* e, VkPipelineStageFlags2 stage);
+
+// Blocks the CPU until the timeline reaches value; returns the milliseconds waited
+float frame_scheduler_wait(Engine* e, uint64_t value);
+
+// Frees `destroy` once no submitted or about-to-be-submitted work can use it
+void frame_scheduler_retire(Engine* e, std::function<void()> destroy);
+
+// Times vkAcquireNextImageKHR into acquireWaitMs
+VkResult frame_scheduler_acquire(Engine* e, VkSemaphore signal, uint32_t* imageIndex);
@@ -0,0 +1,141 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "types.h"
+#include "descriptors.h"
+
+struct Engine;
+
+// ─── GPU draw item ────────────────────────────────────────────────────────────
+// Mirrors DrawItem in shaders/draw_item.glsl (scalar layout). Items are grouped
+// by asset so every asset owns a contiguous range of indirect command slots.
+struct GPUDrawItem {
+    glm::mat4 modelMatrix;
+    glm::vec4 sphere;           // world-space centre xyz, radius w
+    glm::vec4 aabbMin;          // world-space AABB, w unused
+    glm::vec4 aabbMax;
+    uint32_t  firstIndex;
+    uint32_t  indexCount;
+    uint32_t  assetIndex;
+    uint32_t  commandBase;      // first item of this asset
+    uint32_t  albedoIndex;
+    uint32_t  normalIndex;
+    uint32_t  metalRoughIndex;
+    uint32_t  aoIndex;
+    uint32_t  emissiveIndex;
+    float     metallicFactor;
+    float     roughnessFactor;
+    float     normalStrength;
+    glm::vec4 colorFactor;
+};
+static_assert(sizeof(GPUDrawItem) == 176, "GPUDrawItem must match draw_item.glsl");
+
+// occlusion_cull.comp push block
+struct GpuCullPushConstants {
+    glm::vec4       frustum[6];
+    VkDeviceAddress items;
+    VkDeviceAddress visibility;
+    VkDeviceAddress commands;
+    VkDeviceAddress counts;
+    VkDeviceAddress stats;
+    uint32_t        itemCount;
+    uint32_t        assetCount;
+    uint32_t        phase;
+    uint32_t        pyramidIndex;
+    glm::vec2       depthSize;
+    uint32_t        pyramidMips;
+    uint32_t        occlusionEnabled;
+};
+
+// mesh_indirect.vert / tex_image_indirect.frag push block
+struct GpuDrawPushConstants {
+    VkDeviceAddress items;
+    glm::vec3       sunDirection;
+    glm::vec3       sunColor;
+    float           sunIntensity;
+    uint32_t        shadowMapIndex;
+    float           shadowBias;
+    uint32_t        iblIrradianceIndex;
+    uint32_t        iblPrefilterIndex;
+    uint32_t        iblBrdfLutIndex;
+};
+
+struct PyramidPushConstants {
+    glm::ivec2 srcSize;
+    glm::ivec2 dstSize;
+};
+
+// Written by the cull shader, read back once the frame's fence has signalled
+struct GpuCullStats {
+    uint32_t earlyDrawn = 0;
+    uint32_t lateDrawn = 0;
+    uint32_t frustumCulled = 0;
+    uint32_t occlusionCulled = 0;
+    uint32_t triangles = 0;
+};
+
+enum class GpuCullGranularity : int { Object = 0, Cluster = 1 };
+
+constexpr uint32_t HIZ_MAX_MIPS = 12;
+
+struct GpuCullingState {
+    bool               enabled = false;
+    bool               occlusion = true;       // off = frustum only, still two-phase
+    bool               occlusionSupported = true;   // MAX depth resolve available
+    GpuCullGranularity granularity = GpuCullGranularity::Object;
+    GpuCullGranularity builtGranularity = GpuCullGranularity::Object;
+    bool               itemsBuilt = false;
+
+    // ── Scene buffers (device-local, accessed through BDA)
+    uint32_t              itemCount = 0;
+    std::vector<uint32_t> assetFirstItem;
+    std::vector<uint32_t> assetItemCount;
+    AllocatedBuffer       itemBuffer{};
+    AllocatedBuffer       visibilityBuffer{};
+    AllocatedBuffer       commandBuffer{};   // [phase][item] VkDrawIndexedIndirectCommand
+    AllocatedBuffer       countBuffer{};     // [phase][asset] uint32
+
+    // ── Per-frame readback
+    std::vector<AllocatedBuffer> statsBuffers;
+    std::vector<uint8_t>         frameRecorded;
+
+    // ── Depth pyramid
+    AllocatedImage        depthResolve{};     // single-sample copy of depthImage
+    VkResolveModeFlagBits depthResolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+    AllocatedImage        pyramid{};
+    uint32_t              pyramidMips = 0;
+    VkExtent2D            pyramidExtent{};
+    VkImageView           pyramidMipViews[HIZ_MAX_MIPS] = {};
+    VkDescriptorSet       pyramidSets[HIZ_MAX_MIPS] = {};
+    uint32_t              pyramidBindlessIndex = 6;
+    DescriptorAllocator   pyramidDescriptors;
+    VkDescriptorSetLayout pyramidSetLayout = VK_NULL_HANDLE;
+    VkPipelineLayout      pyramidLayout = VK_NULL_HANDLE;
+    VkPipeline            pyramidPipeline = VK_NULL_HANDLE;
+
+    // ── Cull + draw pipelines
+    VkPipelineLayout cullLayout = VK_NULL_HANDLE;
+    VkPipeline       cullPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout drawLayout = VK_NULL_HANDLE;
+    VkPipeline       drawPipeline = VK_NULL_HANDLE;
+
+    // ── Stats shown in the debug UI (one frame-in-flight behind)
+    GpuCullStats stats;
+};
+
+// Pipelines, depth pyramid, readback resources and the first item build —
+// after init_default_data has loaded testMeshes
+void init_gpu_culling(Engine* e);
+
+// (Re)builds the draw item + indirect buffers for the current granularity.
+// Waits for the device when replacing live buffers.
+void build_gpu_cull_items(Engine* e);
+
+// Call after the frame fence wait: reads back the stats of the slot that just
+// signalled and rebuilds items if the granularity changed
+void gpu_culling_begin_frame(Engine* e);
+
+// Replaces draw_geometry: early pass, Hi-Z build, late cull, late pass
+void draw_geometry_gpu_culled(Engine* e, VkCommandBuffer cmd);
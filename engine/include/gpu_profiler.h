@@ -0,0 +1,112 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── GPU profiler ─────────────────────────────────────────────────────────────
+// Timestamps every render graph pass, plus any nested scopes a pass opens, so
+// the frame's GPU time splits into shadow, sky, geometry, ImGui and the rest.
+// Scopes nest: the whole command buffer is a "frame" root, passes sit under
+// it, and a pass may open children of its own (shadow cascades, the depth
+// pre-pass).
+//
+// Each frame slot owns GPU_PROFILER_MAX_SCOPES begin/end timestamp pairs. The
+// slot's results are read back when the slot comes round again, FRAME_OVERLAP
+// frames later. The scheduler has waited for that frame by then, so the
+// readback never blocks; a slot that isn't ready is dropped, not waited for.
+//
+// With the pipelineStatisticsQuery feature, the outermost scope below the root
+// also counts input-assembly primitives and vertex and fragment invocations.
+// Only one statistics query may be active at a time, so nested scopes only get
+// timestamps. Secondary command buffers inherit the statistic flags, so a
+// query stays valid across vkCmdExecuteCommands. That takes the
+// inheritedQueries feature too: statisticsSupported needs both, and without
+// it statisticFlags stays 0 and no statistics query is ever opened.
+//
+// The "frame" root is recorded even with the profiler disabled: dynamic
+// resolution steers by it. `enabled` only gates the passes and nested scopes.
+// Feature panels (shadows, culling, lighting, ...) read their times from here
+// by scope name rather than keeping query pools of their own.
+//
+// The enabled flags are latched at frame begin, so the UI toggling them while
+// the frame records can't leave a scope unbalanced.
+constexpr uint32_t GPU_PROFILER_MAX_SCOPES = 64;      // per frame, root included
+constexpr uint32_t GPU_PROFILER_STATISTICS = 3;       // primitives, vertex, fragment
+
+struct GpuScope {
+    std::string name;
+    uint32_t    depth = 0;
+    bool        statistics = false;     // owns the slot's statistics query `index`
+};
+
+struct GpuScopeResult {
+    std::string name;
+    uint32_t    depth = 0;
+    float       startMs = 0.0f;         // from the frame root's begin
+    float       ms = 0.0f;
+    float       avgMs = 0.0f;           // exponential moving average
+    bool        hasStatistics = false;
+    uint64_t    statistics[GPU_PROFILER_STATISTICS] = {};
+};
+
+struct GpuProfilerState {
+    bool  enabled = true;
+    bool  statistics = true;            // ignored unless statisticsSupported
+    float smoothing = 0.05f;            // weight of the newest frame in avgMs
+
+    bool                          statisticsSupported = false;   // set by init_vulkan
+    VkQueryPipelineStatisticFlags statisticFlags = 0;            // inherited by every secondary
+
+    VkQueryPool timestampPool = VK_NULL_HANDLE;      // 2 per scope per frame slot
+    VkQueryPool statisticsPool = VK_NULL_HANDLE;     // 1 per scope per frame slot
+    float       timestampPeriod = 1.0f;              // ns per tick
+    uint64_t    timestampMask = ~0ull;               // timestampValidBits
+
+    // ── Recording
+    std::vector<std::vector<GpuScope>> frameScopes;  // per frame slot, in begin order
+    std::vector<uint32_t>              open;          // scope indices; UINT32_MAX = dropped
+    bool                               recording = false;         // the root
+    bool                               recordingScopes = false;   // everything below it
+    bool                               recordingStatistics = false;
+    bool                               statisticsOpen = false;
+
+    // ── Results, FRAME_OVERLAP frames behind
+    std::vector<GpuScopeResult>            results;   // begin order, root first
+    std::unordered_map<std::string, float> averages;  // by "parent/name" path
+    int                                    resultFrame = -1;
+    uint32_t                               droppedScopes = 0;   // over the scope budget
+};
+
+// Query pools — after init_vulkan and init_commands
+void init_gpu_profiler(Engine* e);
+
+// Call after the frame scheduler's wait: reads back the slot's scopes
+void gpu_profiler_begin_frame(Engine* e);
+
+// At the end of a run: reads back the last FRAME_OVERLAP frames, which no later
+// frame comes round to. The device must be idle. `resolved` runs after each one
+void gpu_profiler_drain(Engine* e, const std::function<void()>& resolved);
+
+// Resets the slot's queries and opens the "frame" root — right after
+// vkBeginCommandBuffer. frame_end closes the root before vkEndCommandBuffer.
+void gpu_profiler_frame_begin(Engine* e, VkCommandBuffer cmd);
+void gpu_profiler_frame_end(Engine* e, VkCommandBuffer cmd);
+
+// A scope nested in the innermost open one. Outside any rendering instance.
+void gpu_profiler_begin(Engine* e, VkCommandBuffer cmd, const char* name);
+void gpu_profiler_end(Engine* e, VkCommandBuffer cmd);
+
+// The first scope of that name in the last resolved frame, in begin order, or
+// null. gpu_profiler_ms is its time, 0 when the scope wasn't recorded
+const GpuScopeResult* gpu_profiler_find(const Engine* e, std::string_view name);
+float gpu_profiler_ms(const Engine* e, std::string_view name);
+
+// The last resolved frame, one row per scope, with its averages
+bool gpu_profiler_dump_csv(const Engine* e, const char* path);
@@ -3,6 +3,8 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+struct Engine;
+
 struct PipelineBuilder
 {
   std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
@@ -14,6 +16,7 @@ struct PipelineBuilder
   VkPipelineLayout pipelineLayout;
   VkPipelineRenderingCreateInfo renderInfo;
   VkFormat colorAttachmentformat;
+  std::vector<VkFormat> colorAttachmentFormats;   // set_color_attachment_formats (MRT)
   VkPipelineDepthStencilStateCreateInfo depthStencil; 
 
   VkPipelineVertexInputStateCreateInfo vertexInputInfo;
@@ -23,12 +26,15 @@ struct PipelineBuilder
 
 void set_shaders(VkShaderModule vertexShader, VkShaderModule fragmentShader,PipelineBuilder& pb);
 void clear(PipelineBuilder& pb);
-VkPipeline build_pipeline(VkDevice device,PipelineBuilder& pb);
+// Through the engine's pipeline cache (pipeline_cache.h)
+VkPipeline build_pipeline(Engine* e, PipelineBuilder& pb);
 void set_input_topology(VkPrimitiveTopology topology,PipelineBuilder& pb);
 void set_polygon_mode(VkPolygonMode mode, PipelineBuilder& pb);
 void set_cull_mode(VkCullModeFlags cullMode, VkFrontFace frontFace, PipelineBuilder& pb);
 void set_multisampling_none(PipelineBuilder& pb); 
 void set_color_attachment_format(VkFormat format, PipelineBuilder& pb); 
+// Several colour targets; attachments after the first never blend
+void set_color_attachment_formats(const std::vector<VkFormat>& formats, PipelineBuilder& pb);
 void disable_blending(PipelineBuilder& pb); 
 void set_depth_format(VkFormat format, PipelineBuilder& pb); 
 void disable_depthtest(PipelineBuilder& pb);
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <types.h>
+#include "images.h"
+
+struct Engine;
+
+// ─── Headless mode ────────────────────────────────────────────────────────────
+// Runs the renderer with no window, surface or swapchain, for CI and for
+// software rasterisers such as lavapipe. The instance is created headless and
+// the device is picked without a present requirement. An offscreen
+// colour target stands in for the swapchain image. The frame graph writes it
+// exactly as it would a swapchain image and then hands it to a copy rather
+// than to present.
+//
+// Frames advance with a fixed timestep and render at full resolution, so a run
+// doesn't depend on how fast the device is. Dynamic resolution is off unless
+// the config asks for it. There is no ImGui, camera input or frame pacing. The
+// camera stays where init put it.
+//
+// After the last frame, headless_run writes:
+//
+//   - <imagePath>   the final frame as a binary PPM (P6, 8-bit RGB)
+//   - <statsPath>   JSON with the device, the settings, and per-frame CPU and GPU
+//                   milliseconds with their min/avg/max
+//
+// GPU times come from the GPU profiler's "frame" root scope. They are -1 for
+// frames whose queries weren't available.
+struct HeadlessConfig {
+    uint32_t    frames = 60;
+    uint32_t    width = 1920;
+    uint32_t    height = 1080;
+    float       fixedDeltaTime = 1.0f / 60.0f;
+    bool        dynamicResolution = false;   // let GPU times pick the render scale
+    std::string imagePath = "headless.ppm";
+    std::string statsPath = "headless_stats.json";
+};
+
+struct HeadlessState {
+    bool           enabled = false;
+    HeadlessConfig config;
+
+    AllocatedImage  target{};            // B8G8R8A8, in place of the swapchain image
+    AllocatedBuffer readback{};          // tightly packed copy of the final frame
+    bool            captureFrame = false; // this frame copies target into readback
+
+    std::vector<float> cpuMs;            // engine_draw_frame wall time
+    std::vector<float> gpuMs;            // GPU "frame" scope; -1 = unresolved
+};
+
+// init() with no window: the device, an offscreen target and everything else
+// except ImGui, the debug UI and input
+void init_headless(Engine* e, const HeadlessConfig& config);
+
+// The offscreen target and its readback buffer. Called by init in place of
+// init_swapchain
+void headless_create_target(Engine* e);
+
+// Records the target-to-readback copy on the frame that captures. The graph has
+// left the target in TRANSFER_SRC by then
+void headless_record_readback(Engine* e, VkCommandBuffer cmd);
+
+// Renders config.frames frames and writes the image and stats. Returns the
+// process exit code
+int headless_run(Engine* e);
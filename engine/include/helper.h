@@ -5,8 +5,11 @@
 #include <vector>
 #include <vulkan/vulkan_core.h>
 
+struct ShaderBundle;
+
 struct Utils
 {
+  const ShaderBundle* bundle = nullptr;   // looked up before the loose .spv files
   VkRenderingInfo rendering_info(VkExtent2D renderextent, VkRenderingAttachmentInfo* colorAttachment, VkRenderingAttachmentInfo* depthAttachment);
   bool load_shader_module(const char* filePath, VkDevice device, VkShaderModule* module);
   VkPipelineShaderStageCreateInfo pipeline_shader_stage_create_info(VkShaderStageFlagBits stage, VkShaderModule shaderModule, const char* entry);
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ─── Job system ───────────────────────────────────────────────────────────────
+// Fixed pool of worker threads fed from one locked queue. parallel_for splits a
+// range into batches that workers (and the calling thread) pull from an atomic
+// cursor, so small ranges never pay for more than one wake-up.
+//
+// Worker indices are stable: the main thread is 0, pool threads are 1..N. Code
+// that keeps per-thread state (scratch buffers, command pools) can index by it.
+// Do not call jobs_parallel_for from inside a job — the pool does not nest.
+struct JobSystem {
+    std::vector<std::thread>          workers;
+    std::deque<std::function<void()>> queue;
+    std::mutex                        mutex;
+    std::condition_variable           wake;
+    bool                              quit = false;
+};
+
+using JobRangeFn = std::function<void(uint32_t begin, uint32_t end, uint32_t worker)>;
+
+void     jobs_init(JobSystem& js, uint32_t workerCount);
+void     jobs_shutdown(JobSystem& js);
+
+// Total threads that can run a job at once: pool workers + the caller.
+uint32_t jobs_thread_count(const JobSystem& js);
+uint32_t jobs_current_worker();
+
+// Blocks until fn has been called for every batch of [0, count).
+void     jobs_parallel_for(JobSystem& js, uint32_t count, uint32_t batch, const JobRangeFn& fn);
+
+// Queues one job and returns at once; the job must not reference the caller's
+// stack. Pending jobs still run at jobs_shutdown.
+void     jobs_submit(JobSystem& js, std::function<void()> job);
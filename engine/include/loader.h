@@ -22,14 +22,52 @@ struct GeoSurface {
     float metallicFactor = 1.0f;
     float roughnessFactor = 1.0f;
     glm::vec3 emissiveFactor = glm::vec3(0.0f);
+
+    // Mesh-space bounds — worldTransform is applied by the culling stage
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
+    glm::vec3 sphereCenter = glm::vec3(0.0f);
+    float     sphereRadius = 0.0f;
+
+    // glTF alphaMode OPAQUE — only these may hide other geometry
+    bool      opaque = true;
+    // glTF alphaMode MASK — alpha-tested, can join the depth pre-pass
+    bool      masked = false;
+
+    // Range in MeshAsset::occluderIndices; empty when the surface can't occlude
+    uint32_t  occluderFirstIndex = 0;
+    uint32_t  occluderIndexCount = 0;
+};
+
+// Fixed-size slice of one surface's index range, used for finer GPU culling
+constexpr uint32_t CLUSTER_TRIANGLES = 128;
+
+// Occluder proxies are the surface's own largest triangles, never moved, so a
+// proxy can only ever hide less than the surface itself. Surfaces whose best
+// OCCLUDER_MAX_TRIANGLES cover less than OCCLUDER_MIN_COVERAGE of their area
+// (dense, finely tessellated meshes) get no proxy.
+constexpr uint32_t OCCLUDER_MAX_TRIANGLES = 64;
+constexpr float    OCCLUDER_MIN_COVERAGE = 0.25f;
+
+struct MeshCluster {
+    uint32_t  startIndex = 0;
+    uint32_t  count = 0;
+    uint32_t  surfaceIndex = 0;     // owning GeoSurface — material comes from there
+    glm::vec3 boundsMin = glm::vec3(0.0f);
+    glm::vec3 boundsMax = glm::vec3(0.0f);
 };
 
 // One GLTF mesh node — all surfaces share the same vertex/index buffer
 struct MeshAsset {
     std::string             name;
     std::vector<GeoSurface> surfaces;
+    std::vector<MeshCluster> clusters;   // mesh space, built at load time
+    std::vector<glm::vec3>  occluderPositions;   // mesh space, CPU only
+    std::vector<uint32_t>   occluderIndices;
     GPUMeshBuffers          meshBuffers;
     glm::mat4               worldTransform = glm::mat4(1.0f);
+    bool                    isStatic = true;     // never moves — eligible for the draw cache
+    bool                    ownsBuffers = true;  // false for further instances of a shared glTF mesh
     uint64_t				blasAddress{ 0 };
 	VkAccelerationStructureKHR blasHandle{ VK_NULL_HANDLE };
 };
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <atomic>
+#include <charconv>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+// ─── Logging ──────────────────────────────────────────────────────────────────
+// LOG("loaded " << n << " meshes") formats straight into a slot of the calling
+// thread's own ring buffer and returns. A background thread drains every ring
+// in timestamp order to the console, the log file and the in-game console, so
+// a log call never takes a lock, never waits on I/O and costs about as much as
+// formatting the text (well under a microsecond). The flusher wakes every few
+// milliseconds, and at once for a warning or an error. When a thread exits,
+// its ring is retired. Once drained, it goes on a free list for the next new
+// thread, so thread churn neither grows memory nor the flusher's scan.
+//
+// If the ring is full because the flusher is behind, the message is dropped and
+// counted, never waited for. The next flush reports how many were lost.
+//
+// Messages carry a level and a category. Each category has a minimum level,
+// checked before anything is formatted. LOG_DEBUG compiles out of NDEBUG
+// builds. LOG_RATE logs a call site at most once per interval and folds the
+// rest into a "(+N suppressed)" count on its next message.
+//
+//   LOG(...), LOG_WARN(...), LOG_ERROR(...), LOG_DEBUG(...)    category Core
+//   LOG_CAT(Loader, Warn, ...)                                 any category
+//   LOG_RATE(Render, Warn, 1.0, ...)                           rate-limited
+//
+// A message longer than LOG_SLOT_TEXT is truncated. log_flush blocks until all
+// pending messages are written: call it before abort, since abort runs no
+// destructors.
+enum class LogLevel : uint8_t { Trace, Debug, Info, Warn, Error, Count };
+enum class LogCategory : uint8_t { Core, Vulkan, Render, Loader, Pipeline, Jobs, Profiler, UI, Count };
+
+constexpr uint32_t LOG_RING_SLOTS = 1024;        // per thread, power of two
+constexpr uint32_t LOG_SLOT_TEXT = 244;          // bytes of text per message (256-byte slots)
+constexpr uint32_t LOG_CONSOLE_LINES = 2048;     // kept for the in-game console
+
+const char* log_level_name(LogLevel level);
+const char* log_category_name(LogCategory category);
+
+// ─── Filtering ────────────────────────────────────────────────────────────────
+extern std::atomic<uint8_t> g_logMinLevel[(size_t)LogCategory::Count];
+
+inline bool log_enabled(LogLevel level, LogCategory category)
+{
+    return (uint8_t)level >= g_logMinLevel[(size_t)category].load(std::memory_order_relaxed);
+}
+
+void log_set_level(LogCategory category, LogLevel level);
+void log_set_level(LogLevel level);                  // every category
+
+// ─── Sinks ────────────────────────────────────────────────────────────────────
+// Writes to `path` (truncated) from now on; empty closes the file
+void log_set_file(const std::string& path);
+void log_set_console_output(bool enabled);          // stdout / stderr
+
+// Blocks until everything logged before the call is written
+void log_flush();
+
+struct LogStats {
+    uint64_t written = 0;
+    uint64_t dropped = 0;                            // ring full
+    uint32_t threads = 0;
+};
+LogStats log_stats();
+
+// ─── In-game console ──────────────────────────────────────────────────────────
+// The last LOG_CONSOLE_LINES messages, oldest first. The visitor runs under
+// the console's lock, so it must not log
+struct LogLine {
+    double      seconds = 0.0;                       // since logging started
+    LogLevel    level = LogLevel::Info;
+    LogCategory category = LogCategory::Core;
+    std::string text;
+};
+void log_console_visit(const std::function<void(const LogLine&)>& visit);
+void log_console_clear();
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+struct LogSlot;
+
+// Formats one message into the thread's ring; committed on destruction
+class LogStream {
+public:
+    LogStream(LogLevel level, LogCategory category);
+    ~LogStream();
+    LogStream(const LogStream&) = delete;
+    LogStream& operator=(const LogStream&) = delete;
+
+    LogStream& operator<<(std::string_view s) { append(s.data(), s.size()); return *this; }
+    LogStream& operator<<(const char* s) { return *this << std::string_view(s ? s : "(null)"); }
+    LogStream& operator<<(const std::string& s) { return *this << std::string_view(s); }
+    LogStream& operator<<(const std::filesystem::path& p) { return *this << p.string(); }
+    LogStream& operator<<(char c) { append(&c, 1); return *this; }
+    LogStream& operator<<(bool b) { return *this << (b ? "true" : "false"); }
+
+    // Handles (VkImage, ...) and other pointers print as addresses
+    template<typename T>
+        requires std::is_pointer_v<T> && (!std::is_convertible_v<T, std::string_view>)
+    LogStream& operator<<(T p) { append_pointer((const void*)p); return *this; }
+
+    template<typename T>
+        requires std::is_arithmetic_v<T>
+    LogStream& operator<<(T v)
+    {
+        char buf[32];
+        std::to_chars_result r;
+        if constexpr (std::is_floating_point_v<T>)
+            r = std::to_chars(buf, buf + sizeof(buf), v, std::chars_format::general, 6);   // as iostream
+        else
+            r = std::to_chars(buf, buf + sizeof(buf), v);
+        append(buf, (size_t)(r.ptr - buf));
+        return *this;
+    }
+
+    template<typename T>
+        requires std::is_enum_v<T>
+    LogStream& operator<<(T v) { return *this << (std::underlying_type_t<T>)v; }
+
+    // Anything else iostream can print
+    template<typename T>
+        requires (!std::is_arithmetic_v<T> && !std::is_enum_v<T> && !std::is_pointer_v<T> &&
+                  !std::is_convertible_v<const T&, std::string_view>)
+    LogStream& operator<<(const T& v)
+    {
+        std::ostringstream s;
+        s << v;
+        return *this << s.str();
+    }
+
+private:
+    void append(const char* data, size_t size);
+    void append_pointer(const void* p);
+
+    LogSlot* slot_;                                  // null: ring full, message dropped
+    uint32_t length_ = 0;
+};
+
+// Per call site: true once per interval; counts what it turns away
+struct LogRateLimit {
+    std::atomic<int64_t>  nextNs{ 0 };
+    std::atomic<uint32_t> suppressed{ 0 };
+
+    bool allow(double intervalSeconds, uint32_t* suppressedOut);
+};
+
+#define LOG_CAT(category, level, ...)                                                   \
+    do {                                                                                \
+        if (log_enabled(LogLevel::level, LogCategory::category)) {                      \
+            LogStream logStream_(LogLevel::level, LogCategory::category);               \
+            logStream_ << __VA_ARGS__;                                                  \
+        }                                                                               \
+    } while (0)
+
+#define LOG_RATE(category, level, seconds, ...)                                         \
+    do {                                                                                \
+        static LogRateLimit logLimit_;                                                  \
+        uint32_t logSuppressed_ = 0;                                                    \
+        if (log_enabled(LogLevel::level, LogCategory::category) &&                      \
+            logLimit_.allow(seconds, &logSuppressed_)) {                                \
+            LogStream logStream_(LogLevel::level, LogCategory::category);               \
+            logStream_ << __VA_ARGS__;                                                  \
+            if (logSuppressed_) logStream_ << " (+" << logSuppressed_ << " suppressed)";  \
+        }                                                                               \
+    } while (0)
+
+#define LOG(...)       LOG_CAT(Core, Info, __VA_ARGS__)
+#define LOG_WARN(...)  LOG_CAT(Core, Warn, __VA_ARGS__)
+#define LOG_ERROR(...) LOG_CAT(Core, Error, __VA_ARGS__)
+#ifdef NDEBUG
+#define LOG_DEBUG(...) ((void)0)
+#else
+#define LOG_DEBUG(...) LOG_CAT(Core, Debug, __VA_ARGS__)
+#endif
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Parallel command recording ───────────────────────────────────────────────
+// Every job-system thread owns one command pool per frame in flight, so threads
+// never share a pool and a frame's pools are reset together once its fence has
+// signalled. Passes split their draw packets into ranges; each range is recorded
+// into its own secondary buffer on whichever thread picks it up, and the
+// primary buffer only runs vkCmdExecuteCommands inside a rendering instance
+// begun with VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT.
+struct ThreadCommandPool {
+    VkCommandPool                pool = VK_NULL_HANDLE;
+    std::vector<VkCommandBuffer> buffers;   // grows on demand, reused every frame
+    uint32_t                     used = 0;
+};
+
+// Attachment formats the secondaries are recorded against — must match the
+// VkRenderingInfo of the pass that executes them
+struct RecordTarget {
+    std::vector<VkFormat> colorFormats;
+    VkFormat              depthFormat = VK_FORMAT_UNDEFINED;
+    VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT;
+};
+
+struct ParallelRecordState {
+    bool     enabled = true;
+    uint32_t batch = 256;                   // draw packets per secondary
+
+    // ── Stats for the frame being recorded
+    std::vector<float> threadMs;            // by job-system worker index
+    uint32_t           secondaries = 0;
+};
+
+using RecordRangeFn = std::function<void(VkCommandBuffer cmd, uint32_t begin, uint32_t end)>;
+
+// Per-thread pools for every frame in flight — after init_job_system
+void init_parallel_recording(Engine* e);
+
+// Resets this frame's pools — after the frame fence wait
+void parallel_record_begin_frame(Engine* e);
+
+// Records [0, count) in batches of `batch`, one secondary per batch, spread
+// over the job system. Buffers are appended to `out` in range order.
+void record_secondaries(Engine* e, const RecordTarget& target,
+    uint32_t count, uint32_t batch, const RecordRangeFn& fn,
+    std::vector<VkCommandBuffer>& out);
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Pipeline cache ───────────────────────────────────────────────────────────
+// One VkPipelineCache for every pipeline the engine builds, written to disk
+// at shutdown and fed back at the next startup. The file starts with our own
+// header (driver identity, payload size and checksum) in front of the
+// driver's blob; a cache from another GPU, driver version or a torn write is
+// dropped and the run starts cold instead of handing the driver bad data.
+//
+// Every vkCreate*Pipelines call goes through the two helpers below so the
+// startup report can show pipeline creation time, cold against warm. The
+// cold figure is kept in the file header, so a warm run can compare itself
+// with the run that filled the cache.
+constexpr char     PIPELINE_CACHE_MAGIC[4] = { 'S', 'Y', 'P', 'C' };
+constexpr uint32_t PIPELINE_CACHE_VERSION = 1;
+
+struct PipelineCacheFileHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t vendorID;
+    uint32_t deviceID;
+    uint32_t driverVersion;
+    uint8_t  pipelineCacheUUID[VK_UUID_SIZE];
+    uint64_t dataSize;                 // driver blob that follows
+    uint64_t checksum;                 // FNV-1a of the blob
+    float    coldCreateMs;             // pipeline time of the run that started cold
+    uint32_t pad = 0;
+};
+
+struct PipelineCacheState {
+    VkPipelineCache cache = VK_NULL_HANDLE;
+    std::string     path = "pipeline_cache.bin";
+    bool            warm = false;      // a valid cache was loaded
+    std::string     rejected;          // why an existing file was dropped
+    size_t          loadedBytes = 0;
+    size_t          savedBytes = 0;
+
+    // ── Creation time, accumulated by the helpers from any thread (the
+    // pipeline service compiles on its own pool) — summed, not wall time
+    uint32_t pipelines = 0;
+    double   createMs = 0.0;
+    float    coldCreateMs = 0.0f;      // from the file when warm, else this run's
+    bool     reported = false;
+};
+
+// Maps the shader bundle and creates the cache, seeded from disk when the file
+// matches this device — right after init_vulkan, before any pipeline
+void init_pipeline_cache(Engine* e);
+
+// Logs startup pipeline time, cold or warm — once, at the end of init
+void pipeline_cache_report(Engine* e);
+
+// vkCreate*Pipelines against the engine's cache, timed into createMs
+VkResult create_graphics_pipeline(Engine* e, const VkGraphicsPipelineCreateInfo& info, VkPipeline* pipeline);
+VkResult create_compute_pipeline(Engine* e, const VkComputePipelineCreateInfo& info, VkPipeline* pipeline);
@@ -0,0 +1,82 @@
+#pragma once
+
+#include "graphics_pipeline.h"
+#include "jobs.h"
+
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Pipeline service ─────────────────────────────────────────────────────────
+// Compiles pipelines on a pool of its own threads, so startup pipeline time
+// shrinks with core count and a background compile never stalls the frame's
+// jobs_parallel_for. A request hashes the whole builder state — shader
+// modules, fixed-function state, attachment formats, vertex layout and
+// pipeline layout — and returns a shared future; identical state gets the
+// future of the first request, so each pipeline is compiled once.
+//
+// The service owns every pipeline and shader module it hands out and
+// destroys them at shutdown; callers must not. Modules come from
+// pipeline_service_shader, which keeps them alive for that reason — a
+// destroyed module's handle could be reused and alias an old hash.
+//
+// Startup pipelines are written into their engine field by
+// pipeline_service_wait. Pipelines needed only later are held as a
+// PipelineVariant, which binds a compatible fallback until its compile ends.
+using PipelineFuture = std::shared_future<VkPipeline>;
+
+struct PipelineVariant {
+    PipelineFuture pending;            // compiling in the background
+    PipelineFuture fallback;           // must be ready and layout-compatible
+};
+
+struct PipelineServiceTarget {
+    VkPipeline*    target;
+    PipelineFuture future;
+};
+
+struct PipelineServiceState {
+    JobSystem pool;
+
+    std::mutex                                  mutex;      // guards pipelines, built, stats
+    std::unordered_map<uint64_t, PipelineFuture> pipelines;
+    std::vector<VkPipeline>                     built;      // destroyed at shutdown
+    std::unordered_map<std::string, VkShaderModule> shaders;  // main thread only
+    std::vector<PipelineServiceTarget>          targets;    // resolved by wait
+
+    // ── Stats
+    uint32_t requests = 0;
+    uint32_t deduplicated = 0;
+    double   compileMs = 0.0;          // summed over compile jobs
+    std::chrono::high_resolution_clock::time_point firstRequest{};
+    double   startupWallMs = 0.0;      // first request to the first wait returning
+};
+
+// Creates e->pipelineService and starts its compile threads — right after
+// init_pipeline_cache
+void init_pipeline_service(Engine* e);
+
+// Loads a shader once and keeps it for the service's lifetime; exits if missing
+VkShaderModule pipeline_service_shader(Engine* e, const char* path);
+
+// Queues a compile, or returns the in-flight/finished one for identical state.
+// The builder is copied, so it may be changed or destroyed right away.
+PipelineFuture pipeline_service_request(Engine* e, const PipelineBuilder& pb, const char* name);
+PipelineFuture pipeline_service_request_compute(Engine* e, VkShaderModule shader,
+    VkPipelineLayout layout, const char* name);
+
+// Writes the pipeline into *target at the next pipeline_service_wait
+void pipeline_service_build(Engine* e, PipelineFuture future, VkPipeline* target);
+
+// Blocks until every pending target is written; exits if any compile failed
+void pipeline_service_wait(Engine* e);
+
+// The variant once compiled, its fallback until then — never blocks
+VkPipeline pipeline_variant_get(const PipelineVariant& variant);
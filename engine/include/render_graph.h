@@ -0,0 +1,152 @@
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include <vk_mem_alloc.h>
+#include "images.h"
+
+struct Engine;
+
+// ─── Render graph ─────────────────────────────────────────────────────────────
+// engine_draw_frame declares the frame as a list of passes, each naming the
+// images it reads and writes. render_graph_execute then:
+//
+//   - culls passes whose writes nothing downstream consumes. Sinks are
+//     exported images (the swapchain) and passes marked with side effects.
+//   - emits one synchronization2 barrier batch before each pass, derived from
+//     the previous access to every image it touches: exact stages, access
+//     masks and layouts. A read after a read in the same layout costs nothing.
+//   - places transient images in a single VMA allocation. Two transients share
+//     memory when their lifetimes [first pass, last pass] don't overlap.
+//
+// Transients are registered once (create_draw_image, init_depth_image) and
+// created on the first execute. They are re-placed, after a device wait, only
+// when the registrations or the frame's lifetimes change. Their contents never
+// outlive the frame. Imported images are owned elsewhere and bring their
+// state with them.
+//
+// A pass may still synchronise inside itself (depth pre-pass, GPU culling's
+// early/late split). The graph only sees what crosses a pass boundary.
+enum class GraphUsage : uint8_t {
+    ColorAttachment,     // includes MSAA resolve targets
+    DepthAttachment,
+    DepthSampled,        // DEPTH_READ_ONLY, sampled by fragment shaders
+    SampledFragment,
+    SampledCompute,
+    StorageCompute,      // GENERAL
+    TransferSrc,
+    TransferDst,
+    Present,
+};
+
+using GraphHandle = uint32_t;
+
+struct GraphAccess {
+    GraphHandle resource;
+    GraphUsage  usage;
+    bool        reads;
+    bool        writes;
+    bool        external;    // the pass synchronises this image itself
+};
+
+// One barrier the compiler emitted — kept for the dump
+struct GraphBarrier {
+    GraphHandle           resource;
+    VkImageLayout         oldLayout, newLayout;
+    VkPipelineStageFlags2 srcStages, dstStages;
+};
+
+struct GraphPass {
+    std::string                          name;
+    std::vector<GraphAccess>             accesses;
+    std::function<void(VkCommandBuffer)> record;
+    bool                                 sideEffects = false;
+
+    // ── Compiled
+    bool                      culled = false;
+    std::vector<GraphBarrier> barriers;
+};
+
+struct GraphResource {
+    std::string        name;
+    VkImage            image = VK_NULL_HANDLE;
+    VkImageAspectFlags aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    int32_t            transient = -1;           // index into RenderGraphState::transients
+
+    // ── Imported images: state on entry, usage on exit (if exported)
+    VkImageLayout         initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 initialStages = VK_PIPELINE_STAGE_2_NONE;
+    bool                  exported = false;
+    GraphUsage            finalUsage = GraphUsage::Present;
+};
+
+struct TransientImage {
+    std::string                  name;
+    VkImageCreateInfo            info{};
+    VkImageAspectFlags           aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+    AllocatedImage*              bind = nullptr;    // engine field that receives image + view
+    std::function<void(Engine*)> onCreate;          // e.g. rewrite descriptors
+
+    // ── Placement
+    VkMemoryRequirements  requirements{};
+    VkDeviceSize          offset = 0;
+    uint32_t              firstPass = UINT32_MAX, lastPass = 0;   // this frame
+    VkPipelineStageFlags2 tailStages = VK_PIPELINE_STAGE_2_NONE;  // last access of the frame
+    VkAccessFlags2        tailWrites = VK_ACCESS_2_NONE;
+};
+
+struct RenderGraphState {
+    bool aliasing = true;
+
+    // ── Declared this frame
+    std::vector<GraphResource> resources;
+    std::vector<GraphPass>     passes;
+
+    // ── Transients — persistent
+    std::vector<TransientImage> transients;
+    VmaAllocation               memory = VK_NULL_HANDLE;
+    uint64_t                    placedSignature = 0;   // 0 = not placed
+
+    // ── Stats for the last executed frame
+    VkDeviceSize memorySize = 0;
+    VkDeviceSize unaliasedSize = 0;    // sum of every transient on its own
+    uint32_t     barriers = 0;
+    uint32_t     culledPasses = 0;
+    uint32_t     placements = 0;       // times the transients were re-placed
+    bool         dumpRequested = false;
+};
+
+// Frees the transient memory at shutdown — before create_draw_image
+void init_render_graph(Engine* e);
+
+// Transient images. Registering again with the same `bind` replaces the
+// description. bind->imageFormat / imageExtent are set at once; image and view
+// appear on the next execute, and onCreate runs after every (re)creation.
+void render_graph_register_transient(Engine* e, const char* name, const VkImageCreateInfo& info,
+    VkImageAspectFlags aspect, AllocatedImage* bind, std::function<void(Engine*)> onCreate = {});
+void render_graph_release_transient(Engine* e, AllocatedImage* bind);
+
+// ── Frame declaration
+void        render_graph_begin(Engine* e);
+GraphHandle render_graph_import(Engine* e, const char* name, VkImage image, VkImageAspectFlags aspect,
+    VkImageLayout layout, VkPipelineStageFlags2 lastStages);
+GraphHandle render_graph_transient(Engine* e, AllocatedImage* bind);
+void        render_graph_export(Engine* e, GraphHandle resource, GraphUsage finalUsage);
+
+uint32_t render_graph_add_pass(Engine* e, const char* name, std::function<void(VkCommandBuffer)> record);
+void     render_graph_read(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage);
+void     render_graph_write(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage);    // overwrites
+void     render_graph_modify(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage);   // loads, then writes
+// The pass writes the image and synchronises it itself, leaving it in `usage`
+void     render_graph_external(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage);
+void     render_graph_side_effects(Engine* e, uint32_t pass);
+
+// Compiles the declared frame and records every live pass into cmd
+void render_graph_execute(Engine* e, VkCommandBuffer cmd);
+
+// Graphviz dump of the last compiled frame: passes with their barriers,
+// resources with their memory placement
+bool render_graph_dump(const Engine* e, const char* path);
@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <vulkan/vulkan_core.h>
+#include "types.h"
+#include "shadow_cascades.h"
+
+struct Engine;
+
+// ─── Sort keys ────────────────────────────────────────────────────────────────
+// Every visible surface becomes a 16-byte packet with a 64-bit key; sorting the
+// keys orders the whole pass. Field order decides what is kept together:
+//
+//   opaque       pass:2 | pipeline:6 | depth slice:6 | geometry:16 | material:20 | depth:14
+//   transparent  pass:2 | pipeline:6 | far-to-near depth:24 | geometry:16 | material:16
+//   shadow       pass:2 | pipeline:6 | geometry:16 | depth:24 | material:16
+//
+// Opaque draws go front to back in 64 coarse slices so early-Z rejects more,
+// and inside a slice they group by vertex/index buffer and material. With
+// instancing on, the batcher merges copies of a surface across every slice
+// into one draw at the position of the nearest copy.
+enum class RenderPassId : uint32_t { Shadow = 0, Opaque = 1, Transparent = 2 };
+
+// Index into the pipeline table the submitters switch on (render_pipeline)
+enum class RenderPipelineId : uint32_t {
+    Mesh = 0, Shadow = 1,
+    MeshEqual = 2,       // colour pass after the depth pre-pass
+    Depth = 3,           // depth pre-pass, opaque
+    DepthMasked = 4,     // depth pre-pass, alpha-tested
+};
+
+uint64_t make_sort_key(RenderPassId pass, RenderPipelineId pipeline,
+    uint32_t geometry, uint32_t material, float depth01);
+
+struct DrawPacket {
+    uint64_t key;
+    uint32_t asset;      // index into Engine::testMeshes
+    uint32_t surface;    // index into that asset's surfaces
+};
+
+// One instanced draw: `count` copies of packets[packet]'s surface whose model
+// matrices sit at [firstInstance, firstInstance + count) in the frame's
+// instance buffer
+struct DrawBatch {
+    uint32_t packet;
+    uint32_t count;
+    uint32_t firstInstance;
+};
+
+struct RenderQueue {
+    std::vector<DrawPacket> packets;
+    std::vector<DrawPacket> scratch;     // radix sort ping-pong buffer
+    uint32_t                triangles = 0;
+
+    // Filled by the batcher; empty = one draw per packet with pushed matrices
+    std::vector<DrawBatch>  batches;
+    VkDeviceAddress         instances = 0;
+};
+
+// Draw calls the submitters will issue for a queue — the range callers split
+inline uint32_t submit_count(const RenderQueue& queue)
+{
+    return (uint32_t)(queue.batches.empty() ? queue.packets.size() : queue.batches.size());
+}
+
+struct RenderQueueStats {
+    uint32_t draws = 0;
+    uint32_t pipelineBinds = 0;
+    uint32_t bufferBinds = 0;            // vertex + index buffer pairs
+    uint32_t pushes = 0;                 // vkCmdPushConstants calls
+    uint32_t instances = 0;              // surfaces drawn — equals draws when unbatched
+};
+
+struct RenderQueueState {
+    bool frontToBack = true;             // off = depth bits left at zero
+
+    // Flat surface index (CullScene order) → dense material id
+    std::vector<uint32_t> surfaceMaterial;
+    uint32_t              materialCount = 0;
+    // Asset index → dense id of its vertex/index buffers; instances of one
+    // glTF mesh share buffers and so share an id
+    std::vector<uint32_t> assetGeometry;
+    uint32_t              geometryCount = 0;
+
+    // ── Instanced batching — identical geometry + material in one draw
+    bool                         instancing = true;
+    std::vector<AllocatedBuffer> instanceBuffers;    // per frame in flight, mapped
+    std::vector<uint32_t>        instanceCapacity;   // model matrices per buffer
+
+    RenderQueue      camera;
+    RenderQueue      shadow[MAX_SHADOW_CASCADES];   // casters per cascade
+    RenderQueue      shadowStatic[MAX_SHADOW_CASCADES];   // static casters for stale shadow cache layers
+    RenderQueue      depth;              // pre-pass packets, empty when it is off
+    RenderQueueStats cameraStats;
+    RenderQueueStats shadowStats;        // all cascades
+    RenderQueueStats cascadeStats[MAX_SHADOW_CASCADES];
+    RenderQueueStats depthStats;
+    float            buildMs = 0.0f;
+    float            sortMs = 0.0f;
+    float            batchMs = 0.0f;
+};
+
+// Per-frame instance buffers — needs only the allocator
+void init_render_queues(Engine* e);
+
+// LSD radix sort on the key, 8 bits per pass; passes where every key shares
+// the same byte are skipped
+void radix_sort_packets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch);
+
+// Dense material + geometry ids (surfaceMaterial, assetGeometry). Runs on its
+// own from build_render_queues when the scene changed size.
+void build_material_ids(Engine* e);
+
+// Fills and sorts the queues from the culling views, then batches them into
+// this frame's instance buffer — after all culling and the frame fence wait
+void build_render_queues(Engine* e);
+
+// The single-sampled variant while TAA is the active anti-aliasing mode
+VkPipeline render_pipeline(const Engine* e, RenderPipelineId id);
+
+// Pipeline the colour pass uses for opaque surfaces — MeshEqual while the depth
+// pre-pass is on
+RenderPipelineId opaque_colour_pipeline(const Engine* e);
+
+// Issue draws [begin, end) of a sorted queue inside an active rendering pass —
+// batches when the queue is batched, packets otherwise (see submit_count).
+// Binds the pipeline and descriptor set itself, so any range can go into its
+// own secondary buffer; viewport and scissor must already be set. Adds to stats.
+// submit_mesh_queue serves every pipeline built on meshPipelineLayout;
+// submit_shadow_queue draws with the given cascade's light matrix.
+void submit_mesh_queue(Engine* e, VkCommandBuffer cmd, const RenderQueue& queue,
+    uint32_t begin, uint32_t end, RenderQueueStats& stats);
+void submit_shadow_queue(Engine* e, VkCommandBuffer cmd, const RenderQueue& queue, uint32_t cascade,
+    uint32_t begin, uint32_t end, RenderQueueStats& stats);
+
+inline void accumulate_stats(RenderQueueStats& into, const RenderQueueStats& from)
+{
+    into.draws += from.draws;
+    into.pipelineBinds += from.pipelineBinds;
+    into.bufferBinds += from.bufferBinds;
+    into.pushes += from.pushes;
+    into.instances += from.instances;
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <unordered_map>
+
+// ─── Shader bundle ────────────────────────────────────────────────────────────
+// Every compiled .spv packed into one file by tools/shader_bundler.cpp at
+// build time, then memory-mapped read-only at startup. Shader modules are
+// created straight from the mapping, so loading a shader is a hash lookup
+// instead of an open/seek/read per file. Entries are named by the path the
+// engine asks for ("shaders/tex_image.frag.spv").
+//
+// Layout: header, `count` entries, then each blob at a 4-byte aligned offset.
+// This header is shared with the bundler and must not pull in Vulkan.
+constexpr char     SHADER_BUNDLE_MAGIC[4] = { 'S', 'P', 'V', 'B' };
+constexpr uint32_t SHADER_BUNDLE_VERSION = 1;
+constexpr uint32_t SHADER_BUNDLE_NAME_SIZE = 56;
+
+struct ShaderBundleHeader {
+    char     magic[4];
+    uint32_t version;
+    uint32_t count;
+    uint32_t totalSize;                // whole file, for truncation checks
+};
+
+struct ShaderBundleEntry {
+    char     name[SHADER_BUNDLE_NAME_SIZE];   // NUL-terminated
+    uint32_t offset;                          // from the start of the file
+    uint32_t size;                            // bytes, a multiple of 4
+};
+static_assert(sizeof(ShaderBundleEntry) == 64, "bundle entries are 64 bytes");
+
+struct ShaderBundle {
+    const std::byte* data = nullptr;
+    size_t           size = 0;
+    void*            mapping = nullptr;       // platform handle for the unmap
+    std::unordered_map<std::string, std::span<const uint32_t>> entries;
+};
+
+// Maps the bundle and indexes it. False (and an empty bundle) when the file is
+// missing or fails validation — callers fall back to loose .spv files.
+bool shader_bundle_open(ShaderBundle& bundle, const char* path);
+void shader_bundle_close(ShaderBundle& bundle);
+
+// SPIR-V words of `name`, or an empty span
+std::span<const uint32_t> shader_bundle_find(const ShaderBundle& bundle, const char* name);
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+#include "images.h"
+#include "shadow_cascades.h"
+
+struct Engine;
+
+// ─── Static shadow cache ──────────────────────────────────────────────────────
+// Static casters are rendered once per cascade into a second layered depth
+// image and re-rendered only when that cascade's matrix or the static scene
+// (drawCache.sceneVersion) changes. A cascade that has dynamic casters gets a
+// copy of its cached layer and only the dynamic casters drawn on top. A
+// cascade with neither a stale cache nor dynamic casters is left untouched,
+// so a static scene costs the shadow pass nothing but its barriers.
+//
+// Sticky cascade fits (see shadow_cascades.h) keep the matrices still while
+// the camera moves inside the margin. With `stagger` on, cascade c is only
+// updated every 2^c frames (capped at 8); between its turns its layer, dynamic
+// casters included, is reused as is. Moving casters then visibly lag in the
+// outer cascades, so `stagger` is off by default and the cache alone changes
+// nothing on screen.
+enum class ShadowCacheResult : uint8_t {
+    Reused,      // layer left as it was — hit
+    Copied,      // cache copied in, dynamic casters drawn on top — hit
+    Refreshed,   // static casters re-rendered — miss
+};
+
+struct ShadowCacheState {
+    bool  enabled = true;
+    bool  stagger = false;               // opt-in: freezes dynamic casters between turns
+    float margin = 0.2f;                 // extra cascade extent, fraction of the slice radius
+
+    // D32, one layer per cascade, same size as shadowMapImage
+    AllocatedImage cacheImage{};
+    VkImageView    layerViews[MAX_SHADOW_CASCADES] = {};
+    VkImageLayout  mapLayout[MAX_SHADOW_CASCADES] = {};     // shadow map layers, between frames
+
+    // ── What each cache layer holds
+    glm::mat4 cacheViewProj[MAX_SHADOW_CASCADES];
+    uint64_t  cacheVersion[MAX_SHADOW_CASCADES] = {};   // 0 = empty
+    bool      mapIsCache[MAX_SHADOW_CASCADES] = {};     // map layer equals cache layer
+
+    // ── Per frame — written by shadow_cache_plan
+    bool due[MAX_SHADOW_CASCADES] = {};                 // on this frame's stagger schedule
+    bool refreshStatic[MAX_SHADOW_CASCADES] = {};       // cache layer is stale
+
+    // ── Stats
+    ShadowCacheResult result[MAX_SHADOW_CASCADES] = {};
+    uint64_t          hits = 0;                         // cascade-frames
+    uint64_t          misses = 0;
+};
+
+// Cache image — after init_shadow_map
+void init_shadow_cache(Engine* e);
+
+// Whether cascade c is on this frame's update schedule
+bool shadow_cache_due(const Engine* e, uint32_t cascade);
+
+// Decides which cache layers are stale — after culling (the cull scene may
+// bump the scene version), before build_render_queues fills the static queues
+void shadow_cache_plan(Engine* e);
+
+// Cached replacement for the body of draw_shadow_pass: refreshes stale cache
+// layers, copies them into the shadow map, draws the dynamic casters on top and
+// leaves every layer in DEPTH_READ_ONLY_OPTIMAL
+void draw_cached_shadow_pass(Engine* e, VkCommandBuffer cmd);
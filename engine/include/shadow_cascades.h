@@ -0,0 +1,60 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+
+struct Engine;
+
+// ─── Cascaded shadow maps ─────────────────────────────────────────────────────
+// The sun's shadow map is a layered image, one layer per cascade. Split
+// distances blend a logarithmic and a uniform partition of [near, distance]
+// (lambda = 1 is fully logarithmic). Each cascade's slice of the view frustum
+// is fitted with a bounding sphere, so the ortho extent does not change as the
+// camera turns. Its centre is snapped to whole shadow texels in light space,
+// so edges don't shimmer as the camera moves. The depth range always spans the
+// whole scene, so casters behind the slice still land in it.
+//
+// The fragment shader picks a cascade by view depth and cross-fades into the
+// next one over the last `blend` fraction of each slice.
+//
+// While the shadow cache is on, fits are sticky: a cascade is fitted with a
+// margin (ShadowCacheState::margin) and keeps its matrix for as long as its
+// slice stays inside that box, so its cached static depth stays valid.
+constexpr uint32_t MAX_SHADOW_CASCADES = 4;
+
+// Light-space box a cascade matrix was built from
+struct ShadowCascadeFit {
+    glm::vec2 center{ 0.0f };     // texel-snapped
+    float     radius = 0.0f;      // half extent, margin included
+    float     zNear = 0.0f, zFar = 0.0f;
+    float     sphere = 0.0f;      // slice radius it was fitted for
+};
+
+struct ShadowCascadeState {
+    uint32_t count = MAX_SHADOW_CASCADES;   // active cascades, 1..MAX
+    float    distance = 120.0f;             // shadowed range from the camera
+    float    lambda = 0.8f;                 // 0 = uniform splits, 1 = logarithmic
+    float    blend = 0.1f;                  // fraction of each slice faded into the next
+
+    VkImageView layerViews[MAX_SHADOW_CASCADES] = {};   // depth attachment per cascade
+
+    // ── Per frame — written by update_shadow_cascades
+    glm::mat4 viewProj[MAX_SHADOW_CASCADES];
+    float     splitFar[MAX_SHADOW_CASCADES] = {};    // view-space far edge of each slice
+    float     texelWorld[MAX_SHADOW_CASCADES] = {};  // world units per shadow texel
+    bool      changed[MAX_SHADOW_CASCADES] = {};     // matrix differs from last frame
+
+    // ── Sticky fitting state
+    ShadowCascadeFit fit[MAX_SHADOW_CASCADES];
+    glm::vec3        fitToSun{ 0.0f };
+    uint64_t         fitVersion = 0;                 // scene version the fits assume
+};
+
+// Identity matrices until the first update — after init_shadow_map
+void init_shadow_cascades(Engine* e);
+
+// Fits every cascade to the camera and sets e->lightViewProj to a single
+// frustum around all of them (union culling, software occlusion). Needs the
+// cull scene bounds.
+void update_shadow_cascades(Engine* e, const glm::mat4& view, float aspect);
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+
+struct Engine;
+struct CullView;
+
+// ─── Software occlusion ───────────────────────────────────────────────────────
+// CPU fallback for when the GPU-driven path is off. The largest opaque surfaces
+// are rasterized as coarse occluder proxies (built by the loader) into a small
+// depth buffer; every frustum-visible surface then has its projected AABB tested
+// against it and is dropped from the CullView if it is fully hidden.
+//
+// Rows are split into bands that workers rasterize independently. Each band
+// also keeps the farthest depth per 8x8 tile, so most tests never touch pixels.
+constexpr uint32_t SWOC_WIDTH = 320;
+constexpr uint32_t SWOC_HEIGHT = 192;
+constexpr uint32_t SWOC_SHADOW_SIZE = 256;
+constexpr uint32_t SWOC_TILE = 8;
+constexpr uint32_t SWOC_BAND_ROWS = 16;     // multiple of SWOC_TILE
+
+// Nearest post-projection z per pixel, cleared to +inf (nothing drawn)
+struct DepthRaster {
+    uint32_t           width = 0;
+    uint32_t           height = 0;
+    uint32_t           tilesX = 0;
+    uint32_t           tilesY = 0;
+    std::vector<float> depth;
+    std::vector<float> tileMax;             // farthest depth in each tile
+};
+
+struct OcclusionView {
+    DepthRaster raster;
+    uint32_t    occluders = 0;
+    uint32_t    triangles = 0;
+    uint32_t    culled = 0;
+};
+
+// One surface that has an occluder proxy, largest first
+struct OccluderCandidate {
+    uint32_t flatIndex;
+    uint32_t asset;
+    uint32_t surface;
+};
+
+struct SoftwareOcclusionState {
+    bool     enabled = false;
+    bool     shadowView = true;             // also cull shadow casters from the light
+    uint32_t maxOccluders = 96;
+    float    minOccluderArea = 0.02f;       // fraction of the view a proxy must cover
+
+    std::vector<OccluderCandidate> candidates;
+    uint32_t      builtSurfaces = 0;        // CullScene::count the set was built for
+    OcclusionView camera;
+    OcclusionView shadow;
+
+    float rasterMs = 0.0f;
+    float testMs = 0.0f;
+};
+
+// Picks occluder candidates from testMeshes — call after build_cull_scene
+void build_occluder_set(Engine* e);
+
+// Rasterizes occluders and clears occluded surfaces out of e->culling's views.
+// Call right after run_frustum_culling.
+void run_software_occlusion(Engine* e);
+
+// Name of the raster kernel the build selected ("AVX2", "SSE2" or "scalar")
+const char* swoc_simd_name();
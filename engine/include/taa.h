@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+#include "images.h"
+
+struct Engine;
+struct RecordTarget;
+
+// ─── Temporal anti-aliasing ───────────────────────────────────────────────────
+// Alternative to 8x MSAA for the scene colour pass, switchable at runtime.
+//
+// In TAA mode every scene target is single-sampled. The projection is offset
+// by a sub-pixel Halton(2,3) jitter each frame (Camera::jitter), and the mesh
+// and sky pipelines write a second attachment: screen-space velocity from the
+// unjittered current and previous view-projection. draw_taa_resolve then
+// reprojects last frame's history through that velocity, clamps it to the
+// colour range of the current 3x3 neighbourhood and blends the current frame
+// in. The result is next frame's history, and the upscale pass reads it in
+// place of drawImage.
+//
+// Switching modes waits for the device and re-registers the draw targets at
+// the new sample count. Velocity is a render-graph transient; the two history
+// images persist across frames, so they live outside the graph and exist only
+// while TAA is active. GPU-driven culling builds its Hi-Z pyramid from the
+// multisampled depth resolve, so TAA mode turns it off.
+enum class AntiAliasing : uint8_t { Msaa = 0, Taa = 1 };
+
+constexpr uint32_t TAA_JITTER_PHASES = 8;
+constexpr VkFormat TAA_VELOCITY_FORMAT = VK_FORMAT_R16G16_SFLOAT;
+
+struct TaaPushConstants {
+    glm::vec2 srcSize;        // drawExtent, pixels
+    glm::vec2 historySize;    // full history image, pixels
+    uint32_t  colorIndex;     // drawImage
+    uint32_t  velocityIndex;
+    uint32_t  historyIndex;   // previous frame's history
+    float     feedback;       // weight of the history, 0..1
+    uint32_t  historyValid;   // 0 = nothing to reproject yet
+};
+
+// Last observed cost of a mode, for the debug UI comparison
+struct AntiAliasingStats {
+    bool         sampled = false;
+    VkDeviceSize transientBytes = 0;   // render-graph memory
+    VkDeviceSize historyBytes = 0;
+    float        gpuMs = 0.0f;         // whole frame, smoothed
+    float        renderScale = 1.0f;   // DRS scale it was measured at
+};
+
+struct TaaState {
+    AntiAliasing mode = AntiAliasing::Msaa;
+    AntiAliasing requested = AntiAliasing::Msaa;   // applied at the next frame start
+
+    float feedback = 0.9f;
+    float jitterScale = 1.0f;          // 0 freezes the jitter
+    VkSampleCountFlagBits msaaSamples = VK_SAMPLE_COUNT_8_BIT;   // restored when leaving TAA
+
+    VkPipelineLayout resolveLayout = VK_NULL_HANDLE;
+    VkPipeline       resolvePipeline = VK_NULL_HANDLE;
+
+    // ── Targets
+    AllocatedImage velocity{};         // RG16F, render-graph transient
+    AllocatedImage history[2]{};       // RGBA16F, persistent while active
+    uint32_t       velocityBindlessIndex = 10;
+    uint32_t       historyBindlessIndex[2] = { 8, 9 };
+    uint32_t       current = 0;        // history written this frame
+    bool           historyValid = false;
+    VkExtent2D     historyExtent{};    // drawExtent the history was written at
+    VkDeviceSize   historyBytes = 0;
+
+    glm::mat4 prevViewProj{ 1.0f };    // unjittered, last frame's
+    uint32_t  frameIndex = 0;
+
+    AntiAliasingStats stats[2];        // indexed by AntiAliasing
+};
+
+// Resolve pipeline — after init_dynamic_resolution (shares upscale.vert)
+void init_taa(Engine* e);
+
+// Call after dynamic_resolution_begin_frame, before update_uniform_buffers:
+// applies a pending mode switch, picks this frame's jitter and records the
+// active mode's cost
+void taa_begin_frame(Engine* e);
+
+// Colour + depth formats and sample count of the scene pass in the active mode
+RecordTarget scene_record_target(const Engine* e);
+
+// Writes the drawExtent sub-rect of history[current] from drawImage, velocity
+// and history[current ^ 1]. history[current] is COLOR_ATTACHMENT_OPTIMAL, the
+// inputs SHADER_READ_ONLY_OPTIMAL.
+void draw_taa_resolve(Engine* e, VkCommandBuffer cmd);
@@ -0,0 +1,147 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "cpu_profiler.h"
+
+struct Engine;
+
+// ─── Frame telemetry ──────────────────────────────────────────────────────────
+// Per-frame timings as named series: the frame interval, CPU phases of the
+// frame and GPU passes. Each series keeps the last TELEMETRY_WINDOW samples in
+// a fixed ring, plus two histograms. The window histogram follows the ring:
+// a sample is counted in on push and out on eviction. The lifetime histogram
+// only counts in. Both give percentiles without sorting and without
+// allocating.
+//
+// Histograms are log-linear (HDR style). Values are whole microseconds, exact
+// below 64 µs, and from there TELEMETRY_SUB_BUCKETS buckets per power of two:
+// about 3% precision up to ~33 s. Percentiles, min and max are reported to
+// that precision. Averages and the samples themselves are exact.
+//
+// A frame is a hitch when its interval exceeds both hitchFactor times the
+// window median and hitchMinMs. Hitches are counted, flagged in the window
+// and logged (rate-limited).
+//
+// CPU phases and GPU passes add to a pending value, so a phase that runs twice
+// counts twice. telemetry_begin_frame commits what the previous frame
+// accumulated. GPU passes therefore land FRAME_OVERLAP frames late, as they
+// leave the GPU profiler.
+//
+// Readers take `const TelemetrySeries*` and read the ring and stats in place.
+// Series live until the engine is cleaned up and their addresses never change.
+// Everything runs on the main thread.
+constexpr uint32_t TELEMETRY_WINDOW = 512;           // samples per series
+constexpr uint32_t TELEMETRY_MAX_SERIES = 64;
+constexpr uint32_t TELEMETRY_LIFETIME_REFRESH = 16; // pushes between lifetime stat refreshes
+constexpr uint32_t TELEMETRY_SUB_BITS = 5;
+constexpr uint32_t TELEMETRY_SUB_BUCKETS = 1u << TELEMETRY_SUB_BITS;
+constexpr uint32_t TELEMETRY_MAX_MSB = 24;           // values clamp below 2^25 µs
+constexpr uint32_t TELEMETRY_BUCKETS = (TELEMETRY_MAX_MSB - TELEMETRY_SUB_BITS + 2) * TELEMETRY_SUB_BUCKETS;
+
+using TelemetryClock = std::chrono::steady_clock;
+
+enum class TelemetryKind : uint8_t { Frame, Cpu, Gpu };
+
+struct TelemetryHistogram {
+    uint32_t counts[TELEMETRY_BUCKETS] = {};
+    uint64_t total = 0;
+
+    void add(float ms);
+    void remove(float ms);
+    void clear();
+};
+
+struct TelemetryStats {
+    uint64_t count = 0;
+    float    avg = 0.0f;
+    float    min = 0.0f, max = 0.0f;
+    float    p50 = 0.0f, p95 = 0.0f, p99 = 0.0f;
+};
+
+struct TelemetrySeries {
+    std::string   name;
+    TelemetryKind kind = TelemetryKind::Cpu;
+
+    // Ring of the last samples (ms). Oldest at `offset()` — ImGui::PlotLines
+    // takes the array, count and offset as they are
+    float    samples[TELEMETRY_WINDOW] = {};
+    uint32_t next = 0;                              // next write
+    uint32_t count = 0;
+    float    last = 0.0f;
+
+    TelemetryHistogram window, lifetime;
+    double             windowSum = 0.0, lifetimeSum = 0.0;
+    TelemetryStats     windowStats;                 // refreshed on every push
+    TelemetryStats     lifetimeStats;               // every TELEMETRY_LIFETIME_REFRESH pushes
+
+    float pending = 0.0f;                           // this frame's total so far
+    bool  hasPending = false;
+
+    uint32_t offset() const { return count < TELEMETRY_WINDOW ? 0 : next; }
+};
+
+struct TelemetryState {
+    bool enabled = true;
+
+    std::vector<std::unique_ptr<TelemetrySeries>> series;   // creation order
+    TelemetrySeries*                              frame = nullptr;   // the frame interval
+
+    // Hitches, on the frame series
+    float    hitchFactor = 2.0f;
+    float    hitchMinMs = 8.0f;
+    uint32_t hitchMinSamples = 30;       // window median must settle first
+    uint64_t hitches = 0;                // since the last reset
+    uint32_t hitchesInWindow = 0;
+    uint64_t lastHitchFrame = 0;
+    float    lastHitchMs = 0.0f;
+    uint8_t  hitchFlags[TELEMETRY_WINDOW] = {};   // parallel to frame->samples
+
+    uint64_t                   frames = 0;
+    bool                       started = false;
+    TelemetryClock::time_point frameStart;
+};
+
+// Frame boundary: commits the previous frame's phases and passes, and times
+// the interval since the last call
+void telemetry_begin_frame(Engine* e);
+
+// Adds to this frame's value of a series, creating it on first use
+void telemetry_cpu(Engine* e, const char* name, float ms);
+void telemetry_gpu(Engine* e, const char* name, float ms);
+
+// Empties every series and the hitch count; the series themselves stay
+void telemetry_reset(Engine* e);
+
+const TelemetrySeries* telemetry_find(const Engine* e, TelemetryKind kind, std::string_view name);
+
+// One line per series, window and lifetime, through the log
+void telemetry_log_summary(const Engine* e);
+
+// Times the rest of the block into a CPU series
+struct TelemetryCpuScope {
+    Engine*                    e;
+    const char*                name;
+    TelemetryClock::time_point start;
+
+    TelemetryCpuScope(Engine* engine, const char* n) : e(engine), name(n), start(TelemetryClock::now()) {}
+    ~TelemetryCpuScope()
+    {
+        telemetry_cpu(e, name, std::chrono::duration<float, std::milli>(TelemetryClock::now() - start).count());
+    }
+
+    TelemetryCpuScope(const TelemetryCpuScope&) = delete;
+    TelemetryCpuScope& operator=(const TelemetryCpuScope&) = delete;
+};
+
+// A CPU zone (traces) that also feeds the telemetry series of the same name
+#define TELEMETRY_JOIN2(a, b) a##b
+#define TELEMETRY_JOIN(a, b) TELEMETRY_JOIN2(a, b)
+#define CPU_PHASE(e, name) \
+    CPU_ZONE(name);        \
+    TelemetryCpuScope TELEMETRY_JOIN(telemetryPhase_, __LINE__)(e, name)
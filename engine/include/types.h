@@ -1,6 +1,7 @@
 ﻿#pragma once
 #define GLM_ENABLE_EXPERIMENTAL
 
+#include <cstddef>
 #include <cstdint>
 #include <vulkan/vulkan_core.h>
 #include <GLFW/glfw3.h>
@@ -30,13 +31,7 @@
 #include "graphics_pipeline.h"
 #include <array>
 #include <stb_image.h>
-
-#ifdef NDEBUG
-#define LOG(...)     
-#else
-#define LOG(...) std::cout << __VA_ARGS__ << "\n"
-#endif
-#define LOG_ERROR(...) std::cerr << "ERROR: " << __VA_ARGS__ << "\n"
+#include "log.h"
 
 struct AllocatedBuffer {
     VkBuffer          buffer = VK_NULL_HANDLE;
@@ -63,8 +58,9 @@ struct Vertex {
 // ============================================================
 // MeshPushConstants
 // Matches fragment shader scalar push_constant block exactly.
-// Total: 140 bytes — within Vulkan's 128-byte minimum guarantee? NO.
-// sunColor ends at offset 136 + 4 = 140. Check your device's maxPushConstantsSize.
+// Total: 168 bytes — over Vulkan's 128-byte minimum guarantee, so check the
+// device's maxPushConstantsSize. The vertex shaders reach instanceBuffer by
+// explicit offset; the static_asserts below keep them in step.
 // ============================================================
 struct MeshPushConstants {
     glm::mat4 modelMatrix;    // offset   0  (64 bytes)
@@ -79,19 +75,26 @@ struct MeshPushConstants {
     glm::vec4 colorFactor;    // offset  96  (16 bytes)
     glm::vec3 sunDirection;   // offset 112  (12 bytes)
     glm::vec3 sunColor;       // offset 124  (12 bytes)
-    float     sunIntensity; 
+    float     sunIntensity;   // offset 136
     
     uint32_t  shadowMapIndex;    // offset 140 — bindless slot of the shadow map
     float     shadowBias;        // offset 144 — per-material bias tweak
-    uint32_t iblIrradianceIndex;
-    uint32_t iblPrefilterIndex;
-    uint32_t iblBrdfLutIndex;
-};                            // = 140 bytes
+    uint32_t iblIrradianceIndex; // offset 148
+    uint32_t iblPrefilterIndex;  // offset 152
+    uint32_t iblBrdfLutIndex;    // offset 156
+    VkDeviceAddress instanceBuffer;  // offset 160 — batched model matrices, 0 = use modelMatrix
+};                            // = 168 bytes
+
+// colored_triangle_mesh.vert, depth_prepass.vert and depth_masked.vert declare
+// `layout(offset = 160) InstanceBuffer instances`
+static_assert(offsetof(MeshPushConstants, instanceBuffer) == 160, "update the vertex shaders' instance buffer offset");
+static_assert(sizeof(MeshPushConstants) == 168, "MeshPushConstants layout changed");
 
 
 struct ShadowPushConstants {
     glm::mat4 lightViewProj;  // offset  0 (64 bytes)
     glm::mat4 modelMatrix;    // offset 64 (64 bytes)
+    VkDeviceAddress instanceBuffer;  // offset 128 — batched model matrices, 0 = use modelMatrix
 };
 
 struct SkyPushConstants {
@@ -121,8 +124,26 @@ struct CameraData {
     glm::mat4 projection;     // 64 bytes
     glm::mat4 viewProjection; // 64 bytes
     glm::vec4 worldPosition;
-    glm::mat4 lightViewProj;    // 16 bytes (w unused)
-};                            // = 208 bytes
+    glm::mat4 lightViewProj;    // frustum around every cascade
+
+    // Cascaded shadow map — see shadow_cascades.h
+    glm::mat4 cascadeViewProj[4];  // one per layer of the shadow map
+    glm::vec4 cascadeSplits;       // view-space far edge of each cascade
+    glm::vec4 cascadeTexel;        // world units per shadow texel, per cascade
+    glm::vec4 cascadeParams;       // x = active cascades, y = blend fraction
+
+    // TAA velocity — both without the projection jitter
+    glm::mat4 unjitteredViewProj;
+    glm::mat4 prevViewProj;        // last frame's unjitteredViewProj
+
+    // Clustered lighting — see clustered_lighting.h
+    glm::vec4       clusterSlicing;    // x = log scale, y = log bias, z = heatmap overlay, w = heatmap max
+    glm::uvec4      clusterGrid;       // x, y, z, max lights per cluster
+    glm::vec4       clusterScreen;     // xy = clusters per pixel, z = local lights on
+    VkDeviceAddress clusterLights;
+    VkDeviceAddress clusterCounts;
+    VkDeviceAddress clusterIndices;
+};                            // = 776 bytes
 
 // ============================================================
 // GPUMaterial
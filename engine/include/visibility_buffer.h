@@ -0,0 +1,188 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include <vulkan/vulkan_core.h>
+#include "types.h"
+
+struct Engine;
+
+// ─── Visibility buffer ────────────────────────────────────────────────────────
+// Alternative to the forward geometry pass, switchable at runtime.
+//
+//   1. visibility — opaque and alpha-masked surfaces are rasterised by a
+//      minimal pipeline (vertex pulling through BDA, no attributes, no
+//      shading) into a single-sampled R32_UINT target plus depth. Each pixel
+//      stores (item << triangleBits) | gl_PrimitiveID, or VIS_INVALID_ID.
+//   2. binning — a compute pass classifies every 8x8 tile by the material of
+//      its pixels (render queue material ids), counts tiles per material,
+//      scans the counts and scatters the tile indices into one list sorted
+//      by material, with tiles of more than one material last.
+//   3. shade — the sky is drawn where depth was left at the clear value, then
+//      one instanced quad per listed tile runs the PBR shader. Each pixel
+//      re-fetches its triangle through the item's vertex/index addresses and
+//      rebuilds barycentrics and their screen derivatives analytically, so
+//      textures are sampled with explicit gradients and every pixel is
+//      shaded exactly once. Neighbouring instances share a material, which
+//      keeps texture indices (nearly) uniform within a wave.
+//
+// Blended surfaces have no place in a visibility buffer; here they are
+// alpha-tested at shade_pbr's cutoff like masked ones. The targets are
+// single-sampled, so under MSAA mode this path has no anti-aliasing — TAA
+// works as usual (the shade pass writes velocity).
+enum class RenderPath : uint8_t { Forward = 0, VisibilityBuffer = 1 };
+
+constexpr VkFormat VIS_ID_FORMAT = VK_FORMAT_R32_UINT;
+constexpr uint32_t VIS_INVALID_ID = 0xFFFFFFFFu;
+constexpr uint32_t VIS_TILE_SIZE = 8;
+
+// Mirrors VisItem in shaders/vis_item.glsl (scalar layout). One per surface,
+// in CullScene flat order.
+struct VisItem {
+    glm::mat4       modelMatrix;
+    VkDeviceAddress vertices;
+    VkDeviceAddress indices;
+    uint32_t        firstIndex;
+    uint32_t        indexCount;
+    uint32_t        material;          // RenderQueueState::surfaceMaterial
+    uint32_t        albedoIndex;
+    uint32_t        normalIndex;
+    uint32_t        metalRoughIndex;
+    uint32_t        aoIndex;
+    uint32_t        emissiveIndex;
+    float           metallicFactor;
+    float           roughnessFactor;
+    float           normalStrength;
+    uint32_t        pad = 0;
+    glm::vec4       colorFactor;
+};
+static_assert(sizeof(VisItem) == 144, "VisItem must match vis_item.glsl");
+
+// vis_id.vert / vis_id.frag / vis_id_masked.frag
+struct VisIdPushConstants {
+    VkDeviceAddress items;
+    uint32_t        triangleBits;
+};
+
+// vis_bin.comp — phase 0 classify, 1 scan, 2 scatter
+struct VisBinPushConstants {
+    VkDeviceAddress items;
+    VkDeviceAddress tileKeys;
+    VkDeviceAddress tileOffsets;
+    VkDeviceAddress tileList;
+    VkDeviceAddress binCounts;
+    VkDeviceAddress binStarts;
+    VkDeviceAddress drawArgs;
+    glm::uvec2      tiles;             // tile grid over drawExtent
+    glm::uvec2      extent;            // drawExtent
+    uint32_t        idIndex;           // visibility target in allTextures
+    uint32_t        triangleBits;
+    uint32_t        materialCount;     // bin materialCount holds mixed tiles
+    uint32_t        phase;
+};
+
+// vis_shade.vert / vis_shade.frag
+struct VisShadePushConstants {
+    VkDeviceAddress items;
+    VkDeviceAddress tileList;
+    glm::vec2       viewSize;          // drawExtent, pixels
+    uint32_t        tilesX;
+    uint32_t        idIndex;
+    uint32_t        triangleBits;
+    glm::vec3       sunDirection;
+    glm::vec3       sunColor;
+    float           sunIntensity;
+    uint32_t        shadowMapIndex;
+    float           shadowBias;
+    uint32_t        iblIrradianceIndex;
+    uint32_t        iblPrefilterIndex;
+    uint32_t        iblBrdfLutIndex;
+};
+
+// Per-asset ranges of this frame's indirect commands: opaque, then masked
+struct VisAssetDraws {
+    uint32_t opaqueFirst = 0, opaqueCount = 0;
+    uint32_t maskedFirst = 0, maskedCount = 0;
+};
+
+// Last observed cost of a path, for the debug UI comparison
+struct RenderPathStats {
+    bool     sampled = false;
+    float    gpuMs = 0.0f;             // whole frame, smoothed
+    float    renderScale = 1.0f;       // DRS scale it was measured at
+    uint32_t drawCalls = 0;
+    uint32_t triangles = 0;
+};
+
+struct VisibilityBufferState {
+    RenderPath path = RenderPath::Forward;
+    RenderPath requested = RenderPath::Forward;   // applied at the next frame start
+
+    // ── Pipelines
+    VkPipelineLayout idLayout = VK_NULL_HANDLE;
+    VkPipeline       idPipeline = VK_NULL_HANDLE;
+    VkPipeline       idMaskedPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout binLayout = VK_NULL_HANDLE;
+    VkPipeline       binPipeline = VK_NULL_HANDLE;
+    VkPipelineLayout shadeLayout = VK_NULL_HANDLE;
+    VkPipeline       shadePipeline = VK_NULL_HANDLE;
+    VkPipeline       shadePipelineTaa = VK_NULL_HANDLE;   // + velocity
+
+    // ── Targets (render-graph transients, registered while the path is active)
+    AllocatedImage ids{};
+    AllocatedImage depth{};
+    uint32_t       idBindlessIndex = 11;
+
+    // ── Scene
+    bool                         itemsBuilt = false;
+    uint64_t                     builtSceneVersion = 0;   // DrawCacheState::sceneVersion
+    uint32_t                     itemCount = 0;
+    uint32_t                     materialCount = 0;
+    uint32_t                     triangleBits = 0;
+    std::vector<uint8_t>         itemMasked;              // flat surface → alpha-tested
+    AllocatedBuffer              itemBuffer{};
+    std::vector<AllocatedBuffer> commandBuffers;          // per frame in flight, mapped
+    std::vector<VisAssetDraws>   assetDraws;
+
+    // ── Binning scratch, sized for the full draw image
+    uint32_t        tileCapacity = 0;
+    uint32_t        binCapacity = 0;
+    AllocatedBuffer tileKeys{};
+    AllocatedBuffer tileOffsets{};
+    AllocatedBuffer tileList{};
+    AllocatedBuffer binCounts{};
+    AllocatedBuffer binStarts{};
+    AllocatedBuffer drawArgs{};                           // VkDrawIndirectCommand
+
+    // ── Tile counts per frame in flight
+    std::vector<uint8_t>         frameRecorded;
+    std::vector<AllocatedBuffer> statsBuffers;            // {tiles, mixed tiles}, mapped
+
+    // ── Stats shown in the debug UI (one frame-in-flight behind)
+    uint32_t tiles = 0;
+    uint32_t mixedTiles = 0;
+    RenderPathStats stats[2];          // indexed by RenderPath
+};
+
+// Pipelines and readback — after init_taa and init_skybox_pipelines
+void init_visibility_buffer(Engine* e);
+
+// Call after taa_begin_frame: applies a pending path switch, reads back the
+// slot's tile counts, (re)builds items and scratch, records the active path's cost
+void visibility_buffer_begin_frame(Engine* e);
+
+// Culls items against this frame's camera view and writes the indirect
+// commands — after run_frustum_culling and build_render_queues
+void visibility_buffer_prepare(Engine* e);
+
+// Clears and fills ids + depth over drawExtent
+void draw_visibility_ids(Engine* e, VkCommandBuffer cmd);
+
+// Tile classification, scan and scatter. Synchronises its own buffers and
+// leaves the tile list and draw arguments ready for the shade pass.
+void draw_visibility_binning(Engine* e, VkCommandBuffer cmd);
+
+// Sky, then the binned material quads, into drawImage (+ velocity under TAA);
+// depth is attached read-only
+void draw_visibility_shade(Engine* e, VkCommandBuffer cmd);
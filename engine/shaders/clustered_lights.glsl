@@ -0,0 +1,40 @@
+// Clustered light data — mirrors GpuLight in clustered_lighting.h (scalar
+// layout, 64 bytes) and the grid buffers the cull pass fills.
+// Requires GL_EXT_buffer_reference and GL_EXT_scalar_block_layout.
+
+const uint LIGHT_POINT = 0u;
+const uint LIGHT_SPOT  = 1u;
+
+struct ClusterLight {
+    vec3  position;
+    float range;
+    vec3  color;
+    float intensity;
+    vec3  direction;
+    uint  type;
+    float spotCosInner;
+    float spotCosOuter;
+    vec2  pad;
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 4) readonly buffer ClusterLightBuffer {
+    ClusterLight lights[];
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 4) buffer ClusterUintBuffer {
+    uint data[];
+};
+
+// Smooth inverse-square falloff that reaches zero at the light's range
+float cluster_light_falloff(float dist2, float range) {
+    float r   = dist2 / (range * range);
+    float win = clamp(1.0 - r * r, 0.0, 1.0);
+    return win * win / max(dist2, 1e-4);
+}
+
+float cluster_spot_cone(ClusterLight light, vec3 toSurface) {
+    if (light.type != LIGHT_SPOT)
+        return 1.0;
+    float c = dot(toSurface, light.direction);
+    return smoothstep(light.spotCosOuter, light.spotCosInner, c);
+}
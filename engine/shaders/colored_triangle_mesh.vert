@@ -1,5 +1,10 @@
 ﻿#version 460
 #extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "instance_data.glsl"
 
 // ── INPUTS (all at top level!) ──
 layout(location = 0) in vec3 inPosition;
@@ -14,9 +19,12 @@ layout(location = 1) out vec2 outUV;
 layout(location = 2) out vec3 outNormal;
 layout(location = 3) out vec4 outColor;
 layout(location = 4) out vec4 outTangent;
+layout(location = 5) out vec4 outCurClip;    // TAA velocity, unjittered
+layout(location = 6) out vec4 outPrevClip;
 
 layout(scalar, push_constant) uniform constants {
     mat4 modelMatrix;
+    layout(offset = 160) InstanceBuffer instances;   // MeshPushConstants::instanceBuffer
 } pc;
 
 layout(set = 0, binding = 2) uniform CameraData {
@@ -25,19 +33,34 @@ layout(set = 0, binding = 2) uniform CameraData {
     mat4 viewProjection;
     vec4 worldPosition;
     mat4 lightViewProj;   // ← ADD THIS
+    mat4 cascadeViewProj[4];
+    vec4 cascadeSplits;
+    vec4 cascadeTexel;
+    vec4 cascadeParams;
+    mat4 unjitteredViewProj;
+    mat4 prevViewProj;
 } cam;
 
+// The depth pre-pass repeats this transform and the colour pass tests EQUAL
+// against it — keep depth_prepass.vert in step
+invariant gl_Position;
+
 void main() {
-    vec4 worldPos = pc.modelMatrix * vec4(inPosition, 1.0);
+    mat4 model    = instance_model(pc.instances, pc.modelMatrix);
+    vec4 worldPos = model * vec4(inPosition, 1.0);
     
     outWorldPos = worldPos.xyz;
     outUV       = inUV;
-    outNormal   = normalize(mat3(pc.modelMatrix) * inNormal);
+    outNormal   = normalize(mat3(model) * inNormal);
     outColor    = inColor;
 
     // Tangent → world space (handedness sign passed through)
-    vec3 worldTangent = normalize(mat3(pc.modelMatrix) * inTangent.xyz);
+    vec3 worldTangent = normalize(mat3(model) * inTangent.xyz);
     outTangent        = vec4(worldTangent, inTangent.w);
 
     gl_Position = cam.viewProjection * worldPos;
+
+    // Camera motion only — instances carry no previous transform
+    outCurClip  = cam.unjitteredViewProj * worldPos;
+    outPrevClip = cam.prevViewProj * worldPos;
 }
\ No newline at end of file
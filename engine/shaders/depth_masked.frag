@@ -0,0 +1,31 @@
+// depth_masked.frag — alpha test only, no colour output
+#version 460
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_EXT_scalar_block_layout  : require
+
+layout(location = 1) in vec2 inUV;
+
+layout(set = 0, binding = 0) uniform sampler2D allTextures[];
+
+// Leading part of MeshPushConstants — only what the alpha test needs
+layout(scalar, push_constant) uniform constants {
+    mat4  modelMatrix;
+    uint  albedoIdx;
+    uint  normalIdx;
+    uint  metalRoughIdx;
+    uint  aoIdx;
+    uint  emissiveIdx;
+    float metallicFactor;
+    float roughnessFactor;
+    float normalStrength;
+    vec4  colorFactor;
+} pc;
+
+void main() {
+    float alpha = pc.colorFactor.a;
+    if (pc.albedoIdx != 0u)
+        alpha *= texture(allTextures[nonuniformEXT(pc.albedoIdx)], inUV).a;
+
+    // Same cutoff as shade_pbr() — a mismatch leaves holes in the EQUAL pass
+    if (alpha < 0.1) discard;
+}
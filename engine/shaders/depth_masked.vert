@@ -0,0 +1,36 @@
+// depth_masked.vert — depth pre-pass for alpha-masked surfaces (position + uv)
+#version 460
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "instance_data.glsl"
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 1) out vec2 outUV;
+
+layout(scalar, push_constant) uniform constants {
+    mat4 modelMatrix;
+    layout(offset = 160) InstanceBuffer instances;   // MeshPushConstants::instanceBuffer
+} pc;
+
+layout(set = 0, binding = 2) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 worldPosition;
+    mat4 lightViewProj;
+} cam;
+
+// Must match colored_triangle_mesh.vert bit for bit — see depth_prepass.vert
+invariant gl_Position;
+
+void main() {
+    mat4 model    = instance_model(pc.instances, pc.modelMatrix);
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+    outUV = inUV;
+    gl_Position = cam.viewProjection * worldPos;
+}
@@ -0,0 +1,27 @@
+// GPU draw item — mirrors GPUDrawItem in gpu_culling.h (scalar layout, 176 bytes).
+// One per surface in object mode, one per 128-triangle cluster in cluster mode.
+// Requires GL_EXT_buffer_reference and GL_EXT_scalar_block_layout.
+
+struct DrawItem {
+    mat4  modelMatrix;
+    vec4  sphere;          // world-space centre xyz, radius w
+    vec4  aabbMin;         // world-space AABB, w unused
+    vec4  aabbMax;
+    uint  firstIndex;
+    uint  indexCount;
+    uint  assetIndex;
+    uint  commandBase;     // first command slot of this item's asset
+    uint  albedoIdx;
+    uint  normalIdx;
+    uint  metalRoughIdx;
+    uint  aoIdx;
+    uint  emissiveIdx;
+    float metallicFactor;
+    float roughnessFactor;
+    float normalStrength;
+    vec4  colorFactor;
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 16) readonly buffer DrawItemBuffer {
+    DrawItem items[];
+};
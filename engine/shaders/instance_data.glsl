@@ -0,0 +1,14 @@
+// Per-frame instance transforms written by the render queue batcher
+// (build_render_queues). A batched draw's firstInstance points at its first
+// matrix, so gl_InstanceIndex indexes the buffer directly.
+// Requires GL_EXT_buffer_reference, GL_EXT_buffer_reference_uvec2 and
+// GL_EXT_scalar_block_layout.
+
+layout(buffer_reference, scalar, buffer_reference_align = 16) readonly buffer InstanceBuffer {
+    mat4 models[];
+};
+
+// Batched draws push an instance buffer; unbatched ones push the matrix itself
+mat4 instance_model(InstanceBuffer instances, mat4 pushedModel) {
+    return uvec2(instances) != uvec2(0u) ? instances.models[gl_InstanceIndex] : pushedModel;
+}
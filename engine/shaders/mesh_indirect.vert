@@ -0,0 +1,50 @@
+#version 460
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "draw_item.glsl"
+
+// Vertex shader for GPU-culled indirect draws. The cull pass writes the draw
+// item index into firstInstance, so gl_InstanceIndex selects the item.
+
+layout(location = 0) in vec3 inPosition;
+layout(location = 1) in vec2 inUV;
+layout(location = 2) in vec3 inNormal;
+layout(location = 3) in vec4 inColor;
+layout(location = 4) in vec4 inTangent;
+
+layout(location = 0) out vec3 outWorldPos;
+layout(location = 1) out vec2 outUV;
+layout(location = 2) out vec3 outNormal;
+layout(location = 3) out vec4 outColor;
+layout(location = 4) out vec4 outTangent;
+layout(location = 5) flat out uint outItem;
+
+layout(scalar, push_constant) uniform constants {
+    DrawItemBuffer items;
+} pc;
+
+layout(set = 0, binding = 2) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 worldPosition;
+    mat4 lightViewProj;
+} cam;
+
+void main() {
+    mat4 model    = pc.items.items[gl_InstanceIndex].modelMatrix;
+    vec4 worldPos = model * vec4(inPosition, 1.0);
+
+    outWorldPos = worldPos.xyz;
+    outUV       = inUV;
+    outNormal   = normalize(mat3(model) * inNormal);
+    outColor    = inColor;
+
+    vec3 worldTangent = normalize(mat3(model) * inTangent.xyz);
+    outTangent        = vec4(worldTangent, inTangent.w);
+    outItem           = gl_InstanceIndex;
+
+    gl_Position = cam.viewProjection * worldPos;
+}
@@ -1,13 +1,20 @@
 // shadow.vert
 #version 460
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "instance_data.glsl"
 
 layout(location = 0) in vec3 inPosition;
 
 layout(push_constant) uniform ShadowPush {
     mat4 lightViewProj;  // offset  0
     mat4 modelMatrix;    // offset 64
+    InstanceBuffer instances;   // offset 128
 } pc;
 
 void main() {
-    gl_Position = pc.lightViewProj * pc.modelMatrix * vec4(inPosition, 1.0);
+    gl_Position = pc.lightViewProj * instance_model(pc.instances, pc.modelMatrix) * vec4(inPosition, 1.0);
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 #extension GL_EXT_scalar_block_layout : require
 
 layout(location = 0) out vec3 outDirection;
+layout(location = 1) out vec4 outCurClip;    // TAA velocity, unjittered
+layout(location = 2) out vec4 outPrevClip;
 
 layout(set = 0, binding = 2) uniform CameraData {
     mat4 view;
@@ -10,6 +12,12 @@ layout(set = 0, binding = 2) uniform CameraData {
     mat4 viewProjection;
     vec4 worldPosition;
     mat4 lightViewProj;
+    mat4 cascadeViewProj[4];
+    vec4 cascadeSplits;
+    vec4 cascadeTexel;
+    vec4 cascadeParams;
+    mat4 unjitteredViewProj;
+    mat4 prevViewProj;
 } cam;
 
 void main()
@@ -26,4 +34,9 @@ void main()
     vec4 viewRay = invProj * vec4(pos, 1.0, 1.0);
     viewRay.w = 0.0;
     outDirection = (invView * viewRay).xyz;
+
+    // The sky is at infinity: w = 0 drops the camera translation, so only
+    // rotation moves it. Clip space is linear across the triangle.
+    outCurClip  = cam.unjitteredViewProj * vec4(outDirection, 0.0);
+    outPrevClip = cam.prevViewProj * vec4(outDirection, 0.0);
 }
\ No newline at end of file
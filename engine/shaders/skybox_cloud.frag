@@ -3,7 +3,10 @@
 #extension GL_EXT_scalar_block_layout : require
 
 layout(location = 0) in  vec3 inDirection;
+layout(location = 1) in  vec4 inCurClip;
+layout(location = 2) in  vec4 inPrevClip;
 layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outVelocity;   // TAA mode only
 
 layout(scalar, push_constant) uniform SkyPC {
     vec3  sunDirection;
@@ -125,5 +128,5 @@ void main()
     result += sunColour;
 
     outColor = vec4(result, 1.0);
-    
+    outVelocity = (inCurClip.xy / inCurClip.w - inPrevClip.xy / inPrevClip.w) * 0.5;
 }
@@ -0,0 +1,144 @@
+#version 460
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Temporal resolve, drawn over the drawExtent sub-rect of this frame's history:
+//   1. reprojection: last frame's history is sampled where the velocity buffer
+//      says this pixel was, with a 5-tap Catmull-Rom filter so the history
+//      doesn't soften a little more every frame
+//   2. neighbourhood clamp: the history is clipped toward the colour box of
+//      the current 3x3 neighbourhood (YCoCg), which rejects disocclusions and
+//      the object motion the camera-only velocity doesn't capture
+//   3. blend: mostly history, with weights that damp bright HDR outliers
+// Velocity is taken from the 3x3 texel with the longest motion, so edges
+// reproject with the foreground that moved over them.
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D allTextures[];
+
+layout(push_constant) uniform TaaPC {
+    vec2  srcSize;
+    vec2  historySize;
+    uint  colorIndex;
+    uint  velocityIndex;
+    uint  historyIndex;
+    float feedback;
+    uint  historyValid;
+} pc;
+
+vec3 fetch_color(ivec2 p)
+{
+    p = clamp(p, ivec2(0), ivec2(pc.srcSize) - 1);
+    return max(texelFetch(allTextures[pc.colorIndex], p, 0).rgb, vec3(0.0));
+}
+
+vec2 fetch_velocity(ivec2 p)
+{
+    p = clamp(p, ivec2(0), ivec2(pc.srcSize) - 1);
+    return texelFetch(allTextures[pc.velocityIndex], p, 0).xy;
+}
+
+vec3 rgb_to_ycocg(vec3 c)
+{
+    return vec3( 0.25 * c.r + 0.5 * c.g + 0.25 * c.b,
+                 0.5  * c.r              - 0.5  * c.b,
+                -0.25 * c.r + 0.5 * c.g - 0.25 * c.b);
+}
+
+vec3 ycocg_to_rgb(vec3 c)
+{
+    return vec3(c.x + c.y - c.z, c.x + c.z, c.x - c.y - c.z);
+}
+
+// Bilinear history read, kept one half-texel inside the valid sub-rect —
+// history texels outside it are stale
+vec3 sample_history(vec2 pixel)
+{
+    pixel = clamp(pixel, vec2(0.5), pc.srcSize - 0.5);
+    return texture(allTextures[pc.historyIndex], pixel / pc.historySize).rgb;
+}
+
+// Catmull-Rom as 5 bilinear taps (the four corner taps carry little weight)
+vec3 sample_history_catmull_rom(vec2 pixel)
+{
+    vec2 centre = floor(pixel - 0.5) + 0.5;
+    vec2 f  = pixel - centre;
+    vec2 w0 = f * (-0.5 + f * (1.0 - 0.5 * f));
+    vec2 w1 = 1.0 + f * f * (-2.5 + 1.5 * f);
+    vec2 w2 = f * (0.5 + f * (2.0 - 1.5 * f));
+    vec2 w3 = f * f * (-0.5 + 0.5 * f);
+
+    vec2 w12 = w1 + w2;
+    vec2 p0  = centre - 1.0;
+    vec2 p3  = centre + 2.0;
+    vec2 p12 = centre + w2 / w12;
+
+    vec3 sum = sample_history(vec2(p12.x, p0.y))  * (w12.x * w0.y)
+             + sample_history(vec2(p0.x,  p12.y)) * (w0.x  * w12.y)
+             + sample_history(p12)                * (w12.x * w12.y)
+             + sample_history(vec2(p3.x,  p12.y)) * (w3.x  * w12.y)
+             + sample_history(vec2(p12.x, p3.y))  * (w12.x * w3.y);
+    float wsum = w12.x * w0.y + w0.x * w12.y + w12.x * w12.y + w3.x * w12.y + w12.x * w3.y;
+    return max(sum / wsum, vec3(0.0));
+}
+
+// Clip toward the box centre rather than clamping per channel, which keeps
+// the history's hue when it falls outside
+vec3 clip_to_box(vec3 history, vec3 lo, vec3 hi)
+{
+    vec3 centre = 0.5 * (hi + lo);
+    vec3 extent = 0.5 * (hi - lo) + 1e-4;
+    vec3 d      = history - centre;
+    vec3 t      = abs(d / extent);
+    float m     = max(t.x, max(t.y, t.z));
+    return m > 1.0 ? centre + d / m : history;
+}
+
+float luma(vec3 c)
+{
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+void main()
+{
+    ivec2 p = ivec2(gl_FragCoord.xy);
+    vec3  current = fetch_color(p);
+
+    if (pc.historyValid == 0u) {
+        outColor = vec4(current, 1.0);
+        return;
+    }
+
+    // ── Neighbourhood: colour box in YCoCg, longest velocity
+    vec3  lo = vec3( 1e9);
+    vec3  hi = vec3(-1e9);
+    vec2  velocity = vec2(0.0);
+    float longest  = -1.0;
+    for (int y = -1; y <= 1; ++y)
+        for (int x = -1; x <= 1; ++x) {
+            vec3 c = rgb_to_ycocg(fetch_color(p + ivec2(x, y)));
+            lo = min(lo, c);
+            hi = max(hi, c);
+
+            vec2  v = fetch_velocity(p + ivec2(x, y));
+            float l = dot(v, v);
+            if (l > longest) { longest = l; velocity = v; }
+        }
+
+    // ── Reproject; off-screen last frame means no history
+    vec2 prevUV = inUV - velocity;
+    if (any(lessThan(prevUV, vec2(0.0))) || any(greaterThan(prevUV, vec2(1.0)))) {
+        outColor = vec4(current, 1.0);
+        return;
+    }
+    vec3 history = sample_history_catmull_rom(prevUV * pc.srcSize);
+    history = ycocg_to_rgb(clip_to_box(rgb_to_ycocg(history), lo, hi));
+
+    // ── Blend, weighting each side by 1 / (1 + luma) so a single very bright
+    // sample can't dominate — the usual source of TAA flicker on HDR input
+    float wc = (1.0 - pc.feedback) / (1.0 + luma(current));
+    float wh = pc.feedback / (1.0 + luma(history));
+    outColor = vec4((current * wc + history * wh) / (wc + wh), 1.0);
+}
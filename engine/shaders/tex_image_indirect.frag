@@ -0,0 +1,52 @@
+#version 460
+
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_EXT_scalar_block_layout  : require
+#extension GL_EXT_buffer_reference     : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "pbr_shading.glsl"
+#include "draw_item.glsl"
+
+// tex_image.frag for indirect draws — material comes from the draw item,
+// lighting from push constants. Layout mirrors GpuDrawPush.
+
+layout(location = 5) flat in uint inItem;
+
+layout(location = 0) out vec4 outColor;
+
+layout(scalar, push_constant) uniform constants {
+    DrawItemBuffer items;
+    vec3  sunDirection;
+    vec3  sunColor;
+    float sunIntensity;
+    uint  shadowMapIndex;
+    float shadowBias;
+    uint  iblIrradianceIndex;
+    uint  iblPrefilterIndex;
+    uint  iblBrdfLutIndex;
+} pc;
+
+void main() {
+    DrawItem item = pc.items.items[inItem];
+
+    pbr.albedoIdx          = item.albedoIdx;
+    pbr.normalIdx          = item.normalIdx;
+    pbr.metalRoughIdx      = item.metalRoughIdx;
+    pbr.aoIdx              = item.aoIdx;
+    pbr.emissiveIdx        = item.emissiveIdx;
+    pbr.metallicFactor     = item.metallicFactor;
+    pbr.roughnessFactor    = item.roughnessFactor;
+    pbr.normalStrength     = item.normalStrength;
+    pbr.colorFactor        = item.colorFactor;
+    pbr.sunDirection       = pc.sunDirection;
+    pbr.sunColor           = pc.sunColor;
+    pbr.sunIntensity       = pc.sunIntensity;
+    pbr.shadowMapIndex     = pc.shadowMapIndex;
+    pbr.shadowBias         = pc.shadowBias;
+    pbr.iblIrradianceIndex = pc.iblIrradianceIndex;
+    pbr.iblPrefilterIndex  = pc.iblPrefilterIndex;
+    pbr.iblBrdfLutIndex    = pc.iblBrdfLutIndex;
+
+    outColor = shade_pbr();
+}
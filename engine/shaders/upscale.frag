@@ -0,0 +1,110 @@
+#version 460
+
+#extension GL_EXT_nonuniform_qualifier : require
+
+// Spatial upscale from the dynamic-resolution sub-rect of drawImage to the
+// swapchain, in one pass:
+//   1. edge-adaptive reconstruction: a 4x4 Lanczos-2 kernel whose footprint is
+//      stretched along the local edge and narrowed across it
+//   2. deringing: the result is clamped to the 2x2 texels around it
+//   3. contrast-adaptive sharpening: a cross-shaped unsharp mask that backs
+//      off where local contrast is already high
+// Texels are fetched, not filtered, and clamped to the sub-rect; drawImage
+// outside it holds stale pixels from larger frames.
+
+layout(location = 0) in vec2 inUV;
+layout(location = 0) out vec4 outColor;
+
+layout(set = 0, binding = 0) uniform sampler2D allTextures[];
+
+layout(push_constant) uniform UpscalePC {
+    vec2  srcSize;
+    uint  sourceIndex;
+    float sharpness;
+} pc;
+
+vec3 fetch(ivec2 p)
+{
+    p = clamp(p, ivec2(0), ivec2(pc.srcSize) - 1);
+    return max(texelFetch(allTextures[pc.sourceIndex], p, 0).rgb, vec3(0.0));
+}
+
+// Luma after a Reinhard curve, so a few very bright HDR texels can't decide
+// the edge direction or the sharpening limit on their own
+float luma(vec3 c)
+{
+    c = c / (1.0 + c);
+    return dot(c, vec3(0.2126, 0.7152, 0.0722));
+}
+
+float lanczos2(float x)
+{
+    if (x >= 2.0) return 0.0;
+    if (x < 1e-4) return 1.0;
+    float px = 3.14159265 * x;
+    return 2.0 * sin(px) * sin(px * 0.5) / (px * px);
+}
+
+void main()
+{
+    // Position in source texels; texel centres sit at integer + 0.5
+    vec2  src  = inUV * pc.srcSize - 0.5;
+    ivec2 base = ivec2(floor(src));
+    vec2  f    = src - vec2(base);
+
+    // 4x4 neighbourhood, base - 1 .. base + 2; index 5, 6, 9, 10 is the centre 2x2
+    vec3  c[16];
+    float l[16];
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x) {
+            c[y * 4 + x] = fetch(base + ivec2(x - 1, y - 1));
+            l[y * 4 + x] = luma(c[y * 4 + x]);
+        }
+
+    // ── Local edge: luma gradient of the centre 2x2, bilinearly blended
+    vec2 g = vec2(0.0);
+    for (int y = 1; y <= 2; ++y)
+        for (int x = 1; x <= 2; ++x) {
+            int   i = y * 4 + x;
+            float w = (x == 1 ? 1.0 - f.x : f.x) * (y == 1 ? 1.0 - f.y : f.y);
+            g += w * vec2(l[i + 1] - l[i - 1], l[i + 4] - l[i - 4]);
+        }
+    float strength = length(g);
+    vec2  across   = strength > 1e-5 ? g / strength : vec2(1.0, 0.0);
+    vec2  along    = vec2(-across.y, across.x);
+    float edge     = clamp(strength * 4.0, 0.0, 1.0);
+
+    // ── Reconstruction: along the edge taps count as nearer, across it farther
+    vec3  sum  = vec3(0.0);
+    float wsum = 0.0;
+    for (int y = 0; y < 4; ++y)
+        for (int x = 0; x < 4; ++x) {
+            vec2  d = vec2(x - 1, y - 1) - f;
+            vec2  k = vec2(dot(d, across) * (1.0 + 0.5 * edge), dot(d, along) / (1.0 + edge));
+            float w = lanczos2(length(k));
+            sum  += w * c[y * 4 + x];
+            wsum += w;
+        }
+    vec3 color = sum / max(wsum, 1e-4);
+
+    vec3 lo = min(min(c[5], c[6]), min(c[9], c[10]));
+    vec3 hi = max(max(c[5], c[6]), max(c[9], c[10]));
+    color = clamp(color, lo, hi);
+
+    // ── Sharpening around the nearest source texel
+    if (pc.sharpness > 0.0) {
+        ivec2 n  = ivec2(1) + ivec2(f + 0.5);       // 1..2 in the 4x4 grid
+        int   ni = n.y * 4 + n.x;
+        float lc = l[ni];
+        float mn = min(lc, min(min(l[ni - 1], l[ni + 1]), min(l[ni - 4], l[ni + 4])));
+        float mx = max(lc, max(max(l[ni - 1], l[ni + 1]), max(l[ni - 4], l[ni + 4])));
+
+        // Headroom to black and white relative to the brightest neighbour
+        float amp = sqrt(clamp(min(mn, 1.0 - mx) / max(mx, 1e-4), 0.0, 1.0));
+        float w   = -amp * 0.2 * pc.sharpness;
+        vec3  crossSum = c[ni - 1] + c[ni + 1] + c[ni - 4] + c[ni + 4];
+        color = max((color + w * crossSum) / (1.0 + 4.0 * w), vec3(0.0));
+    }
+
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,22 @@
+#version 460
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "vis_item.glsl"
+
+// gl_PrimitiveID restarts at every indirect command, so it is the triangle
+// within the item
+
+layout(location = 0) flat in uint inItem;
+
+layout(location = 0) out uint outId;
+
+layout(scalar, push_constant) uniform constants {
+    VisItemBuffer items;
+    uint          triangleBits;
+} pc;
+
+void main() {
+    outId = (inItem << pc.triangleBits) | uint(gl_PrimitiveID);
+}
@@ -0,0 +1,35 @@
+#version 460
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "vis_item.glsl"
+
+// Visibility pass: positions are pulled through the item's vertex address
+// (the bound index buffer supplies gl_VertexIndex), the item index arrives in
+// firstInstance. Only the masked variant's fragment shader reads the uv.
+
+layout(location = 0) flat out uint outItem;
+layout(location = 1) out vec2 outUV;
+
+layout(scalar, push_constant) uniform constants {
+    VisItemBuffer items;
+    uint          triangleBits;
+} pc;
+
+layout(set = 0, binding = 2) uniform CameraData {
+    mat4 view;
+    mat4 projection;
+    mat4 viewProjection;
+    vec4 worldPosition;
+    mat4 lightViewProj;
+} cam;
+
+void main() {
+    VisItem   item = pc.items.items[gl_InstanceIndex];
+    VisVertex v    = item.vertices.vertices[gl_VertexIndex];
+
+    outItem = gl_InstanceIndex;
+    outUV   = v.uv;
+    gl_Position = cam.viewProjection * (item.modelMatrix * vec4(v.position, 1.0));
+}
@@ -0,0 +1,33 @@
+#version 460
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_EXT_buffer_reference     : require
+#extension GL_EXT_scalar_block_layout  : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "vis_item.glsl"
+
+// vis_id.frag with the alpha test of depth_masked.frag
+
+layout(location = 0) flat in uint inItem;
+layout(location = 1) in vec2 inUV;
+
+layout(location = 0) out uint outId;
+
+layout(set = 0, binding = 0) uniform sampler2D allTextures[];
+
+layout(scalar, push_constant) uniform constants {
+    VisItemBuffer items;
+    uint          triangleBits;
+} pc;
+
+void main() {
+    VisItem item  = pc.items.items[inItem];
+    float   alpha = item.colorFactor.a;
+    if (item.albedoIdx != 0u)
+        alpha *= texture(allTextures[nonuniformEXT(item.albedoIdx)], inUV).a;
+
+    // Same cutoff as shade_pbr() — the shade pass would discard the pixel
+    if (alpha < 0.1) discard;
+
+    outId = (inItem << pc.triangleBits) | uint(gl_PrimitiveID);
+}
@@ -0,0 +1,50 @@
+// Visibility-buffer item — mirrors VisItem in visibility_buffer.h (scalar
+// layout, 144 bytes). One per surface; vertices and indices are the owning
+// asset's buffers, reached through their device addresses.
+// Requires GL_EXT_buffer_reference and GL_EXT_scalar_block_layout.
+
+struct VisVertex {
+    vec3 position;
+    vec3 normal;
+    vec2 uv;
+    vec4 color;
+    vec4 tangent;
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 4) readonly buffer VisVertexBuffer {
+    VisVertex vertices[];
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 4) readonly buffer VisIndexBuffer {
+    uint indices[];
+};
+
+struct VisItem {
+    mat4            modelMatrix;
+    VisVertexBuffer vertices;
+    VisIndexBuffer  indices;
+    uint            firstIndex;
+    uint            indexCount;
+    uint            material;
+    uint            albedoIdx;
+    uint            normalIdx;
+    uint            metalRoughIdx;
+    uint            aoIdx;
+    uint            emissiveIdx;
+    float           metallicFactor;
+    float           roughnessFactor;
+    float           normalStrength;
+    uint            pad;
+    vec4            colorFactor;
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 16) readonly buffer VisItemBuffer {
+    VisItem items[];
+};
+
+layout(buffer_reference, scalar, buffer_reference_align = 4) buffer VisUintBuffer {
+    uint values[];
+};
+
+const uint VIS_INVALID_ID = 0xFFFFFFFFu;
+const uint VIS_TILE_SIZE  = 8u;
@@ -0,0 +1,138 @@
+#version 460
+
+#extension GL_EXT_nonuniform_qualifier : require
+#extension GL_EXT_scalar_block_layout  : require
+#extension GL_EXT_buffer_reference     : require
+#extension GL_GOOGLE_include_directive : require
+
+#define PBR_RECONSTRUCTED
+#include "pbr_shading.glsl"
+#include "vis_item.glsl"
+
+// Material pass of the visibility buffer. The pixel's triangle is fetched
+// again through the item's index/vertex addresses, projected with this
+// frame's (jittered) view-projection, and its attributes are interpolated
+// with perspective-correct barycentrics. Their one-pixel differences give the
+// uv and normal gradients shade_pbr() uses in place of dFdx / dFdy, which
+// would straddle triangle edges in a full-screen pass.
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out vec2 outVelocity;   // TAA mode only, dropped under MSAA
+
+layout(set = 0, binding = 0) uniform usampler2D allUintTextures[];   // aliases allTextures
+
+layout(scalar, push_constant) uniform constants {
+    VisItemBuffer items;
+    VisUintBuffer tileList;
+    vec2  viewSize;
+    uint  tilesX;
+    uint  idIndex;
+    uint  triangleBits;
+    vec3  sunDirection;
+    vec3  sunColor;
+    float sunIntensity;
+    uint  shadowMapIndex;
+    float shadowBias;
+    uint  iblIrradianceIndex;
+    uint  iblPrefilterIndex;
+    uint  iblBrdfLutIndex;
+} pc;
+
+struct BarycentricDeriv {
+    vec3 lambda;
+    vec3 ddx;     // change over one pixel step in x
+    vec3 ddy;
+};
+
+// Perspective-correct barycentrics of `ndc` inside the clip-space triangle,
+// and their derivatives. Vulkan NDC and framebuffer y both point down, so a
+// pixel step is +2 / viewSize in NDC on either axis.
+BarycentricDeriv barycentric_deriv(vec4 c0, vec4 c1, vec4 c2, vec2 ndc)
+{
+    BarycentricDeriv r;
+    vec3 invW = 1.0 / vec3(c0.w, c1.w, c2.w);
+    vec2 n0 = c0.xy * invW.x;
+    vec2 n1 = c1.xy * invW.y;
+    vec2 n2 = c2.xy * invW.z;
+
+    float invDet = 1.0 / determinant(mat2(n2 - n1, n0 - n1));
+    vec3  ddx = vec3(n1.y - n2.y, n2.y - n0.y, n0.y - n1.y) * invDet * invW;
+    vec3  ddy = vec3(n2.x - n1.x, n0.x - n2.x, n1.x - n0.x) * invDet * invW;
+    float ddxSum = dot(ddx, vec3(1.0));
+    float ddySum = dot(ddy, vec3(1.0));
+
+    vec2  d          = ndc - n0;
+    float interpInvW = invW.x + d.x * ddxSum + d.y * ddySum;
+    r.lambda = (vec3(invW.x, 0.0, 0.0) + d.x * ddx + d.y * ddy) / interpInvW;
+
+    vec2 pixelStep = 2.0 / pc.viewSize;
+    ddx *= pixelStep.x;  ddxSum *= pixelStep.x;
+    ddy *= pixelStep.y;  ddySum *= pixelStep.y;
+    r.ddx = (r.lambda * interpInvW + ddx) / (interpInvW + ddxSum) - r.lambda;
+    r.ddy = (r.lambda * interpInvW + ddy) / (interpInvW + ddySum) - r.lambda;
+    return r;
+}
+
+void main() {
+    uint id = texelFetch(allUintTextures[pc.idIndex], ivec2(gl_FragCoord.xy), 0).r;
+    if (id == VIS_INVALID_ID) discard;           // sky pixel in a listed tile
+
+    VisItem item = pc.items.items[id >> pc.triangleBits];
+    uint    tri  = id & ((1u << pc.triangleBits) - 1u);
+    uint    base = item.firstIndex + tri * 3u;
+
+    VisVertex v[3];
+    vec4      world[3];
+    vec4      clip[3];
+    for (int k = 0; k < 3; ++k) {
+        v[k]     = item.vertices.vertices[item.indices.indices[base + uint(k)]];
+        world[k] = item.modelMatrix * vec4(v[k].position, 1.0);
+        clip[k]  = cam.viewProjection * world[k];
+    }
+
+    BarycentricDeriv b = barycentric_deriv(clip[0], clip[1], clip[2],
+        gl_FragCoord.xy / pc.viewSize * 2.0 - 1.0);
+
+    // Same world-space attributes as colored_triangle_mesh.vert
+    mat3 normalMatrix = mat3(item.modelMatrix);
+    vec3 n[3];
+    vec3 t[3];
+    for (int k = 0; k < 3; ++k) {
+        n[k] = normalize(normalMatrix * v[k].normal);
+        t[k] = normalize(normalMatrix * v[k].tangent.xyz);
+    }
+
+    inWorldPos = mat3(world[0].xyz, world[1].xyz, world[2].xyz) * b.lambda;
+    inUV       = mat3x2(v[0].uv, v[1].uv, v[2].uv) * b.lambda;
+    inUVdx     = mat3x2(v[0].uv, v[1].uv, v[2].uv) * b.ddx;
+    inUVdy     = mat3x2(v[0].uv, v[1].uv, v[2].uv) * b.ddy;
+    inNormal   = mat3(n[0], n[1], n[2]) * b.lambda;
+    inNormalDx = mat3(n[0], n[1], n[2]) * b.ddx;
+    inNormalDy = mat3(n[0], n[1], n[2]) * b.ddy;
+    inColor    = mat3x4(v[0].color, v[1].color, v[2].color) * b.lambda;
+    inTangent  = vec4(mat3(t[0], t[1], t[2]) * b.lambda, v[0].tangent.w);
+
+    pbr.albedoIdx          = item.albedoIdx;
+    pbr.normalIdx          = item.normalIdx;
+    pbr.metalRoughIdx      = item.metalRoughIdx;
+    pbr.aoIdx              = item.aoIdx;
+    pbr.emissiveIdx        = item.emissiveIdx;
+    pbr.metallicFactor     = item.metallicFactor;
+    pbr.roughnessFactor    = item.roughnessFactor;
+    pbr.normalStrength     = item.normalStrength;
+    pbr.colorFactor        = item.colorFactor;
+    pbr.sunDirection       = pc.sunDirection;
+    pbr.sunColor           = pc.sunColor;
+    pbr.sunIntensity       = pc.sunIntensity;
+    pbr.shadowMapIndex     = pc.shadowMapIndex;
+    pbr.shadowBias         = pc.shadowBias;
+    pbr.iblIrradianceIndex = pc.iblIrradianceIndex;
+    pbr.iblPrefilterIndex  = pc.iblPrefilterIndex;
+    pbr.iblBrdfLutIndex    = pc.iblBrdfLutIndex;
+
+    outColor = shade_pbr();
+
+    vec4 cur  = cam.unjitteredViewProj * vec4(inWorldPos, 1.0);
+    vec4 prev = cam.prevViewProj * vec4(inWorldPos, 1.0);
+    outVelocity = (cur.xy / cur.w - prev.xy / prev.w) * 0.5;
+}
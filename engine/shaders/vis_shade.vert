@@ -0,0 +1,28 @@
+#version 460
+#extension GL_EXT_buffer_reference    : require
+#extension GL_EXT_scalar_block_layout : require
+#extension GL_GOOGLE_include_directive : require
+
+#include "vis_item.glsl"
+
+// One 8x8 quad per listed tile; the instance walks the material-sorted tile
+// list. Edge tiles are clipped to the drawExtent.
+
+layout(scalar, push_constant) uniform constants {
+    VisItemBuffer items;
+    VisUintBuffer tileList;
+    vec2  viewSize;
+    uint  tilesX;
+} pc;
+
+const vec2 CORNERS[6] = vec2[6](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0),
+    vec2(0.0, 1.0), vec2(1.0, 0.0), vec2(1.0, 1.0)
+);
+
+void main() {
+    uint tile  = pc.tileList.values[gl_InstanceIndex];
+    vec2 pixel = (vec2(tile % pc.tilesX, tile / pc.tilesX) + CORNERS[gl_VertexIndex]) * float(VIS_TILE_SIZE);
+    vec2 ndc   = min(pixel, pc.viewSize) / pc.viewSize * 2.0 - 1.0;
+    gl_Position = vec4(ndc, 0.0, 1.0);
+}
@@ -0,0 +1,322 @@
+#include "benchmark.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+using BenchClock = std::chrono::steady_clock;
+
+static float ms_since(BenchClock::time_point start, BenchClock::time_point end)
+{
+    return std::chrono::duration<float, std::milli>(end - start).count();
+}
+
+// ─── Manifest ─────────────────────────────────────────────────────────────────
+bool benchmark_load_manifest(const std::string& file, std::vector<BenchmarkScene>& scenes)
+{
+    std::ifstream in(find_asset(file));
+    if (!in) {
+        LOG_ERROR("Benchmark: cannot read manifest " << file);
+        return false;
+    }
+
+    scenes.clear();
+    std::string line;
+    uint32_t lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        std::istringstream fields(line);
+        std::string keyword, value;
+        if (!(fields >> keyword)) continue;
+        std::getline(fields >> std::ws, value);
+        while (!value.empty() && std::isspace((unsigned char)value.back())) value.pop_back();
+
+        if (keyword == "scene") {
+            scenes.push_back({ value, {}, {} });
+        }
+        else if (scenes.empty() || value.empty() || (keyword != "file" && keyword != "path")) {
+            LOG_ERROR("Benchmark: " << file << ":" << lineNumber << ": expected scene, file or path");
+            return false;
+        }
+        else if (keyword == "file") scenes.back().files.push_back(value);
+        else                        scenes.back().cameraPath = value;
+    }
+    return !scenes.empty();
+}
+
+// ─── Statistics ───────────────────────────────────────────────────────────────
+struct FrameSeries {
+    uint32_t count = 0;
+    float    avg = 0.0f, p50 = 0.0f, p95 = 0.0f, p99 = 0.0f, worst = 0.0f;
+};
+
+// Nearest-rank percentiles; negative samples (unresolved GPU frames) don't count
+static FrameSeries summarize(const std::vector<float>& ms)
+{
+    std::vector<float> sorted;
+    sorted.reserve(ms.size());
+    for (float v : ms) if (v >= 0.0f) sorted.push_back(v);
+
+    FrameSeries s;
+    if (sorted.empty()) return s;
+    std::sort(sorted.begin(), sorted.end());
+
+    auto rank = [&](float p) {
+        const size_t i = (size_t)std::ceil(p * (float)sorted.size());
+        return sorted[std::clamp<size_t>(i, 1, sorted.size()) - 1];
+        };
+    double sum = 0.0;
+    for (float v : sorted) sum += v;
+
+    s.count = (uint32_t)sorted.size();
+    s.avg = (float)(sum / (double)sorted.size());
+    s.p50 = rank(0.50f);
+    s.p95 = rank(0.95f);
+    s.p99 = rank(0.99f);
+    s.worst = sorted.back();
+    return s;
+}
+
+struct SceneResult {
+    std::string        name;
+    std::string        device;
+    bool               skipped = false;
+    std::string        note;                 // why it was skipped, or which camera path
+    float              initMs = 0.0f;        // init(), scene load included
+    float              loadMs = 0.0f;        // the glTF files alone
+    uint64_t           peakVramBytes = 0;
+    uint64_t           hitches = 0;          // from the frame telemetry, measured frames only
+    VkExtent2D         renderExtent{};       // drawExtent of the measured frames
+    std::vector<float> time, cpuMs, gpuMs, frameMs;
+};
+
+// What VMA has allocated in device-local heaps
+static uint64_t device_local_bytes(Engine* e)
+{
+    const VkPhysicalDeviceMemoryProperties* props = nullptr;
+    vmaGetMemoryProperties(e->allocator, &props);
+    VmaBudget budgets[VK_MAX_MEMORY_HEAPS];
+    vmaGetHeapBudgets(e->allocator, budgets);
+
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < props->memoryHeapCount; ++i)
+        if (props->memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT)
+            bytes += budgets[i].usage;
+    return bytes;
+}
+
+// ─── One scene ────────────────────────────────────────────────────────────────
+// Returns false if the user closed the window, which ends the suite
+static bool run_scene(Engine* e, const BenchmarkConfig& config, const BenchmarkScene& scene, SceneResult& r)
+{
+    r.name = scene.name;
+    for (const std::string& file : scene.files) {
+        if (!std::filesystem::exists(find_asset(file))) {
+            r.skipped = true;
+            r.note = "missing " + file;
+            LOG_ERROR("Benchmark: " << scene.name << " skipped, " << r.note);
+            return true;
+        }
+    }
+
+    LOG("Benchmark: " << scene.name);
+    const auto initStart = BenchClock::now();
+    e->sceneFiles = scene.files;
+    if (config.headless) {
+        HeadlessConfig headless;
+        headless.width = config.width;
+        headless.height = config.height;
+        headless.fixedDeltaTime = config.fixedDeltaTime;
+        headless.frames = 1;
+        init_headless(e, headless);
+    }
+    else {
+        init(e, 3840, 2160);
+    }
+    r.initMs = ms_since(initStart, BenchClock::now());
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(e->physicalDevice, &props);
+    r.device = props.deviceName;
+    r.loadMs = e->sceneLoadMs;
+    r.peakVramBytes = device_local_bytes(e);
+
+    // Fixed render resolution: the dynamic resolution controller would pick the
+    // extent from GPU times, so neither runs nor scenes would be comparable
+    const bool dynamicRes = e->dynamicRes.enabled;
+    e->dynamicRes.enabled = false;
+    e->dynamicRes.scale = 1.0f;
+
+    CameraPath path;
+    if (!scene.cameraPath.empty() && camera_path_load(find_asset(scene.cameraPath).string(), path)) {
+        r.note = scene.cameraPath;
+    }
+    else {
+        const CullScene& bounds = e->culling.scene;
+        path = camera_path_orbit(bounds.worldMin, bounds.worldMax, config.orbitSeconds);
+        r.note = "orbit";
+        if (!scene.cameraPath.empty())
+            LOG_ERROR("Benchmark: cannot read camera path " << scene.cameraPath << ", orbiting instead");
+    }
+
+    // Windowed: measure the renderer, not vsync (FIFO if immediate is missing)
+    if (!config.headless)
+        frame_pacing_set_present_mode(e, VK_PRESENT_MODE_IMMEDIATE_KHR);
+
+    CameraPathState& cp = e->cameraPath;
+    cp.playing = true;
+    cp.step = config.fixedDeltaTime;
+
+    const uint32_t measured = (uint32_t)std::ceil(path.duration() / config.fixedDeltaTime) + 1;
+    const uint32_t total = config.warmupFrames + measured;
+    r.gpuMs.assign(measured, -1.0f);
+
+    // GPU times arrive FRAME_OVERLAP frames late, against the frame number;
+    // every frame drawn advances it by one, so frame n is sample n - warmup
+    auto collect_gpu = [&]() {
+        const GpuProfilerState& gp = e->gpuProfiler;
+        const int sample = gp.resultFrame - (int)config.warmupFrames;
+        if (gp.resultFrame >= 0 && sample >= 0 && sample < (int)measured && !gp.results.empty())
+            r.gpuMs[sample] = gp.results[0].ms;
+        };
+
+    bool open = true;
+    auto lastStart = BenchClock::now();
+    for (uint32_t drawn = 0; drawn < total;) {
+        if (!config.headless) {
+            glfwPollEvents();
+            if (glfwWindowShouldClose(e->window)) {
+                open = false;
+                break;
+            }
+        }
+
+        const bool warmup = drawn < config.warmupFrames;
+        if (drawn == config.warmupFrames) telemetry_reset(e);   // hitches count from here
+        const float time = warmup ? 0.0f : (float)(drawn - config.warmupFrames) * config.fixedDeltaTime;
+        camera_path_apply(e->mainCamera, camera_path_sample(path, time));
+
+        const int frameNumber = e->frameNumber;
+        const auto start = BenchClock::now();
+        engine_draw_frame(e);
+        const auto end = BenchClock::now();
+        collect_gpu();
+
+        // Nothing drawn (minimised, swapchain rebuilt): try the same pose again
+        if (e->frameNumber == frameNumber) continue;
+
+        if (!warmup) {
+            r.time.push_back(time);
+            r.cpuMs.push_back(ms_since(start, end));
+            r.frameMs.push_back(ms_since(lastStart, start));
+        }
+        lastStart = start;
+        r.peakVramBytes = std::max(r.peakVramBytes, device_local_bytes(e));
+        drawn++;
+    }
+
+    VK_CHECK(vkDeviceWaitIdle(e->device));
+    gpu_profiler_drain(e, collect_gpu);
+    r.gpuMs.resize(r.cpuMs.size());      // an aborted run stops short
+    r.hitches = e->telemetry.hitches;
+    r.renderExtent = e->drawExtent;
+
+    const FrameSeries cpu = summarize(r.cpuMs), gpu = summarize(r.gpuMs);
+    LOG("Benchmark: " << scene.name << " " << r.cpuMs.size() << " frames, cpu avg " << cpu.avg
+        << " ms p99 " << cpu.p99 << " ms, gpu avg " << gpu.avg << " ms p99 " << gpu.p99 << " ms, "
+        << r.hitches << " hitches");
+
+    e->dynamicRes.enabled = dynamicRes;
+    engine_cleanup(e);
+    return open;
+}
+
+// ─── Reports ──────────────────────────────────────────────────────────────────
+static void write_summary(std::ofstream& out, const char* name, const FrameSeries& s)
+{
+    out << "\"" << name << "\": {\"frames\": " << s.count << ", \"avg_ms\": " << s.avg
+        << ", \"p50_ms\": " << s.p50 << ", \"p95_ms\": " << s.p95 << ", \"p99_ms\": " << s.p99
+        << ", \"worst_ms\": " << s.worst << "}";
+}
+
+static bool write_reports(const BenchmarkConfig& config, const std::vector<SceneResult>& results)
+{
+    std::string device = "unknown";
+    for (const SceneResult& r : results)
+        if (!r.device.empty()) device = r.device;
+
+    const std::string jsonPath = config.outputPrefix + ".json";
+    const std::string csvPath = config.outputPrefix + ".csv";
+    std::ofstream json(jsonPath), csv(csvPath);
+    if (!json || !csv) {
+        LOG_ERROR("Benchmark: cannot write " << jsonPath << " or " << csvPath);
+        return false;
+    }
+
+    json.setf(std::ios::fixed);
+    json.precision(3);
+    json << "{\n  \"device\": \"" << device << "\",\n"
+        << "  \"headless\": " << (config.headless ? "true" : "false") << ",\n"
+        << "  \"fixed_delta_ms\": " << config.fixedDeltaTime * 1000.0f << ",\n"
+        << "  \"warmup_frames\": " << config.warmupFrames << ",\n"
+        << "  \"scenes\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const SceneResult& r = results[i];
+        json << (i ? "," : "") << "\n    {\"name\": \"" << r.name << "\", ";
+        if (r.skipped) {
+            json << "\"skipped\": \"" << r.note << "\"}";
+            continue;
+        }
+        json << "\"camera\": \"" << r.note << "\", \"init_ms\": " << r.initMs
+            << ", \"load_ms\": " << r.loadMs
+            << ", \"peak_vram_mb\": " << (double)r.peakVramBytes / (1024.0 * 1024.0)
+            << ", \"hitches\": " << r.hitches
+            << ", \"render_width\": " << r.renderExtent.width << ", \"render_height\": " << r.renderExtent.height
+            << ",\n      ";
+        write_summary(json, "cpu", summarize(r.cpuMs));
+        json << ",\n      ";
+        write_summary(json, "gpu", summarize(r.gpuMs));
+        json << ",\n      ";
+        write_summary(json, "frame", summarize(r.frameMs));
+        json << "}";
+    }
+    json << "\n  ]\n}\n";
+
+    csv.setf(std::ios::fixed);
+    csv.precision(3);
+    csv << "scene,frame,time_s,cpu_ms,gpu_ms,frame_ms\n";
+    for (const SceneResult& r : results) {
+        for (size_t f = 0; f < r.cpuMs.size(); ++f) {
+            csv << r.name << ',' << f << ',' << r.time[f] << ',' << r.cpuMs[f] << ',';
+            if (r.gpuMs[f] >= 0.0f) csv << r.gpuMs[f];
+            csv << ',' << r.frameMs[f] << '\n';
+        }
+    }
+
+    LOG("Benchmark: reports written to " << jsonPath << " and " << csvPath);
+    return (bool)json && (bool)csv;
+}
+
+// ─── Suite ────────────────────────────────────────────────────────────────────
+int benchmark_run(Engine* e, const BenchmarkConfig& config)
+{
+    std::vector<BenchmarkScene> scenes;
+    if (!benchmark_load_manifest(config.manifest, scenes)) return 1;
+
+    std::vector<SceneResult> results;
+    for (const BenchmarkScene& scene : scenes) {
+        SceneResult& r = results.emplace_back();
+        if (!run_scene(e, config, scene, r)) {
+            LOG("Benchmark: window closed, stopping after " << scene.name);
+            break;
+        }
+    }
+    return write_reports(config, results) ? 0 : 1;
+}
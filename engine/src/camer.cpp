@@ -54,6 +54,17 @@ void Camera::focusOn(glm::vec3 center, float radius)
     fov = 45.0f;
 }
 
+// %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
+void Camera::setPose(glm::vec3 newPosition, float newYaw, float newPitch, float newFov)
+{
+    position = newPosition;
+    yaw = newYaw;
+    pitch = clampAngle(newPitch, -89.0f, 89.0f);
+    fov = newFov;
+    _updateVectors();
+    _syncOrbitFromPose();
+}
+
 // %%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%%
 glm::mat4 Camera::getViewMatrix() const
 {
@@ -62,7 +73,13 @@ glm::mat4 Camera::getViewMatrix() const
 
 glm::mat4 Camera::getProjectionMatrix(float aspect, float nearPlane, float farPlane) const
 {
-    return glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+    glm::mat4 proj = glm::perspective(glm::radians(fov), aspect, nearPlane, farPlane);
+
+    // Jitter: the z column feeds clip w (= -z), so subtracting here moves
+    // every point by jitter * w in clip space — exactly `jitter` in NDC
+    proj[2][0] -= jitter.x;
+    proj[2][1] -= jitter.y;
+    return proj;
 }
 
 // ============================================================
@@ -0,0 +1,152 @@
+#include "camera_path.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+// ─── Files ────────────────────────────────────────────────────────────────────
+bool camera_path_load(const std::string& file, CameraPath& path)
+{
+    std::ifstream in(file);
+    if (!in) return false;
+
+    path.keys.clear();
+    std::string line;
+    while (std::getline(in, line)) {
+        const size_t hash = line.find('#');
+        if (hash != std::string::npos) line.resize(hash);
+
+        std::istringstream fields(line);
+        CameraKey key;
+        if (fields >> key.time >> key.position.x >> key.position.y >> key.position.z
+            >> key.yaw >> key.pitch >> key.fov)
+            path.keys.push_back(key);
+    }
+    std::sort(path.keys.begin(), path.keys.end(),
+        [](const CameraKey& a, const CameraKey& b) { return a.time < b.time; });
+    return !path.keys.empty();
+}
+
+bool camera_path_save(const std::string& file, const CameraPath& path)
+{
+    std::ofstream out(file);
+    if (!out) {
+        LOG_ERROR("Camera path: cannot write " << file);
+        return false;
+    }
+    out << "# Synchrona camera path: time x y z yaw pitch fov\n";
+    out.setf(std::ios::fixed);
+    out.precision(4);
+    for (const CameraKey& k : path.keys)
+        out << k.time << ' ' << k.position.x << ' ' << k.position.y << ' ' << k.position.z << ' '
+            << k.yaw << ' ' << k.pitch << ' ' << k.fov << '\n';
+    return (bool)out;
+}
+
+// ─── Sampling ─────────────────────────────────────────────────────────────────
+template<typename T>
+static T catmull_rom(const T& p0, const T& p1, const T& p2, const T& p3, float u)
+{
+    const float u2 = u * u, u3 = u2 * u;
+    return 0.5f * ((2.0f * p1) + (p2 - p0) * u
+        + (2.0f * p0 - 5.0f * p1 + 4.0f * p2 - p3) * u2
+        + (3.0f * p1 - p0 - 3.0f * p2 + p3) * u3);
+}
+
+CameraKey camera_path_sample(const CameraPath& path, float time)
+{
+    const std::vector<CameraKey>& keys = path.keys;
+    if (keys.empty()) return {};
+    if (time <= keys.front().time) return keys.front();
+    if (time >= keys.back().time) return keys.back();
+
+    // Segment [i, i + 1] holds `time`; the outer control points clamp at the ends
+    const size_t i = (size_t)(std::upper_bound(keys.begin(), keys.end(), time,
+        [](float t, const CameraKey& k) { return t < k.time; }) - keys.begin()) - 1;
+    const CameraKey& k0 = keys[i > 0 ? i - 1 : i];
+    const CameraKey& k1 = keys[i];
+    const CameraKey& k2 = keys[i + 1];
+    const CameraKey& k3 = keys[std::min(i + 2, keys.size() - 1)];
+    const float span = k2.time - k1.time;
+    const float u = span > 0.0f ? (time - k1.time) / span : 0.0f;
+
+    CameraKey key;
+    key.time = time;
+    key.position = catmull_rom(k0.position, k1.position, k2.position, k3.position, u);
+    key.yaw = catmull_rom(k0.yaw, k1.yaw, k2.yaw, k3.yaw, u);
+    key.pitch = catmull_rom(k0.pitch, k1.pitch, k2.pitch, k3.pitch, u);
+    key.fov = catmull_rom(k0.fov, k1.fov, k2.fov, k3.fov, u);
+    return key;
+}
+
+void camera_path_apply(Camera& camera, const CameraKey& key)
+{
+    camera.setPose(key.position, key.yaw, key.pitch, key.fov);
+}
+
+CameraPath camera_path_orbit(glm::vec3 boundsMin, glm::vec3 boundsMax, float seconds)
+{
+    const glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+    const glm::vec3 extent = boundsMax - boundsMin;
+    const float radius = std::max(0.35f * 0.5f * glm::length(glm::vec2(extent.x, extent.z)), 1.0f);
+    const float height = boundsMin.y + extent.y * 0.3f;
+
+    // Yaw = orbit angle + 180° faces the centre and stays continuous
+    constexpr uint32_t KEYS = 32;
+    CameraPath path;
+    for (uint32_t i = 0; i <= KEYS; ++i) {
+        const float turn = (float)i / (float)KEYS;
+        const float angle = turn * 360.0f;
+        CameraKey& key = path.keys.emplace_back();
+        key.time = turn * seconds;
+        key.position = glm::vec3(center.x + radius * std::cos(glm::radians(angle)), height,
+            center.z + radius * std::sin(glm::radians(angle)));
+        key.yaw = angle + 180.0f;
+        key.pitch = glm::degrees(std::atan2(center.y - height, radius));
+        key.fov = 60.0f;
+    }
+    return path;
+}
+
+// ─── Recorder ─────────────────────────────────────────────────────────────────
+void camera_path_record_start(Engine* e)
+{
+    CameraPathState& cp = e->cameraPath;
+    cp.recording = true;
+    cp.elapsed = 0.0f;
+    cp.sinceKey = cp.interval;           // key the starting pose at once
+    cp.path.keys.clear();
+}
+
+void camera_path_record_stop(Engine* e, const std::string& file)
+{
+    CameraPathState& cp = e->cameraPath;
+    if (!cp.recording) return;
+    cp.recording = false;
+
+    // Always end on the pose the user stopped at
+    const Camera& cam = e->mainCamera;
+    if (cp.path.keys.empty() || cp.path.keys.back().time < cp.elapsed)
+        cp.path.keys.push_back({ cp.elapsed, cam.position, cam.yaw, cam.pitch, cam.fov });
+
+    if (camera_path_save(file, cp.path)) {
+        cp.lastSaved = file;
+        LOG("Camera path: " << cp.path.keys.size() << " keys, " << cp.elapsed << " s written to " << file);
+    }
+}
+
+void camera_path_record_frame(Engine* e)
+{
+    CameraPathState& cp = e->cameraPath;
+    if (!cp.recording) return;
+
+    cp.sinceKey += e->deltaTime;
+    if (cp.sinceKey >= cp.interval) {
+        const Camera& cam = e->mainCamera;
+        cp.path.keys.push_back({ cp.elapsed, cam.position, cam.yaw, cam.pitch, cam.fov });
+        cp.sinceKey = 0.0f;
+    }
+    cp.elapsed += e->deltaTime;
+}
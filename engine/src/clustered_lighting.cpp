@@ -0,0 +1,270 @@
+#include "clustered_lighting.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+// getProjectionMatrix's default far plane — the last slice runs out to it
+static constexpr float CAMERA_FAR = 50000.0f;
+
+// ─── Helpers ──────────────────────────────────────────────────────────────────
+static VkDeviceAddress cluster_buffer_address(Engine* e, const AllocatedBuffer& buffer)
+{
+    VkBufferDeviceAddressInfo info{ .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO };
+    info.buffer = buffer.buffer;
+    return vkGetBufferDeviceAddress(e->device, &info);
+}
+
+static void cluster_memory_barrier(VkCommandBuffer cmd,
+    VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+    VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    VkMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_clustered_lighting(Engine* e)
+{
+    ClusteredLightingState& c = e->clusteredLighting;
+
+    VkPushConstantRange range{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(ClusterCullPushConstants) };
+    VkPipelineLayoutCreateInfo layoutInfo = e->util.pipeline_layout_create_info();
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &e->bindlessLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &range;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &layoutInfo, nullptr, &c.cullLayout));
+
+    VkShaderModule shader = load_shader_or_exit(e, "shaders/cluster_lights.comp.spv");
+    VkComputePipelineCreateInfo info{ .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    info.stage = { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    info.stage.module = shader;
+    info.stage.pName = "main";
+    info.layout = c.cullLayout;
+    VK_CHECK(create_compute_pipeline(e, info, &c.cullPipeline));
+    vkDestroyShaderModule(e->device, shader, nullptr);
+
+    // ── Grid
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    const VkDeviceSize countBytes = (CLUSTER_COUNT + CLUSTER_STAT_WORDS) * sizeof(uint32_t);
+    c.clusterCounts = create_buffer(e->allocator, countBytes, usage, VMA_MEMORY_USAGE_GPU_ONLY, e);
+    c.clusterIndices = create_buffer(e->allocator, CLUSTER_COUNT * CLUSTER_MAX_LIGHTS * sizeof(uint32_t),
+        usage, VMA_MEMORY_USAGE_GPU_ONLY, e);
+    c.clusterCounts.address = cluster_buffer_address(e, c.clusterCounts);
+    c.clusterIndices.address = cluster_buffer_address(e, c.clusterIndices);
+
+    // ── Lights + readback, one of each per frame in flight
+    c.lightBuffers.resize(FRAME_OVERLAP);
+    for (AllocatedBuffer& buffer : c.lightBuffers) {
+        buffer = create_buffer(e->allocator, MAX_CLUSTERED_LIGHTS * sizeof(GpuLight),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_CPU_TO_GPU, e);
+        VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+        buffer.address = cluster_buffer_address(e, buffer);
+    }
+    c.readbackBuffers.resize(FRAME_OVERLAP);
+    for (AllocatedBuffer& buffer : c.readbackBuffers) {
+        buffer = create_buffer(e->allocator, countBytes,
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU, e);
+        VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+    }
+    c.counts.assign(CLUSTER_COUNT, 0);
+    c.frameRecorded.assign(FRAME_OVERLAP, 0);
+
+    e->mainDeletionQueue.push_function([=]() {
+        ClusteredLightingState& c = e->clusteredLighting;
+        for (std::vector<AllocatedBuffer>* list : { &c.lightBuffers, &c.readbackBuffers })
+            for (AllocatedBuffer& buffer : *list) {
+                vmaUnmapMemory(e->allocator, buffer.allocation);
+                destroy_buffer(buffer, e);
+            }
+        destroy_buffer(c.clusterIndices, e);
+        destroy_buffer(c.clusterCounts, e);
+        vkDestroyPipeline(e->device, c.cullPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, c.cullLayout, nullptr);
+        });
+
+    LOG("Clustered lighting: " << CLUSTER_GRID_X << "x" << CLUSTER_GRID_Y << "x" << CLUSTER_GRID_Z
+        << " clusters, " << CLUSTER_MAX_LIGHTS << " lights per cluster, up to "
+        << MAX_CLUSTERED_LIGHTS << " lights");
+}
+
+// ─── Lights ───────────────────────────────────────────────────────────────────
+// Bright, saturated colours so overlapping lights stay distinguishable
+static glm::vec3 light_hue(float h)
+{
+    const glm::vec3 k(0.0f, 2.0f / 3.0f, 1.0f / 3.0f);
+    glm::vec3 rgb = glm::clamp(glm::abs(glm::fract(glm::vec3(h) + k) * 6.0f - 3.0f) - 1.0f, 0.0f, 1.0f);
+    return glm::mix(glm::vec3(1.0f), rgb, 0.8f);
+}
+
+static void generate_lights(Engine* e)
+{
+    ClusteredLightingState& c = e->clusteredLighting;
+    const CullScene& scene = e->culling.scene;
+
+    c.lightCount = std::min(c.lightCount, MAX_CLUSTERED_LIGHTS);
+    c.generatedCount = c.lightCount;
+    c.generatedSeed = c.seed;
+    c.generatedMin = scene.worldMin;
+    c.generatedMax = scene.worldMax;
+
+    // Inset a little so lights don't sit inside the outer walls
+    const glm::vec3 inset = (scene.worldMax - scene.worldMin) * 0.05f;
+    const glm::vec3 lo = scene.worldMin + inset;
+    const glm::vec3 hi = scene.worldMax - inset;
+
+    std::mt19937 rng(c.seed);
+    std::uniform_real_distribution<float> unit(0.0f, 1.0f);
+
+    c.sources.resize(c.lightCount);
+    c.lights.resize(c.lightCount);
+    for (uint32_t i = 0; i < c.lightCount; ++i) {
+        ClusteredLightSource& s = c.sources[i];
+        s.basePosition = glm::mix(lo, hi, glm::vec3(unit(rng), unit(rng), unit(rng)));
+        s.phase = unit(rng) * 6.2831853f;
+        s.speed = 0.3f + unit(rng) * 0.7f;
+
+        GpuLight& l = c.lights[i];
+        l = {};
+        l.color = light_hue(unit(rng));
+        l.type = unit(rng) < c.spotFraction ? LightType::Spot : LightType::Point;
+        if (l.type == LightType::Spot) {
+            // Mostly downward cones of 20–45 degrees
+            glm::vec3 d(unit(rng) * 2.0f - 1.0f, -1.5f, unit(rng) * 2.0f - 1.0f);
+            l.direction = glm::normalize(d);
+            const float outer = glm::radians(20.0f + unit(rng) * 25.0f);
+            l.spotCosOuter = std::cos(outer);
+            l.spotCosInner = std::cos(outer * 0.7f);
+        }
+        else {
+            l.direction = glm::vec3(0.0f, -1.0f, 0.0f);
+        }
+    }
+}
+
+// ─── Per frame ────────────────────────────────────────────────────────────────
+void clustered_lighting_begin_frame(Engine* e)
+{
+    ClusteredLightingState& c = e->clusteredLighting;
+    if (c.frameRecorded.empty()) return;
+
+    // ── Counts of the frame that last used this slot
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    if (c.frameRecorded[slot]) {
+        // GPU_TO_CPU memory may be non-coherent
+        VK_CHECK(vmaInvalidateAllocation(e->allocator, c.readbackBuffers[slot].allocation, 0, VK_WHOLE_SIZE));
+        const uint32_t* data = (const uint32_t*)c.readbackBuffers[slot].info.pMappedData;
+        std::copy(data, data + CLUSTER_COUNT, c.counts.begin());
+        c.indexCount = data[CLUSTER_COUNT];
+        c.maxPerCluster = data[CLUSTER_COUNT + 1];
+        c.overflowClusters = data[CLUSTER_COUNT + 2];
+        c.occupiedClusters = (uint32_t)std::count_if(c.counts.begin(), c.counts.end(),
+            [](uint32_t n) { return n > 0; });
+        c.frameRecorded[slot] = 0;
+    }
+
+    const CullScene& scene = e->culling.scene;
+    if (c.lightCount != c.generatedCount || c.seed != c.generatedSeed ||
+        scene.worldMin != c.generatedMin || scene.worldMax != c.generatedMax)
+        generate_lights(e);
+
+    // ── Animate and upload; the range follows the slider live
+    if (c.animate) c.time += e->deltaTime;
+    const float diagonal = glm::length(scene.worldMax - scene.worldMin);
+    const float range = std::max(diagonal * c.rangeScale, 0.01f);
+    for (uint32_t i = 0; i < c.lightCount; ++i) {
+        const ClusteredLightSource& s = c.sources[i];
+        const float t = c.time * s.speed + s.phase;
+        GpuLight& l = c.lights[i];
+        l.position = s.basePosition + glm::vec3(std::sin(t), 0.5f * std::sin(2.0f * t), std::cos(t)) * range * 0.5f;
+        l.range = range;
+        l.intensity = c.intensity * range * range;   // same brightness at any scene scale
+    }
+    memcpy(c.lightBuffers[slot].info.pMappedData, c.lights.data(), c.lightCount * sizeof(GpuLight));
+}
+
+void write_cluster_camera_data(const Engine* e, CameraData& cam)
+{
+    const ClusteredLightingState& c = e->clusteredLighting;
+    const float sliceNear = std::max(c.sliceNear, 0.01f);
+    const float sliceFar = std::max(c.sliceFar, sliceNear * 2.0f);
+
+    // slice = log(depth) * scale + bias: 1 at sliceNear, z at sliceFar
+    const float scale = (float)(CLUSTER_GRID_Z - 1) / std::log(sliceFar / sliceNear);
+    cam.clusterSlicing = glm::vec4(scale, 1.0f - std::log(sliceNear) * scale,
+        c.heatmapOverlay ? 1.0f : 0.0f, std::max(c.heatmapMax, 1.0f));
+    cam.clusterGrid = glm::uvec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, CLUSTER_MAX_LIGHTS);
+    cam.clusterScreen = glm::vec4(
+        (float)CLUSTER_GRID_X / (float)std::max(1u, e->drawExtent.width),
+        (float)CLUSTER_GRID_Y / (float)std::max(1u, e->drawExtent.height),
+        c.enabled && c.lightCount > 0 ? 1.0f : 0.0f, 0.0f);
+    cam.clusterLights = c.lightBuffers[e->frameNumber % FRAME_OVERLAP].address;
+    cam.clusterCounts = c.clusterCounts.address;
+    cam.clusterIndices = c.clusterIndices.address;
+}
+
+// ─── Culling ──────────────────────────────────────────────────────────────────
+void draw_cluster_light_culling(Engine* e, VkCommandBuffer cmd)
+{
+    ClusteredLightingState& c = e->clusteredLighting;
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+
+    // Last frame's fragments and counts copy are done with the grid
+    cluster_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        VK_ACCESS_2_NONE,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+    vkCmdFillBuffer(cmd, c.clusterCounts.buffer, CLUSTER_COUNT * sizeof(uint32_t),
+        CLUSTER_STAT_WORDS * sizeof(uint32_t), 0);
+    cluster_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, c.cullPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+        c.cullLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+    // Same projection as update_uniform_buffers, y flipped
+    const float aspect = (float)e->drawExtent.width / (float)std::max(1u, e->drawExtent.height);
+    const glm::mat4 projection = e->mainCamera.getProjectionMatrix(aspect);
+
+    ClusterCullPushConstants push{};
+    push.lights = c.lightBuffers[slot].address;
+    push.counts = c.clusterCounts.address;
+    push.indices = c.clusterIndices.address;
+    push.grid = glm::uvec4(CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, CLUSTER_MAX_LIGHTS);
+    push.projScale = glm::vec2(projection[0][0], -projection[1][1]);
+    push.sliceNear = std::max(c.sliceNear, 0.01f);
+    push.sliceFar = std::max(c.sliceFar, push.sliceNear * 2.0f);
+    push.cameraFar = CAMERA_FAR;
+    push.lightCount = c.enabled ? c.lightCount : 0;
+    vkCmdPushConstants(cmd, c.cullLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+    vkCmdDispatch(cmd, (CLUSTER_COUNT + 63) / 64, 1, 1);
+
+    cluster_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT);
+
+    VkBufferCopy copy{ 0, 0, (CLUSTER_COUNT + CLUSTER_STAT_WORDS) * sizeof(uint32_t) };
+    vkCmdCopyBuffer(cmd, c.clusterCounts.buffer, c.readbackBuffers[slot].buffer, 1, &copy);
+    cluster_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_HOST_BIT, VK_ACCESS_2_HOST_READ_BIT);
+    c.frameRecorded[slot] = 1;
+}
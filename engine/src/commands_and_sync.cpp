@@ -38,7 +38,7 @@ void init_commands(Engine* e) {
         // Per-frame pools are destroyed in engine_cleanup
         });
 
-    std::printf("✅ Commands initialized\n");
+    LOG_CAT(Vulkan, Info, "✅ Commands initialized");
 }
 
 // ─── Sync structures ──────────────────────────────────────────────────────────
@@ -57,21 +57,16 @@ VkSemaphoreCreateInfo semaphore_create_info(VkSemaphoreCreateFlags flags) {
 }
 
 void init_sync_structures(Engine* e) {
-    VkFenceCreateInfo     fenceInfo = fence_create_info(VK_FENCE_CREATE_SIGNALED_BIT);
     VkSemaphoreCreateInfo semInfo = semaphore_create_info(0);
 
+    // Frame and immediate-submit completion is tracked by the frame
+    // scheduler's timeline semaphore; these are the binary WSI semaphores
     for (uint32_t i = 0; i < FRAME_OVERLAP; i++) {
-        VK_CHECK(vkCreateFence(e->device, &fenceInfo, nullptr, &e->frames[i].renderFence));
         VK_CHECK(vkCreateSemaphore(e->device, &semInfo, nullptr, &e->frames[i].swapchainSemaphore));
         VK_CHECK(vkCreateSemaphore(e->device, &semInfo, nullptr, &e->frames[i].renderSemaphore));
     }
 
-    VK_CHECK(vkCreateFence(e->device, &fenceInfo, nullptr, &e->immFence));
-    e->mainDeletionQueue.push_function([=]() {
-        vkDestroyFence(e->device, e->immFence, nullptr);
-        });
-
-    std::printf("✅ Sync structures initialized\n");
+    LOG_CAT(Vulkan, Info, "✅ Sync structures initialized");
 }
 
 // ─── Submit helpers ───────────────────────────────────────────────────────────
@@ -0,0 +1,269 @@
+#include "cpu_profiler.h"
+#include "types.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+std::atomic<bool> g_cpuZonesCapturing{ false };
+
+struct CpuZoneEvent {
+    const CpuZoneSite* site;
+    uint64_t           begin;        // ticks
+    uint64_t           end;
+};
+
+// One per live thread that was named or recorded a zone, plus exited ones a
+// running capture still has to export. Only its own thread writes the ring;
+// the exporter reads up to `head`, which is published with release. The ring
+// stays empty until the first zone.
+struct ThreadZones {
+    std::vector<CpuZoneEvent> ring;
+    std::atomic<uint64_t>     head{ 0 };        // zones ever written
+    uint64_t                  captureStart = 0; // head when the capture began
+    uint32_t                  tid = 0;
+    std::string               name;
+    bool                      exited = false;   // its thread is gone
+};
+
+static std::mutex                                s_mutex;      // guards everything below
+static std::vector<std::unique_ptr<ThreadZones>> s_threads;
+static std::vector<std::vector<CpuZoneEvent>>    s_spareRings; // from exited threads
+static uint32_t                                  s_nextTid = 0;
+static uint32_t                                  s_framesLeft = 0;
+static std::string                               s_path;
+static uint64_t                                  s_startTicks = 0;
+static std::chrono::steady_clock::time_point     s_startTime;
+static CpuProfilerStatus                         s_status;
+
+// Drops exited threads, parking their rings. Not while capturing: the export
+// still reads them. Caller holds s_mutex.
+static void release_exited_threads()
+{
+    if (g_cpuZonesCapturing.load(std::memory_order_relaxed)) return;
+    std::erase_if(s_threads, [](const std::unique_ptr<ThreadZones>& z) {
+        if (!z->exited) return false;
+        if (!z->ring.empty() && s_spareRings.size() < CPU_ZONE_SPARE_RINGS)
+            s_spareRings.push_back(std::move(z->ring));
+        return true;
+        });
+}
+
+// Unregisters the thread's zones when the thread exits
+struct ThreadZonesOwner {
+    ThreadZones* zones = nullptr;
+
+    ~ThreadZonesOwner()
+    {
+        if (!zones) return;
+        std::lock_guard<std::mutex> lock(s_mutex);
+        zones->exited = true;
+        release_exited_threads();
+    }
+};
+
+static thread_local ThreadZonesOwner t_zones;
+
+static ThreadZones* thread_zones()
+{
+    if (!t_zones.zones) {
+        std::lock_guard<std::mutex> lock(s_mutex);
+        auto zones = std::make_unique<ThreadZones>();
+        zones->tid = s_nextTid++;
+        zones->name = "thread " + std::to_string(zones->tid);
+        t_zones.zones = zones.get();
+        s_threads.push_back(std::move(zones));
+    }
+    return t_zones.zones;
+}
+
+// First zone of a thread: a parked ring if there is one. Stale events in it
+// are never read, the exporter stops at `head`.
+static void allocate_ring(ThreadZones* zones)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (!s_spareRings.empty()) {
+        zones->ring = std::move(s_spareRings.back());
+        s_spareRings.pop_back();
+    }
+    else {
+        zones->ring.resize(CPU_ZONE_RING);
+    }
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+void cpu_zone_record(const CpuZoneSite* site, uint64_t begin, uint64_t end)
+{
+    ThreadZones* zones = thread_zones();
+    if (zones->ring.empty()) allocate_ring(zones);
+    const uint64_t head = zones->head.load(std::memory_order_relaxed);
+    zones->ring[head & (CPU_ZONE_RING - 1)] = { site, begin, end };
+    zones->head.store(head + 1, std::memory_order_release);
+}
+
+void cpu_profiler_thread_name(const char* name)
+{
+    ThreadZones* zones = thread_zones();
+    std::lock_guard<std::mutex> lock(s_mutex);
+    zones->name = name;
+}
+
+// ─── Export ───────────────────────────────────────────────────────────────────
+static void json_string(std::ofstream& out, const char* s)
+{
+    out << '"';
+    for (; *s; ++s) {
+        if (*s == '"' || *s == '\\') out << '\\' << *s;
+        else if ((unsigned char)*s < 0x20) out << ' ';
+        else out << *s;
+    }
+    out << '"';
+}
+
+struct ThreadCapture {
+    const ThreadZones*        zones;
+    std::vector<CpuZoneEvent> events;
+};
+
+// Innermost-first unwinding of each thread's zones into "thread;outer;inner"
+// stacks, each charged its self time
+static void write_folded(const std::vector<ThreadCapture>& threads, double nsPerTick, const std::string& path)
+{
+    std::map<std::string, uint64_t> stacks;     // ticks of self time
+    struct Open { uint64_t end; uint64_t duration; uint64_t children; std::string stack; };
+
+    for (const ThreadCapture& t : threads) {
+        std::vector<CpuZoneEvent> events = t.events;
+        std::sort(events.begin(), events.end(), [](const CpuZoneEvent& a, const CpuZoneEvent& b) {
+            return a.begin != b.begin ? a.begin < b.begin : a.end > b.end;
+            });
+
+        std::vector<Open> open;
+        auto close = [&]() {
+            Open& o = open.back();
+            stacks[o.stack] += o.duration > o.children ? o.duration - o.children : 0;
+            open.pop_back();
+            };
+        for (const CpuZoneEvent& ev : events) {
+            while (!open.empty() && open.back().end <= ev.begin) close();
+            const uint64_t duration = ev.end - ev.begin;
+            if (!open.empty()) open.back().children += duration;
+            open.push_back({ ev.end, duration, 0,
+                (open.empty() ? t.zones->name : open.back().stack) + ";" + ev.site->name });
+        }
+        while (!open.empty()) close();
+    }
+
+    std::ofstream out(path);
+    for (const auto& [stack, ticks] : stacks) {
+        const uint64_t us = (uint64_t)((double)ticks * nsPerTick / 1000.0);
+        if (us > 0) out << stack << ' ' << us << '\n';
+    }
+}
+
+static void export_capture()
+{
+    std::vector<ThreadCapture> threads;
+    uint64_t zones = 0, dropped = 0, origin = UINT64_MAX;
+    for (const std::unique_ptr<ThreadZones>& z : s_threads) {
+        const uint64_t head = z->head.load(std::memory_order_acquire);
+        const uint64_t first = std::max(z->captureStart, head > CPU_ZONE_RING ? head - CPU_ZONE_RING : 0);
+        dropped += first - std::min(first, z->captureStart);
+        if (first == head) continue;
+
+        ThreadCapture& t = threads.emplace_back();
+        t.zones = z.get();
+        t.events.reserve(head - first);
+        for (uint64_t i = first; i < head; ++i) {
+            t.events.push_back(z->ring[i & (CPU_ZONE_RING - 1)]);
+            origin = std::min(origin, t.events.back().begin);
+        }
+        zones += head - first;
+    }
+
+    // Ticks to ns over the whole capture; exact when ticks already are ns
+    const double elapsedNs = (double)std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now() - s_startTime).count();
+    const uint64_t elapsedTicks = cpu_zone_ticks() - s_startTicks;
+    const double nsPerTick = elapsedTicks > 0 ? elapsedNs / (double)elapsedTicks : 1.0;
+
+    std::ofstream out(s_path);
+    if (!out) {
+        LOG_ERROR("CPU profiler: cannot write " << s_path);
+        return;
+    }
+
+    out << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n";
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    bool first = true;
+    for (const ThreadCapture& t : threads) {
+        out << (first ? "" : ",\n") << "{\"ph\":\"M\",\"pid\":1,\"tid\":" << t.zones->tid
+            << ",\"name\":\"thread_name\",\"args\":{\"name\":";
+        json_string(out, t.zones->name.c_str());
+        out << "}}";
+        first = false;
+
+        for (const CpuZoneEvent& ev : t.events) {
+            out << ",\n{\"ph\":\"X\",\"pid\":1,\"tid\":" << t.zones->tid
+                << ",\"ts\":" << (double)(ev.begin - origin) * nsPerTick / 1000.0
+                << ",\"dur\":" << (double)(ev.end - ev.begin) * nsPerTick / 1000.0 << ",\"name\":";
+            json_string(out, ev.site->name);
+            out << ",\"args\":{\"file\":";
+            json_string(out, ev.site->file);
+            out << ",\"line\":" << ev.site->line << "}}";
+        }
+    }
+    out << "\n]}\n";
+    out.close();
+
+    write_folded(threads, nsPerTick, s_path + ".folded");
+
+    s_status.lastPath = s_path;
+    s_status.lastZones = zones;
+    s_status.lastDropped = dropped;
+    s_status.lastThreads = (uint32_t)threads.size();
+    LOG("CPU trace: " << zones << " zones on " << threads.size() << " threads written to " << s_path
+        << (dropped ? " (" + std::to_string(dropped) + " dropped)" : std::string()));
+}
+
+// ─── Capture ──────────────────────────────────────────────────────────────────
+void cpu_profiler_capture(uint32_t frames, const char* path)
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (g_cpuZonesCapturing.load(std::memory_order_relaxed) || frames == 0) return;
+
+    for (const std::unique_ptr<ThreadZones>& z : s_threads)
+        z->captureStart = z->head.load(std::memory_order_acquire);
+    s_framesLeft = frames;
+    s_path = path;
+    s_startTime = std::chrono::steady_clock::now();
+    s_startTicks = cpu_zone_ticks();
+    g_cpuZonesCapturing.store(true, std::memory_order_relaxed);
+}
+
+void cpu_profiler_frame()
+{
+    if (!g_cpuZonesCapturing.load(std::memory_order_relaxed)) return;
+
+    std::lock_guard<std::mutex> lock(s_mutex);
+    if (--s_framesLeft > 0) return;
+
+    // Zones still open finish after this and stay out of the trace
+    g_cpuZonesCapturing.store(false, std::memory_order_relaxed);
+    export_capture();
+    release_exited_threads();
+}
+
+CpuProfilerStatus cpu_profiler_status()
+{
+    std::lock_guard<std::mutex> lock(s_mutex);
+    CpuProfilerStatus status = s_status;
+    status.capturing = g_cpuZonesCapturing.load(std::memory_order_relaxed);
+    status.framesLeft = status.capturing ? s_framesLeft : 0;
+    return status;
+}
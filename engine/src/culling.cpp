@@ -0,0 +1,270 @@
+#include "culling.h"
+#include "engine.h"
+
+#include <cfloat>
+#include <chrono>
+
+// Kernel width is chosen at compile time: build with /arch:AVX2 (MSVC) or
+// -mavx2 (GCC/Clang) for 8 surfaces per iteration, otherwise SSE2 handles 4.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CULL_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CULL_SSE2 1
+#endif
+
+// ─── Frustum extraction ───────────────────────────────────────────────────────
+// Gribb/Hartmann on the rows of the matrix. Vulkan clip space has z in [0, w],
+// so the near plane is row 2 alone rather than row 3 + row 2.
+Frustum frustum_from_matrix(const glm::mat4& m)
+{
+    const glm::vec4 r0(m[0][0], m[1][0], m[2][0], m[3][0]);
+    const glm::vec4 r1(m[0][1], m[1][1], m[2][1], m[3][1]);
+    const glm::vec4 r2(m[0][2], m[1][2], m[2][2], m[3][2]);
+    const glm::vec4 r3(m[0][3], m[1][3], m[2][3], m[3][3]);
+
+    Frustum f{};
+    f.planes[0] = r3 + r0;   // left
+    f.planes[1] = r3 - r0;   // right
+    f.planes[2] = r3 + r1;   // bottom (top after the Y flip — order doesn't matter)
+    f.planes[3] = r3 - r1;   // top
+    f.planes[4] = r2;        // near
+    f.planes[5] = r3 - r2;   // far
+
+    for (auto& p : f.planes) {
+        float len = glm::length(glm::vec3(p));
+        if (len > 0.0f) p /= len;
+    }
+    return f;
+}
+
+// ─── Scene bounds ─────────────────────────────────────────────────────────────
+void build_cull_scene(Engine* e)
+{
+    CullScene& s = e->culling.scene;
+
+    uint32_t count = 0;
+    s.assetFirstSurface.clear();
+    s.assetFirstSurface.reserve(e->testMeshes.size());
+    for (auto& asset : e->testMeshes) {
+        s.assetFirstSurface.push_back(count);
+        count += (uint32_t)asset->surfaces.size();
+    }
+
+    s.count = count;
+    s.padded = (count + CULL_LANES - 1) / CULL_LANES * CULL_LANES;
+
+    for (auto* v : { &s.aabbCX, &s.aabbCY, &s.aabbCZ, &s.aabbEX, &s.aabbEY, &s.aabbEZ,
+                     &s.sphereX, &s.sphereY, &s.sphereZ, &s.sphereR })
+        v->assign(s.padded, 0.0f);
+
+    s.worldMin = glm::vec3(FLT_MAX);
+    s.worldMax = glm::vec3(-FLT_MAX);
+
+    uint32_t i = 0;
+    for (auto& asset : e->testMeshes) {
+        const glm::mat4& M = asset->worldTransform;
+        const glm::mat3  absM(glm::abs(glm::vec3(M[0])), glm::abs(glm::vec3(M[1])), glm::abs(glm::vec3(M[2])));
+        const float      maxScale = std::max({ glm::length(glm::vec3(M[0])),
+                                               glm::length(glm::vec3(M[1])),
+                                               glm::length(glm::vec3(M[2])) });
+
+        for (auto& surface : asset->surfaces) {
+            // AABB: transform the centre, project the extents onto |M| (Arvo)
+            glm::vec3 c = (surface.boundsMin + surface.boundsMax) * 0.5f;
+            glm::vec3 h = (surface.boundsMax - surface.boundsMin) * 0.5f;
+            glm::vec3 wc = glm::vec3(M * glm::vec4(c, 1.0f));
+            glm::vec3 wh = absM * h;
+
+            s.aabbCX[i] = wc.x; s.aabbCY[i] = wc.y; s.aabbCZ[i] = wc.z;
+            s.aabbEX[i] = wh.x; s.aabbEY[i] = wh.y; s.aabbEZ[i] = wh.z;
+
+            glm::vec3 sc = glm::vec3(M * glm::vec4(surface.sphereCenter, 1.0f));
+            s.sphereX[i] = sc.x; s.sphereY[i] = sc.y; s.sphereZ[i] = sc.z;
+            s.sphereR[i] = surface.sphereRadius * maxScale;
+
+            s.worldMin = glm::min(s.worldMin, wc - wh);
+            s.worldMax = glm::max(s.worldMax, wc + wh);
+            ++i;
+        }
+    }
+
+    if (count == 0) s.worldMin = s.worldMax = glm::vec3(0.0f);
+
+    // Transforms or surfaces changed — cached static passes are stale
+    mark_scene_dirty(e);
+
+    LOG("Cull scene built: " << count << " surfaces (" << cull_simd_name() << ")");
+}
+
+// ─── Kernels ──────────────────────────────────────────────────────────────────
+// A surface survives if, for every plane, both its sphere and its AABB reach the
+// positive side. Ranges are always multiples of CULL_LANES.
+#if defined(CULL_AVX2)
+static void cull_range(const CullScene& s, const Frustum& f, uint32_t begin, uint32_t end, uint8_t* out)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 allOnes = _mm256_castsi256_ps(_mm256_set1_epi32(-1));
+
+    __m256 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& pl = f.planes[p];
+        nx[p] = _mm256_set1_ps(pl.x);  ny[p] = _mm256_set1_ps(pl.y);
+        nz[p] = _mm256_set1_ps(pl.z);  nw[p] = _mm256_set1_ps(pl.w);
+        ax[p] = _mm256_set1_ps(std::fabs(pl.x));
+        ay[p] = _mm256_set1_ps(std::fabs(pl.y));
+        az[p] = _mm256_set1_ps(std::fabs(pl.z));
+    }
+
+    for (uint32_t i = begin; i < end; i += 8) {
+        const __m256 cx = _mm256_loadu_ps(&s.aabbCX[i]);
+        const __m256 cy = _mm256_loadu_ps(&s.aabbCY[i]);
+        const __m256 cz = _mm256_loadu_ps(&s.aabbCZ[i]);
+        const __m256 ex = _mm256_loadu_ps(&s.aabbEX[i]);
+        const __m256 ey = _mm256_loadu_ps(&s.aabbEY[i]);
+        const __m256 ez = _mm256_loadu_ps(&s.aabbEZ[i]);
+        const __m256 sx = _mm256_loadu_ps(&s.sphereX[i]);
+        const __m256 sy = _mm256_loadu_ps(&s.sphereY[i]);
+        const __m256 sz = _mm256_loadu_ps(&s.sphereZ[i]);
+        const __m256 sr = _mm256_loadu_ps(&s.sphereR[i]);
+
+        __m256 inside = allOnes;
+        for (int p = 0; p < 6; ++p) {
+            __m256 d = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], cx), _mm256_mul_ps(ny[p], cy)),
+                                     _mm256_add_ps(_mm256_mul_ps(nz[p], cz), nw[p]));
+            __m256 r = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(ax[p], ex), _mm256_mul_ps(ay[p], ey)),
+                                     _mm256_mul_ps(az[p], ez));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(d, r), zero, _CMP_GE_OQ));
+
+            __m256 ds = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx[p], sx), _mm256_mul_ps(ny[p], sy)),
+                                      _mm256_add_ps(_mm256_mul_ps(nz[p], sz), nw[p]));
+            inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(ds, sr), zero, _CMP_GE_OQ));
+        }
+
+        int mask = _mm256_movemask_ps(inside);
+        for (int l = 0; l < 8; ++l)
+            out[i + l] = (uint8_t)((mask >> l) & 1);
+    }
+}
+
+const char* cull_simd_name() { return "AVX2"; }
+
+#elif defined(CULL_SSE2)
+static void cull_range(const CullScene& s, const Frustum& f, uint32_t begin, uint32_t end, uint8_t* out)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 allOnes = _mm_castsi128_ps(_mm_set1_epi32(-1));
+
+    __m128 nx[6], ny[6], nz[6], nw[6], ax[6], ay[6], az[6];
+    for (int p = 0; p < 6; ++p) {
+        const glm::vec4& pl = f.planes[p];
+        nx[p] = _mm_set1_ps(pl.x);  ny[p] = _mm_set1_ps(pl.y);
+        nz[p] = _mm_set1_ps(pl.z);  nw[p] = _mm_set1_ps(pl.w);
+        ax[p] = _mm_set1_ps(std::fabs(pl.x));
+        ay[p] = _mm_set1_ps(std::fabs(pl.y));
+        az[p] = _mm_set1_ps(std::fabs(pl.z));
+    }
+
+    for (uint32_t i = begin; i < end; i += 4) {
+        const __m128 cx = _mm_loadu_ps(&s.aabbCX[i]);
+        const __m128 cy = _mm_loadu_ps(&s.aabbCY[i]);
+        const __m128 cz = _mm_loadu_ps(&s.aabbCZ[i]);
+        const __m128 ex = _mm_loadu_ps(&s.aabbEX[i]);
+        const __m128 ey = _mm_loadu_ps(&s.aabbEY[i]);
+        const __m128 ez = _mm_loadu_ps(&s.aabbEZ[i]);
+        const __m128 sx = _mm_loadu_ps(&s.sphereX[i]);
+        const __m128 sy = _mm_loadu_ps(&s.sphereY[i]);
+        const __m128 sz = _mm_loadu_ps(&s.sphereZ[i]);
+        const __m128 sr = _mm_loadu_ps(&s.sphereR[i]);
+
+        __m128 inside = allOnes;
+        for (int p = 0; p < 6; ++p) {
+            __m128 d = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], cx), _mm_mul_ps(ny[p], cy)),
+                                  _mm_add_ps(_mm_mul_ps(nz[p], cz), nw[p]));
+            __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ax[p], ex), _mm_mul_ps(ay[p], ey)),
+                                  _mm_mul_ps(az[p], ez));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(d, r), zero));
+
+            __m128 ds = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx[p], sx), _mm_mul_ps(ny[p], sy)),
+                                   _mm_add_ps(_mm_mul_ps(nz[p], sz), nw[p]));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(ds, sr), zero));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        for (int l = 0; l < 4; ++l)
+            out[i + l] = (uint8_t)((mask >> l) & 1);
+    }
+}
+
+const char* cull_simd_name() { return "SSE2"; }
+
+#else
+static void cull_range(const CullScene& s, const Frustum& f, uint32_t begin, uint32_t end, uint8_t* out)
+{
+    for (uint32_t i = begin; i < end; ++i) {
+        bool inside = true;
+        for (const glm::vec4& p : f.planes) {
+            float d = p.x * s.aabbCX[i] + p.y * s.aabbCY[i] + p.z * s.aabbCZ[i] + p.w;
+            float r = std::fabs(p.x) * s.aabbEX[i] + std::fabs(p.y) * s.aabbEY[i] + std::fabs(p.z) * s.aabbEZ[i];
+            float ds = p.x * s.sphereX[i] + p.y * s.sphereY[i] + p.z * s.sphereZ[i] + p.w;
+            if (d + r < 0.0f || ds + s.sphereR[i] < 0.0f) { inside = false; break; }
+        }
+        out[i] = inside ? 1 : 0;
+    }
+}
+
+const char* cull_simd_name() { return "scalar"; }
+#endif
+
+// ─── Per-view culling ─────────────────────────────────────────────────────────
+void cull_view(Engine* e, const Frustum& frustum, CullView& out)
+{
+    const CullScene& s = e->culling.scene;
+    out.visible.assign(s.padded, 0);
+
+    uint8_t* dst = out.visible.data();
+    auto kernel = [&](uint32_t begin, uint32_t end, uint32_t) {
+        cull_range(s, frustum, begin, end, dst);
+        };
+
+    if (e->jobs && s.padded > CULL_PARALLEL_BATCH)
+        jobs_parallel_for(*e->jobs, s.padded, CULL_PARALLEL_BATCH, kernel);
+    else
+        kernel(0, s.padded, 0);
+
+    uint32_t visible = 0;
+    for (uint32_t i = 0; i < s.count; ++i)
+        visible += dst[i];
+    out.visibleCount = visible;
+}
+
+void run_frustum_culling(Engine* e)
+{
+    CPU_ZONE("run_frustum_culling");
+    auto t0 = std::chrono::high_resolution_clock::now();
+    CullingState& c = e->culling;
+
+    if (c.scene.assetFirstSurface.size() != e->testMeshes.size())
+        build_cull_scene(e);
+
+    if (c.enabled) {
+        cull_view(e, frustum_from_matrix(e->cameraViewProj), c.camera);
+        cull_view(e, frustum_from_matrix(e->lightViewProj), c.shadow);
+        for (uint32_t i = 0; i < e->shadowCascades.count; ++i)
+            cull_view(e, frustum_from_matrix(e->shadowCascades.viewProj[i]), c.cascades[i]);
+    }
+    else {
+        auto all_visible = [&](CullView& v) {
+            v.visible.assign(c.scene.padded, 1);
+            v.visibleCount = c.scene.count;
+            };
+        all_visible(c.camera);
+        all_visible(c.shadow);
+        for (uint32_t i = 0; i < e->shadowCascades.count; ++i)
+            all_visible(c.cascades[i]);
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    c.cpuMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+}
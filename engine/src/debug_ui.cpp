@@ -37,49 +37,41 @@ void debug_ui_init(Engine* e)
 void debug_ui_shutdown()
 {
     s_engine = nullptr;
-    g_debugUI.logMessages.clear();
-}
-
-// ─── Update ──────────────────────────────────────────────────────────────────
-void debug_ui_update(float deltaTime)
-{
-    float msec = deltaTime * 1000.0f;
-
-    g_debugUI.frameTimes.erase(g_debugUI.frameTimes.begin());
-    g_debugUI.frameTimes.push_back(msec);
-
-    g_debugUI.minFrameTime = *std::min_element(
-        g_debugUI.frameTimes.begin(), g_debugUI.frameTimes.end());
-    g_debugUI.maxFrameTime = *std::max_element(
-        g_debugUI.frameTimes.begin(), g_debugUI.frameTimes.end());
-
-    g_debugUI.avgFrameTime = 0.0f;
-    for (float t : g_debugUI.frameTimes) g_debugUI.avgFrameTime += t;
-    g_debugUI.avgFrameTime /= (float)g_debugUI.frameTimes.size();
-
-    float fps = (msec > 0.01f) ? 1000.0f / msec : 0.0f;
-    g_debugUI.fpsHistory.erase(g_debugUI.fpsHistory.begin());
-    g_debugUI.fpsHistory.push_back(fps);
 }
 
 // ─── Logging ──────────────────────────────────────────────────────────────────
 void debug_ui_log(const char* fmt, ...)
 {
-    char buf[1024];
+    char buf[LOG_SLOT_TEXT + 1];
     va_list args;
     va_start(args, fmt);
     vsnprintf(buf, sizeof(buf), fmt, args);
     va_end(args);
-    g_debugUI.logMessages.emplace_back(buf);
-    if (g_debugUI.logMessages.size() > 800)
-        g_debugUI.logMessages.erase(g_debugUI.logMessages.begin());
+    LOG_CAT(UI, Info, buf);
 }
 
 void debug_ui_log(const std::string& msg)
 {
-    g_debugUI.logMessages.push_back(msg);
-    if (g_debugUI.logMessages.size() > 800)
-        g_debugUI.logMessages.erase(g_debugUI.logMessages.begin());
+    LOG_CAT(UI, Info, msg);
+}
+
+// Green = reused, yellow = cache copied under dynamic casters, red = re-rendered
+static ImVec4 shadow_cache_colour(ShadowCacheResult r)
+{
+    switch (r) {
+    case ShadowCacheResult::Reused: return ImVec4(0.2f, 1.0f, 0.2f, 1.0f);
+    case ShadowCacheResult::Copied: return ImVec4(1.0f, 1.0f, 0.1f, 1.0f);
+    default:                        return ImVec4(1.0f, 0.2f, 0.2f, 1.0f);
+    }
+}
+
+static const char* shadow_cache_label(ShadowCacheResult r)
+{
+    switch (r) {
+    case ShadowCacheResult::Reused: return "reused";
+    case ShadowCacheResult::Copied: return "cache + dynamic";
+    default:                        return "re-rendered";
+    }
 }
 
 // ─── Main render ─────────────────────────────────────────────────────────────
@@ -90,6 +82,7 @@ void debug_ui_render(Engine* e)
             ImGui::MenuItem("Performance", nullptr, &g_debugUI.show_performance);
             ImGui::MenuItem("Scene", nullptr, &g_debugUI.show_scene_debug);
             ImGui::MenuItem("Renderer Stats", nullptr, &g_debugUI.show_renderer_stats);
+            ImGui::MenuItem("GPU Profiler", nullptr, &g_debugUI.show_gpu_profiler);
             ImGui::MenuItem("Memory Stats", nullptr, &g_debugUI.show_memory_stats);
             ImGui::MenuItem("Log Console", nullptr, &g_debugUI.show_log_console);
             ImGui::MenuItem("Input Debug", nullptr, &g_debugUI.show_input_debug);
@@ -107,14 +100,16 @@ void debug_ui_render(Engine* e)
             ImGui::EndMenu();
         }
 
-        // Live FPS in menu bar
-        float fps = (g_debugUI.avgFrameTime > 0.01f)
-            ? 1000.0f / g_debugUI.avgFrameTime : 0.0f;
+        // Live FPS in menu bar, from the telemetry window
+        const TelemetrySeries* frame = e ? e->telemetry.frame : nullptr;
+        const float avgFrameTime = frame ? frame->windowStats.avg : 0.0f;
+        float fps = (avgFrameTime > 0.01f)
+            ? 1000.0f / avgFrameTime : 0.0f;
         ImVec4 col = fps >= 55 ? ImVec4(0.2f, 1.0f, 0.2f, 1.0f)
             : fps >= 30 ? ImVec4(1.0f, 1.0f, 0.1f, 1.0f)
             : ImVec4(1.0f, 0.2f, 0.2f, 1.0f);
         ImGui::PushStyleColor(ImGuiCol_Text, col);
-        ImGui::Text("  %.0f FPS  (%.2f ms)", fps, g_debugUI.avgFrameTime);
+        ImGui::Text("  %.0f FPS  (%.2f ms)", fps, avgFrameTime);
         ImGui::PopStyleColor();
 
         // Draw calls always visible in menu bar
@@ -129,6 +124,16 @@ void debug_ui_render(Engine* e)
                     else snprintf(buf, sizeof(buf), "%u", n);
                     return buf;
                 }(e->lastTriangles));
+
+            // Shadow cache hit per cascade
+            if (e->shadowCache.enabled) {
+                ImGui::TextDisabled("  Shadows:");
+                for (uint32_t c = 0; c < e->shadowCascades.count; ++c) {
+                    ShadowCacheResult r = e->shadowCache.result[c];
+                    ImGui::SameLine();
+                    ImGui::TextColored(shadow_cache_colour(r), "%s", r == ShadowCacheResult::Refreshed ? "MISS" : "HIT");
+                }
+            }
         }
 
         ImGui::EndMainMenuBar();
@@ -137,6 +142,7 @@ void debug_ui_render(Engine* e)
     if (g_debugUI.show_performance)     debug_ui_render_performance_window();
     if (g_debugUI.show_scene_debug)     debug_ui_render_scene_debug_window(e);
     if (g_debugUI.show_renderer_stats)  debug_ui_render_renderer_stats_window(e);
+    if (g_debugUI.show_gpu_profiler)    debug_ui_render_gpu_profiler_window(e);
     if (g_debugUI.show_memory_stats)    debug_ui_render_memory_stats_window(e);
     if (g_debugUI.show_log_console)     debug_ui_render_log_console_window();
     if (g_debugUI.show_input_debug)     debug_ui_render_input_debug_window();
@@ -151,16 +157,113 @@ void debug_ui_render_performance_window()
     ImGui::Begin("Performance", &g_debugUI.show_performance,
         ImGuiWindowFlags_AlwaysAutoResize);
 
-    ImGui::Text("Avg: %.2f ms   Min: %.2f   Max: %.2f",
-        g_debugUI.avgFrameTime, g_debugUI.minFrameTime, g_debugUI.maxFrameTime);
+    // ── Telemetry: the last TELEMETRY_WINDOW frames, read in place ───────────
+    const TelemetryState* t = s_engine ? &s_engine->telemetry : nullptr;
+    if (t && t->frame && t->frame->count) {
+        const TelemetrySeries& f = *t->frame;
+        const TelemetryStats&  w = f.windowStats;
+        ImGui::Text("Avg: %.2f ms   Min: %.2f   Max: %.2f", w.avg, w.min, w.max);
+        ImGui::Text("p50 %.2f   p95 %.2f   p99 %.2f ms   (lifetime p99 %.2f)",
+            w.p50, w.p95, w.p99, f.lifetimeStats.p99);
+        ImGui::Text("Hitches: %u in window, %llu total", t->hitchesInWindow, (unsigned long long)t->hitches);
+        if (t->hitches) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(last %.1f ms, frame %llu)", t->lastHitchMs, (unsigned long long)t->lastHitchFrame);
+        }
+
+        float maxScale = std::max(w.max * 1.3f, 5.0f);
+        ImGui::PlotLines("##frametimes", f.samples, (int)f.count, (int)f.offset(),
+            "Frame Time (ms)", 0.0f, maxScale, ImVec2(400, 80));
+
+        // CPU phases and GPU passes, window stats
+        if (ImGui::CollapsingHeader("Phases and passes") &&
+            ImGui::BeginTable("##telemetry", 6, ImGuiTableFlags_RowBg | ImGuiTableFlags_SizingFixedFit)) {
+            ImGui::TableSetupColumn("Series");
+            ImGui::TableSetupColumn("Last");
+            ImGui::TableSetupColumn("Avg");
+            ImGui::TableSetupColumn("p50");
+            ImGui::TableSetupColumn("p95");
+            ImGui::TableSetupColumn("p99");
+            ImGui::TableHeadersRow();
+            for (const auto& s : t->series) {
+                if (s->kind == TelemetryKind::Frame || !s->count) continue;
+                const TelemetryStats& st = s->windowStats;
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("%s %s", s->kind == TelemetryKind::Gpu ? "gpu" : "cpu", s->name.c_str());
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", s->last);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", st.avg);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", st.p50);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", st.p95);
+                ImGui::TableNextColumn(); ImGui::Text("%.2f", st.p99);
+            }
+            ImGui::EndTable();
+        }
+        if (ImGui::Button("Reset telemetry")) telemetry_reset(s_engine);
+    }
+    else {
+        ImGui::TextDisabled("(no frames yet)");
+    }
+
+    // ── Frame pacing ──────────────────────────────────────────────────────────
+    if (s_engine) {
+        FramePacingState& fp = s_engine->framePacing;
+        ImGui::Separator();
+        if (ImGui::BeginCombo("Present mode", present_mode_name(fp.presentMode))) {
+            for (VkPresentModeKHR mode : { VK_PRESENT_MODE_FIFO_KHR, VK_PRESENT_MODE_FIFO_RELAXED_KHR,
+                                           VK_PRESENT_MODE_MAILBOX_KHR, VK_PRESENT_MODE_IMMEDIATE_KHR }) {
+                const bool supported = std::find(fp.supportedModes.begin(), fp.supportedModes.end(), mode)
+                    != fp.supportedModes.end();
+                if (ImGui::Selectable(present_mode_name(mode), mode == fp.presentMode,
+                    supported ? 0 : ImGuiSelectableFlags_Disabled))
+                    frame_pacing_set_present_mode(s_engine, mode);
+            }
+            ImGui::EndCombo();
+        }
+        if (fp.activePresentMode != fp.presentMode) {
+            ImGui::SameLine();
+            ImGui::TextDisabled("(running %s)", present_mode_name(fp.activePresentMode));
+        }
+        ImGui::SliderFloat("Frame cap", &fp.frameCap, 0.0f, 360.0f, fp.frameCap > 0.0f ? "%.0f fps" : "off");
+        ImGui::SliderFloat("Spin tail ms", &fp.spinMs, 0.0f, 4.0f, "%.1f");
+        FrameSchedulerState& sched = s_engine->scheduler;
+        int inFlight = (int)sched.framesInFlight;
+        if (ImGui::SliderInt("Frames in flight", &inFlight, 1, (int)FRAME_OVERLAP))
+            sched.framesInFlight = (uint32_t)inFlight;
+        ImGui::BeginDisabled(!fp.presentWaitSupported);
+        ImGui::Checkbox("Low latency (present wait)", &fp.lowLatency);
+        ImGui::EndDisabled();
+
+        ImGui::Text("Interval %.2f ms   stddev %.2f   worst %.2f   limiter %.2f ms",
+            fp.meanIntervalMs, fp.intervalStdDevMs, fp.worstIntervalMs, fp.limiterWaitMs);
+        ImGui::Text("CPU blocked: GPU %.2f ms   acquire %.2f ms   (timeline %llu/%llu, %u retired)",
+            sched.gpuWaitMs, sched.acquireWaitMs, (unsigned long long)sched.completed,
+            (unsigned long long)sched.submitted, sched.retiredLastFrame);
+        ImGui::Text("Input-to-present %.1f ms (%s)", fp.latencyMs,
+            fp.latencyMeasured ? "measured" : "estimated");
+        ImGui::PlotLines("##pacing", fp.intervalHistory, (int)PACING_HISTORY, (int)fp.historyHead,
+            "Frame interval (ms)", 0.0f, std::max(fp.worstIntervalMs * 1.2f, 5.0f), ImVec2(400, 60));
+        ImGui::PlotLines("##latency", fp.latencyHistory, (int)PACING_HISTORY, (int)fp.historyHead,
+            "Latency (ms)", 0.0f, std::max(fp.latencyMs * 2.0f, 10.0f), ImVec2(400, 50));
+    }
 
-    float maxScale = std::max(g_debugUI.maxFrameTime * 1.3f, 5.0f);
-    ImGui::PlotLines("##frametimes", g_debugUI.frameTimes.data(),
-        (int)g_debugUI.frameTimes.size(), 0, "Frame Time (ms)", 0.0f, maxScale,
-        ImVec2(400, 80));
-    ImGui::PlotHistogram("##fps", g_debugUI.fpsHistory.data(),
-        (int)g_debugUI.fpsHistory.size(), 0, "FPS", 0.0f, 165.0f,
-        ImVec2(400, 60));
+    // ── CPU trace ─────────────────────────────────────────────────────────────
+    ImGui::Separator();
+#if SYNCHRONA_ZONES
+    CpuProfilerStatus trace = cpu_profiler_status();
+    ImGui::BeginDisabled(trace.capturing);
+    ImGui::SliderInt("Trace frames", &g_debugUI.traceFrames, 1, 600);
+    ImGui::SameLine();
+    if (ImGui::Button("Capture CPU trace"))
+        cpu_profiler_capture((uint32_t)g_debugUI.traceFrames, "cpu_trace.json");
+    ImGui::EndDisabled();
+    if (trace.capturing)
+        ImGui::Text("Capturing... %u frames left", trace.framesLeft);
+    else if (!trace.lastPath.empty())
+        ImGui::TextDisabled("%s: %llu zones, %u threads, %llu dropped", trace.lastPath.c_str(),
+            (unsigned long long)trace.lastZones, trace.lastThreads, (unsigned long long)trace.lastDropped);
+#else
+    ImGui::TextDisabled("CPU zones compiled out (SYNCHRONA_PROFILE_ZONES=OFF)");
+#endif
 
     ImGui::End();
 }
@@ -230,6 +333,23 @@ void debug_ui_render_scene_debug_window(Engine* e)
         ImGui::Text("Position: (%.2f, %.2f, %.2f)", p.x, p.y, p.z);
         ImGui::Text("Yaw: %.1f   Pitch: %.1f",
             e->mainCamera.yaw, e->mainCamera.pitch);
+
+        // Flythroughs for the benchmark runner's manifest
+        CameraPathState& cp = e->cameraPath;
+        ImGui::InputText("Path file", g_debugUI.cameraPathFile, sizeof(g_debugUI.cameraPathFile));
+        ImGui::SliderFloat("Key interval (s)", &cp.interval, 0.02f, 1.0f, "%.2f");
+        if (!cp.recording) {
+            if (ImGui::Button("Record camera path")) camera_path_record_start(e);
+            if (!cp.lastSaved.empty()) {
+                ImGui::SameLine();
+                ImGui::TextDisabled("last: %s", cp.lastSaved.c_str());
+            }
+        }
+        else {
+            if (ImGui::Button("Stop and save")) camera_path_record_stop(e, g_debugUI.cameraPathFile);
+            ImGui::SameLine();
+            ImGui::Text("%.1f s, %zu keys", cp.elapsed, cp.path.keys.size());
+        }
     }
 
     ImGui::End();
@@ -253,13 +373,298 @@ void debug_ui_render_renderer_stats_window(Engine* e)
     else
         ImGui::Text("Triangles:        %u", t);
 
+    ImGui::Separator();
+    ImGui::Checkbox("Frustum culling", &e->culling.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%s, %.3f ms)", cull_simd_name(), e->culling.cpuMs);
+    ImGui::Text("Main pass:    %u / %u surfaces",
+        e->culling.camera.visibleCount, e->culling.scene.count);
+    ImGui::Text("Shadow pass:  %u / %u surfaces",
+        e->culling.shadow.visibleCount, e->culling.scene.count);
+    for (uint32_t c = 0; c < e->shadowCascades.count; ++c)
+        ImGui::Text("  cascade %u:  %u", c, e->culling.cascades[c].visibleCount);
+    ImGui::Separator();
+
+    RenderQueueState& rq = e->renderQueue;
+    ImGui::Checkbox("Front-to-back sort", &rq.frontToBack);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(build %.3f ms, radix %.3f ms)", rq.buildMs, rq.sortMs);
+    ImGui::Checkbox("Instanced batching", &rq.instancing);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%.3f ms)", rq.batchMs);
+    ImGui::Text("Main pass:    %u draws / %u instances, %u pipeline / %u buffer binds, %u pushes",
+        rq.cameraStats.draws, rq.cameraStats.instances, rq.cameraStats.pipelineBinds,
+        rq.cameraStats.bufferBinds, rq.cameraStats.pushes);
+    ImGui::Text("Shadow pass:  %u draws / %u instances, %u pipeline / %u buffer binds, %u pushes",
+        rq.shadowStats.draws, rq.shadowStats.instances, rq.shadowStats.pipelineBinds,
+        rq.shadowStats.bufferBinds, rq.shadowStats.pushes);
+    ImGui::Text("Materials:    %u unique   Geometry: %u unique / %zu assets",
+        rq.materialCount, rq.geometryCount, e->testMeshes.size());
+    ImGui::Separator();
+
+    ParallelRecordState& pr = e->parallelRecord;
+    ImGui::Checkbox("Parallel recording", &pr.enabled);
+    if (pr.enabled) {
+        int batch = (int)pr.batch;
+        if (ImGui::SliderInt("Packets / secondary", &batch, 16, 4096))
+            pr.batch = (uint32_t)batch;
+        ImGui::Text("Secondaries:  %u", pr.secondaries);
+        for (size_t t = 0; t < pr.threadMs.size(); ++t)
+            ImGui::Text("  %s %2zu: %.3f ms", t == 0 ? "main  " : "worker", t, pr.threadMs[t]);
+    }
+    ImGui::Separator();
+
+    DepthPrepassState& dp = e->depthPrepass;
+    ImGui::Checkbox("Depth pre-pass", &dp.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(colour pass tests EQUAL)");
+    const float prepassMs = gpu_profiler_ms(e, "depth pre-pass"), colourMs = gpu_profiler_ms(e, "colour");
+    ImGui::Text("GPU pre-pass: %.3f ms   colour: %.3f ms   total: %.3f ms",
+        prepassMs, colourMs, prepassMs + colourMs);
+    if (dp.enabled)
+        ImGui::Text("Pre-pass:     %u draws / %u instances, %u tris, %u pipeline binds",
+            rq.depthStats.draws, rq.depthStats.instances, rq.depth.triangles, rq.depthStats.pipelineBinds);
+    ImGui::Separator();
+
+    ShadowCascadeState& sc = e->shadowCascades;
+    int cascades = (int)sc.count;
+    if (ImGui::SliderInt("Shadow cascades", &cascades, 1, (int)MAX_SHADOW_CASCADES))
+        sc.count = (uint32_t)cascades;
+    ImGui::SliderFloat("Shadow distance", &sc.distance, 10.0f, 1000.0f, "%.0f", ImGuiSliderFlags_Logarithmic);
+    ImGui::SliderFloat("Split lambda", &sc.lambda, 0.0f, 1.0f);
+    ImGui::SliderFloat("Cascade blend", &sc.blend, 0.0f, 0.5f);
+    ImGui::Text("GPU shadow pass: %.3f ms  (%ux%u per cascade)",
+        gpu_profiler_ms(e, "shadow"), e->shadowMapImage.imageExtent.width, e->shadowMapImage.imageExtent.height);
+    for (uint32_t c = 0; c < sc.count; ++c)
+        ImGui::Text("  %u: to %6.1f  %6.1f texels/unit  %u draws / %u instances",
+            c, sc.splitFar[c], sc.texelWorld[c] > 0.0f ? 1.0f / sc.texelWorld[c] : 0.0f,
+            rq.cascadeStats[c].draws, rq.cascadeStats[c].instances);
+    ImGui::TextDisabled("(old single map: 25.6 texels/unit over a fixed 80x80 area)");
+
+    ShadowCacheState& cache = e->shadowCache;
+    ImGui::Checkbox("Cache static shadows", &cache.enabled);
+    ImGui::SameLine();
+    ImGui::Checkbox("Stagger cascades", &cache.stagger);
+    ImGui::SliderFloat("Cascade margin", &cache.margin, 0.0f, 0.5f);
+    if (cache.enabled) {
+        uint64_t total = cache.hits + cache.misses;
+        ImGui::Text("Shadow cache: %llu hits / %llu misses (%.1f%%)",
+            (unsigned long long)cache.hits, (unsigned long long)cache.misses,
+            total ? 100.0 * (double)cache.hits / (double)total : 0.0);
+        for (uint32_t c = 0; c < sc.count; ++c) {
+            ImGui::Text("  %u:", c);
+            ImGui::SameLine();
+            ImGui::TextColored(shadow_cache_colour(cache.result[c]), "%-16s", shadow_cache_label(cache.result[c]));
+            ImGui::SameLine();
+            ImGui::TextDisabled("%u static / %u dynamic casters",
+                (uint32_t)rq.shadowStatic[c].packets.size(), (uint32_t)rq.shadow[c].packets.size());
+        }
+    }
+    ImGui::Separator();
+
+    DynamicResolutionState& dr = e->dynamicRes;
+    ImGui::Checkbox("Dynamic resolution", &dr.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%ux%u, %.0f%%)", e->drawExtent.width, e->drawExtent.height,
+        100.0f * (float)e->drawExtent.width / (float)std::max(1u, e->drawImage.imageExtent.width));
+    ImGui::SliderFloat("Target GPU ms", &dr.targetMs, 4.0f, 50.0f, "%.1f");
+    ImGui::SliderFloat("Min scale", &dr.minScale, 0.25f, 1.0f);
+    ImGui::SliderFloat("Max scale", &dr.maxScale, 0.25f, 1.0f);
+    ImGui::SliderFloat("Upscale sharpness", &dr.sharpness, 0.0f, 1.0f);
+    ImGui::Text("GPU frame: %.2f ms (smoothed %.2f)   extent changes: %u",
+        dr.gpuMs, dr.smoothedMs, dr.extentChanges);
+    ImGui::PlotLines("##drsScale", dr.scaleHistory, (int)DRS_HISTORY, (int)dr.historyHead,
+        "Render scale", 0.0f, 1.0f, ImVec2(400, 50));
+    ImGui::PlotLines("##drsGpu", dr.gpuMsHistory, (int)DRS_HISTORY, (int)dr.historyHead,
+        "GPU ms", 0.0f, dr.targetMs * 2.0f, ImVec2(400, 50));
+    ImGui::Separator();
+
+    TaaState& taa = e->taa;
+    int aaMode = (int)taa.requested;
+    const char* aaModes[] = { "8x MSAA", "TAA" };
+    if (ImGui::Combo("Anti-aliasing", &aaMode, aaModes, 2))
+        taa.requested = (AntiAliasing)aaMode;
+    if (taa.mode == AntiAliasing::Taa) {
+        ImGui::SliderFloat("History feedback", &taa.feedback, 0.5f, 0.98f);
+        ImGui::SliderFloat("Jitter", &taa.jitterScale, 0.0f, 1.0f);
+        ImGui::TextDisabled("(GPU occlusion culling is MSAA-only)");
+    }
+    // Each mode's last measured cost; GPU time depends on the DRS scale it ran at
+    auto mb = [](VkDeviceSize bytes) { return (double)bytes / (1024.0 * 1024.0); };
+    for (uint32_t m = 0; m < 2; ++m) {
+        const AntiAliasingStats& s = taa.stats[m];
+        if (!s.sampled) {
+            ImGui::TextDisabled("%-8s  not measured yet", aaModes[m]);
+            continue;
+        }
+        ImGui::Text("%-8s  VRAM %6.1f MB (targets %.1f + history %.1f)   GPU %5.2f ms @ %.0f%%",
+            aaModes[m], mb(s.transientBytes + s.historyBytes), mb(s.transientBytes), mb(s.historyBytes),
+            s.gpuMs, 100.0f * s.renderScale);
+    }
+    ImGui::Separator();
+
+    VisibilityBufferState& vb = e->visibility;
+    int path = (int)vb.requested;
+    const char* paths[] = { "Forward", "Visibility buffer" };
+    if (ImGui::Combo("Render path", &path, paths, 2))
+        vb.requested = (RenderPath)path;
+    if (vb.path == RenderPath::VisibilityBuffer) {
+        ImGui::Text("Ids %.3f ms   Binning %.3f ms   Shade %.3f ms", gpu_profiler_ms(e, "visibility"),
+            gpu_profiler_ms(e, "material binning"), gpu_profiler_ms(e, "material shade"));
+        ImGui::Text("Tiles: %u shaded, %u mixed-material (%.1f%%)", vb.tiles, vb.mixedTiles,
+            vb.tiles > 0 ? 100.0 * vb.mixedTiles / vb.tiles : 0.0);
+        ImGui::Text("Items: %u, %u materials, %u triangle bits", vb.itemCount, vb.materialCount, vb.triangleBits);
+        ImGui::TextDisabled("(single-sampled — use TAA; no pre-pass / GPU culling)");
+    }
+    // Each path's last measured cost; GPU time depends on the DRS scale it ran at
+    for (uint32_t p = 0; p < 2; ++p) {
+        const RenderPathStats& s = vb.stats[p];
+        if (!s.sampled) {
+            ImGui::TextDisabled("%-17s  not measured yet", paths[p]);
+            continue;
+        }
+        ImGui::Text("%-17s  GPU %5.2f ms @ %.0f%%   %u draws, %u tris",
+            paths[p], s.gpuMs, 100.0f * s.renderScale, s.drawCalls, s.triangles);
+    }
+    ImGui::Separator();
+
+    ClusteredLightingState& cl = e->clusteredLighting;
+    ImGui::Checkbox("Clustered lights", &cl.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%ux%ux%u, %u per cluster)", CLUSTER_GRID_X, CLUSTER_GRID_Y, CLUSTER_GRID_Z, CLUSTER_MAX_LIGHTS);
+    if (cl.enabled) {
+        int lightCount = (int)cl.lightCount;
+        if (ImGui::SliderInt("Lights", &lightCount, 0, (int)MAX_CLUSTERED_LIGHTS, "%d", ImGuiSliderFlags_Logarithmic))
+            cl.lightCount = (uint32_t)lightCount;
+        ImGui::SliderFloat("Light range", &cl.rangeScale, 0.005f, 0.2f, "%.3f x scene", ImGuiSliderFlags_Logarithmic);
+        ImGui::SliderFloat("Light intensity", &cl.intensity, 0.0f, 50.0f);
+        ImGui::Checkbox("Animate", &cl.animate);
+        ImGui::SameLine();
+        if (ImGui::Button("Reseed"))
+            cl.seed++;
+        ImGui::DragFloatRange2("Log slices", &cl.sliceNear, &cl.sliceFar, 0.5f, 0.05f, 5000.0f, "near %.2f", "far %.0f");
+        ImGui::Text("Binning %.3f ms   %u indices   %u/%u clusters lit",
+            gpu_profiler_ms(e, "light culling"), cl.indexCount, cl.occupiedClusters, CLUSTER_COUNT);
+        ImGui::Text("Max in a cluster: %u   Over capacity: %u clusters", cl.maxPerCluster, cl.overflowClusters);
+
+        ImGui::Checkbox("Heatmap overlay", &cl.heatmapOverlay);
+        ImGui::SliderFloat("Heatmap max", &cl.heatmapMax, 1.0f, (float)CLUSTER_MAX_LIGHTS, "%.0f lights");
+        int slice = (int)cl.heatmapSlice;
+        if (ImGui::SliderInt("Depth slice", &slice, 0, (int)CLUSTER_GRID_Z - 1))
+            cl.heatmapSlice = (uint32_t)slice;
+
+        // Screen grid of the chosen slice, then the busiest cluster of every slice
+        ImDrawList* dl = ImGui::GetWindowDrawList();
+        const float cell = 14.0f;
+        const float limit = std::max(cl.heatmapMax, 1.0f);
+        auto heat = [limit](uint32_t n) {
+            if (n == 0) return IM_COL32(20, 20, 30, 255);
+            const float t = std::min((float)n / limit, 1.0f);
+            return ImGui::ColorConvertFloat4ToU32(ImVec4(t, 1.0f - std::abs(2.0f * t - 1.0f), 1.0f - t, 1.0f));
+        };
+        ImVec2 origin = ImGui::GetCursorScreenPos();
+        for (uint32_t y = 0; y < CLUSTER_GRID_Y; ++y)
+            for (uint32_t x = 0; x < CLUSTER_GRID_X; ++x) {
+                const uint32_t n = cl.counts[(cl.heatmapSlice * CLUSTER_GRID_Y + y) * CLUSTER_GRID_X + x];
+                const ImVec2 p0(origin.x + x * cell, origin.y + y * cell);
+                dl->AddRectFilled(p0, ImVec2(p0.x + cell - 1.0f, p0.y + cell - 1.0f), heat(n));
+            }
+        ImGui::Dummy(ImVec2(CLUSTER_GRID_X * cell, CLUSTER_GRID_Y * cell));
+
+        origin = ImGui::GetCursorScreenPos();
+        for (uint32_t z = 0; z < CLUSTER_GRID_Z; ++z) {
+            const auto first = cl.counts.begin() + z * CLUSTER_GRID_X * CLUSTER_GRID_Y;
+            const uint32_t n = *std::max_element(first, first + CLUSTER_GRID_X * CLUSTER_GRID_Y);
+            const ImVec2 p0(origin.x + z * cell, origin.y);
+            dl->AddRectFilled(p0, ImVec2(p0.x + cell - 1.0f, p0.y + cell - 1.0f), heat(n));
+            if (z == cl.heatmapSlice)
+                dl->AddRect(p0, ImVec2(p0.x + cell - 1.0f, p0.y + cell - 1.0f), IM_COL32(255, 255, 255, 255));
+        }
+        ImGui::Dummy(ImVec2(CLUSTER_GRID_Z * cell, cell));
+        ImGui::TextDisabled("(slice %u; strip = busiest cluster per depth slice)", cl.heatmapSlice);
+    }
+    ImGui::Separator();
+
+    RenderGraphState& rg = e->renderGraph;
+    ImGui::Text("Render graph: %zu passes (%u culled), %u barriers",
+        rg.passes.size(), rg.culledPasses, rg.barriers);
+    ImGui::Text("Transients:   %zu images, %.1f MB (%.1f MB unaliased), placed %u times",
+        rg.transients.size(), (double)rg.memorySize / (1024.0 * 1024.0),
+        (double)rg.unaliasedSize / (1024.0 * 1024.0), rg.placements);
+    ImGui::Checkbox("Alias transients", &rg.aliasing);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(pipeline cache %s, %u pipelines, %.1f ms total CPU)",
+        e->pipelineCache.warm ? "warm" : "cold", e->pipelineCache.pipelines, e->pipelineCache.createMs);
+    ImGui::SameLine();
+    if (ImGui::Button("Dump render graph"))
+        rg.dumpRequested = true;
+    ImGui::Separator();
+
+    DrawCacheState& dc = e->drawCache;
+    ImGui::Checkbox("Cache static passes", &dc.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(scene v%llu)", (unsigned long long)dc.sceneVersion);
+    if (dc.enabled) {
+        ImGui::Text("Main pass:    %s (%zu static packets)",
+            dc.hitOpaque ? "replayed" : "re-recorded", dc.staticOpaque.packets.size());
+        ImGui::Text("Shadow pass:  %s (%zu static packets)",
+            dc.hitShadow ? "replayed" : "re-recorded", dc.staticShadow.packets.size());
+        ImGui::Text("Re-recordings: %u (last %.3f ms)", dc.rebuilds, dc.lastRecordMs);
+        if (ImGui::Button("Invalidate"))
+            mark_scene_dirty(e);
+    }
+    ImGui::Separator();
+
+    SoftwareOcclusionState& so = e->swOcclusion;
+    ImGui::Checkbox("CPU occlusion culling", &so.enabled);
+    ImGui::SameLine();
+    ImGui::TextDisabled("(%s, %ux%u)", swoc_simd_name(), SWOC_WIDTH, SWOC_HEIGHT);
+    if (so.enabled) {
+        ImGui::Checkbox("Shadow casters too", &so.shadowView);
+        int maxOccluders = (int)so.maxOccluders;
+        if (ImGui::SliderInt("Max occluders", &maxOccluders, 1, 256))
+            so.maxOccluders = (uint32_t)maxOccluders;
+        ImGui::SliderFloat("Min occluder area", &so.minOccluderArea, 0.001f, 0.2f, "%.3f");
+        ImGui::Text("Raster: %.3f ms   Test: %.3f ms", so.rasterMs, so.testMs);
+        ImGui::Text("Main pass:    %u culled (%u occluders, %u tris)",
+            so.camera.culled, so.camera.occluders, so.camera.triangles);
+        ImGui::Text("Shadow pass:  %u culled (%u occluders, %u tris)",
+            so.shadow.culled, so.shadow.occluders, so.shadow.triangles);
+    }
+    ImGui::Separator();
+
+    GpuCullingState& gc = e->gpuCulling;
+    ImGui::Checkbox("GPU occlusion culling", &gc.enabled);
+    if (gc.enabled) {
+        ImGui::SameLine();
+        ImGui::BeginDisabled(!gc.occlusionSupported);
+        ImGui::Checkbox("Hi-Z", &gc.occlusion);
+        ImGui::EndDisabled();
+
+        int granularity = (int)gc.granularity;
+        const char* granularities[] = { "Per object", "Per cluster" };
+        if (ImGui::Combo("Granularity", &granularity, granularities, 2))
+            gc.granularity = (GpuCullGranularity)granularity;
+
+        ImGui::Text("Items:        %u", gc.itemCount);
+        ImGui::Text("Early / late: %u / %u drawn",
+            gc.stats.earlyDrawn, gc.stats.lateDrawn);
+        ImGui::Text("Culled:       %u frustum, %u occlusion",
+            gc.stats.frustumCulled, gc.stats.occlusionCulled);
+        ImGui::Text("Hi-Z build:   %.3f ms (%u mips, depth resolve %s)",
+            gpu_profiler_ms(e, "hi-z pyramid"), gc.pyramidMips,
+            gc.depthResolveMode == VK_RESOLVE_MODE_MAX_BIT ? "MAX" : "SAMPLE_ZERO");
+    }
+    ImGui::Separator();
+
     ImGui::Text("Textures (bindless): %u / 4096", e->nextBindlessTextureIndex);
     ImGui::Text("Mesh assets:         %zu", e->testMeshes.size());
     ImGui::Text("Frame #:             %d", e->frameNumber);
     ImGui::Text("Frame overlap:       %d", FRAME_OVERLAP);
 
     ImGui::Separator();
-    ImGui::Text("Draw image:   %ux%u  R16G16B16A16_SFLOAT",
+    ImGui::Text("Draw image:   %ux%u  R16G16B16A16_SFLOAT, rendering %ux%u",
+        e->drawImage.imageExtent.width, e->drawImage.imageExtent.height,
         e->drawExtent.width, e->drawExtent.height);
     ImGui::Text("Swapchain:    %ux%u",
         e->swapchainExtent.width, e->swapchainExtent.height);
@@ -267,6 +672,111 @@ void debug_ui_render_renderer_stats_window(Engine* e)
     ImGui::End();
 }
 
+// ─── GPU profiler panel ──────────────────────────────────────────────────────
+static const char* format_count(uint64_t n)
+{
+    static char buf[4][32];
+    static int  next = 0;
+    char* out = buf[next++ & 3];
+    if (n >= 1000000) snprintf(out, 32, "%.1fM", n / 1000000.0);
+    else if (n >= 1000) snprintf(out, 32, "%.1fK", n / 1000.0);
+    else snprintf(out, 32, "%llu", (unsigned long long)n);
+    return out;
+}
+
+void debug_ui_render_gpu_profiler_window(Engine* e)
+{
+    ImGui::Begin("GPU Profiler", &g_debugUI.show_gpu_profiler);
+    if (!e) { ImGui::End(); return; }
+
+    GpuProfilerState& gp = e->gpuProfiler;
+    ImGui::Checkbox("Enabled", &gp.enabled);
+    ImGui::SameLine();
+    ImGui::BeginDisabled(!gp.statisticsSupported);
+    ImGui::Checkbox("Pipeline statistics", &gp.statistics);
+    ImGui::EndDisabled();
+    ImGui::SameLine();
+    if (ImGui::Button("Dump CSV") && gpu_profiler_dump_csv(e, "gpu_profile.csv"))
+        LOG("GPU profile written to gpu_profile.csv");
+    ImGui::SliderFloat("Smoothing", &gp.smoothing, 0.01f, 1.0f, "%.2f");
+
+    if (gp.results.empty()) {
+        ImGui::TextDisabled("(no frame resolved yet)");
+        ImGui::End();
+        return;
+    }
+    const float frameMs = std::max(gp.results[0].ms, 0.001f);
+    ImGui::Text("Frame %d: %.3f ms GPU (avg %.3f)", gp.resultFrame, gp.results[0].ms, gp.results[0].avgMs);
+    if (gp.droppedScopes > 0) {
+        ImGui::SameLine();
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%u scopes over budget", gp.droppedScopes);
+    }
+
+    // ── Timeline: one row per depth, bars placed by start time
+    uint32_t maxDepth = 0;
+    for (const GpuScopeResult& r : gp.results) maxDepth = std::max(maxDepth, r.depth);
+
+    const float  rowH = ImGui::GetTextLineHeight() + 4.0f;
+    const float  width = std::max(ImGui::GetContentRegionAvail().x, 100.0f);
+    const ImVec2 origin = ImGui::GetCursorScreenPos();
+    ImDrawList*  dl = ImGui::GetWindowDrawList();
+    for (uint32_t i = 0; i < (uint32_t)gp.results.size(); ++i) {
+        const GpuScopeResult& r = gp.results[i];
+        const float x0 = origin.x + width * std::clamp(r.startMs / frameMs, 0.0f, 1.0f);
+        const float x1 = origin.x + width * std::clamp((r.startMs + r.ms) / frameMs, 0.0f, 1.0f);
+        const ImVec2 p0(x0, origin.y + r.depth * rowH);
+        const ImVec2 p1(std::max(x1, x0 + 1.0f), p0.y + rowH - 1.0f);
+
+        const float hue = (float)((i * 0.618034) - std::floor(i * 0.618034));
+        ImVec4 colour;
+        ImGui::ColorConvertHSVtoRGB(hue, 0.55f, 0.75f, colour.x, colour.y, colour.z);
+        colour.w = 1.0f;
+        dl->AddRectFilled(p0, p1, ImGui::GetColorU32(colour));
+        dl->PushClipRect(p0, p1, true);
+        dl->AddText(ImVec2(p0.x + 3.0f, p0.y + 2.0f), IM_COL32(0, 0, 0, 255), r.name.c_str());
+        dl->PopClipRect();
+        if (ImGui::IsMouseHoveringRect(p0, p1))
+            ImGui::SetTooltip("%s\n%.3f ms (avg %.3f)\nstarts at %.3f ms", r.name.c_str(), r.ms, r.avgMs, r.startMs);
+    }
+    ImGui::Dummy(ImVec2(width, (maxDepth + 1) * rowH));
+
+    // ── Table, indented by depth
+    const bool statistics = gp.statisticsSupported;
+    if (ImGui::BeginTable("##gpuscopes", statistics ? 6 : 3,
+        ImGuiTableFlags_RowBg | ImGuiTableFlags_BordersInnerV | ImGuiTableFlags_SizingFixedFit)) {
+        ImGui::TableSetupColumn("Scope", ImGuiTableColumnFlags_WidthStretch);
+        ImGui::TableSetupColumn("ms");
+        ImGui::TableSetupColumn("avg ms");
+        if (statistics) {
+            ImGui::TableSetupColumn("Prims");
+            ImGui::TableSetupColumn("VS");
+            ImGui::TableSetupColumn("FS");
+        }
+        ImGui::TableHeadersRow();
+
+        for (const GpuScopeResult& r : gp.results) {
+            ImGui::TableNextRow();
+            ImGui::TableNextColumn();
+            if (r.depth > 0) ImGui::Indent(r.depth * 12.0f);
+            ImGui::TextUnformatted(r.name.c_str());
+            if (r.depth > 0) ImGui::Unindent(r.depth * 12.0f);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", r.ms);
+            ImGui::TableNextColumn();
+            ImGui::Text("%.3f", r.avgMs);
+            if (statistics) {
+                for (uint32_t c = 0; c < GPU_PROFILER_STATISTICS; ++c) {
+                    ImGui::TableNextColumn();
+                    if (r.hasStatistics) ImGui::TextUnformatted(format_count(r.statistics[c]));
+                }
+            }
+        }
+        ImGui::EndTable();
+    }
+
+    ImGui::End();
+}
+
 // ─── Memory stats panel ──────────────────────────────────────────────────────
 void debug_ui_render_memory_stats_window(Engine* e)
 {
@@ -355,17 +865,35 @@ void debug_ui_render_log_console_window()
 {
     ImGui::Begin("Log Console", &g_debugUI.show_log_console);
 
-    if (ImGui::Button("Clear")) g_debugUI.logMessages.clear();
+    if (ImGui::Button("Clear")) log_console_clear();
     ImGui::SameLine();
     ImGui::Checkbox("Auto Scroll", &g_debugUI.autoScrollLog);
+    ImGui::SameLine();
+    ImGui::SetNextItemWidth(90);
+    ImGui::Combo("Level", &g_debugUI.logShowLevel, "trace\0debug\0info\0warn\0error\0");
     g_debugUI.logFilter.Draw("Filter", 200);
 
+    const LogStats stats = log_stats();
+    if (stats.dropped)
+        ImGui::TextColored(ImVec4(1.0f, 0.6f, 0.2f, 1.0f), "%llu messages dropped (ring full)",
+            (unsigned long long)stats.dropped);
+
     ImGui::Separator();
     ImGui::BeginChild("##logscroll", ImVec2(0, 0), false,
         ImGuiWindowFlags_HorizontalScrollbar);
-    for (const auto& msg : g_debugUI.logMessages)
-        if (g_debugUI.logFilter.PassFilter(msg.c_str()))
-            ImGui::TextUnformatted(msg.c_str());
+    log_console_visit([](const LogLine& line) {
+        if ((int)line.level < g_debugUI.logShowLevel) return;
+        if (!g_debugUI.logFilter.PassFilter(line.text.c_str())) return;
+        const ImVec4 colour = line.level == LogLevel::Error ? ImVec4(1.0f, 0.35f, 0.35f, 1.0f)
+            : line.level == LogLevel::Warn ? ImVec4(1.0f, 0.85f, 0.3f, 1.0f)
+            : line.level <= LogLevel::Debug ? ImVec4(0.6f, 0.6f, 0.6f, 1.0f)
+            : ImGui::GetStyleColorVec4(ImGuiCol_Text);
+        ImGui::PushStyleColor(ImGuiCol_Text, colour);
+        ImGui::Text("%8.3f %-8s", line.seconds, log_category_name(line.category));
+        ImGui::SameLine();
+        ImGui::TextUnformatted(line.text.c_str());
+        ImGui::PopStyleColor();
+        });
     if (g_debugUI.autoScrollLog)
         ImGui::SetScrollHereY(1.0f);
     ImGui::EndChild();
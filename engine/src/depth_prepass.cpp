@@ -0,0 +1,178 @@
+#include "depth_prepass.h"
+#include "engine.h"
+#include "graphics_pipeline.h"
+
+// ─── Pipelines ────────────────────────────────────────────────────────────────
+static VkPipeline depth_prepass_pipeline(Engine* e, PipelineBuilder& pb, const char* name)
+{
+    VkPipeline pipeline = build_pipeline(e, pb);
+    if (pipeline == VK_NULL_HANDLE) {
+        LOG_ERROR("Failed to create " << name << " pipeline");
+        std::exit(1);
+    }
+    return pipeline;
+}
+
+static void init_depth_prepass_pipelines(Engine* e)
+{
+    DepthPrepassState& dp = e->depthPrepass;
+
+    VkShaderModule depthVert = load_shader_or_exit(e, "shaders/depth_prepass.vert.spv");
+    VkShaderModule maskedVert = load_shader_or_exit(e, "shaders/depth_masked.vert.spv");
+    VkShaderModule maskedFrag = load_shader_or_exit(e, "shaders/depth_masked.frag.spv");
+    VkShaderModule meshVert = load_shader_or_exit(e, "shaders/colored_triangle_mesh.vert.spv");
+    VkShaderModule meshFrag = load_shader_or_exit(e, "shaders/tex_image.frag.spv");
+
+    // All three share meshPipelineLayout, so the render queue submitter pushes
+    // the same MeshPushConstants whichever of them is bound
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::vector<VkVertexInputAttributeDescription> attributes = {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT,    (uint32_t)offsetof(Vertex, position) },
+        { 1, 0, VK_FORMAT_R32G32_SFLOAT,       (uint32_t)offsetof(Vertex, uv)       },
+        { 2, 0, VK_FORMAT_R32G32B32_SFLOAT,    (uint32_t)offsetof(Vertex, normal)   },
+        { 3, 0, VK_FORMAT_R32G32B32A32_SFLOAT, (uint32_t)offsetof(Vertex, color)    },
+        { 4, 0, VK_FORMAT_R32G32B32A32_SFLOAT, (uint32_t)offsetof(Vertex, tangent)  },
+    };
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vertexInput.vertexBindingDescriptionCount = 1;
+    vertexInput.pVertexBindingDescriptions = &binding;
+    vertexInput.pVertexAttributeDescriptions = attributes.data();
+
+    // One set per anti-aliasing mode: the MSAA sample count with the draw
+    // image, or single-sampled with the TAA velocity target next to it
+    auto build_set = [&](VkSampleCountFlagBits samples, const std::vector<VkFormat>& colorFormats,
+        VkPipeline& depth, VkPipeline& masked, VkPipeline& equal) {
+        // ── Depth only — no colour attachment
+        PipelineBuilder pb;
+        set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, pb);
+        set_polygon_mode(VK_POLYGON_MODE_FILL, pb);
+        set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, pb);
+        set_multisampling(samples, pb);
+        enable_depthtest(pb, VK_COMPARE_OP_LESS_OR_EQUAL);
+        set_depth_format(e->depthImage.imageFormat, pb);
+        pb.pipelineLayout = e->meshPipelineLayout;
+
+        set_shaders(depthVert, VK_NULL_HANDLE, pb);
+        vertexInput.vertexAttributeDescriptionCount = 1;       // position
+        pb.vertexInputInfo = vertexInput;
+        depth = depth_prepass_pipeline(e, pb, "depth pre-pass");
+
+        set_shaders(maskedVert, maskedFrag, pb);
+        vertexInput.vertexAttributeDescriptionCount = 2;       // position + uv
+        pb.vertexInputInfo = vertexInput;
+        masked = depth_prepass_pipeline(e, pb, "masked depth pre-pass");
+
+        // ── Colour pass over a filled depth buffer — same state as meshPipeline
+        // except the depth test
+        set_shaders(meshVert, meshFrag, pb);
+        enable_blending_alphablend(pb);
+        enable_depthtest(pb, VK_COMPARE_OP_EQUAL);
+        pb.depthStencil.depthWriteEnable = VK_FALSE;
+        set_color_attachment_formats(colorFormats, pb);
+        vertexInput.vertexAttributeDescriptionCount = (uint32_t)attributes.size();
+        pb.vertexInputInfo = vertexInput;
+        equal = depth_prepass_pipeline(e, pb, "depth-equal mesh");
+        };
+
+    build_set(e->msaaSamples, { e->drawImage.imageFormat },
+        dp.depthPipeline, dp.maskedPipeline, dp.equalPipeline);
+    build_set(VK_SAMPLE_COUNT_1_BIT, { e->drawImage.imageFormat, TAA_VELOCITY_FORMAT },
+        dp.depthPipelineTaa, dp.maskedPipelineTaa, dp.equalPipelineTaa);
+
+    vkDestroyShaderModule(e->device, depthVert, nullptr);
+    vkDestroyShaderModule(e->device, maskedVert, nullptr);
+    vkDestroyShaderModule(e->device, maskedFrag, nullptr);
+    vkDestroyShaderModule(e->device, meshVert, nullptr);
+    vkDestroyShaderModule(e->device, meshFrag, nullptr);
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_depth_prepass(Engine* e)
+{
+    init_depth_prepass_pipelines(e);
+
+    e->mainDeletionQueue.push_function([=]() {
+        DepthPrepassState& dp = e->depthPrepass;
+        vkDestroyPipeline(e->device, dp.equalPipeline, nullptr);
+        vkDestroyPipeline(e->device, dp.maskedPipeline, nullptr);
+        vkDestroyPipeline(e->device, dp.depthPipeline, nullptr);
+        vkDestroyPipeline(e->device, dp.equalPipelineTaa, nullptr);
+        vkDestroyPipeline(e->device, dp.maskedPipelineTaa, nullptr);
+        vkDestroyPipeline(e->device, dp.depthPipelineTaa, nullptr);
+        });
+
+    LOG("Depth pre-pass pipelines created");
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+void draw_depth_prepass(Engine* e, VkCommandBuffer cmd)
+{
+    VkRenderingAttachmentInfo depthAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    depthAttachment.imageView = e->depthImage.imageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.clearValue.depthStencil.depth = 1.0f;
+
+    VkRenderingInfo renderInfo{ .sType = VK_STRUCTURE_TYPE_RENDERING_INFO };
+    renderInfo.renderArea = { {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+    renderInfo.layerCount = 1;
+    renderInfo.pDepthAttachment = &depthAttachment;
+
+    auto set_viewport = [e](VkCommandBuffer c) {
+        VkViewport viewport{ 0, 0,
+            (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+        vkCmdSetViewport(c, 0, 1, &viewport);
+        VkRect2D scissor{ {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+        vkCmdSetScissor(c, 0, 1, &scissor);
+        };
+
+    const RenderQueue& queue = e->renderQueue.depth;
+    RenderQueueStats&  stats = e->renderQueue.depthStats;
+    const uint32_t     count = submit_count(queue);
+    stats = {};
+
+    if (e->parallelRecord.enabled && count > 0) {
+        const uint32_t batch = e->parallelRecord.batch;
+        std::vector<RenderQueueStats> rangeStats((count + batch - 1) / batch);
+
+        RecordTarget target{ {}, e->depthImage.imageFormat, e->msaaSamples };
+        std::vector<VkCommandBuffer> secondaries;
+        record_secondaries(e, target, count, batch,
+            [&](VkCommandBuffer c, uint32_t begin, uint32_t end) {
+                set_viewport(c);
+                submit_mesh_queue(e, c, queue, begin, end, rangeStats[begin / batch]);
+            }, secondaries);
+
+        renderInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        vkCmdBeginRendering(cmd, &renderInfo);
+        vkCmdExecuteCommands(cmd, (uint32_t)secondaries.size(), secondaries.data());
+
+        for (const RenderQueueStats& rs : rangeStats)
+            accumulate_stats(stats, rs);
+    }
+    else {
+        vkCmdBeginRendering(cmd, &renderInfo);
+        set_viewport(cmd);
+        submit_mesh_queue(e, cmd, queue, 0, count, stats);
+    }
+
+    vkCmdEndRendering(cmd);
+
+    // ── Depth writes visible to the colour pass's EQUAL test ──────────────────
+    VkMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
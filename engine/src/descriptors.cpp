@@ -94,6 +94,7 @@ VkDescriptorSet DescriptorAllocator::allocate(VkDevice device, VkDescriptorSetLa
 {
     if (pool == VK_NULL_HANDLE) {
         LOG_ERROR("DescriptorAllocator: pool not initialized");
+        log_flush();
         std::abort();
     }
 
@@ -178,6 +179,7 @@ void init_descriptors(Engine* e)
     builder.add_binding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, 1);
     builder.add_binding(2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, 1);
     builder.add_bindless_array(3, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 8);    // ← ADD: samplerCube
+    builder.add_bindless_array(4, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 8);    // sampler2DArray (shadow cascades)
 
     e->bindlessLayout = builder.build(
         e->device,
@@ -191,5 +193,5 @@ void init_descriptors(Engine* e)
         vkDestroyDescriptorSetLayout(e->device, e->bindlessLayout, nullptr);
         });
 
-    LOG("Bindless descriptor system ready (bindings 0, 1, 2, 3)");
+    LOG("Bindless descriptor system ready (bindings 0, 1, 2, 3, 4)");
 }
\ No newline at end of file
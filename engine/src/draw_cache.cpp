@@ -0,0 +1,217 @@
+#include "draw_cache.h"
+#include "engine.h"
+
+#include <chrono>
+
+static_assert(DRAW_CACHE_SLOTS == FRAME_OVERLAP, "one cached copy per frame in flight");
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_draw_cache(Engine* e)
+{
+    DrawCacheState& dc = e->drawCache;
+
+    VkCommandPoolCreateInfo poolInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = e->graphicsQueueFamily;
+
+    for (uint32_t i = 0; i < DRAW_CACHE_SLOTS; ++i) {
+        VK_CHECK(vkCreateCommandPool(e->device, &poolInfo, nullptr, &dc.pools[i]));
+
+        VkCommandBufferAllocateInfo alloc{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        alloc.commandPool = dc.pools[i];
+        alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc.commandBufferCount = 1;
+        VK_CHECK(vkAllocateCommandBuffers(e->device, &alloc, &dc.opaque[i].cmd));
+        for (CachedPass& pass : dc.shadow[i])
+            VK_CHECK(vkAllocateCommandBuffers(e->device, &alloc, &pass.cmd));
+    }
+
+    e->mainDeletionQueue.push_function([=]() {
+        for (uint32_t i = 0; i < DRAW_CACHE_SLOTS; ++i)
+            vkDestroyCommandPool(e->device, e->drawCache.pools[i], nullptr);
+        });
+}
+
+void mark_scene_dirty(Engine* e)
+{
+    e->drawCache.sceneVersion++;
+}
+
+bool draw_cache_owns(const Engine* e, const MeshAsset& mesh, const GeoSurface& surf, bool shadowPass)
+{
+    // Blended surfaces need a per-frame back-to-front sort; static casters
+    // belong to the shadow cache while it is on
+    if (shadowPass) return e->drawCache.enabled && mesh.isStatic && !e->shadowCache.enabled;
+    return e->drawCache.enabled && mesh.isStatic && surf.opaque;
+}
+
+// ─── Static queues ────────────────────────────────────────────────────────────
+static void build_static_queues(Engine* e)
+{
+    DrawCacheState& dc = e->drawCache;
+    const RenderQueueState& rq = e->renderQueue;
+
+    dc.staticOpaque.packets.clear();
+    dc.staticShadow.packets.clear();
+    dc.staticOpaque.triangles = 0;
+
+    const RenderPipelineId colourPipeline = opaque_colour_pipeline(e);
+    uint32_t flat = 0;
+    for (uint32_t a = 0; a < (uint32_t)e->testMeshes.size(); ++a) {
+        const MeshAsset& mesh = *e->testMeshes[a];
+        for (uint32_t i = 0; i < (uint32_t)mesh.surfaces.size(); ++i, ++flat) {
+            const GeoSurface& surf = mesh.surfaces[i];
+            if (!mesh.isStatic) continue;
+
+            uint32_t material = flat < rq.surfaceMaterial.size() ? rq.surfaceMaterial[flat] : 0;
+            uint32_t geometry = a < rq.assetGeometry.size() ? rq.assetGeometry[a] : a;
+            if (surf.opaque) {
+                dc.staticOpaque.packets.push_back({
+                    make_sort_key(RenderPassId::Opaque, colourPipeline, geometry, material, 0.0f), a, i });
+                dc.staticOpaque.triangles += surf.count / 3;
+            }
+            dc.staticShadow.packets.push_back({
+                make_sort_key(RenderPassId::Shadow, RenderPipelineId::Shadow, geometry, material, 0.0f), a, i });
+        }
+    }
+
+    radix_sort_packets(dc.staticOpaque.packets, dc.staticOpaque.scratch);
+    radix_sort_packets(dc.staticShadow.packets, dc.staticShadow.scratch);
+    dc.builtVersion = dc.sceneVersion;
+    dc.builtPipeline = colourPipeline;
+}
+
+// ─── Keys ─────────────────────────────────────────────────────────────────────
+// FNV-1a over the raw bytes of everything a recording bakes in
+static uint64_t hash_bytes(uint64_t h, const void* data, size_t size)
+{
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i) {
+        h ^= p[i];
+        h *= 1099511628211ull;
+    }
+    return h;
+}
+
+template <typename T>
+static uint64_t hash_value(uint64_t h, const T& v) { return hash_bytes(h, &v, sizeof(T)); }
+
+static uint64_t opaque_params_hash(const Engine* e)
+{
+    uint64_t h = 14695981039346656037ull;
+    h = hash_value(h, e->sunDirection);
+    h = hash_value(h, e->sunColor);
+    h = hash_value(h, e->sunIntensity);
+    h = hash_value(h, e->shadowBias);
+    h = hash_value(h, e->shadowMapBindlessIndex);
+    h = hash_value(h, e->iblIrradianceIndex);
+    h = hash_value(h, e->iblPrefilterIndex);
+    h = hash_value(h, e->iblBrdfLutIndex);
+    h = hash_value(h, e->drawExtent);
+    return h;
+}
+
+static uint64_t shadow_params_hash(const Engine* e, uint32_t cascade)
+{
+    uint64_t h = 14695981039346656037ull;
+    h = hash_value(h, e->shadowCascades.viewProj[cascade]);
+    h = hash_value(h, e->shadowMapImage.imageExtent);
+    return h;
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+static void begin_cached(Engine* e, VkCommandBuffer cmd, const RecordTarget& target)
+{
+    VkCommandBufferInheritanceRenderingInfo renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO };
+    renderingInfo.colorAttachmentCount = (uint32_t)target.colorFormats.size();
+    renderingInfo.pColorAttachmentFormats = target.colorFormats.data();
+    renderingInfo.depthAttachmentFormat = target.depthFormat;
+    renderingInfo.rasterizationSamples = target.samples;
+
+    VkCommandBufferInheritanceInfo inheritance{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inheritance.pNext = &renderingInfo;
+    inheritance.pipelineStatistics = e->gpuProfiler.statisticFlags;   // fixed for the device's lifetime
+
+    // Replayed every time this frame slot comes round — not ONE_TIME_SUBMIT
+    VkCommandBufferBeginInfo beginInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    VK_CHECK(vkResetCommandBuffer(cmd, 0));
+    VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+}
+
+using CachedRecordFn = std::function<void(VkCommandBuffer cmd, RenderQueueStats& stats)>;
+
+// Re-records `pass` if its key is stale. Returns true on a cache hit.
+static bool refresh_cached(Engine* e, CachedPass& pass, const DrawCacheKey& key,
+    const RecordTarget& target, const CachedRecordFn& record)
+{
+    if (pass.valid && pass.key == key) return true;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    begin_cached(e, pass.cmd, target);
+    pass.stats = {};
+    record(pass.cmd, pass.stats);
+    VK_CHECK(vkEndCommandBuffer(pass.cmd));
+    auto t1 = std::chrono::high_resolution_clock::now();
+
+    pass.key = key;
+    pass.valid = true;
+    e->drawCache.rebuilds++;
+    e->drawCache.lastRecordMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+    return false;
+}
+
+VkCommandBuffer draw_cache_opaque(Engine* e, RenderQueueStats& stats, uint32_t& triangles)
+{
+    DrawCacheState& dc = e->drawCache;
+    if (dc.builtVersion != dc.sceneVersion || dc.builtPipeline != opaque_colour_pipeline(e))
+        build_static_queues(e);
+    if (dc.staticOpaque.packets.empty()) return VK_NULL_HANDLE;
+
+    CachedPass& pass = dc.opaque[e->frameNumber % DRAW_CACHE_SLOTS];
+    DrawCacheKey key{ dc.sceneVersion, render_pipeline(e, dc.builtPipeline), opaque_params_hash(e) };
+    RecordTarget target = scene_record_target(e);
+
+    dc.hitOpaque = refresh_cached(e, pass, key, target, [&](VkCommandBuffer cmd, RenderQueueStats& s) {
+        VkViewport viewport{ 0, 0,
+            (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        VkRect2D scissor{ {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        submit_mesh_queue(e, cmd, dc.staticOpaque, 0, submit_count(dc.staticOpaque), s);
+        });
+    pass.triangles = dc.staticOpaque.triangles;
+
+    accumulate_stats(stats, pass.stats);
+    triangles += pass.triangles;
+    return pass.cmd;
+}
+
+VkCommandBuffer draw_cache_shadow(Engine* e, uint32_t cascade, RenderQueueStats& stats)
+{
+    DrawCacheState& dc = e->drawCache;
+    if (dc.builtVersion != dc.sceneVersion) build_static_queues(e);
+    if (dc.staticShadow.packets.empty()) return VK_NULL_HANDLE;
+
+    CachedPass& pass = dc.shadow[e->frameNumber % DRAW_CACHE_SLOTS][cascade];
+    DrawCacheKey key{ dc.sceneVersion, e->shadowPipeline, shadow_params_hash(e, cascade) };
+    RecordTarget target{ {}, e->shadowMapImage.imageFormat, VK_SAMPLE_COUNT_1_BIT };
+    const VkExtent3D size = e->shadowMapImage.imageExtent;
+
+    bool hit = refresh_cached(e, pass, key, target, [&](VkCommandBuffer cmd, RenderQueueStats& s) {
+        VkViewport viewport{ 0, 0, (float)size.width, (float)size.height, 0.0f, 1.0f };
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        VkRect2D scissor{ {0,0}, {size.width, size.height} };
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        submit_shadow_queue(e, cmd, dc.staticShadow, cascade, 0, submit_count(dc.staticShadow), s);
+        });
+    dc.hitShadow = (cascade == 0 || dc.hitShadow) && hit;
+
+    accumulate_stats(stats, pass.stats);
+    return pass.cmd;
+}
@@ -0,0 +1,137 @@
+#include "dynamic_resolution.h"
+#include "engine.h"
+#include "graphics_pipeline.h"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_dynamic_resolution(Engine* e)
+{
+    DynamicResolutionState& dr = e->dynamicRes;
+
+    VkShaderModule vert = load_shader_or_exit(e, "shaders/upscale.vert.spv");
+    VkShaderModule frag = load_shader_or_exit(e, "shaders/upscale.frag.spv");
+
+    VkPushConstantRange pushRange{ VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(UpscalePushConstants) };
+    VkPipelineLayoutCreateInfo layoutInfo = e->util.pipeline_layout_create_info();
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &e->bindlessLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &layoutInfo, nullptr, &dr.upscaleLayout));
+
+    PipelineBuilder pb;
+    set_shaders(vert, frag, pb);
+    set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, pb);
+    set_polygon_mode(VK_POLYGON_MODE_FILL, pb);
+    set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, pb);
+    set_multisampling_none(pb);
+    disable_blending(pb);
+    disable_depthtest(pb);
+    set_color_attachment_format(e->swapchainImageFormat, pb);
+    set_depth_format(VK_FORMAT_UNDEFINED, pb);
+    pb.pipelineLayout = dr.upscaleLayout;
+    pb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    dr.upscalePipeline = build_pipeline(e, pb);
+    if (dr.upscalePipeline == VK_NULL_HANDLE) {
+        LOG_ERROR("Failed to create upscale pipeline");
+        std::exit(1);
+    }
+    vkDestroyShaderModule(e->device, vert, nullptr);
+    vkDestroyShaderModule(e->device, frag, nullptr);
+
+    e->mainDeletionQueue.push_function([=]() {
+        DynamicResolutionState& dr = e->dynamicRes;
+        vkDestroyPipeline(e->device, dr.upscalePipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, dr.upscaleLayout, nullptr);
+        });
+
+    LOG("Dynamic resolution: upscale pipeline created, drawImage at slot " << dr.sourceBindlessIndex);
+}
+
+// ─── Controller ───────────────────────────────────────────────────────────────
+void dynamic_resolution_begin_frame(Engine* e)
+{
+    DynamicResolutionState& dr = e->dynamicRes;
+    if (dr.upscalePipeline == VK_NULL_HANDLE) return;
+
+    // ── GPU time of the frame the profiler resolved last, once per frame.
+    // Frames recorded before discardBefore ran another render path or AA mode
+    const GpuProfilerState& gp = e->gpuProfiler;
+    bool fresh = false;
+    if (gp.resultFrame != dr.lastResultFrame) {
+        dr.lastResultFrame = gp.resultFrame;
+        const GpuScopeResult* frame = gpu_profiler_find(e, "frame");
+        if (frame && gp.resultFrame >= dr.discardBefore) {
+            dr.gpuMs = frame->ms;
+            dr.smoothedMs = dr.smoothedMs > 0.0f ? glm::mix(dr.smoothedMs, dr.gpuMs, 0.2f) : dr.gpuMs;
+            fresh = true;
+        }
+    }
+
+    // ── New scale: drop fast when over budget, climb slowly and only with
+    // 10% headroom — the measurement is FRAME_OVERLAP frames old
+    dr.maxScale = std::clamp(dr.maxScale, 0.25f, 1.0f);
+    dr.minScale = std::clamp(dr.minScale, 0.25f, dr.maxScale);
+    if (!dr.enabled) {
+        dr.scale = 1.0f;
+    }
+    else if (fresh) {
+        const float load = dr.smoothedMs / std::max(dr.targetMs, 1.0f);
+        if (load > 1.0f || load < 0.9f) {
+            const float ideal = dr.scale / std::sqrt(std::max(load, 0.01f));
+            dr.scale += (ideal - dr.scale) * (load > 1.0f ? 0.5f : 0.1f);
+        }
+        dr.scale = std::clamp(dr.scale, dr.minScale, dr.maxScale);
+    }
+
+    // ── Quantise so width and height scale by the same ratio
+    const VkExtent3D full = e->drawImage.imageExtent;
+    const uint32_t   steps = std::max(1u, std::gcd(full.width, full.height));
+    const uint32_t   k = std::clamp((uint32_t)std::lround(dr.scale * (float)steps), 1u, steps);
+    const VkExtent2D extent = { full.width / steps * k, full.height / steps * k };
+    if (extent.width != e->drawExtent.width || extent.height != e->drawExtent.height)
+        dr.extentChanges++;
+    e->drawExtent = extent;
+
+    if (fresh) {
+        dr.scaleHistory[dr.historyHead] = (float)extent.width / (float)full.width;
+        dr.gpuMsHistory[dr.historyHead] = dr.gpuMs;
+        dr.historyHead = (dr.historyHead + 1) % DRS_HISTORY;
+    }
+}
+
+// ─── Upscale ──────────────────────────────────────────────────────────────────
+void draw_upscale(Engine* e, VkCommandBuffer cmd, VkImageView target, uint32_t sourceIndex)
+{
+    DynamicResolutionState& dr = e->dynamicRes;
+
+    // Every pixel is written, nothing to load
+    VkRenderingAttachmentInfo colorAttachment = attachment_info(
+        target, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    VkRenderingInfo renderInfo = e->util.rendering_info(e->swapchainExtent, &colorAttachment, nullptr);
+
+    vkCmdBeginRendering(cmd, &renderInfo);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, dr.upscalePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+        dr.upscaleLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+    VkViewport viewport{ 0, 0,
+        (float)e->swapchainExtent.width, (float)e->swapchainExtent.height, 0.0f, 1.0f };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    VkRect2D scissor{ {0, 0}, e->swapchainExtent };
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    UpscalePushConstants push{};
+    push.srcSize = glm::vec2(e->drawExtent.width, e->drawExtent.height);
+    push.sourceIndex = sourceIndex;
+    push.sharpness = std::clamp(dr.sharpness, 0.0f, 1.0f);
+    vkCmdPushConstants(cmd, dr.upscaleLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
+
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    vkCmdEndRendering(cmd);
+}
@@ -13,21 +13,36 @@
 #include "texture_loader.h"
 #include "skybox.h"
 #include <filesystem>
+#include <chrono>
 
 Engine* engine = nullptr;
 
 void init(Engine* e, uint32_t x, uint32_t y)
 {
+    // Set by the caller before init: headless mode, and the scene to load
+    HeadlessState headless = std::move(e->headless);
+    std::vector<std::string> sceneFiles = std::move(e->sceneFiles);
     *e = Engine{};
+    e->headless = std::move(headless);
+    e->sceneFiles = std::move(sceneFiles);
     ::engine = e;
-    e->shadowMapBindlessIndex = 5;
+    cpu_profiler_thread_name("main");
+    CPU_ZONE("init");
+    e->shadowMapBindlessIndex = 0;
     uint32_t targetW = 3840;
     uint32_t targetH = 2160;
     init_vulkan(e);
-    init_swapchain(e, targetW, targetH);
+    init_frame_pacing(e);
+    init_pipeline_cache(e);
+    init_pipeline_service(e);
+    if (e->headless.enabled) headless_create_target(e);
+    else                     init_swapchain(e, targetW, targetH);
     init_descriptors(e);
     init_samplers(e);
-    init_shadow_map(e, 4096, 4096);
+    init_shadow_map(e, 2048, 2048);
+    init_shadow_cascades(e);
+    init_shadow_cache(e);
+    init_render_graph(e);
 
     create_draw_image(e, targetW, targetH);
     init_depth_image(e, targetW, targetH);
@@ -35,19 +50,49 @@ void init(Engine* e, uint32_t x, uint32_t y)
     init_commands(e);
     init_camera_buffers(e);
     init_sync_structures(e);
+    init_frame_scheduler(e);
+    init_gpu_profiler(e);
     init_pipelines(e);
     init_skybox_pipelines(e);
     init_mesh_pipelines(e);
+    init_depth_prepass(e);
+    init_dynamic_resolution(e);
+    init_taa(e);
+    init_visibility_buffer(e);
+    init_clustered_lighting(e);
     init_shadow_pipeline(e);
+    pipeline_service_wait(e);
+    init_job_system(e);
+    init_parallel_recording(e);
+    init_draw_cache(e);
+    init_render_queues(e);
     init_default_data(e);
-	init_acceleration_structure(e, e->testMeshes);
+    init_gpu_culling(e);
+    if (e->rayTracingSupported)
+        init_acceleration_structure(e, e->testMeshes);
     init_ibl(e);
-    init_imgui(e);
-    init_debug_ui(e);
-    setupCameraCallbacks(e->window);
-    glfwSetWindowUserPointer(e->window, e);
+    if (!e->headless.enabled) {
+        init_imgui(e);
+        init_debug_ui(e);
+        setupCameraCallbacks(e->window);
+        glfwSetWindowUserPointer(e->window, e);
+    }
     e->mainCamera.focusOn(glm::vec3(0.0f, 0.5f, 0.0f), 5.0f);
+    pipeline_cache_report(e);
+
+}
 
+std::filesystem::path find_asset(const std::filesystem::path& relative)
+{
+    // Walk up from CWD until we find it (works from build/ or project root)
+    std::filesystem::path search = std::filesystem::current_path();
+    for (int i = 0; i < 5; ++i) {
+        auto candidate = search / relative;
+        if (std::filesystem::exists(candidate)) return candidate;
+        if (!search.has_parent_path()) break;
+        search = search.parent_path();
+    }
+    return relative;
 }
 
 VkFormat find_depth_format(VkPhysicalDevice physicalDevice)
@@ -64,21 +109,14 @@ VkFormat find_depth_format(VkPhysicalDevice physicalDevice)
             return format;
     }
     LOG_ERROR("No supported depth format found");
+    log_flush();
     std::abort();
     return VK_FORMAT_UNDEFINED;
 }
 
 void destroy_depth_image(Engine* e)
 {
-    if (e->depthImage.imageView != VK_NULL_HANDLE) {
-        vkDestroyImageView(e->device, e->depthImage.imageView, nullptr);
-        e->depthImage.imageView = VK_NULL_HANDLE;
-    }
-    if (e->depthImage.image != VK_NULL_HANDLE) {
-        vmaDestroyImage(e->allocator, e->depthImage.image, e->depthImage.allocation);
-        e->depthImage.image = VK_NULL_HANDLE;
-        e->depthImage.allocation = VK_NULL_HANDLE;
-    }
+    render_graph_release_transient(e, &e->depthImage);
 }
 
 void init_camera_buffers(Engine* e)
@@ -98,15 +136,24 @@ void init_camera_buffers(Engine* e)
     LOG("Camera UBOs mapped");
 }
 
+void init_job_system(Engine* e)
+{
+    // Leave one core for the main thread
+    uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+    e->jobs = std::make_unique<JobSystem>();
+    jobs_init(*e->jobs, std::min(cores - 1, 15u));
+    LOG("Job system: " << jobs_thread_count(*e->jobs) << " threads");
+}
+
 void init_depth_image(Engine* e, uint32_t width, uint32_t height)
 {
     destroy_depth_image(e);
     VkExtent3D depthExtent = { width, height, 1 };
-    e->depthImage = create_msaa_image(e, depthExtent,
-        VK_FORMAT_D32_SFLOAT,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT);
-    e->mainDeletionQueue.push_function([=]() { destroy_depth_image(e); });
-    LOG("Depth image created");
+    VkImageCreateInfo depthInfo = image_create_info(VK_FORMAT_D32_SFLOAT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, depthExtent);
+    depthInfo.samples = e->msaaSamples;
+    render_graph_register_transient(e, "depthImage", depthInfo, VK_IMAGE_ASPECT_DEPTH_BIT, &e->depthImage);
+    LOG("Depth image registered");
 }
 
 void init_shadow_map(Engine* e, uint32_t width, uint32_t height)
@@ -115,10 +162,13 @@ void init_shadow_map(Engine* e, uint32_t width, uint32_t height)
     VkExtent3D shadowExtent = { width, height, 1 };
     e->shadowMapImage.imageExtent = shadowExtent;
 
+    // One layer per cascade — width x height is the size of each layer
     VkImageCreateInfo smimg_info = image_create_info(
         e->shadowMapImage.imageFormat,
-        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT
+        | VK_IMAGE_USAGE_TRANSFER_DST_BIT,          // shadow cache copies into it
         shadowExtent);
+    smimg_info.arrayLayers = MAX_SHADOW_CASCADES;
 
     VmaAllocationCreateInfo smimg_allocinfo{};
     smimg_allocinfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
@@ -127,13 +177,26 @@ void init_shadow_map(Engine* e, uint32_t width, uint32_t height)
     VK_CHECK(vmaCreateImage(e->allocator, &smimg_info, &smimg_allocinfo,
         &e->shadowMapImage.image, &e->shadowMapImage.allocation, nullptr));
 
+    // Array view for sampling, single-layer views to render each cascade into
     VkImageViewCreateInfo smview_info = imageview_create_info(
         e->shadowMapImage.imageFormat,
         e->shadowMapImage.image,
         VK_IMAGE_ASPECT_DEPTH_BIT);
+    smview_info.viewType = VK_IMAGE_VIEW_TYPE_2D_ARRAY;
+    smview_info.subresourceRange.layerCount = MAX_SHADOW_CASCADES;
     VK_CHECK(vkCreateImageView(e->device, &smview_info, nullptr,
         &e->shadowMapImage.imageView));
 
+    for (uint32_t i = 0; i < MAX_SHADOW_CASCADES; ++i) {
+        VkImageViewCreateInfo layer_info = imageview_create_info(
+            e->shadowMapImage.imageFormat,
+            e->shadowMapImage.image,
+            VK_IMAGE_ASPECT_DEPTH_BIT);
+        layer_info.subresourceRange.baseArrayLayer = i;
+        VK_CHECK(vkCreateImageView(e->device, &layer_info, nullptr,
+            &e->shadowCascades.layerViews[i]));
+    }
+
     VkSamplerCreateInfo samplerCI{ .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO };
     samplerCI.magFilter = VK_FILTER_LINEAR;
     samplerCI.minFilter = VK_FILTER_LINEAR;
@@ -154,7 +217,7 @@ void init_shadow_map(Engine* e, uint32_t width, uint32_t height)
     VkWriteDescriptorSet write{};
     write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
     write.dstSet = e->bindlessSet;
-    write.dstBinding = 0;
+    write.dstBinding = 4;
     write.dstArrayElement = e->shadowMapBindlessIndex;
     write.descriptorCount = 1;
     write.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
@@ -163,37 +226,20 @@ void init_shadow_map(Engine* e, uint32_t width, uint32_t height)
     vkUpdateDescriptorSets(e->device, 1, &write, 0, nullptr);
 
     e->mainDeletionQueue.push_function([=]() {
+        for (VkImageView view : e->shadowCascades.layerViews)
+            vkDestroyImageView(e->device, view, nullptr);
         destroy_image(e->shadowMapImage, e);
         vkDestroySampler(e->device, e->shadowMapSampler, nullptr);
         });
 
-    LOG("Shadow map created " << width << "x" << height
-        << " at bindless slot " << e->shadowMapBindlessIndex);
+    LOG("Shadow map created " << width << "x" << height << "x" << MAX_SHADOW_CASCADES
+        << " at layered slot " << e->shadowMapBindlessIndex);
 }
 
 void destroy_draw_image(Engine* e)
 {
-    // Destroy MSAA image
-    if (e->msaaImage.imageView != VK_NULL_HANDLE) {
-        vkDestroyImageView(e->device, e->msaaImage.imageView, nullptr);
-        e->msaaImage.imageView = VK_NULL_HANDLE;
-    }
-    if (e->msaaImage.image != VK_NULL_HANDLE) {
-        vmaDestroyImage(e->allocator, e->msaaImage.image, e->msaaImage.allocation);
-        e->msaaImage.image = VK_NULL_HANDLE;
-        e->msaaImage.allocation = VK_NULL_HANDLE;
-    }
-
-    // Destroy resolve/draw image
-    if (e->drawImage.imageView != VK_NULL_HANDLE) {
-        vkDestroyImageView(e->device, e->drawImage.imageView, nullptr);
-        e->drawImage.imageView = VK_NULL_HANDLE;
-    }
-    if (e->drawImage.image != VK_NULL_HANDLE) {
-        vmaDestroyImage(e->allocator, e->drawImage.image, e->drawImage.allocation);
-        e->drawImage.image = VK_NULL_HANDLE;
-        e->drawImage.allocation = VK_NULL_HANDLE;
-    }
+    render_graph_release_transient(e, &e->msaaImage);
+    render_graph_release_transient(e, &e->drawImage);
 }
 
 void init_debug_ui(Engine* e)
@@ -229,70 +275,50 @@ void create_draw_image(Engine* e, uint32_t width, uint32_t height)
     destroy_draw_image(e);
 
     VkExtent3D drawImageExtent = { width, height, 1 };
-    e->drawImage.imageFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
-    e->drawImage.imageExtent = drawImageExtent;
     e->drawExtent = { width, height };
 
+    // Both images are render-graph transients: created and placed on the first
+    // frame that uses them, in memory they may share with other transients
+
     // ── Resolve target (drawImage) — geometry blits/resolves into this ────────
     VkImageUsageFlags drawImageUsages =
         VK_IMAGE_USAGE_TRANSFER_SRC_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT |
         VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
         VK_IMAGE_USAGE_SAMPLED_BIT;
 
-    VkImageCreateInfo rimg_info = image_create_info(e->drawImage.imageFormat, drawImageUsages, drawImageExtent);
-    VmaAllocationCreateInfo rimg_allocinfo{};
-    rimg_allocinfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-    rimg_allocinfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-    VK_CHECK(vmaCreateImage(e->allocator, &rimg_info, &rimg_allocinfo,
-        &e->drawImage.image, &e->drawImage.allocation, nullptr));
-
-    VkImageViewCreateInfo rview_info = imageview_create_info(
-        e->drawImage.imageFormat, e->drawImage.image, VK_IMAGE_ASPECT_COLOR_BIT);
-    VK_CHECK(vkCreateImageView(e->device, &rview_info, nullptr, &e->drawImage.imageView));
-
-    // Update bindless slot 1 (storage) with new draw image view
-    VkDescriptorImageInfo storageInfo{};
-    storageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    storageInfo.imageView = e->drawImage.imageView;
-
-    VkWriteDescriptorSet storageWrite{};
-    storageWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-    storageWrite.dstSet = e->bindlessSet;
-    storageWrite.dstBinding = 1;
-    storageWrite.descriptorCount = 1;
-    storageWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    storageWrite.pImageInfo = &storageInfo;
-    vkUpdateDescriptorSets(e->device, 1, &storageWrite, 0, nullptr);
-
-    // ── MSAA render target — 4x, geometry renders here, resolves to drawImage ─
-    VkImageCreateInfo msaa_info{};
-    msaa_info.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
-    msaa_info.imageType = VK_IMAGE_TYPE_2D;
-    msaa_info.format = VK_FORMAT_R16G16B16A16_SFLOAT;
-    msaa_info.extent = drawImageExtent;
-    msaa_info.mipLevels = 1;
-    msaa_info.arrayLayers = 1;
-    msaa_info.samples = e->msaaSamples;
-    msaa_info.tiling = VK_IMAGE_TILING_OPTIMAL;
-    msaa_info.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT;
-    msaa_info.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-
-    VmaAllocationCreateInfo msaa_alloc{};
-    msaa_alloc.usage = VMA_MEMORY_USAGE_GPU_ONLY;
-    msaa_alloc.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
-
-    VK_CHECK(vmaCreateImage(e->allocator, &msaa_info, &msaa_alloc,
-        &e->msaaImage.image, &e->msaaImage.allocation, nullptr));
-
-    VkImageViewCreateInfo msaa_view = imageview_create_info(
-        VK_FORMAT_R16G16B16A16_SFLOAT, e->msaaImage.image, VK_IMAGE_ASPECT_COLOR_BIT);
-    VK_CHECK(vkCreateImageView(e->device, &msaa_view, nullptr, &e->msaaImage.imageView));
+    VkImageCreateInfo rimg_info = image_create_info(VK_FORMAT_R16G16B16A16_SFLOAT, drawImageUsages, drawImageExtent);
+    render_graph_register_transient(e, "drawImage", rimg_info, VK_IMAGE_ASPECT_COLOR_BIT, &e->drawImage,
+        [](Engine* e) {
+            // Update bindless slot 1 (storage) with new draw image view
+            VkDescriptorImageInfo storageInfo{};
+            storageInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+            storageInfo.imageView = e->drawImage.imageView;
+
+            VkWriteDescriptorSet storageWrite{};
+            storageWrite.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            storageWrite.dstSet = e->bindlessSet;
+            storageWrite.dstBinding = 1;
+            storageWrite.descriptorCount = 1;
+            storageWrite.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            storageWrite.pImageInfo = &storageInfo;
+            vkUpdateDescriptorSets(e->device, 1, &storageWrite, 0, nullptr);
+
+            // Sampled by the upscale pass
+            upload_texture_to_bindless(e, e->drawImage, e->defaultSamplerNearest, e->dynamicRes.sourceBindlessIndex);
+        });
 
-    e->msaaImage.imageFormat = VK_FORMAT_R16G16B16A16_SFLOAT;
-    e->msaaImage.imageExtent = drawImageExtent;
+    // ── MSAA render target — geometry renders here, resolves to drawImage ────
+    // Single-sampled (TAA mode) geometry renders to drawImage directly
+    if (e->msaaSamples == VK_SAMPLE_COUNT_1_BIT) {
+        LOG("Draw image registered — single-sampled");
+        return;
+    }
+    VkImageCreateInfo msaa_info = image_create_info(VK_FORMAT_R16G16B16A16_SFLOAT,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT, drawImageExtent);
+    msaa_info.samples = e->msaaSamples;
+    render_graph_register_transient(e, "msaaImage", msaa_info, VK_IMAGE_ASPECT_COLOR_BIT, &e->msaaImage);
 
-    LOG("Draw image created — msaaImage(4x) -> resolve -> drawImage");
+    LOG("Draw image registered — msaaImage -> resolve -> drawImage");
 }
 
 void init_default_data(Engine* e)
@@ -310,59 +336,33 @@ void init_default_data(Engine* e)
     uint32_t black = glm::packUnorm4x8(glm::vec4(0, 0, 0, 1));
     e->blackImage = create_image((void*)&black, e, { 1,1,1 }, VK_FORMAT_R8G8B8A8_UNORM, VK_IMAGE_USAGE_SAMPLED_BIT);
     upload_texture_to_bindless(e, e->blackImage, e->defaultSamplerLinear, 3);
-    e->nextBindlessTextureIndex = e->shadowMapBindlessIndex + 1;
-
-    // Walk up from CWD until we find the assets folder (works from build/ or project root)
-    std::filesystem::path glbRelative = "assets/main_sponza/NewSponza_Main_glTF_003.gltf";
-    std::filesystem::path glbPath = glbRelative;
-    {
-        std::filesystem::path search = std::filesystem::current_path();
-        for (int i = 0; i < 5; ++i) {
-            auto candidate = search / glbRelative;
-            if (std::filesystem::exists(candidate)) {
-                glbPath = candidate;
-                break;
-            }
-            if (!search.has_parent_path()) break;
-            search = search.parent_path();  
+    e->nextBindlessTextureIndex = 5;     // slots 0-4 reserved
+
+    // The New Sponza main building and its curtains, unless the caller (the
+    // benchmark runner) picked a scene
+    if (e->sceneFiles.empty())
+        e->sceneFiles = { "assets/main_sponza/NewSponza_Main_glTF_003.gltf",
+                          "assets/pkg_a_curtains/NewSponza_Curtains_gLTF.gltf" };
+
+    const auto loadStart = std::chrono::steady_clock::now();
+    for (const std::string& file : e->sceneFiles) {
+        std::filesystem::path glbPath = find_asset(file);
+        LOG_CAT(Loader, Info, "GLB path: " << std::filesystem::absolute(glbPath));
+
+        auto meshes = loadgltfMeshes(e, glbPath);
+        if (meshes.has_value()) {
+            for (auto& mesh : meshes.value())
+                e->testMeshes.push_back(std::move(mesh));
         }
-    }
-    std::printf("[loader] GLB path: %s\n", std::filesystem::absolute(glbPath).string().c_str());
-
-    auto testMeshes = loadgltfMeshes(e, glbPath);
-    if (testMeshes.has_value()) {
-        e->testMeshes = std::move(testMeshes.value());
-        LOG("Loaded " << e->testMeshes.size() << " meshes");
-    } else {
-        LOG_ERROR("No meshes loaded from GLTF file");
-    }
-
-    
-    std::filesystem::path glbRelative_two = "assets/pkg_a_curtains/NewSponza_Curtains_gLTF.gltf";
-    std::filesystem::path glbPath_two = glbRelative_two;
-    {
-        std::filesystem::path search = std::filesystem::current_path();
-        for (int i = 0; i < 5; ++i) {
-            auto candidate = search / glbRelative_two;
-            if (std::filesystem::exists(candidate)) {
-                glbPath_two = candidate;
-                break;
-            }
-            if (!search.has_parent_path()) break;
-            search = search.parent_path();
+        else {
+            LOG_ERROR("No meshes loaded from GLTF file");
         }
     }
-    std::printf("[loader] GLB_2 path: %s\n", std::filesystem::absolute(glbPath_two).string().c_str());
+    e->sceneLoadMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - loadStart).count();
+    LOG("Loaded " << e->testMeshes.size() << " meshes in " << e->sceneLoadMs << " ms");
 
-    auto testMeshes_two = loadgltfMeshes(e, glbPath_two);
-    if (testMeshes_two.has_value()) {
-        for (auto& mesh : testMeshes_two.value())
-            e->testMeshes.push_back(std::move(mesh));
-    }
-    else {
-        LOG_ERROR("No meshes loaded from GLTF file");
-    }
-    
+    build_cull_scene(e);
+    build_occluder_set(e);
 
 
 
@@ -377,6 +377,7 @@ void init_default_data(Engine* e)
 
     e->mainDeletionQueue.push_function([=]() {
         for (auto& mesh : e->testMeshes) {
+            if (!mesh->ownsBuffers) continue;
             destroy_buffer(mesh->meshBuffers.vertexBuffer, e);
             destroy_buffer(mesh->meshBuffers.indexBuffer, e);
         }
@@ -395,13 +396,18 @@ void engine_cleanup(Engine* e)
 {
     if (!e) return;
     vkDeviceWaitIdle(e->device);
+    telemetry_log_summary(e);
+
+    if (e->jobs) {
+        jobs_shutdown(*e->jobs);
+        e->jobs.reset();
+    }
 
     for (uint32_t i = 0; i < FRAME_OVERLAP; i++) {
         e->frames[i].deletionQueue.flush();
         vkDestroyCommandPool(e->device, e->frames[i].commandPool, nullptr);
         vkDestroySemaphore(e->device, e->frames[i].swapchainSemaphore, nullptr);
         vkDestroySemaphore(e->device, e->frames[i].renderSemaphore, nullptr);
-        vkDestroyFence(e->device, e->frames[i].renderFence, nullptr);
     }
 
     for (auto& tex : e->sceneTextures) destroy_image(tex, e);
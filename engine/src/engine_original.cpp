@@ -1129,7 +1129,7 @@ void init_mesh_pipelines(Engine* e)
     pb.vertexInputInfo = {};
     pb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-    e->meshPipeline = build_pipeline(e->device, pb);
+    e->meshPipeline = build_pipeline(e, pb);
     if (e->meshPipeline == VK_NULL_HANDLE) {
         std::cerr << "❌ Failed to create mesh pipeline\n"; std::exit(1);
     }
@@ -0,0 +1,157 @@
+#include "frame_pacing.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+using PacingClock = std::chrono::high_resolution_clock;
+
+static float ms_between(PacingClock::time_point a, PacingClock::time_point b)
+{
+    return std::chrono::duration<float, std::milli>(b - a).count();
+}
+
+const char* present_mode_name(VkPresentModeKHR mode)
+{
+    switch (mode) {
+    case VK_PRESENT_MODE_FIFO_KHR:         return "FIFO (vsync)";
+    case VK_PRESENT_MODE_FIFO_RELAXED_KHR: return "FIFO relaxed";
+    case VK_PRESENT_MODE_MAILBOX_KHR:      return "Mailbox";
+    case VK_PRESENT_MODE_IMMEDIATE_KHR:    return "Immediate";
+    default:                               return "Other";
+    }
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_frame_pacing(Engine* e)
+{
+    FramePacingState& fp = e->framePacing;
+    if (fp.presentWaitSupported) {
+        fp.pfnWaitForPresent = (PFN_vkWaitForPresentKHR)vkGetDeviceProcAddr(e->device, "vkWaitForPresentKHR");
+        fp.presentWaitSupported = fp.pfnWaitForPresent != nullptr;
+    }
+    fp.lastFrame = PacingClock::now();
+    fp.deadline = fp.lastFrame;
+
+    LOG("Frame pacing: present wait " << (fp.presentWaitSupported ? "available" : "unavailable"));
+}
+
+void frame_pacing_set_present_mode(Engine* e, VkPresentModeKHR mode)
+{
+    FramePacingState& fp = e->framePacing;
+    if (mode == fp.presentMode) return;
+    fp.presentMode = mode;
+    e->resize_requested = true;          // resize_swapchain rebuilds with the new mode
+}
+
+// ─── Frame start ──────────────────────────────────────────────────────────────
+// Sleeps to within spinMs of the deadline and spins the rest
+static void limit_frame_rate(FramePacingState& fp)
+{
+    if (fp.frameCap <= 0.0f) {
+        fp.limiterWaitMs = 0.0f;
+        return;
+    }
+
+    const auto period = std::chrono::duration_cast<PacingClock::duration>(
+        std::chrono::duration<double>(1.0 / fp.frameCap));
+    const auto start = PacingClock::now();
+
+    // More than a period behind (a hitch, a resize): restart the schedule
+    // rather than racing to catch up
+    fp.deadline += period;
+    if (fp.deadline < start - period) fp.deadline = start;
+
+    const auto spin = std::chrono::duration_cast<PacingClock::duration>(
+        std::chrono::duration<float, std::milli>(fp.spinMs));
+    if (fp.deadline - spin > start)
+        std::this_thread::sleep_until(fp.deadline - spin);
+    while (PacingClock::now() < fp.deadline)
+        std::this_thread::yield();
+
+    fp.limiterWaitMs = ms_between(start, PacingClock::now());
+}
+
+// Latency of every present that has reached the display. With timeoutNs = 0
+// this only polls, so a finish is seen at most one frame late; otherwise it
+// blocks until every pending present is out.
+static void collect_presents(Engine* e, uint64_t timeoutNs)
+{
+    FramePacingState& fp = e->framePacing;
+    while (!fp.pending.empty()) {
+        const PendingPresent& p = fp.pending.front();
+        VkResult result = fp.pfnWaitForPresent(e->device, e->swapchain, p.id, timeoutNs);
+        if (result == VK_TIMEOUT) return;
+        if (result == VK_SUCCESS) {
+            const float ms = ms_between(p.input, PacingClock::now());
+            fp.latencyMs = fp.latencyMeasured ? fp.latencyMs * 0.9f + ms * 0.1f : ms;
+            fp.latencyMeasured = true;
+        }
+        fp.pending.pop_front();          // measured, or lost to an out-of-date swapchain
+    }
+}
+
+static void record_interval(FramePacingState& fp, float intervalMs, uint32_t framesInFlight)
+{
+    fp.intervalHistory[fp.historyHead] = intervalMs;
+
+    float sum = 0.0f, worst = 0.0f;
+    for (float ms : fp.intervalHistory) {
+        sum += ms;
+        worst = std::max(worst, ms);
+    }
+    fp.meanIntervalMs = sum / (float)PACING_HISTORY;
+    float variance = 0.0f;
+    for (float ms : fp.intervalHistory)
+        variance += (ms - fp.meanIntervalMs) * (ms - fp.meanIntervalMs);
+    fp.intervalStdDevMs = std::sqrt(variance / (float)PACING_HISTORY);
+    fp.worstIntervalMs = worst;
+
+    if (!fp.latencyMeasured)
+        fp.latencyMs = fp.meanIntervalMs * (float)(framesInFlight + 1);
+    fp.latencyHistory[fp.historyHead] = fp.latencyMs;
+    fp.historyHead = (fp.historyHead + 1) % PACING_HISTORY;
+}
+
+void frame_pacing_begin_frame(Engine* e)
+{
+    FramePacingState& fp = e->framePacing;
+    limit_frame_rate(fp);
+
+    // Ids belong to one swapchain; a rebuild leaves nothing to wait for
+    if (fp.presentWaitSupported && fp.swapchain != e->swapchain) {
+        fp.pending.clear();
+        fp.swapchain = e->swapchain;
+    }
+    if (fp.presentWaitSupported && e->swapchain != VK_NULL_HANDLE) {
+        // Low latency: hold input sampling until the last frame is on screen,
+        // so the display never has more than this frame queued behind it
+        const bool block = fp.lowLatency && !fp.pending.empty();
+        collect_presents(e, block ? 100'000'000ull : 0);
+    }
+    else {
+        fp.latencyMeasured = false;
+    }
+
+    const auto now = PacingClock::now();
+    record_interval(fp, ms_between(fp.lastFrame, now), e->scheduler.framesInFlight);
+    fp.lastFrame = now;
+    fp.input = now;
+}
+
+// ─── Present ──────────────────────────────────────────────────────────────────
+void frame_pacing_present(Engine* e, VkPresentInfoKHR& presentInfo)
+{
+    FramePacingState& fp = e->framePacing;
+    if (!fp.presentWaitSupported) return;
+
+    fp.presentIdInfo.swapchainCount = 1;
+    fp.presentIdInfo.pPresentIds = &(++fp.presentId);
+    fp.presentIdInfo.pNext = presentInfo.pNext;
+    presentInfo.pNext = &fp.presentIdInfo;
+    fp.pending.push_back({ fp.presentId, fp.input });
+
+    // A stalled display (minimised, occluded) must not grow this forever
+    if (fp.pending.size() > 16) fp.pending.pop_front();
+}
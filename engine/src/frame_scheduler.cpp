@@ -0,0 +1,92 @@
+#include "frame_scheduler.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_frame_scheduler(Engine* e)
+{
+    FrameSchedulerState& s = e->scheduler;
+    s.slotValue.assign(FRAME_OVERLAP, 0);
+    s.framesInFlight = std::clamp(s.framesInFlight, 1u, FRAME_OVERLAP);
+
+    VkSemaphoreTypeCreateInfo typeInfo{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO };
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+    typeInfo.initialValue = 0;
+    VkSemaphoreCreateInfo info{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, .pNext = &typeInfo };
+    VK_CHECK(vkCreateSemaphore(e->device, &info, nullptr, &s.timeline));
+
+    // Pushed early, so flushed after every module that may still retire
+    e->mainDeletionQueue.push_function([=]() {
+        FrameSchedulerState& s = e->scheduler;
+        for (RetiredResource& r : s.retired) r.destroy();    // device is idle by now
+        s.retired.clear();
+        vkDestroySemaphore(e->device, s.timeline, nullptr);
+        s.timeline = VK_NULL_HANDLE;
+        });
+
+    LOG("Frame scheduler: timeline semaphore, " << s.framesInFlight << " frames in flight");
+}
+
+// ─── Waiting ──────────────────────────────────────────────────────────────────
+float frame_scheduler_wait(Engine* e, uint64_t value)
+{
+    FrameSchedulerState& s = e->scheduler;
+    if (value <= s.completed) return 0.0f;
+
+    auto start = std::chrono::high_resolution_clock::now();
+    VkSemaphoreWaitInfo wait{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO };
+    wait.semaphoreCount = 1;
+    wait.pSemaphores = &s.timeline;
+    wait.pValues = &value;
+    VK_CHECK(vkWaitSemaphores(e->device, &wait, UINT64_MAX));
+    VK_CHECK(vkGetSemaphoreCounterValue(e->device, s.timeline, &s.completed));
+    return std::chrono::duration<float, std::milli>(std::chrono::high_resolution_clock::now() - start).count();
+}
+
+void frame_scheduler_begin_frame(Engine* e)
+{
+    FrameSchedulerState& s = e->scheduler;
+    s.framesInFlight = std::clamp(s.framesInFlight, 1u, FRAME_OVERLAP);
+
+    // The frame framesInFlight back; never younger than this slot's last use
+    uint64_t target = 0;
+    if (e->frameNumber >= (int)s.framesInFlight)
+        target = s.slotValue[(e->frameNumber - s.framesInFlight) % FRAME_OVERLAP];
+    s.gpuWaitMs = frame_scheduler_wait(e, target);
+
+    VK_CHECK(vkGetSemaphoreCounterValue(e->device, s.timeline, &s.completed));
+    s.retiredLastFrame = 0;
+    while (!s.retired.empty() && s.retired.front().value <= s.completed) {
+        s.retired.front().destroy();
+        s.retired.pop_front();
+        s.retiredLastFrame++;
+    }
+}
+
+// ─── Submission ───────────────────────────────────────────────────────────────
+VkSemaphoreSubmitInfo frame_scheduler_signal(Engine* e, VkPipelineStageFlags2 stage)
+{
+    FrameSchedulerState& s = e->scheduler;
+    VkSemaphoreSubmitInfo info = semaphore_submit_info(stage, s.timeline);
+    info.value = ++s.submitted;
+    return info;
+}
+
+void frame_scheduler_retire(Engine* e, std::function<void()> destroy)
+{
+    // Work recorded this frame signals submitted + 1 at the earliest
+    FrameSchedulerState& s = e->scheduler;
+    s.retired.push_back({ s.submitted + 1, std::move(destroy) });
+}
+
+VkResult frame_scheduler_acquire(Engine* e, VkSemaphore signal, uint32_t* imageIndex)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    VkResult result = vkAcquireNextImageKHR(e->device, e->swapchain, UINT64_MAX,
+        signal, VK_NULL_HANDLE, imageIndex);
+    e->scheduler.acquireWaitMs = std::chrono::duration<float, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    return result;
+}
@@ -0,0 +1,734 @@
+#include "gpu_culling.h"
+#include "engine.h"
+#include "graphics_pipeline.h"
+
+#include <cmath>
+
+// ─── Helpers ──────────────────────────────────────────────────────────────────
+static VkPipeline gpu_cull_compute_pipeline(Engine* e, const char* path, VkPipelineLayout layout)
+{
+    VkShaderModule shader = load_shader_or_exit(e, path);
+
+    VkPipelineShaderStageCreateInfo stage{ .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    stage.module = shader;
+    stage.pName = "main";
+
+    VkComputePipelineCreateInfo info{ .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    info.stage = stage;
+    info.layout = layout;
+
+    VkPipeline pipeline;
+    VK_CHECK(create_compute_pipeline(e, info, &pipeline));
+    vkDestroyShaderModule(e->device, shader, nullptr);
+    return pipeline;
+}
+
+static VkDeviceAddress gpu_cull_buffer_address(Engine* e, const AllocatedBuffer& buffer)
+{
+    VkBufferDeviceAddressInfo info{ .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO };
+    info.buffer = buffer.buffer;
+    return vkGetBufferDeviceAddress(e->device, &info);
+}
+
+static void gpu_cull_memory_barrier(VkCommandBuffer cmd,
+    VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+    VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    VkMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+// World AABB of a mesh-space box (Arvo), sphere wrapped around it
+static void gpu_cull_world_bounds(const glm::mat4& m, const glm::vec3& bmin,
+    const glm::vec3& bmax, GPUDrawItem& item)
+{
+    glm::vec3 c = glm::vec3(m * glm::vec4((bmin + bmax) * 0.5f, 1.0f));
+    glm::vec3 h = (bmax - bmin) * 0.5f;
+    glm::mat3 a = glm::mat3(m);
+    glm::vec3 ext(0.0f);
+    for (int col = 0; col < 3; ++col)
+        ext += glm::abs(a[col]) * h[col];
+
+    item.aabbMin = glm::vec4(c - ext, 0.0f);
+    item.aabbMax = glm::vec4(c + ext, 0.0f);
+    item.sphere = glm::vec4(c, glm::length(ext));
+}
+
+static void gpu_cull_destroy_items(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+    for (AllocatedBuffer* b : { &g.itemBuffer, &g.visibilityBuffer, &g.commandBuffer, &g.countBuffer }) {
+        if (b->buffer != VK_NULL_HANDLE) destroy_buffer(*b, e);
+        *b = {};
+    }
+    g.itemsBuilt = false;
+}
+
+// ─── Depth pyramid resources ──────────────────────────────────────────────────
+static void init_depth_pyramid(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+    VkExtent3D depthExtent = e->depthImage.imageExtent;
+
+    // Single-sample depth the MSAA depth buffer resolves into after the early pass
+    g.depthResolve = create_image(e, depthExtent, VK_FORMAT_D32_SFLOAT,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+
+    // Pyramid mip 0 is half resolution; each level halves again (rounding up)
+    g.pyramidExtent = { (depthExtent.width + 1) / 2, (depthExtent.height + 1) / 2 };
+    uint32_t largest = std::max(g.pyramidExtent.width, g.pyramidExtent.height);
+    g.pyramidMips = std::min(HIZ_MAX_MIPS, (uint32_t)std::floor(std::log2((float)largest)) + 1);
+
+    VkImageCreateInfo imgInfo = image_create_info(VK_FORMAT_R32_SFLOAT,
+        VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT,
+        { g.pyramidExtent.width, g.pyramidExtent.height, 1 });
+    imgInfo.mipLevels = g.pyramidMips;
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    g.pyramid.imageFormat = VK_FORMAT_R32_SFLOAT;
+    g.pyramid.imageExtent = imgInfo.extent;
+    g.pyramid.mipLevels = g.pyramidMips;
+    VK_CHECK(vmaCreateImage(e->allocator, &imgInfo, &allocInfo,
+        &g.pyramid.image, &g.pyramid.allocation, nullptr));
+
+    VkImageViewCreateInfo viewInfo = imageview_create_info(VK_FORMAT_R32_SFLOAT,
+        g.pyramid.image, VK_IMAGE_ASPECT_COLOR_BIT);
+    viewInfo.subresourceRange.levelCount = g.pyramidMips;
+    VK_CHECK(vkCreateImageView(e->device, &viewInfo, nullptr, &g.pyramid.imageView));
+
+    for (uint32_t mip = 0; mip < g.pyramidMips; ++mip) {
+        VkImageViewCreateInfo mipView = imageview_create_info(VK_FORMAT_R32_SFLOAT,
+            g.pyramid.image, VK_IMAGE_ASPECT_COLOR_BIT);
+        mipView.subresourceRange.baseMipLevel = mip;
+        mipView.subresourceRange.levelCount = 1;
+        VK_CHECK(vkCreateImageView(e->device, &mipView, nullptr, &g.pyramidMipViews[mip]));
+    }
+
+    // The pyramid lives in GENERAL for its whole life — written as storage,
+    // read with texelFetch by the cull shader
+    immediate_submit([&](VkCommandBuffer cmd) {
+        VkImageMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        barrier.image = g.pyramid.image;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, g.pyramidMips, 0, 1 };
+
+        VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dep.imageMemoryBarrierCount = 1;
+        dep.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &dep);
+        }, e);
+
+    // Whole pyramid in the bindless array for the cull shader
+    VkDescriptorImageInfo bindlessInfo{};
+    bindlessInfo.sampler = e->defaultSamplerNearest;
+    bindlessInfo.imageView = g.pyramid.imageView;
+    bindlessInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+
+    VkWriteDescriptorSet bindlessWrite{ .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET };
+    bindlessWrite.dstSet = e->bindlessSet;
+    bindlessWrite.dstBinding = 0;
+    bindlessWrite.dstArrayElement = g.pyramidBindlessIndex;
+    bindlessWrite.descriptorCount = 1;
+    bindlessWrite.descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+    bindlessWrite.pImageInfo = &bindlessInfo;
+    vkUpdateDescriptorSets(e->device, 1, &bindlessWrite, 0, nullptr);
+
+    // One set per mip: previous level (or resolved depth) → this level
+    DescriptorLayoutBuilder builder;
+    builder.add_binding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+    builder.add_binding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+    g.pyramidSetLayout = builder.build(e->device, VK_SHADER_STAGE_COMPUTE_BIT);
+
+    std::vector<DescriptorAllocator::PoolSizeRatio> sizes = {
+        { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1.0f },
+        { VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,          1.0f },
+    };
+    g.pyramidDescriptors.init_pool(e->device, HIZ_MAX_MIPS, sizes);
+
+    for (uint32_t mip = 0; mip < g.pyramidMips; ++mip) {
+        g.pyramidSets[mip] = g.pyramidDescriptors.allocate(e->device, g.pyramidSetLayout);
+
+        DescriptorWriter writer;
+        if (mip == 0)
+            writer.write_image(0, g.depthResolve.imageView, e->defaultSamplerNearest,
+                VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        else
+            writer.write_image(0, g.pyramidMipViews[mip - 1], e->defaultSamplerNearest,
+                VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER);
+        writer.write_image(1, g.pyramidMipViews[mip], VK_NULL_HANDLE,
+            VK_IMAGE_LAYOUT_GENERAL, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE);
+        writer.update_set(e->device, g.pyramidSets[mip]);
+    }
+
+    VkPushConstantRange pushRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(PyramidPushConstants) };
+    VkPipelineLayoutCreateInfo layoutInfo{ .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &g.pyramidSetLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &layoutInfo, nullptr, &g.pyramidLayout));
+
+    g.pyramidPipeline = gpu_cull_compute_pipeline(e, "shaders/depth_pyramid.comp.spv", g.pyramidLayout);
+
+    LOG("Hi-Z pyramid " << g.pyramidExtent.width << "x" << g.pyramidExtent.height
+        << ", " << g.pyramidMips << " mips at bindless slot " << g.pyramidBindlessIndex);
+}
+
+// ─── Cull + indirect draw pipelines ───────────────────────────────────────────
+static void init_gpu_cull_pipelines(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+
+    // ── Cull compute — bindless set for the pyramid + camera UBO
+    VkPushConstantRange cullRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(GpuCullPushConstants) };
+    VkPipelineLayoutCreateInfo cullLayoutInfo{ .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    cullLayoutInfo.setLayoutCount = 1;
+    cullLayoutInfo.pSetLayouts = &e->bindlessLayout;
+    cullLayoutInfo.pushConstantRangeCount = 1;
+    cullLayoutInfo.pPushConstantRanges = &cullRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &cullLayoutInfo, nullptr, &g.cullLayout));
+
+    g.cullPipeline = gpu_cull_compute_pipeline(e, "shaders/occlusion_cull.comp.spv", g.cullLayout);
+
+    // ── Indirect mesh pipeline — same state as meshPipeline, item-driven shaders
+    VkShaderModule vertShader = load_shader_or_exit(e, "shaders/mesh_indirect.vert.spv");
+    VkShaderModule fragShader = load_shader_or_exit(e, "shaders/tex_image_indirect.frag.spv");
+
+    VkPushConstantRange drawRange{};
+    drawRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+    drawRange.offset = 0;
+    drawRange.size = sizeof(GpuDrawPushConstants);
+
+    VkPipelineLayoutCreateInfo drawLayoutInfo{ .sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO };
+    drawLayoutInfo.setLayoutCount = 1;
+    drawLayoutInfo.pSetLayouts = &e->bindlessLayout;
+    drawLayoutInfo.pushConstantRangeCount = 1;
+    drawLayoutInfo.pPushConstantRanges = &drawRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &drawLayoutInfo, nullptr, &g.drawLayout));
+
+    VkVertexInputBindingDescription binding{};
+    binding.binding = 0;
+    binding.stride = sizeof(Vertex);
+    binding.inputRate = VK_VERTEX_INPUT_RATE_VERTEX;
+
+    std::vector<VkVertexInputAttributeDescription> attributes = {
+        { 0, 0, VK_FORMAT_R32G32B32_SFLOAT,    (uint32_t)offsetof(Vertex, position) },
+        { 1, 0, VK_FORMAT_R32G32_SFLOAT,       (uint32_t)offsetof(Vertex, uv)       },
+        { 2, 0, VK_FORMAT_R32G32B32_SFLOAT,    (uint32_t)offsetof(Vertex, normal)   },
+        { 3, 0, VK_FORMAT_R32G32B32A32_SFLOAT, (uint32_t)offsetof(Vertex, color)    },
+        { 4, 0, VK_FORMAT_R32G32B32A32_SFLOAT, (uint32_t)offsetof(Vertex, tangent)  },
+    };
+
+    VkPipelineVertexInputStateCreateInfo vertexInput{ .sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO };
+    vertexInput.vertexBindingDescriptionCount = 1;
+    vertexInput.pVertexBindingDescriptions = &binding;
+    vertexInput.vertexAttributeDescriptionCount = (uint32_t)attributes.size();
+    vertexInput.pVertexAttributeDescriptions = attributes.data();
+
+    PipelineBuilder pb;
+    set_shaders(vertShader, fragShader, pb);
+    set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, pb);
+    set_polygon_mode(VK_POLYGON_MODE_FILL, pb);
+    set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, pb);
+    set_multisampling(e->msaaSamples, pb);
+    enable_blending_alphablend(pb);
+    enable_depthtest(pb, VK_COMPARE_OP_LESS_OR_EQUAL);
+    set_color_attachment_format(e->drawImage.imageFormat, pb);
+    set_depth_format(e->depthImage.imageFormat, pb);
+    pb.vertexInputInfo = vertexInput;
+    pb.pipelineLayout = g.drawLayout;
+
+    g.drawPipeline = build_pipeline(e, pb);
+    if (g.drawPipeline == VK_NULL_HANDLE) {
+        LOG_ERROR("Failed to create indirect mesh pipeline");
+        std::exit(1);
+    }
+
+    vkDestroyShaderModule(e->device, vertShader, nullptr);
+    vkDestroyShaderModule(e->device, fragShader, nullptr);
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_gpu_culling(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+
+    // The pyramid must hold the farthest depth of every pixel, so the resolve
+    // has to be MAX. Any single sample can be nearer than the others and would
+    // cull geometry that shows through the pixel's other samples. Without MAX,
+    // the passes keep resolving SAMPLE_ZERO (always supported) but the cull
+    // shader is frustum only.
+    VkPhysicalDeviceDepthStencilResolveProperties resolveProps{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEPTH_STENCIL_RESOLVE_PROPERTIES };
+    VkPhysicalDeviceProperties2 props{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2 };
+    props.pNext = &resolveProps;
+    vkGetPhysicalDeviceProperties2(e->physicalDevice, &props);
+
+    g.occlusionSupported = (resolveProps.supportedDepthResolveModes & VK_RESOLVE_MODE_MAX_BIT) != 0;
+    g.depthResolveMode = g.occlusionSupported ? VK_RESOLVE_MODE_MAX_BIT : VK_RESOLVE_MODE_SAMPLE_ZERO_BIT;
+    if (!g.occlusionSupported) {
+        g.occlusion = false;
+        LOG_WARN("No MAX depth resolve — GPU culling is frustum only");
+    }
+
+    init_depth_pyramid(e);
+    init_gpu_cull_pipelines(e);
+
+    // ── Per-frame stats readback
+    g.statsBuffers.resize(FRAME_OVERLAP);
+    g.frameRecorded.assign(FRAME_OVERLAP, 0);
+    for (auto& buffer : g.statsBuffers) {
+        buffer = create_buffer(e->allocator, sizeof(GpuCullStats),
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_GPU_TO_CPU, e);
+        VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+        buffer.address = gpu_cull_buffer_address(e, buffer);
+    }
+
+    build_gpu_cull_items(e);
+
+    e->mainDeletionQueue.push_function([=]() {
+        GpuCullingState& g = e->gpuCulling;
+        gpu_cull_destroy_items(e);
+        for (auto& buffer : g.statsBuffers) {
+            vmaUnmapMemory(e->allocator, buffer.allocation);
+            destroy_buffer(buffer, e);
+        }
+
+        vkDestroyPipeline(e->device, g.drawPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, g.drawLayout, nullptr);
+        vkDestroyPipeline(e->device, g.cullPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, g.cullLayout, nullptr);
+        vkDestroyPipeline(e->device, g.pyramidPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, g.pyramidLayout, nullptr);
+        g.pyramidDescriptors.destroy_pool(e->device);
+        vkDestroyDescriptorSetLayout(e->device, g.pyramidSetLayout, nullptr);
+
+        for (uint32_t mip = 0; mip < g.pyramidMips; ++mip)
+            vkDestroyImageView(e->device, g.pyramidMipViews[mip], nullptr);
+        destroy_image(g.pyramid, e);
+        destroy_image(g.depthResolve, e);
+        });
+
+    LOG("GPU occlusion culling ready — depth resolve "
+        << (g.depthResolveMode == VK_RESOLVE_MODE_MAX_BIT ? "MAX" : "SAMPLE_ZERO"));
+}
+
+// ─── Draw items ───────────────────────────────────────────────────────────────
+void build_gpu_cull_items(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+
+    // Frames in flight may still read the old items — free them once the
+    // timeline is past, instead of draining the GPU
+    if (g.itemsBuilt) {
+        std::vector<AllocatedBuffer> old;
+        for (AllocatedBuffer* b : { &g.itemBuffer, &g.visibilityBuffer, &g.commandBuffer, &g.countBuffer }) {
+            if (b->buffer != VK_NULL_HANDLE) old.push_back(*b);
+            *b = {};
+        }
+        frame_scheduler_retire(e, [e, old]() {
+            for (const AllocatedBuffer& b : old) destroy_buffer(b, e);
+            });
+        g.itemsBuilt = false;
+    }
+
+    std::vector<GPUDrawItem> items;
+    g.assetFirstItem.assign(e->testMeshes.size(), 0);
+    g.assetItemCount.assign(e->testMeshes.size(), 0);
+
+    auto make_item = [&](uint32_t asset, const MeshAsset& mesh, const GeoSurface& surf,
+        uint32_t firstIndex, uint32_t indexCount) {
+            GPUDrawItem item{};
+            item.modelMatrix = mesh.worldTransform;
+            item.firstIndex = firstIndex;
+            item.indexCount = indexCount;
+            item.assetIndex = asset;
+            item.commandBase = g.assetFirstItem[asset];
+            item.albedoIndex = surf.albedoIndex;
+            item.normalIndex = surf.normalIndex;
+            item.metalRoughIndex = surf.metallicRoughnessIndex;
+            item.aoIndex = surf.aoIndex;
+            item.emissiveIndex = surf.emissiveIndex;
+            item.metallicFactor = surf.metallicFactor;
+            item.roughnessFactor = surf.roughnessFactor;
+            item.normalStrength = 1.0f;
+            item.colorFactor = surf.colorFactor;
+            return item;
+        };
+
+    for (uint32_t a = 0; a < (uint32_t)e->testMeshes.size(); ++a) {
+        const MeshAsset& mesh = *e->testMeshes[a];
+        g.assetFirstItem[a] = (uint32_t)items.size();
+
+        if (g.granularity == GpuCullGranularity::Cluster) {
+            for (const MeshCluster& c : mesh.clusters) {
+                GPUDrawItem item = make_item(a, mesh, mesh.surfaces[c.surfaceIndex], c.startIndex, c.count);
+                gpu_cull_world_bounds(mesh.worldTransform, c.boundsMin, c.boundsMax, item);
+                items.push_back(item);
+            }
+        }
+        else {
+            for (const GeoSurface& s : mesh.surfaces) {
+                GPUDrawItem item = make_item(a, mesh, s, s.startIndex, s.count);
+                gpu_cull_world_bounds(mesh.worldTransform, s.boundsMin, s.boundsMax, item);
+                items.push_back(item);
+            }
+        }
+
+        g.assetItemCount[a] = (uint32_t)items.size() - g.assetFirstItem[a];
+    }
+
+    g.itemCount = (uint32_t)items.size();
+    g.builtGranularity = g.granularity;
+    if (g.itemCount == 0) return;
+
+    const size_t itemBytes = items.size() * sizeof(GPUDrawItem);
+    const size_t assetCount = std::max<size_t>(e->testMeshes.size(), 1);
+
+    g.itemBuffer = create_buffer(e->allocator, itemBytes,
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY, e);
+    g.visibilityBuffer = create_buffer(e->allocator, g.itemCount * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY, e);
+    g.commandBuffer = create_buffer(e->allocator, 2 * g.itemCount * sizeof(VkDrawIndexedIndirectCommand),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY, e);
+    g.countBuffer = create_buffer(e->allocator, 2 * assetCount * sizeof(uint32_t),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_GPU_ONLY, e);
+
+    for (AllocatedBuffer* b : { &g.itemBuffer, &g.visibilityBuffer, &g.commandBuffer, &g.countBuffer })
+        b->address = gpu_cull_buffer_address(e, *b);
+
+    AllocatedBuffer staging = create_buffer(e->allocator, itemBytes,
+        VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, e);
+    void* data;
+    VK_CHECK(vmaMapMemory(e->allocator, staging.allocation, &data));
+    memcpy(data, items.data(), itemBytes);
+    vmaUnmapMemory(e->allocator, staging.allocation);
+
+    // Nothing visible "last frame" — the first frame draws everything late
+    immediate_submit([&](VkCommandBuffer cmd) {
+        VkBufferCopy copy{ .size = itemBytes };
+        vkCmdCopyBuffer(cmd, staging.buffer, g.itemBuffer.buffer, 1, &copy);
+        vkCmdFillBuffer(cmd, g.visibilityBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+        }, e);
+
+    destroy_buffer(staging, e);
+    g.itemsBuilt = true;
+
+    LOG("GPU cull items: " << g.itemCount << " ("
+        << (g.granularity == GpuCullGranularity::Cluster ? "clusters" : "surfaces") << ")");
+}
+
+// ─── Per-frame readback ───────────────────────────────────────────────────────
+void gpu_culling_begin_frame(Engine* e)
+{
+    GpuCullingState& g = e->gpuCulling;
+    if (g.statsBuffers.empty()) return;
+
+    uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    if (g.frameRecorded[slot]) {
+        const AllocatedBuffer& buffer = g.statsBuffers[slot];
+        vmaInvalidateAllocation(e->allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+        memcpy(&g.stats, buffer.info.pMappedData, sizeof(GpuCullStats));
+        g.frameRecorded[slot] = 0;
+    }
+
+    if (g.enabled && (!g.itemsBuilt || g.builtGranularity != g.granularity))
+        build_gpu_cull_items(e);
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+static void gpu_cull_dispatch(Engine* e, VkCommandBuffer cmd, GpuCullPushConstants& push, uint32_t phase)
+{
+    push.phase = phase;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, e->gpuCulling.cullPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+        e->gpuCulling.cullLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+    vkCmdPushConstants(cmd, e->gpuCulling.cullLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(GpuCullPushConstants), &push);
+    vkCmdDispatch(cmd, (push.itemCount + 63) / 64, 1, 1);
+
+    gpu_cull_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+}
+
+static uint32_t gpu_cull_draw_phase(Engine* e, VkCommandBuffer cmd, uint32_t phase)
+{
+    GpuCullingState& g = e->gpuCulling;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, g.drawPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+        g.drawLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+    VkViewport viewport{ 0, 0,
+        (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    VkRect2D scissor{ {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    GpuDrawPushConstants push{};
+    push.items = g.itemBuffer.address;
+    push.sunDirection = glm::normalize(e->sunDirection);
+    push.sunColor = e->sunColor;
+    push.sunIntensity = e->sunIntensity;
+    push.shadowMapIndex = e->shadowMapBindlessIndex;
+    push.shadowBias = e->shadowBias;
+    push.iblIrradianceIndex = e->iblIrradianceIndex;
+    push.iblPrefilterIndex = e->iblPrefilterIndex;
+    push.iblBrdfLutIndex = e->iblBrdfLutIndex;
+    vkCmdPushConstants(cmd, g.drawLayout,
+        VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(GpuDrawPushConstants), &push);
+
+    const uint32_t assetCount = (uint32_t)e->testMeshes.size();
+    uint32_t drawCalls = 0;
+
+    for (uint32_t a = 0; a < assetCount; ++a) {
+        if (g.assetItemCount[a] == 0) continue;
+        const MeshAsset& mesh = *e->testMeshes[a];
+
+        VkDeviceSize offset = 0;
+        vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.meshBuffers.vertexBuffer.buffer, &offset);
+        vkCmdBindIndexBuffer(cmd, mesh.meshBuffers.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+
+        VkDeviceSize commandOffset = ((VkDeviceSize)phase * g.itemCount + g.assetFirstItem[a])
+            * sizeof(VkDrawIndexedIndirectCommand);
+        VkDeviceSize countOffset = ((VkDeviceSize)phase * assetCount + a) * sizeof(uint32_t);
+
+        vkCmdDrawIndexedIndirectCount(cmd,
+            g.commandBuffer.buffer, commandOffset,
+            g.countBuffer.buffer, countOffset,
+            g.assetItemCount[a], sizeof(VkDrawIndexedIndirectCommand));
+        drawCalls++;
+    }
+    return drawCalls;
+}
+
+static void gpu_cull_build_pyramid(Engine* e, VkCommandBuffer cmd)
+{
+    GpuCullingState& g = e->gpuCulling;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, g.pyramidPipeline);
+
+    // Only the drawExtent sub-rect holds this frame's depth; the clamped fetch
+    // keeps every level inside it
+    VkExtent2D src = e->drawExtent;
+    VkExtent2D dst = { (src.width + 1) / 2, (src.height + 1) / 2 };
+
+    for (uint32_t mip = 0; mip < g.pyramidMips; ++mip) {
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+            g.pyramidLayout, 0, 1, &g.pyramidSets[mip], 0, nullptr);
+
+        PyramidPushConstants push{};
+        push.srcSize = glm::ivec2(src.width, src.height);
+        push.dstSize = glm::ivec2(dst.width, dst.height);
+        vkCmdPushConstants(cmd, g.pyramidLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+            0, sizeof(PyramidPushConstants), &push);
+        vkCmdDispatch(cmd, (dst.width + 15) / 16, (dst.height + 15) / 16, 1);
+
+        // Next level reads this one; the last barrier hands the pyramid to the cull
+        VkImageMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+        barrier.image = g.pyramid.image;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.srcAccessMask = VK_ACCESS_2_SHADER_WRITE_BIT;
+        barrier.dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+        barrier.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+        barrier.subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, mip, 1, 0, 1 };
+
+        VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+        dep.imageMemoryBarrierCount = 1;
+        dep.pImageMemoryBarriers = &barrier;
+        vkCmdPipelineBarrier2(cmd, &dep);
+
+        src = dst;
+        dst = { std::max(1u, (dst.width + 1) / 2), std::max(1u, (dst.height + 1) / 2) };
+    }
+}
+
+void draw_geometry_gpu_culled(Engine* e, VkCommandBuffer cmd)
+{
+    GpuCullingState& g = e->gpuCulling;
+    if (!g.itemsBuilt || g.itemCount == 0) {
+        draw_geometry(e, cmd);
+        return;
+    }
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    const AllocatedBuffer& statsBuffer = g.statsBuffers[slot];
+    Frustum frustum = frustum_from_matrix(e->cameraViewProj);
+
+    GpuCullPushConstants push{};
+    for (int i = 0; i < 6; ++i) push.frustum[i] = frustum.planes[i];
+    push.items = g.itemBuffer.address;
+    push.visibility = g.visibilityBuffer.address;
+    push.commands = g.commandBuffer.address;
+    push.counts = g.countBuffer.address;
+    push.stats = statsBuffer.address;
+    push.itemCount = g.itemCount;
+    push.assetCount = (uint32_t)e->testMeshes.size();
+    push.pyramidIndex = g.pyramidBindlessIndex;
+    push.depthSize = glm::vec2(e->drawExtent.width, e->drawExtent.height);    // dynamic-resolution sub-rect
+    push.pyramidMips = g.pyramidMips;
+    push.occlusionEnabled = g.occlusion && g.occlusionSupported ? 1u : 0u;
+
+    // ── 1. Reset counters — previous frames may still be reading them ─────────
+    gpu_cull_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+    vkCmdFillBuffer(cmd, g.countBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+    vkCmdFillBuffer(cmd, statsBuffer.buffer, 0, VK_WHOLE_SIZE, 0);
+    gpu_cull_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+    // ── 2. Early cull: last frame's visible set ───────────────────────────────
+    gpu_cull_dispatch(e, cmd, push, 0);
+
+    // ── 3. Early pass — clears, draws, resolves depth for the pyramid ─────────
+    VkImageMemoryBarrier2 toResolve{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    toResolve.image = g.depthResolve.image;
+    toResolve.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toResolve.newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    toResolve.srcStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    toResolve.dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+        | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    toResolve.dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+        | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    toResolve.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+
+    VkDependencyInfo resolveDep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    resolveDep.imageMemoryBarrierCount = 1;
+    resolveDep.pImageMemoryBarriers = &toResolve;
+    vkCmdPipelineBarrier2(cmd, &resolveDep);
+
+    VkRenderingAttachmentInfo colorAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    colorAttachment.imageView = e->msaaImage.imageView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;   // late pass continues on it
+    colorAttachment.clearValue = { {0.0f, 0.0f, 0.0f, 0.0f} };
+
+    VkRenderingAttachmentInfo depthAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    depthAttachment.imageView = e->depthImage.imageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.clearValue.depthStencil.depth = 1.0f;
+    depthAttachment.resolveMode = g.depthResolveMode;
+    depthAttachment.resolveImageView = g.depthResolve.imageView;
+    depthAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+
+    VkRenderingInfo renderInfo{ .sType = VK_STRUCTURE_TYPE_RENDERING_INFO };
+    renderInfo.renderArea = { {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+    renderInfo.layerCount = 1;
+    renderInfo.colorAttachmentCount = 1;
+    renderInfo.pColorAttachments = &colorAttachment;
+    renderInfo.pDepthAttachment = &depthAttachment;
+
+    vkCmdBeginRendering(cmd, &renderInfo);
+    draw_skybox(e, cmd);
+    uint32_t drawCalls = gpu_cull_draw_phase(e, cmd, 0);
+    vkCmdEndRendering(cmd);
+
+    // ── 4. Hi-Z pyramid from the resolved early depth ─────────────────────────
+    VkImageMemoryBarrier2 barriers[3]{};
+    barriers[0] = { .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    barriers[0].image = g.depthResolve.image;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+    barriers[0].srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT
+        | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barriers[0].srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT
+        | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[0].dstStageMask = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
+    barriers[0].subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+
+    // The late pass keeps drawing into the same MSAA colour + depth
+    barriers[1] = { .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    barriers[1].image = e->depthImage.image;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    barriers[1].srcStageMask = VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barriers[1].srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[1].dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT
+        | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
+        | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    barriers[1].subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+
+    barriers[2] = { .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    barriers[2].image = e->msaaImage.image;
+    barriers[2].oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[2].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    barriers[2].srcStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barriers[2].srcAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[2].dstStageMask = VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT;
+    barriers[2].dstAccessMask = VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT
+        | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT;
+    barriers[2].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 };
+
+    VkDependencyInfo passDep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    passDep.imageMemoryBarrierCount = 3;
+    passDep.pImageMemoryBarriers = barriers;
+    vkCmdPipelineBarrier2(cmd, &passDep);
+
+    gpu_profiler_begin(e, cmd, "hi-z pyramid");
+    gpu_cull_build_pyramid(e, cmd);
+    gpu_profiler_end(e, cmd);
+
+    // ── 5. Late cull: everything against the pyramid ──────────────────────────
+    gpu_cull_dispatch(e, cmd, push, 1);
+
+    // ── 6. Late pass — newly visible items, resolves colour into drawImage ────
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+    colorAttachment.resolveImageView = e->drawImage.imageView;
+    colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.resolveMode = VK_RESOLVE_MODE_NONE;
+    depthAttachment.resolveImageView = VK_NULL_HANDLE;
+
+    vkCmdBeginRendering(cmd, &renderInfo);
+    drawCalls += gpu_cull_draw_phase(e, cmd, 1);
+    vkCmdEndRendering(cmd);
+
+    g.frameRecorded[slot] = 1;
+    e->lastDrawCalls = drawCalls;
+    e->lastTriangles = g.stats.triangles;
+}
@@ -0,0 +1,242 @@
+#include "gpu_profiler.h"
+#include "engine.h"
+
+#include <fstream>
+
+// Results come back in bit order: primitives, vertex, fragment
+static constexpr VkQueryPipelineStatisticFlags PROFILER_STATISTICS =
+    VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_PRIMITIVES_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+    VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_gpu_profiler(Engine* e)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(e->physicalDevice, &props);
+    gp.timestampPeriod = props.limits.timestampPeriod;
+
+    uint32_t familyCount = 0;
+    vkGetPhysicalDeviceQueueFamilyProperties(e->physicalDevice, &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vkGetPhysicalDeviceQueueFamilyProperties(e->physicalDevice, &familyCount, families.data());
+    const uint32_t validBits = families[e->graphicsQueueFamily].timestampValidBits;
+    gp.timestampMask = validBits >= 64 ? ~0ull : (1ull << validBits) - 1;
+
+    VkQueryPoolCreateInfo queryInfo{ .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+    queryInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryInfo.queryCount = 2 * GPU_PROFILER_MAX_SCOPES * FRAME_OVERLAP;
+    VK_CHECK(vkCreateQueryPool(e->device, &queryInfo, nullptr, &gp.timestampPool));
+
+    if (gp.statisticsSupported) {
+        gp.statisticFlags = PROFILER_STATISTICS;
+        VkQueryPoolCreateInfo statsInfo{ .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO };
+        statsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statsInfo.queryCount = GPU_PROFILER_MAX_SCOPES * FRAME_OVERLAP;
+        statsInfo.pipelineStatistics = PROFILER_STATISTICS;
+        VK_CHECK(vkCreateQueryPool(e->device, &statsInfo, nullptr, &gp.statisticsPool));
+    }
+    gp.frameScopes.assign(FRAME_OVERLAP, {});
+
+    e->mainDeletionQueue.push_function([=]() {
+        GpuProfilerState& gp = e->gpuProfiler;
+        if (gp.statisticsPool != VK_NULL_HANDLE)
+            vkDestroyQueryPool(e->device, gp.statisticsPool, nullptr);
+        vkDestroyQueryPool(e->device, gp.timestampPool, nullptr);
+        });
+
+    LOG("GPU profiler: " << GPU_PROFILER_MAX_SCOPES << " scopes per frame, pipeline statistics "
+        << (gp.statisticsSupported ? "available" : "unavailable"));
+}
+
+// ─── Readback ─────────────────────────────────────────────────────────────────
+void gpu_profiler_begin_frame(Engine* e)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+    if (gp.frameScopes.empty()) return;
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    std::vector<GpuScope>& scopes = gp.frameScopes[slot];
+    if (scopes.empty()) return;
+
+    const uint32_t count = (uint32_t)scopes.size();
+    uint64_t ticks[2 * GPU_PROFILER_MAX_SCOPES];
+    VkResult result = vkGetQueryPoolResults(e->device, gp.timestampPool, slot * 2 * GPU_PROFILER_MAX_SCOPES,
+        2 * count, sizeof(ticks), ticks, sizeof(uint64_t), VK_QUERY_RESULT_64_BIT);
+
+    // Unused statistics queries are reset but never written, so only the
+    // scopes that owned one are fetched
+    uint64_t counters[GPU_PROFILER_MAX_SCOPES][GPU_PROFILER_STATISTICS] = {};
+    for (uint32_t i = 0; result == VK_SUCCESS && i < count; ++i) {
+        if (!scopes[i].statistics) continue;
+        if (vkGetQueryPoolResults(e->device, gp.statisticsPool, slot * GPU_PROFILER_MAX_SCOPES + i, 1,
+            sizeof(counters[i]), counters[i], sizeof(counters[i]), VK_QUERY_RESULT_64_BIT) != VK_SUCCESS)
+            scopes[i].statistics = false;
+    }
+
+    if (result == VK_SUCCESS) {
+        const uint64_t origin = ticks[0] & gp.timestampMask;
+        auto to_ms = [&](uint64_t tick) {
+            return (float)((double)((tick & gp.timestampMask) - origin) * gp.timestampPeriod / 1e6);
+            };
+
+        std::vector<std::string> path;
+        gp.results.resize(count);
+        for (uint32_t i = 0; i < count; ++i) {
+            const GpuScope& s = scopes[i];
+            GpuScopeResult& r = gp.results[i];
+            r.name = s.name;
+            r.depth = s.depth;
+            r.startMs = to_ms(ticks[2 * i]);
+            r.ms = to_ms(ticks[2 * i + 1]) - r.startMs;
+
+            // Same name under different parents averages separately
+            path.resize(s.depth);
+            path.push_back(s.depth > 0 ? path[s.depth - 1] + "/" + s.name : s.name);
+            auto [it, inserted] = gp.averages.try_emplace(path.back(), r.ms);
+            if (!inserted) it->second += (r.ms - it->second) * gp.smoothing;
+            r.avgMs = it->second;
+
+            r.hasStatistics = s.statistics;
+            for (uint32_t c = 0; c < GPU_PROFILER_STATISTICS; ++c)
+                r.statistics[c] = s.statistics ? counters[i][c] : 0;
+
+            // The frame and its passes; nested scopes stay in the profiler
+            if (s.depth <= 1) telemetry_gpu(e, s.name.c_str(), r.ms);
+        }
+        gp.resultFrame = e->frameNumber - (int)FRAME_OVERLAP;
+    }
+    scopes.clear();
+}
+
+void gpu_profiler_drain(Engine* e, const std::function<void()>& resolved)
+{
+    const int frameNumber = e->frameNumber;
+    for (uint32_t i = 0; i < FRAME_OVERLAP; ++i, ++e->frameNumber) {
+        gpu_profiler_begin_frame(e);
+        resolved();
+    }
+    e->frameNumber = frameNumber;
+}
+
+// ─── Scopes ───────────────────────────────────────────────────────────────────
+void gpu_profiler_frame_begin(Engine* e, VkCommandBuffer cmd)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+    gp.recording = !gp.frameScopes.empty();
+    gp.recordingScopes = gp.recording && gp.enabled;
+    gp.recordingStatistics = gp.recordingScopes && gp.statistics && gp.statisticsPool != VK_NULL_HANDLE;
+    gp.statisticsOpen = false;
+    gp.open.clear();
+    if (!gp.recording) return;
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    vkCmdResetQueryPool(cmd, gp.timestampPool, slot * 2 * GPU_PROFILER_MAX_SCOPES, 2 * GPU_PROFILER_MAX_SCOPES);
+    if (gp.recordingStatistics)
+        vkCmdResetQueryPool(cmd, gp.statisticsPool, slot * GPU_PROFILER_MAX_SCOPES, GPU_PROFILER_MAX_SCOPES);
+
+    gp.frameScopes[slot].clear();
+    gp.frameScopes[slot].reserve(GPU_PROFILER_MAX_SCOPES);
+    gpu_profiler_begin(e, cmd, "frame");
+}
+
+void gpu_profiler_frame_end(Engine* e, VkCommandBuffer cmd)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+    while (!gp.open.empty())             // the root, and anything left open
+        gpu_profiler_end(e, cmd);
+    gp.recording = false;
+}
+
+void gpu_profiler_begin(Engine* e, VkCommandBuffer cmd, const char* name)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+    if (!gp.recording) return;
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    std::vector<GpuScope>& scopes = gp.frameScopes[slot];
+    if (!gp.recordingScopes && !gp.open.empty()) {
+        gp.open.push_back(UINT32_MAX);   // only the root while disabled
+        return;
+    }
+    if (scopes.size() == GPU_PROFILER_MAX_SCOPES) {
+        gp.droppedScopes++;
+        gp.open.push_back(UINT32_MAX);   // keeps gpu_profiler_end balanced
+        return;
+    }
+
+    const uint32_t index = (uint32_t)scopes.size();
+    GpuScope& scope = scopes.emplace_back();
+    scope.name = name;
+    scope.depth = (uint32_t)gp.open.size();
+    gp.open.push_back(index);
+
+    // ALL_COMMANDS: the mark lands once everything recorded before it is done
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, gp.timestampPool,
+        (slot * GPU_PROFILER_MAX_SCOPES + index) * 2);
+
+    // One statistics query at a time: the outermost scope below the root
+    if (gp.recordingStatistics && !gp.statisticsOpen && scope.depth > 0) {
+        vkCmdBeginQuery(cmd, gp.statisticsPool, slot * GPU_PROFILER_MAX_SCOPES + index, 0);
+        scope.statistics = true;
+        gp.statisticsOpen = true;
+    }
+}
+
+void gpu_profiler_end(Engine* e, VkCommandBuffer cmd)
+{
+    GpuProfilerState& gp = e->gpuProfiler;
+    if (!gp.recording || gp.open.empty()) return;
+
+    const uint32_t index = gp.open.back();
+    gp.open.pop_back();
+    if (index == UINT32_MAX) return;
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    const GpuScope& scope = gp.frameScopes[slot][index];
+    if (scope.statistics) {
+        vkCmdEndQuery(cmd, gp.statisticsPool, slot * GPU_PROFILER_MAX_SCOPES + index);
+        gp.statisticsOpen = false;
+    }
+    vkCmdWriteTimestamp2(cmd, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT, gp.timestampPool,
+        (slot * GPU_PROFILER_MAX_SCOPES + index) * 2 + 1);
+}
+
+// ─── Lookup ───────────────────────────────────────────────────────────────────
+const GpuScopeResult* gpu_profiler_find(const Engine* e, std::string_view name)
+{
+    for (const GpuScopeResult& r : e->gpuProfiler.results)
+        if (r.name == name) return &r;
+    return nullptr;
+}
+
+float gpu_profiler_ms(const Engine* e, std::string_view name)
+{
+    const GpuScopeResult* r = gpu_profiler_find(e, name);
+    return r ? r->ms : 0.0f;
+}
+
+// ─── Dump ─────────────────────────────────────────────────────────────────────
+bool gpu_profiler_dump_csv(const Engine* e, const char* path)
+{
+    const GpuProfilerState& gp = e->gpuProfiler;
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("GPU profiler: cannot write " << path);
+        return false;
+    }
+
+    out << "frame,scope,depth,start_ms,ms,avg_ms,primitives,vertex_invocations,fragment_invocations\n";
+    for (const GpuScopeResult& r : gp.results) {
+        out << gp.resultFrame << ',' << r.name << ',' << r.depth << ','
+            << r.startMs << ',' << r.ms << ',' << r.avgMs;
+        for (uint32_t c = 0; c < GPU_PROFILER_STATISTICS; ++c) {
+            out << ',';
+            if (r.hasStatistics) out << r.statistics[c];
+        }
+        out << '\n';
+    }
+    return true;
+}
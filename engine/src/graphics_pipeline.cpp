@@ -1,6 +1,10 @@
 #include "graphics_pipeline.h"
 #include "iostream"
+#include "log.h"
 #include "helper.h"
+#include "pipeline_cache.h"
+#include "engine.h"
+#include <algorithm>
 #include <vulkan/vulkan_core.h>
 
 Utils utils;
@@ -34,7 +38,7 @@ PipelineBuilder::PipelineBuilder()
 
 // You can now delete your `clear` function.
 
-VkPipeline build_pipeline(VkDevice device, PipelineBuilder& pb)
+VkPipeline build_pipeline(Engine* e, PipelineBuilder& pb)
 {
     // Viewport state
     VkPipelineViewportStateCreateInfo viewportState{};
@@ -42,12 +46,19 @@ VkPipeline build_pipeline(VkDevice device, PipelineBuilder& pb)
     viewportState.viewportCount = 1;
     viewportState.scissorCount = 1;
 
-    // Color blending
+    // Color blending — the first attachment carries the builder's blend state,
+    // any further ones (MRT) write through
+    std::vector<VkPipelineColorBlendAttachmentState> blendAttachments(
+        std::max(1u, pb.renderInfo.colorAttachmentCount), VkPipelineColorBlendAttachmentState{});
+    blendAttachments[0] = pb.colorBlendAttachment;
+    for (size_t i = 1; i < blendAttachments.size(); ++i)
+        blendAttachments[i].colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+
     VkPipelineColorBlendStateCreateInfo colorBlending{};
     colorBlending.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
     colorBlending.logicOpEnable = VK_FALSE;
-    colorBlending.attachmentCount = 1;
-    colorBlending.pAttachments = &pb.colorBlendAttachment;
+    colorBlending.attachmentCount = (uint32_t)blendAttachments.size();
+    colorBlending.pAttachments = blendAttachments.data();
 
     // Vertex input
     VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
@@ -75,28 +86,18 @@ VkPipeline build_pipeline(VkDevice device, PipelineBuilder& pb)
     pipelineInfo.pDynamicState = &dynamicInfo;
     pipelineInfo.layout = pb.pipelineLayout;
     pipelineInfo.pVertexInputState = &pb.vertexInputInfo;
-    // Debug logs
     if (pb.pipelineLayout == VK_NULL_HANDLE) {
-        std::cerr << "❌ Pipeline layout is NULL!" << std::endl;
+        LOG_CAT(Pipeline, Error, "Pipeline layout is NULL");
     }
-    std::cout << "Creating pipeline with " << pb.shaderStages.size() << " shader stages" << std::endl;
-
-    // In build_pipeline, right before vkCreateGraphicsPipelines:
-    std::cout << "pipelineLayout: " << pb.pipelineLayout << std::endl;
-    std::cout << "renderInfo sType: " << pb.renderInfo.sType << std::endl;
-    std::cout << "colorAttachmentCount: " << pb.renderInfo.colorAttachmentCount << std::endl;
-    std::cout << "depthFormat: " << pb.renderInfo.depthAttachmentFormat << std::endl;
 
     VkPipeline newPipeline = VK_NULL_HANDLE;
-    VkResult result = vkCreateGraphicsPipelines(
-        device, VK_NULL_HANDLE, 1, &pipelineInfo, nullptr, &newPipeline);
+    VkResult result = create_graphics_pipeline(e, pipelineInfo, &newPipeline);
 
     if (result != VK_SUCCESS) {
-        std::cerr << "❌ vkCreateGraphicsPipelines failed with error code: " << result << std::endl;
+        LOG_CAT(Pipeline, Error, "vkCreateGraphicsPipelines failed with error code " << result);
         return VK_NULL_HANDLE;
     }
 
-    std::cout << "✅ Graphics pipeline created successfully!" << std::endl;
     return newPipeline;
 }
 
@@ -159,6 +160,13 @@ void set_color_attachment_format(VkFormat format, PipelineBuilder& pb)
     pb.renderInfo.pColorAttachmentFormats = &pb.colorAttachmentformat;
 }
 
+void set_color_attachment_formats(const std::vector<VkFormat>& formats, PipelineBuilder& pb)
+{
+    pb.colorAttachmentFormats = formats;
+    pb.renderInfo.colorAttachmentCount = (uint32_t)pb.colorAttachmentFormats.size();
+    pb.renderInfo.pColorAttachmentFormats = pb.colorAttachmentFormats.data();
+}
+
 void disable_blending(PipelineBuilder& pb)
 {
     pb.colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_A_BIT;
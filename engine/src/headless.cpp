@@ -0,0 +1,185 @@
+#include "headless.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_headless(Engine* e, const HeadlessConfig& config)
+{
+    e->headless.enabled = true;
+    e->headless.config = config;
+    e->headless.config.frames = std::max(1u, config.frames);   // the last one is captured
+    init(e, config.width, config.height);      // keeps e->headless
+    e->dynamicRes.enabled = config.dynamicResolution;
+    e->dynamicRes.scale = 1.0f;
+}
+
+void headless_create_target(Engine* e)
+{
+    HeadlessState& h = e->headless;
+    const VkExtent3D extent{ h.config.width, h.config.height, 1 };
+
+    // What the rest of the engine reads off the swapchain
+    e->swapchainImageFormat = VK_FORMAT_B8G8R8A8_UNORM;
+    e->swapchainExtent = { extent.width, extent.height };
+
+    h.target = create_image(e, extent, e->swapchainImageFormat,
+        VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    h.readback = create_buffer(e->allocator, (size_t)extent.width * extent.height * 4,
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU, e);
+    VK_CHECK(vmaMapMemory(e->allocator, h.readback.allocation, &h.readback.info.pMappedData));
+
+    h.cpuMs.reserve(h.config.frames);
+    h.gpuMs.assign(h.config.frames, -1.0f);
+
+    e->mainDeletionQueue.push_function([=]() {
+        HeadlessState& h = e->headless;
+        vmaUnmapMemory(e->allocator, h.readback.allocation);
+        destroy_buffer(h.readback, e);
+        destroy_image(h.target, e);
+        });
+
+    LOG("Headless: " << extent.width << "x" << extent.height << " offscreen target, "
+        << h.config.frames << " frames");
+}
+
+// ─── Readback ─────────────────────────────────────────────────────────────────
+void headless_record_readback(Engine* e, VkCommandBuffer cmd)
+{
+    HeadlessState& h = e->headless;
+    if (!h.captureFrame) return;
+
+    VkBufferImageCopy region{};
+    region.imageSubresource = { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 };
+    region.imageExtent = h.target.imageExtent;
+    vkCmdCopyImageToBuffer(cmd, h.target.image, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        h.readback.buffer, 1, &region);
+
+    // The timeline signal only makes the copy available to the device
+    VkMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask = VK_PIPELINE_STAGE_2_COPY_BIT;
+    barrier.srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT;
+    barrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT;
+    barrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT;
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+// ─── Output ───────────────────────────────────────────────────────────────────
+static bool write_ppm(Engine* e, const std::string& path)
+{
+    HeadlessState& h = e->headless;
+    VK_CHECK(vmaInvalidateAllocation(e->allocator, h.readback.allocation, 0, VK_WHOLE_SIZE));
+
+    std::ofstream out(path, std::ios::binary);
+    if (!out) {
+        LOG_ERROR("Headless: cannot write " << path);
+        return false;
+    }
+
+    const uint32_t width = h.target.imageExtent.width, height = h.target.imageExtent.height;
+    out << "P6\n" << width << ' ' << height << "\n255\n";
+
+    // BGRA to RGB, one row at a time
+    const uint8_t* pixels = (const uint8_t*)h.readback.info.pMappedData;
+    std::vector<uint8_t> row(width * 3);
+    for (uint32_t y = 0; y < height; ++y) {
+        const uint8_t* src = pixels + (size_t)y * width * 4;
+        for (uint32_t x = 0; x < width; ++x) {
+            row[x * 3 + 0] = src[x * 4 + 2];
+            row[x * 3 + 1] = src[x * 4 + 1];
+            row[x * 3 + 2] = src[x * 4 + 0];
+        }
+        out.write((const char*)row.data(), (std::streamsize)row.size());
+    }
+    return (bool)out;
+}
+
+static void write_series(std::ofstream& out, const char* name, const std::vector<float>& ms)
+{
+    float lo = 0.0f, hi = 0.0f, sum = 0.0f;
+    uint32_t count = 0;
+    for (float v : ms) {
+        if (v < 0.0f) continue;
+        lo = count ? std::min(lo, v) : v;
+        hi = count ? std::max(hi, v) : v;
+        sum += v;
+        count++;
+    }
+
+    out << "  \"" << name << "\": {\"frames\": " << count
+        << ", \"min_ms\": " << lo << ", \"avg_ms\": " << (count ? sum / (float)count : 0.0f)
+        << ", \"max_ms\": " << hi << ", \"ms\": [";
+    for (size_t i = 0; i < ms.size(); ++i)
+        out << (i ? ", " : "") << ms[i];
+    out << "]}";
+}
+
+static bool write_stats(Engine* e, const std::string& path)
+{
+    const HeadlessState& h = e->headless;
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("Headless: cannot write " << path);
+        return false;
+    }
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(e->physicalDevice, &props);
+
+    out.setf(std::ios::fixed);
+    out.precision(3);
+    out << "{\n  \"device\": \"" << props.deviceName << "\",\n"
+        << "  \"width\": " << h.config.width << ",\n"
+        << "  \"height\": " << h.config.height << ",\n"
+        << "  \"frames\": " << h.config.frames << ",\n"
+        << "  \"fixed_delta_ms\": " << h.config.fixedDeltaTime * 1000.0f << ",\n"
+        << "  \"dynamic_resolution\": " << (h.config.dynamicResolution ? "true" : "false") << ",\n"
+        << "  \"ray_tracing\": " << (e->rayTracingSupported ? "true" : "false") << ",\n"
+        << "  \"pipeline_statistics\": " << (e->gpuProfiler.statisticsSupported ? "true" : "false") << ",\n";
+    write_series(out, "cpu", h.cpuMs);
+    out << ",\n";
+    write_series(out, "gpu", h.gpuMs);
+    out << "\n}\n";
+    return (bool)out;
+}
+
+// ─── Run ──────────────────────────────────────────────────────────────────────
+// The profiler resolves a slot FRAME_OVERLAP frames late; store whatever the
+// last readback produced
+static void collect_gpu_time(Engine* e)
+{
+    const GpuProfilerState& gp = e->gpuProfiler;
+    HeadlessState& h = e->headless;
+    if (gp.resultFrame >= 0 && gp.resultFrame < (int)h.gpuMs.size() && !gp.results.empty())
+        h.gpuMs[gp.resultFrame] = gp.results[0].ms;
+}
+
+int headless_run(Engine* e)
+{
+    HeadlessState& h = e->headless;
+    for (uint32_t i = 0; i < h.config.frames; ++i) {
+        cpu_profiler_frame();
+        CPU_ZONE("frame");
+        h.captureFrame = i + 1 == h.config.frames;
+
+        const auto start = std::chrono::steady_clock::now();
+        engine_draw_frame(e);
+        h.cpuMs.push_back(std::chrono::duration<float, std::milli>(
+            std::chrono::steady_clock::now() - start).count());
+        collect_gpu_time(e);
+    }
+    VK_CHECK(vkDeviceWaitIdle(e->device));
+
+    gpu_profiler_drain(e, [e]() { collect_gpu_time(e); });
+
+    const bool ok = write_ppm(e, h.config.imagePath) && write_stats(e, h.config.statsPath);
+    if (ok)
+        LOG("Headless: " << h.config.frames << " frames, image " << h.config.imagePath
+            << ", stats " << h.config.statsPath);
+    return ok ? 0 : 1;
+}
@@ -1,10 +1,22 @@
 #include "helper.h"
 #include <vulkan/vulkan_core.h>
+#include "shader_bundle.h"
 
 bool Utils::load_shader_module(const char* filePath,
     VkDevice device,
     VkShaderModule* outShaderModule)
 {
+    // Prebuilt bundle first — the words are used straight from the mapping
+    if (bundle) {
+        std::span<const uint32_t> code = shader_bundle_find(*bundle, filePath);
+        if (!code.empty()) {
+            VkShaderModuleCreateInfo createInfo{ .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO };
+            createInfo.codeSize = code.size_bytes();
+            createInfo.pCode = code.data();
+            return vkCreateShaderModule(device, &createInfo, nullptr, outShaderModule) == VK_SUCCESS;
+        }
+    }
+
     // open the file. With cursor at the end
     std::ifstream file(filePath, std::ios::ate | std::ios::binary);
 
@@ -5,6 +5,7 @@
 // ─── Load HDR from disk and upload to GPU ─────────────────────────────────────
 AllocatedImage load_hdri(Engine* e, const char* filepath)
 {
+    CPU_ZONE("load_hdri");
     int width, height, channels;
     float* data = stbi_loadf(filepath, &width, &height, &channels, 4);
     if (!data) {
@@ -100,31 +101,12 @@ static VkDescriptorSetLayout make_ibl_layout(Engine* e, bool hasSamplerInput)
     return layout;
 }
 
-// ─── Helper: create a compute pipeline ───────────────────────────────────────
-static VkPipeline make_compute_pipeline(Engine* e, const char* shaderPath,
-    VkPipelineLayout layout)
+// ─── Helper: queue a compute pipeline on the pipeline service ────────────────
+static void make_compute_pipeline(Engine* e, const char* shaderPath,
+    VkPipelineLayout layout, VkPipeline* target)
 {
-    VkShaderModule shader;
-    if (!e->util.load_shader_module(shaderPath, e->device, &shader)) {
-        LOG_ERROR("Failed to load shader: " << shaderPath);
-        return VK_NULL_HANDLE;
-    }
-
-    VkPipelineShaderStageCreateInfo stage{};
-    stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
-    stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
-    stage.module = shader;
-    stage.pName = "main";
-
-    VkComputePipelineCreateInfo info{};
-    info.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
-    info.stage = stage;
-    info.layout = layout;
-
-    VkPipeline pipeline;
-    VK_CHECK(vkCreateComputePipelines(e->device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline));
-    vkDestroyShaderModule(e->device, shader, nullptr);
-    return pipeline;
+    VkShaderModule shader = pipeline_service_shader(e, shaderPath);
+    pipeline_service_build(e, pipeline_service_request_compute(e, shader, layout, shaderPath), target);
 }
 
 // ─── Helper: write a 2-binding descriptor set ────────────────────────────────
@@ -236,15 +218,11 @@ void init_ibl(Engine* e)
     e->prefilterLayout = makePipelineLayout(e->prefilterSetLayout, true); // has push constant
     e->brdfLutLayout = makePipelineLayout(e->brdfLutSetLayout, false);
 
-    // ── 4. Compute pipelines ──────────────────────────────────────────────────
-    e->equirectPipeline = make_compute_pipeline(e,
-        "shaders/equirect_to_cubemap.comp.spv", e->equirectLayout);
-    e->irradiancePipeline = make_compute_pipeline(e,
-        "shaders/irradiance.comp.spv", e->irradianceLayout);
-    e->prefilterPipeline = make_compute_pipeline(e,
-        "shaders/prefilter.comp.spv", e->prefilterLayout);
-    e->brdfLutPipeline = make_compute_pipeline(e,
-        "shaders/brdf_lut.comp.spv", e->brdfLutLayout);
+    // ── 4. Compute pipelines — all four compile at once, waited on below ─────
+    make_compute_pipeline(e, "shaders/equirect_to_cubemap.comp.spv", e->equirectLayout, &e->equirectPipeline);
+    make_compute_pipeline(e, "shaders/irradiance.comp.spv", e->irradianceLayout, &e->irradiancePipeline);
+    make_compute_pipeline(e, "shaders/prefilter.comp.spv", e->prefilterLayout, &e->prefilterPipeline);
+    make_compute_pipeline(e, "shaders/brdf_lut.comp.spv", e->brdfLutLayout, &e->brdfLutPipeline);
 
     // ── 5. Allocate descriptor sets ───────────────────────────────────────────
     e->equirectSet = e->globalDescriptorAllocator.allocate(e->device, e->equirectSetLayout);
@@ -300,6 +278,7 @@ void init_ibl(Engine* e)
         e->brdfLUT.imageView);
 
     // ── 7. Run all compute passes once ───────────────────────────────────────
+    pipeline_service_wait(e);
     immediate_submit([&](VkCommandBuffer cmd)
         {
             // Transition all outputs to GENERAL for compute writes
@@ -398,12 +377,8 @@ void init_ibl(Engine* e)
 
 
     // ── 9. Cleanup pipelines — never needed again after startup ───────────────
+    // (the pipelines themselves belong to the pipeline service)
     e->mainDeletionQueue.push_function([=]() {
-        vkDestroyPipeline(e->device, e->equirectPipeline, nullptr);
-        vkDestroyPipeline(e->device, e->irradiancePipeline, nullptr);
-        vkDestroyPipeline(e->device, e->prefilterPipeline, nullptr);
-        vkDestroyPipeline(e->device, e->brdfLutPipeline, nullptr);
-
         vkDestroyPipelineLayout(e->device, e->equirectLayout, nullptr);
         vkDestroyPipelineLayout(e->device, e->irradianceLayout, nullptr);
         vkDestroyPipelineLayout(e->device, e->prefilterLayout, nullptr);
@@ -67,6 +67,7 @@ void init_imgui(Engine* e)
     e->mainDeletionQueue.push_function([=]() {
         ImGui_ImplVulkan_Shutdown();
         ImGui_ImplGlfw_Shutdown();
+        ImGui::DestroyContext();         // the benchmark runner re-initialises per scene
         vkDestroyDescriptorPool(e->device, e->imguiDescriptorPool, nullptr);
         });
 }
\ No newline at end of file
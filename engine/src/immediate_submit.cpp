@@ -13,8 +13,6 @@
 // - Synchronization for single-shot operations
 void immediate_submit(std::function<void(VkCommandBuffer cmd)>&& function, Engine* e)
 {
-
-    VK_CHECK(vkResetFences(e->device, 1, &e->immFence));
     VK_CHECK(vkResetCommandBuffer(e->immCommandBuffer, 0));
 
     VkCommandBuffer cmd = e->immCommandBuffer;
@@ -28,9 +26,11 @@ void immediate_submit(std::function<void(VkCommandBuffer cmd)>&& function, Engin
     VK_CHECK(vkEndCommandBuffer(cmd));
 
     VkCommandBufferSubmitInfo cmdinfo = command_buffer_submit_info(cmd);
-    VkSubmitInfo2 submit = submit_info(&cmdinfo, nullptr, nullptr);
+    VkSemaphoreSubmitInfo signal = frame_scheduler_signal(e, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
+    VkSubmitInfo2 submit = submit_info(&cmdinfo, &signal, nullptr);
 
-    VK_CHECK(vkQueueSubmit2(e->graphicsQueue, 1, &submit, e->immFence));
+    VK_CHECK(vkQueueSubmit2(e->graphicsQueue, 1, &submit, VK_NULL_HANDLE));
 
-    VK_CHECK(vkWaitForFences(e->device, 1, &e->immFence, true, 9999999999));
+    // Also drains every frame submitted before it
+    frame_scheduler_wait(e, signal.value);
 }
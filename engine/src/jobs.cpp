@@ -0,0 +1,127 @@
+#include "jobs.h"
+#include "cpu_profiler.h"
+
+#include <algorithm>
+#include <memory>
+#include <string>
+
+static thread_local uint32_t t_workerIndex = 0;
+
+static void job_worker_main(JobSystem* js, uint32_t index)
+{
+    t_workerIndex = index;
+    cpu_profiler_thread_name(("job worker " + std::to_string(index)).c_str());
+
+    for (;;) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(js->mutex);
+            js->wake.wait(lock, [js] { return js->quit || !js->queue.empty(); });
+            if (js->quit && js->queue.empty()) return;
+            job = std::move(js->queue.front());
+            js->queue.pop_front();
+        }
+        job();
+    }
+}
+
+void jobs_init(JobSystem& js, uint32_t workerCount)
+{
+    js.quit = false;
+    js.workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i)
+        js.workers.emplace_back(job_worker_main, &js, i + 1);
+}
+
+void jobs_shutdown(JobSystem& js)
+{
+    {
+        std::lock_guard<std::mutex> lock(js.mutex);
+        js.quit = true;
+    }
+    js.wake.notify_all();
+    for (auto& t : js.workers)
+        if (t.joinable()) t.join();
+    js.workers.clear();
+    js.queue.clear();
+}
+
+uint32_t jobs_thread_count(const JobSystem& js)
+{
+    return (uint32_t)js.workers.size() + 1;
+}
+
+uint32_t jobs_current_worker()
+{
+    return t_workerIndex;
+}
+
+void jobs_parallel_for(JobSystem& js, uint32_t count, uint32_t batch, const JobRangeFn& fn)
+{
+    if (count == 0) return;
+    batch = std::max(batch, 1u);
+
+    const uint32_t batches = (count + batch - 1) / batch;
+    const uint32_t helpers = std::min<uint32_t>(batches - 1, (uint32_t)js.workers.size());
+
+    // Single batch (or no pool) — run inline, no synchronisation needed
+    if (helpers == 0) {
+        fn(0, count, t_workerIndex);
+        return;
+    }
+
+    // Shared with the helpers, which hold a reference until they return: the
+    // last one still calls notify_all after its decrement has released the
+    // caller, so this must not live on the caller's stack. `fn` may: no helper
+    // touches it after decrementing
+    struct ParallelFor {
+        std::atomic<uint32_t> cursor{ 0 };
+        std::atomic<uint32_t> pending{ 0 };
+        uint32_t              count = 0, batch = 0, batches = 0;
+        const JobRangeFn*     fn = nullptr;
+
+        void drain()
+        {
+            for (;;) {
+                uint32_t b = cursor.fetch_add(1, std::memory_order_relaxed);
+                if (b >= batches) break;
+                uint32_t begin = b * batch;
+                (*fn)(begin, std::min(begin + batch, count), t_workerIndex);
+            }
+        }
+    };
+    auto state = std::make_shared<ParallelFor>();
+    state->pending.store(helpers, std::memory_order_relaxed);
+    state->count = count;
+    state->batch = batch;
+    state->batches = batches;
+    state->fn = &fn;
+
+    {
+        std::lock_guard<std::mutex> lock(js.mutex);
+        for (uint32_t i = 0; i < helpers; ++i) {
+            js.queue.emplace_back([state]() {
+                state->drain();
+                if (state->pending.fetch_sub(1, std::memory_order_acq_rel) == 1)
+                    state->pending.notify_all();
+                });
+        }
+    }
+    js.wake.notify_all();
+
+    state->drain();
+
+    // fn is the caller's — wait for every helper to finish with it
+    for (uint32_t p = state->pending.load(std::memory_order_acquire); p != 0;
+        p = state->pending.load(std::memory_order_acquire))
+        state->pending.wait(p, std::memory_order_acquire);
+}
+
+void jobs_submit(JobSystem& js, std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(js.mutex);
+        js.queue.emplace_back(std::move(job));
+    }
+    js.wake.notify_one();
+}
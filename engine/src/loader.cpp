@@ -10,6 +10,7 @@
 #include <glm/gtx/quaternion.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <iostream>
+#include <algorithm>
 #include <chrono>
 #include <fstream>     // ← NEW: for DDS file loading
 
@@ -156,7 +157,7 @@ static bool load_dds_file(const std::filesystem::path& path, DDSData& out) {
     uint32_t magic = 0;
     f.read(reinterpret_cast<char*>(&magic), 4);
     if (magic != DDS_MAGIC) {
-        std::cerr << "[DDS] Bad magic in " << path << "\n";
+        LOG_CAT(Loader, Warn, "[DDS] Bad magic in " << path);
         return false;
     }
 
@@ -164,7 +165,7 @@ static bool load_dds_file(const std::filesystem::path& path, DDSData& out) {
     DDSHeader hdr{};
     f.read(reinterpret_cast<char*>(&hdr), sizeof(DDSHeader));
     if (hdr.size != 124) {
-        std::cerr << "[DDS] Bad header size in " << path << "\n";
+        LOG_CAT(Loader, Warn, "[DDS] Bad header size in " << path);
         return false;
     }
 
@@ -192,20 +193,22 @@ static bool load_dds_file(const std::filesystem::path& path, DDSData& out) {
             case FOURCC_BC4S: out.format = VK_FORMAT_BC4_SNORM_BLOCK;       break;
             case FOURCC_ATI2:
             case FOURCC_BC5U: out.format = VK_FORMAT_BC5_UNORM_BLOCK;       break;
-            default:
-                std::cerr << "[DDS] Unknown FourCC 0x" << std::hex
-                    << hdr.ddspf.fourCC << std::dec << " in " << path << "\n";
+            default: {
+                char fourCC[9];
+                std::snprintf(fourCC, sizeof(fourCC), "%08X", hdr.ddspf.fourCC);
+                LOG_CAT(Loader, Warn, "[DDS] Unknown FourCC 0x" << fourCC << " in " << path);
                 return false;
             }
+            }
         }
         else {
-            std::cerr << "[DDS] No FourCC and no DX10 header in " << path << "\n";
+            LOG_CAT(Loader, Warn, "[DDS] No FourCC and no DX10 header in " << path);
             return false;
         }
     }
 
     if (out.format == VK_FORMAT_UNDEFINED) {
-        std::cerr << "[DDS] Unsupported DXGI format in " << path << "\n";
+        LOG_CAT(Loader, Warn, "[DDS] Unsupported DXGI format in " << path);
         return false;
     }
 
@@ -452,6 +455,7 @@ void upload_image_data(Engine* e, AllocatedImage& image, const void* pixels, siz
 // data with pre-baked mip chain (no blit needed). Falls back to stbi otherwise.
 AllocatedImage load_image_from_gltf(Engine* e, cgltf_image* img, bool isLinear)
 {
+    CPU_ZONE("load image");
     if (!img) return {};
 
     // ── 1. Try DDS (BC-compressed, pre-baked mips) ────────────────────────────
@@ -489,15 +493,14 @@ AllocatedImage load_image_from_gltf(Engine* e, cgltf_image* img, bool isLinear)
 
                 upload_compressed_image(e, gpu, dds);
 
-                std::cout << "  [DDS BC] " << ddsPath.filename().string()
+                LOG_CAT(Loader, Debug, "  [DDS BC] " << ddsPath.filename()
                     << "  " << dds.width << "x" << dds.height
                     << "  mips=" << dds.mipLevels
-                    << "  fmt=" << (int)dds.format << "\n";
+                    << "  fmt=" << (int)dds.format);
                 return gpu;
             }
             // If DDS load failed for any reason, fall through to stbi
-            std::cerr << "[loader] DDS load failed for " << ddsPath
-                << " — falling back to uncompressed\n";
+            LOG_CAT(Loader, Warn, "DDS load failed for " << ddsPath << " — falling back to uncompressed");
         }
     }
 
@@ -510,8 +513,8 @@ AllocatedImage load_image_from_gltf(Engine* e, cgltf_image* img, bool isLinear)
         std::filesystem::path fullPath = e->sceneBasePath / img->uri;
         pixels = stbi_load(fullPath.string().c_str(), &width, &height, &channels, 4);
         if (!pixels) {
-            std::cerr << "[loader] Failed to load external texture: "
-                << fullPath << " — " << stbi_failure_reason() << "\n";
+            LOG_CAT(Loader, Error, "Failed to load external texture: "
+                << fullPath << " — " << stbi_failure_reason());
             return {};
         }
     }
@@ -522,8 +525,7 @@ AllocatedImage load_image_from_gltf(Engine* e, cgltf_image* img, bool isLinear)
         size_t rawSize = img->buffer_view->size;
         pixels = stbi_load_from_memory(raw, (int)rawSize, &width, &height, &channels, 4);
         if (!pixels) {
-            std::cerr << "[loader] Embedded texture decode failed — "
-                << stbi_failure_reason() << "\n";
+            LOG_CAT(Loader, Error, "Embedded texture decode failed — " << stbi_failure_reason());
             return {};
         }
     }
@@ -670,15 +672,121 @@ static bool load_primitive(
         default: break;
         }
     }
+
+    // ── Local bounds — AABB, then a sphere around its centre ─────────────────
+    glm::vec3 bmin(std::numeric_limits<float>::max());
+    glm::vec3 bmax(std::numeric_limits<float>::lowest());
+    for (size_t i = 0; i < vcount; ++i) {
+        bmin = glm::min(bmin, verts[vtxBase + i].position);
+        bmax = glm::max(bmax, verts[vtxBase + i].position);
+    }
+    surf.boundsMin = bmin;
+    surf.boundsMax = bmax;
+    surf.sphereCenter = (bmin + bmax) * 0.5f;
+
+    float radiusSq = 0.0f;
+    for (size_t i = 0; i < vcount; ++i) {
+        glm::vec3 d = verts[vtxBase + i].position - surf.sphereCenter;
+        radiusSq = std::max(radiusSq, glm::dot(d, d));
+    }
+    surf.sphereRadius = std::sqrt(radiusSq);
+
     return true;
 }
 
+// ─── Cluster split ────────────────────────────────────────────────────────────
+// Cuts every surface into CLUSTER_TRIANGLES-sized index ranges and bounds each.
+// glTF exporters emit triangles with decent spatial locality, so consecutive
+// ranges make usable clusters without a real partitioner.
+static void build_clusters(MeshAsset& asset,
+    const std::vector<Vertex>& verts,
+    const std::vector<uint32_t>& idx)
+{
+    const uint32_t clusterIndices = CLUSTER_TRIANGLES * 3;
+
+    for (uint32_t s = 0; s < (uint32_t)asset.surfaces.size(); ++s) {
+        const GeoSurface& surf = asset.surfaces[s];
+
+        for (uint32_t first = 0; first < surf.count; first += clusterIndices) {
+            MeshCluster c{};
+            c.startIndex = surf.startIndex + first;
+            c.count = std::min(clusterIndices, surf.count - first);
+            c.surfaceIndex = s;
+
+            glm::vec3 bmin(std::numeric_limits<float>::max());
+            glm::vec3 bmax(std::numeric_limits<float>::lowest());
+            for (uint32_t i = 0; i < c.count; ++i) {
+                const glm::vec3& p = verts[idx[c.startIndex + i]].position;
+                bmin = glm::min(bmin, p);
+                bmax = glm::max(bmax, p);
+            }
+            c.boundsMin = bmin;
+            c.boundsMax = bmax;
+            asset.clusters.push_back(c);
+        }
+    }
+}
+
+// ─── Occluder proxies ─────────────────────────────────────────────────────────
+// A proxy is a subset of the surface's triangles, largest first, with their
+// vertices copied as they are. It is conservative by construction: anything it
+// covers the surface covers at the same depth, so it can never hide something
+// the real mesh leaves visible. Nothing to validate at load time.
+static void build_occluders(MeshAsset& asset,
+    const std::vector<Vertex>& verts,
+    const std::vector<uint32_t>& idx)
+{
+    for (GeoSurface& surf : asset.surfaces) {
+        if (!surf.opaque || surf.count < 3) continue;
+
+        const uint32_t triCount = surf.count / 3;
+        std::vector<float>    areas(triCount);
+        std::vector<uint32_t> order(triCount);
+        float total = 0.0f;
+        for (uint32_t t = 0; t < triCount; ++t) {
+            const glm::vec3& a = verts[idx[surf.startIndex + t * 3]].position;
+            const glm::vec3& b = verts[idx[surf.startIndex + t * 3 + 1]].position;
+            const glm::vec3& c = verts[idx[surf.startIndex + t * 3 + 2]].position;
+            areas[t] = 0.5f * glm::length(glm::cross(b - a, c - a));
+            total += areas[t];
+            order[t] = t;
+        }
+        if (total <= 0.0f) continue;
+
+        const uint32_t keep = std::min(triCount, OCCLUDER_MAX_TRIANGLES);
+        std::partial_sort(order.begin(), order.begin() + keep, order.end(),
+            [&](uint32_t l, uint32_t r) { return areas[l] > areas[r]; });
+
+        std::vector<uint32_t> proxy;            // indices into verts
+        float covered = 0.0f;
+        for (uint32_t i = 0; i < keep && areas[order[i]] > 0.0f; ++i) {
+            for (uint32_t k = 0; k < 3; ++k)
+                proxy.push_back(idx[surf.startIndex + order[i] * 3 + k]);
+            covered += areas[order[i]];
+        }
+        if (covered < OCCLUDER_MIN_COVERAGE * total) continue;
+
+        std::unordered_map<uint32_t, uint32_t> remap;
+        surf.occluderFirstIndex = (uint32_t)asset.occluderIndices.size();
+        surf.occluderIndexCount = (uint32_t)proxy.size();
+        for (uint32_t v : proxy) {
+            auto [it, inserted] = remap.try_emplace(v, (uint32_t)asset.occluderPositions.size());
+            if (inserted) asset.occluderPositions.push_back(verts[v].position);
+            asset.occluderIndices.push_back(it->second);
+        }
+    }
+}
+
 // ─── Recursive node traversal ─────────────────────────────────────────────────
+// Nodes that reference an already loaded glTF mesh reuse its GPU buffers
+using GeometryMap = std::unordered_map<const cgltf_mesh*, std::shared_ptr<MeshAsset>>;
+
 static void traverse_node(
     const cgltf_node* node,
     const glm::mat4& parentWorld,
     Engine* e,
     TexMap& texMap,
+    GeometryMap& geometryMap,
     std::vector<std::shared_ptr<MeshAsset>>& out)
 {
     if (!node) return;
@@ -686,7 +794,19 @@ static void traverse_node(
     glm::mat4 localT = node_local(node);
     glm::mat4 worldT = parentWorld * localT;
 
-    if (node->mesh) {
+    auto shared = node->mesh ? geometryMap.find(node->mesh) : geometryMap.end();
+    if (shared != geometryMap.end()) {
+        // Same surfaces, clusters and buffers — only the placement differs.
+        // The first node keeps ownership of the buffers.
+        MeshAsset asset = *shared->second;
+        asset.name = node->name ? node->name : "unnamed";
+        asset.worldTransform = worldT;
+        asset.ownsBuffers = false;
+        asset.blasAddress = 0;
+        asset.blasHandle = VK_NULL_HANDLE;
+        out.push_back(std::make_shared<MeshAsset>(std::move(asset)));
+    }
+    else if (node->mesh) {
         const cgltf_mesh* mesh = node->mesh;
 
         size_t totalV = 0, totalI = 0;
@@ -735,6 +855,8 @@ static void traverse_node(
                     surf.emissiveFactor = glm::vec3(mat->emissive_factor[0],
                         mat->emissive_factor[1],
                         mat->emissive_factor[2]);
+                    surf.opaque = mat->alpha_mode == cgltf_alpha_mode_opaque;
+                    surf.masked = mat->alpha_mode == cgltf_alpha_mode_mask;
                 }
 
                 if (load_primitive(prim, localT, verts, indices, surf))
@@ -748,14 +870,17 @@ static void traverse_node(
                 if (!hasTangents)
                     calculateTangents(verts, indices);
 
+                build_clusters(asset, verts, indices);
+                build_occluders(asset, verts, indices);
                 asset.meshBuffers = uploadMesh(e, indices, verts);
                 out.push_back(std::make_shared<MeshAsset>(std::move(asset)));
+                geometryMap.emplace(mesh, out.back());
             }
         }
     }
 
     for (size_t i = 0; i < node->children_count; ++i)
-        traverse_node(node->children[i], worldT, e, texMap, out);
+        traverse_node(node->children[i], worldT, e, texMap, geometryMap, out);
 }
 
 
@@ -764,35 +889,38 @@ static void traverse_node(
 std::optional<std::vector<std::shared_ptr<MeshAsset>>>
 loadgltfMeshes(Engine* e, std::filesystem::path filePath)
 {
+    CPU_ZONE("loadgltfMeshes");
     double t0 = now_ms();
-    std::cout << "\n╔══════════════════════════════════════════════╗\n";
-    std::cout << "║ " << filePath.filename().string() << "\n";
-    std::cout << "╚══════════════════════════════════════════════╝\n";
+    LOG_CAT(Loader, Info, "Loading " << filePath.filename());
 
     e->sceneBasePath = filePath.parent_path();
 
     cgltf_options opts{};
     cgltf_data* data = nullptr;
 
-    if (cgltf_parse_file(&opts, filePath.string().c_str(), &data) != cgltf_result_success) {
-        std::cerr << "[loader] ❌ Parse failed: " << filePath << "\n";
-        return std::nullopt;
-    }
-    if (cgltf_load_buffers(&opts, data, filePath.string().c_str()) != cgltf_result_success) {
-        std::cerr << "[loader] ❌ Buffer load failed: " << filePath << "\n";
-        cgltf_free(data);
-        return std::nullopt;
+    {
+        CPU_ZONE("parse glTF");
+        if (cgltf_parse_file(&opts, filePath.string().c_str(), &data) != cgltf_result_success) {
+            LOG_CAT(Loader, Error, "Parse failed: " << filePath);
+            return std::nullopt;
+        }
+        if (cgltf_load_buffers(&opts, data, filePath.string().c_str()) != cgltf_result_success) {
+            LOG_CAT(Loader, Error, "Buffer load failed: " << filePath);
+            cgltf_free(data);
+            return std::nullopt;
+        }
     }
 
-    std::cout << " Meshes " << data->meshes_count
+    LOG_CAT(Loader, Info, " Meshes " << data->meshes_count
         << " | Materials " << data->materials_count
-        << " | Textures " << data->textures_count << "\n";
+        << " | Textures " << data->textures_count);
 
     if (e->nextBindlessTextureIndex <= e->iblBrdfLutIndex)
         e->nextBindlessTextureIndex = e->iblBrdfLutIndex + 1;
 
     TexMap texMap;
     texMap.reserve(data->textures_count * 2);
+    GeometryMap geometryMap;
 
     std::vector<std::shared_ptr<MeshAsset>> meshes;
     meshes.reserve(data->meshes_count);
@@ -802,12 +930,12 @@ loadgltfMeshes(Engine* e, std::filesystem::path filePath)
 
     if (scene) {
         for (size_t i = 0; i < scene->nodes_count; ++i)
-            traverse_node(scene->nodes[i], glm::mat4(1.0f), e, texMap, meshes);
+            traverse_node(scene->nodes[i], glm::mat4(1.0f), e, texMap, geometryMap, meshes);
     }
     else {
         for (size_t i = 0; i < data->nodes_count; ++i)
             if (!data->nodes[i].parent)
-                traverse_node(&data->nodes[i], glm::mat4(1.0f), e, texMap, meshes);
+                traverse_node(&data->nodes[i], glm::mat4(1.0f), e, texMap, geometryMap, meshes);
     }
 
     cgltf_free(data);
@@ -817,10 +945,10 @@ loadgltfMeshes(Engine* e, std::filesystem::path filePath)
         for (auto& s : m->surfaces)
             totalTris += s.count / 3;
 
-    std::cout << " ✅ " << meshes.size() << " mesh nodes | "
+    LOG_CAT(Loader, Info, " ✅ " << meshes.size() << " mesh nodes (" << geometryMap.size() << " unique) | "
         << texMap.size() << " textures | "
         << totalTris << " triangles | "
-        << (int)(now_ms() - t0) << " ms\n\n";
+        << (int)(now_ms() - t0) << " ms");
 
     return meshes;
 }
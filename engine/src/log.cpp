@@ -0,0 +1,438 @@
+#include "log.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+std::atomic<uint8_t> g_logMinLevel[(size_t)LogCategory::Count] = {
+    (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info,
+    (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info, (uint8_t)LogLevel::Info,
+};
+static_assert((size_t)LogCategory::Count == 8, "initialise g_logMinLevel for every category");
+
+const char* log_level_name(LogLevel level)
+{
+    static const char* names[] = { "trace", "debug", "info", "warn", "error" };
+    return (size_t)level < (size_t)LogLevel::Count ? names[(size_t)level] : "?";
+}
+
+const char* log_category_name(LogCategory category)
+{
+    static const char* names[] = { "core", "vulkan", "render", "loader", "pipeline", "jobs", "profiler", "ui" };
+    return (size_t)category < (size_t)LogCategory::Count ? names[(size_t)category] : "?";
+}
+
+void log_set_level(LogCategory category, LogLevel level)
+{
+    g_logMinLevel[(size_t)category].store((uint8_t)level, std::memory_order_relaxed);
+}
+
+void log_set_level(LogLevel level)
+{
+    for (auto& min : g_logMinLevel) min.store((uint8_t)level, std::memory_order_relaxed);
+}
+
+static int64_t log_now_ns()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// ─── Rings ────────────────────────────────────────────────────────────────────
+struct alignas(64) LogSlot {
+    int64_t     ns;
+    LogLevel    level;
+    LogCategory category;
+    uint16_t    length;
+    char        text[LOG_SLOT_TEXT];
+};
+static_assert(sizeof(LogSlot) == 256, "LogSlot should stay four cache lines");
+
+// Single producer (the owning thread), single consumer (the flusher). The
+// producer owns head, the consumer owns tail; a slot belongs to the producer
+// from reservation until head passes it
+struct LogRing {
+    LogSlot                            slots[LOG_RING_SLOTS];
+    alignas(64) std::atomic<uint64_t>  head{ 0 };
+    alignas(64) std::atomic<uint64_t>  tail{ 0 };
+    std::atomic<uint64_t>              dropped{ 0 };
+    bool                               retired = false;    // owner exited; under ringsMutex
+};
+static_assert((LOG_RING_SLOTS & (LOG_RING_SLOTS - 1)) == 0, "LOG_RING_SLOTS must be a power of two");
+
+// A message as the flusher took it out of a ring
+struct LogRecord {
+    int64_t     ns;
+    LogLevel    level;
+    LogCategory category;
+    std::string text;
+};
+
+// Never destroyed: threads may log while static destructors run, and rings
+// must outlive every thread that writes to them
+struct LogState {
+    std::mutex                            ringsMutex;
+    std::vector<std::unique_ptr<LogRing>> rings;       // every ring ever made
+    std::vector<LogRing*>                 live;        // drained: owned, or retired with messages left
+    std::vector<LogRing*>                 freeRings;   // retired and drained, for new threads
+
+    // Flusher
+    std::mutex              wakeMutex;
+    std::condition_variable wakeCv;
+    std::atomic<bool>       wake{ false };
+    bool                    stop = false;
+    std::thread             thread;
+
+    // Drain passes, for log_flush
+    std::mutex              drainMutex;
+    std::condition_variable drainedCv;
+    uint64_t                passesStarted = 0;
+    uint64_t                passesDone = 0;
+    std::vector<LogRecord>  batch;
+
+    // Sinks, touched only while draining or under drainMutex
+    FILE*    file = nullptr;
+    bool     console = true;
+    uint64_t written = 0;
+    uint64_t droppedReported = 0;
+
+    // In-game console
+    std::mutex           consoleMutex;
+    std::vector<LogLine> lines;                 // ring of LOG_CONSOLE_LINES
+    size_t               linesHead = 0;
+
+    int64_t originNs = log_now_ns();
+};
+
+static LogState& log_state()
+{
+    static LogState* state = new LogState;
+    return *state;
+}
+
+static void log_flusher_main();
+
+static thread_local LogRing* t_logRing = nullptr;
+static thread_local bool     t_logRingRetired = false;
+
+// Retires the thread's ring when the thread exits; the next drain that
+// leaves it empty moves it to the free list
+struct LogRingOwner {
+    LogRing* ring = nullptr;
+
+    ~LogRingOwner()
+    {
+        if (!ring) return;
+        LogState& s = log_state();
+        std::lock_guard lock(s.ringsMutex);
+        ring->retired = true;
+        t_logRing = nullptr;
+        t_logRingRetired = true;
+    }
+};
+
+static LogRing* log_thread_ring()
+{
+    if (t_logRing) return t_logRing;
+
+    LogState& s = log_state();
+    std::lock_guard lock(s.ringsMutex);
+    LogRing* ring;
+    if (!s.freeRings.empty()) {
+        ring = s.freeRings.back();
+        s.freeRings.pop_back();
+        ring->retired = false;
+    }
+    else {
+        ring = s.rings.emplace_back(std::make_unique<LogRing>()).get();
+    }
+    s.live.push_back(ring);
+    t_logRing = ring;
+    // Logging from a thread_local destructor after the owner is gone: that
+    // ring is simply never retired
+    if (!t_logRingRetired) {
+        thread_local LogRingOwner owner;
+        owner.ring = ring;
+    }
+    {
+        std::lock_guard wakeLock(s.wakeMutex);
+        if (!s.thread.joinable() && !s.stop) s.thread = std::thread(log_flusher_main);
+    }
+    return ring;
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+LogStream::LogStream(LogLevel level, LogCategory category)
+{
+    LogRing* ring = log_thread_ring();
+    const uint64_t head = ring->head.load(std::memory_order_relaxed);
+    if (head - ring->tail.load(std::memory_order_acquire) >= LOG_RING_SLOTS) {
+        ring->dropped.fetch_add(1, std::memory_order_relaxed);
+        slot_ = nullptr;
+        return;
+    }
+    slot_ = &ring->slots[head & (LOG_RING_SLOTS - 1)];
+    slot_->ns = log_now_ns();
+    slot_->level = level;
+    slot_->category = category;
+}
+
+LogStream::~LogStream()
+{
+    if (!slot_) return;
+    slot_->length = (uint16_t)length_;
+
+    // The ring can't have changed hands: only this thread moves head
+    LogRing* ring = log_thread_ring();
+    ring->head.store(ring->head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+
+    if (slot_->level >= LogLevel::Warn) {
+        LogState& s = log_state();
+        s.wake.store(true, std::memory_order_relaxed);
+        s.wakeCv.notify_one();
+    }
+}
+
+void LogStream::append(const char* data, size_t size)
+{
+    if (!slot_ || length_ >= LOG_SLOT_TEXT) return;
+    const size_t room = LOG_SLOT_TEXT - length_;
+    if (size > room) {
+        std::memcpy(slot_->text + length_, data, room);
+        std::memcpy(slot_->text + LOG_SLOT_TEXT - 3, "...", 3);
+        length_ = LOG_SLOT_TEXT;
+        return;
+    }
+    std::memcpy(slot_->text + length_, data, size);
+    length_ += (uint32_t)size;
+}
+
+void LogStream::append_pointer(const void* p)
+{
+    char buf[2 + 16];
+    buf[0] = '0';
+    buf[1] = 'x';
+    const auto r = std::to_chars(buf + 2, buf + sizeof(buf), (uintptr_t)p, 16);
+    append(buf, (size_t)(r.ptr - buf));
+}
+
+bool LogRateLimit::allow(double intervalSeconds, uint32_t* suppressedOut)
+{
+    const int64_t now = log_now_ns();
+    int64_t next = nextNs.load(std::memory_order_relaxed);
+    if (now < next || !nextNs.compare_exchange_strong(next, now + (int64_t)(intervalSeconds * 1e9),
+        std::memory_order_relaxed)) {
+        suppressed.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    *suppressedOut = suppressed.exchange(0, std::memory_order_relaxed);
+    return true;
+}
+
+// ─── Flushing ─────────────────────────────────────────────────────────────────
+static void log_write(LogState& s, const LogRecord& r)
+{
+    const double seconds = (double)(r.ns - s.originNs) * 1e-9;
+    const char* prefix = r.level == LogLevel::Error ? "ERROR: " : r.level == LogLevel::Warn ? "WARN: " : "";
+
+    if (s.console) {
+        if (r.level >= LogLevel::Warn) {
+            std::fflush(stdout);
+            std::fprintf(stderr, "%s%s\n", prefix, r.text.c_str());
+        }
+        else {
+            std::fprintf(stdout, "%s\n", r.text.c_str());
+        }
+    }
+    if (s.file)
+        std::fprintf(s.file, "%10.4f %-5s %-8s %s\n", seconds, log_level_name(r.level),
+            log_category_name(r.category), r.text.c_str());
+
+    std::lock_guard lock(s.consoleMutex);
+    if (s.lines.size() < LOG_CONSOLE_LINES) {
+        s.lines.push_back({ seconds, r.level, r.category, r.text });
+    }
+    else {
+        s.lines[s.linesHead] = { seconds, r.level, r.category, r.text };
+        s.linesHead = (s.linesHead + 1) % LOG_CONSOLE_LINES;
+    }
+}
+
+// One pass over every ring; the caller holds drainMutex
+static void log_drain(LogState& s)
+{
+    std::vector<LogRing*> rings;
+    uint64_t dropped = 0;
+    {
+        std::lock_guard lock(s.ringsMutex);
+        rings = s.live;
+        for (auto& ring : s.rings) dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+
+    // Copy out and release the slots first, so producers get room back before
+    // any I/O happens
+    s.batch.clear();
+    for (LogRing* ring : rings) {
+        const uint64_t head = ring->head.load(std::memory_order_acquire);
+        const uint64_t tail = ring->tail.load(std::memory_order_relaxed);
+        for (uint64_t i = tail; i < head; ++i) {
+            const LogSlot& slot = ring->slots[i & (LOG_RING_SLOTS - 1)];
+            s.batch.push_back({ slot.ns, slot.level, slot.category, std::string(slot.text, slot.length) });
+        }
+        ring->tail.store(head, std::memory_order_release);
+    }
+
+    // A retired ring has no writer left; once empty it can serve a new thread
+    {
+        std::lock_guard lock(s.ringsMutex);
+        std::erase_if(s.live, [&](LogRing* ring) {
+            if (!ring->retired
+                || ring->head.load(std::memory_order_acquire) != ring->tail.load(std::memory_order_relaxed))
+                return false;
+            s.freeRings.push_back(ring);
+            return true;
+            });
+    }
+
+    // Rings are each in order; interleave them by time
+    std::stable_sort(s.batch.begin(), s.batch.end(),
+        [](const LogRecord& a, const LogRecord& b) { return a.ns < b.ns; });
+    for (const LogRecord& r : s.batch) log_write(s, r);
+    s.written += s.batch.size();
+
+    if (dropped > s.droppedReported) {
+        LogRecord note{ log_now_ns(), LogLevel::Warn, LogCategory::Core,
+            "log: " + std::to_string(dropped - s.droppedReported) + " messages dropped (ring full)" };
+        log_write(s, note);
+        s.droppedReported = dropped;
+    }
+
+    if (!s.batch.empty() || dropped) {
+        if (s.console) std::fflush(stdout);
+        if (s.file) std::fflush(s.file);
+    }
+}
+
+static void log_drain_pass(LogState& s)
+{
+    std::unique_lock lock(s.drainMutex);
+    s.passesStarted++;
+    log_drain(s);
+    s.passesDone++;
+    lock.unlock();
+    s.drainedCv.notify_all();
+}
+
+static void log_flusher_main()
+{
+    LogState& s = log_state();
+    for (;;) {
+        bool stopping;
+        {
+            std::unique_lock lock(s.wakeMutex);
+            s.wakeCv.wait_for(lock, std::chrono::milliseconds(5),
+                [&] { return s.wake.load(std::memory_order_relaxed) || s.stop; });
+            s.wake.store(false, std::memory_order_relaxed);
+            stopping = s.stop;
+        }
+        log_drain_pass(s);
+        if (stopping) return;
+    }
+}
+
+void log_flush()
+{
+    LogState& s = log_state();
+    bool running;
+    {
+        std::lock_guard lock(s.wakeMutex);
+        running = s.thread.joinable() && !s.stop;
+    }
+    if (!running) {
+        log_drain_pass(s);
+        return;
+    }
+
+    // Wait for a pass that began after this call
+    std::unique_lock lock(s.drainMutex);
+    const uint64_t target = s.passesStarted + 1;
+    s.wake.store(true, std::memory_order_relaxed);
+    s.wakeCv.notify_one();
+    s.drainedCv.wait(lock, [&] { return s.passesDone >= target; });
+}
+
+// Drains and stops the flusher when the process exits normally (std::exit
+// included). Later messages stay in their rings
+static struct LogShutdown {
+    ~LogShutdown()
+    {
+        LogState& s = log_state();
+        {
+            std::lock_guard lock(s.wakeMutex);
+            s.stop = true;
+        }
+        s.wakeCv.notify_one();
+        if (s.thread.joinable()) s.thread.join();
+        else log_drain_pass(s);
+
+        std::lock_guard lock(s.drainMutex);
+        if (s.file) std::fclose(s.file);
+        s.file = nullptr;
+    }
+} g_logShutdown;
+
+// ─── Sinks ────────────────────────────────────────────────────────────────────
+void log_set_file(const std::string& path)
+{
+    LogState& s = log_state();
+    std::lock_guard lock(s.drainMutex);
+    if (s.file) std::fclose(s.file);
+    s.file = path.empty() ? nullptr : std::fopen(path.c_str(), "w");
+    if (!path.empty() && !s.file)
+        std::fprintf(stderr, "ERROR: log: cannot open %s\n", path.c_str());
+}
+
+void log_set_console_output(bool enabled)
+{
+    LogState& s = log_state();
+    std::lock_guard lock(s.drainMutex);
+    s.console = enabled;
+}
+
+LogStats log_stats()
+{
+    LogState& s = log_state();
+    LogStats stats;
+    {
+        std::lock_guard lock(s.ringsMutex);
+        stats.threads = (uint32_t)s.live.size();
+        for (auto& ring : s.rings) stats.dropped += ring->dropped.load(std::memory_order_relaxed);
+    }
+    std::lock_guard lock(s.drainMutex);
+    stats.written = s.written;
+    return stats;
+}
+
+// ─── In-game console ──────────────────────────────────────────────────────────
+void log_console_visit(const std::function<void(const LogLine&)>& visit)
+{
+    LogState& s = log_state();
+    std::lock_guard lock(s.consoleMutex);
+    const size_t count = s.lines.size();
+    for (size_t i = 0; i < count; ++i)
+        visit(s.lines[(s.linesHead + i) % count]);
+}
+
+void log_console_clear()
+{
+    LogState& s = log_state();
+    std::lock_guard lock(s.consoleMutex);
+    s.lines.clear();
+    s.linesHead = 0;
+}
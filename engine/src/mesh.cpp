@@ -5,6 +5,10 @@ GPUMeshBuffers uploadMesh(Engine* e, std::span<uint32_t> indices, std::span<Vert
 {
     GPUMeshBuffers newSurface{};
 
+    // Only valid with the acceleration structure extension enabled
+    const VkBufferUsageFlags blasInput = e->rayTracingSupported
+        ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR : 0;
+
     // ── Vertex buffer ─────────────────────────────────────────────────────
     size_t vertexBufferSize = vertices.size() * sizeof(Vertex);
     if (vertexBufferSize == 0) {
@@ -29,7 +33,7 @@ GPUMeshBuffers uploadMesh(Engine* e, std::span<uint32_t> indices, std::span<Vert
             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
             VK_BUFFER_USAGE_TRANSFER_DST_BIT |
             VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | 
-            VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR,
+            blasInput,
             VMA_MEMORY_USAGE_GPU_ONLY, e);
         if (newSurface.vertexBuffer.buffer == VK_NULL_HANDLE) {
             LOG_ERROR("uploadMesh: failed to create vertex buffer");
@@ -67,7 +71,7 @@ GPUMeshBuffers uploadMesh(Engine* e, std::span<uint32_t> indices, std::span<Vert
         vmaUnmapMemory(e->allocator, staging.allocation);
 
         newSurface.indexBuffer = create_buffer(e->allocator, indexBufferSize,
-            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VK_BUFFER_USAGE_INDEX_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT | blasInput | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
             VMA_MEMORY_USAGE_GPU_ONLY, e);
         if (newSurface.indexBuffer.buffer == VK_NULL_HANDLE) {
             LOG_ERROR("uploadMesh: failed to create index buffer");
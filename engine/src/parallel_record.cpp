@@ -0,0 +1,114 @@
+#include "parallel_record.h"
+#include "engine.h"
+
+#include <chrono>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_parallel_recording(Engine* e)
+{
+    const uint32_t threads = e->jobs ? jobs_thread_count(*e->jobs) : 1;
+
+    VkCommandPoolCreateInfo poolInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO };
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;   // reset as a whole each frame
+    poolInfo.queueFamilyIndex = e->graphicsQueueFamily;
+
+    for (uint32_t f = 0; f < FRAME_OVERLAP; ++f) {
+        e->frames[f].threadPools.resize(threads);
+        for (ThreadCommandPool& tp : e->frames[f].threadPools)
+            VK_CHECK(vkCreateCommandPool(e->device, &poolInfo, nullptr, &tp.pool));
+    }
+    e->parallelRecord.threadMs.assign(threads, 0.0f);
+
+    e->mainDeletionQueue.push_function([=]() {
+        for (uint32_t f = 0; f < FRAME_OVERLAP; ++f) {
+            for (ThreadCommandPool& tp : e->frames[f].threadPools)
+                vkDestroyCommandPool(e->device, tp.pool, nullptr);
+            e->frames[f].threadPools.clear();
+        }
+        });
+
+    LOG("Parallel recording: " << threads << " command pools per frame");
+}
+
+void parallel_record_begin_frame(Engine* e)
+{
+    for (ThreadCommandPool& tp : get_current_frame(e).threadPools) {
+        VK_CHECK(vkResetCommandPool(e->device, tp.pool, 0));
+        tp.used = 0;
+    }
+
+    ParallelRecordState& pr = e->parallelRecord;
+    std::fill(pr.threadMs.begin(), pr.threadMs.end(), 0.0f);
+    pr.secondaries = 0;
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+static VkCommandBuffer acquire_secondary(ThreadCommandPool& tp, VkDevice device)
+{
+    if (tp.used == tp.buffers.size()) {
+        VkCommandBufferAllocateInfo alloc{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO };
+        alloc.commandPool = tp.pool;
+        alloc.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+        alloc.commandBufferCount = 1;
+
+        VkCommandBuffer cmd;
+        VK_CHECK(vkAllocateCommandBuffers(device, &alloc, &cmd));
+        tp.buffers.push_back(cmd);
+    }
+    return tp.buffers[tp.used++];
+}
+
+void record_secondaries(Engine* e, const RecordTarget& target,
+    uint32_t count, uint32_t batch, const RecordRangeFn& fn,
+    std::vector<VkCommandBuffer>& out)
+{
+    if (count == 0) return;
+    batch = std::max(batch, 1u);
+
+    FrameData& frame = get_current_frame(e);
+    ParallelRecordState& pr = e->parallelRecord;
+
+    const uint32_t ranges = (count + batch - 1) / batch;
+    const size_t   first = out.size();
+    out.resize(first + ranges, VK_NULL_HANDLE);
+
+    VkCommandBufferInheritanceRenderingInfo renderingInfo{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO };
+    renderingInfo.colorAttachmentCount = (uint32_t)target.colorFormats.size();
+    renderingInfo.pColorAttachmentFormats = target.colorFormats.data();
+    renderingInfo.depthAttachmentFormat = target.depthFormat;
+    renderingInfo.rasterizationSamples = target.samples;
+
+    VkCommandBufferInheritanceInfo inheritance{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO };
+    inheritance.pNext = &renderingInfo;
+    inheritance.pipelineStatistics = e->gpuProfiler.statisticFlags;   // a profiler query may be active; 0 without inheritedQueries
+
+    VkCommandBufferBeginInfo beginInfo{ .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO };
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT
+        | VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+    beginInfo.pInheritanceInfo = &inheritance;
+
+    auto record = [&](uint32_t begin, uint32_t end, uint32_t worker) {
+        CPU_ZONE("record secondary");
+        auto t0 = std::chrono::high_resolution_clock::now();
+
+        // Worker indices are stable and unique, so each thread only ever
+        // touches its own pool and its own timing slot
+        VkCommandBuffer cmd = acquire_secondary(frame.threadPools[worker], e->device);
+        VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+        fn(cmd, begin, end);
+        VK_CHECK(vkEndCommandBuffer(cmd));
+        out[first + begin / batch] = cmd;
+
+        auto t1 = std::chrono::high_resolution_clock::now();
+        pr.threadMs[worker] += std::chrono::duration<float, std::milli>(t1 - t0).count();
+        };
+
+    if (e->jobs && ranges > 1)
+        jobs_parallel_for(*e->jobs, count, batch, record);
+    else
+        for (uint32_t begin = 0; begin < count; begin += batch)
+            record(begin, std::min(begin + batch, count), jobs_current_worker());
+
+    pr.secondaries += ranges;
+}
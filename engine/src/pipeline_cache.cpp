@@ -0,0 +1,214 @@
+#include "pipeline_cache.h"
+#include "engine.h"
+
+#include <chrono>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+
+// ─── File ─────────────────────────────────────────────────────────────────────
+static uint64_t fnv1a(const uint8_t* data, size_t size)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= data[i];
+        hash *= 0x100000001b3ull;
+    }
+    return hash;
+}
+
+// The blob if `path` holds a cache written on this exact device and driver;
+// otherwise empty, with the reason in `rejected`
+static std::vector<uint8_t> read_cache_file(const std::string& path,
+    const VkPhysicalDeviceProperties& props, std::string& rejected, float& coldCreateMs)
+{
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return {};                  // first run — nothing to reject
+
+    const size_t fileSize = (size_t)file.tellg();
+    file.seekg(0);
+    PipelineCacheFileHeader header{};
+    if (fileSize < sizeof(header) || !file.read((char*)&header, sizeof(header))) {
+        rejected = "truncated header";
+        return {};
+    }
+    if (std::memcmp(header.magic, PIPELINE_CACHE_MAGIC, 4) != 0 || header.version != PIPELINE_CACHE_VERSION) {
+        rejected = "unknown format";
+        return {};
+    }
+    if (header.vendorID != props.vendorID || header.deviceID != props.deviceID ||
+        header.driverVersion != props.driverVersion ||
+        std::memcmp(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        rejected = "written by another GPU or driver";
+        return {};
+    }
+    if (header.dataSize != fileSize - sizeof(header)) {
+        rejected = "size mismatch";
+        return {};
+    }
+
+    std::vector<uint8_t> data((size_t)header.dataSize);
+    if (!file.read((char*)data.data(), (std::streamsize)data.size()) ||
+        fnv1a(data.data(), data.size()) != header.checksum) {
+        rejected = "checksum mismatch";
+        return {};
+    }
+
+    // The driver's own header must agree too (VkPipelineCacheHeaderVersionOne)
+    VkPipelineCacheHeaderVersionOne driverHeader{};
+    if (data.size() < sizeof(driverHeader)) {
+        rejected = "driver header missing";
+        return {};
+    }
+    std::memcpy(&driverHeader, data.data(), sizeof(driverHeader));
+    if (driverHeader.headerVersion != VK_PIPELINE_CACHE_HEADER_VERSION_ONE ||
+        driverHeader.vendorID != props.vendorID || driverHeader.deviceID != props.deviceID ||
+        std::memcmp(driverHeader.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE) != 0) {
+        rejected = "driver header mismatch";
+        return {};
+    }
+
+    coldCreateMs = header.coldCreateMs;
+    return data;
+}
+
+// Written beside the target and renamed over it, so a crash mid-write leaves
+// the previous cache intact
+static size_t write_cache_file(Engine* e)
+{
+    PipelineCacheState& pc = e->pipelineCache;
+
+    size_t size = 0;
+    if (vkGetPipelineCacheData(e->device, pc.cache, &size, nullptr) != VK_SUCCESS || size == 0)
+        return 0;
+    std::vector<uint8_t> data(size);
+    if (vkGetPipelineCacheData(e->device, pc.cache, &size, data.data()) != VK_SUCCESS)
+        return 0;
+    data.resize(size);
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(e->physicalDevice, &props);
+
+    PipelineCacheFileHeader header{};
+    std::memcpy(header.magic, PIPELINE_CACHE_MAGIC, 4);
+    header.version = PIPELINE_CACHE_VERSION;
+    header.vendorID = props.vendorID;
+    header.deviceID = props.deviceID;
+    header.driverVersion = props.driverVersion;
+    std::memcpy(header.pipelineCacheUUID, props.pipelineCacheUUID, VK_UUID_SIZE);
+    header.dataSize = data.size();
+    header.checksum = fnv1a(data.data(), data.size());
+    header.coldCreateMs = pc.coldCreateMs;
+
+    const std::string temp = pc.path + ".tmp";
+    {
+        std::ofstream file(temp, std::ios::binary | std::ios::trunc);
+        file.write((const char*)&header, sizeof(header));
+        file.write((const char*)data.data(), (std::streamsize)data.size());
+        if (!file) {
+            LOG_ERROR("Pipeline cache: could not write " << temp);
+            return 0;
+        }
+    }
+    std::error_code ec;
+    std::filesystem::rename(temp, pc.path, ec);
+    if (ec) {
+        LOG_ERROR("Pipeline cache: could not replace " << pc.path << ": " << ec.message());
+        return 0;
+    }
+    return sizeof(header) + data.size();
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_pipeline_cache(Engine* e)
+{
+    PipelineCacheState& pc = e->pipelineCache;
+
+    if (shader_bundle_open(e->shaderBundle, "shaders/shaders.bundle"))
+        e->util.bundle = &e->shaderBundle;
+
+    VkPhysicalDeviceProperties props;
+    vkGetPhysicalDeviceProperties(e->physicalDevice, &props);
+    std::vector<uint8_t> data = read_cache_file(pc.path, props, pc.rejected, pc.coldCreateMs);
+
+    VkPipelineCacheCreateInfo info{ .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO };
+    info.initialDataSize = data.size();
+    info.pInitialData = data.empty() ? nullptr : data.data();
+    if (vkCreatePipelineCache(e->device, &info, nullptr, &pc.cache) != VK_SUCCESS) {
+        // Drivers may still refuse a blob that passed our checks — start cold
+        pc.rejected = "refused by the driver";
+        info.initialDataSize = 0;
+        info.pInitialData = nullptr;
+        data.clear();
+        VK_CHECK(vkCreatePipelineCache(e->device, &info, nullptr, &pc.cache));
+    }
+    pc.warm = !data.empty();
+    pc.loadedBytes = data.size();
+
+    // Pushed before any pipeline, so flushed after all of them are destroyed
+    e->mainDeletionQueue.push_function([=]() {
+        PipelineCacheState& pc = e->pipelineCache;
+        pc.savedBytes = write_cache_file(e);
+        LOG("Pipeline cache: saved " << pc.savedBytes / 1024 << " KB to " << pc.path);
+        vkDestroyPipelineCache(e->device, pc.cache, nullptr);
+        pc.cache = VK_NULL_HANDLE;
+        e->util.bundle = nullptr;
+        shader_bundle_close(e->shaderBundle);
+        });
+
+    if (pc.warm)
+        LOG("Pipeline cache: loaded " << pc.loadedBytes / 1024 << " KB from " << pc.path);
+    else if (!pc.rejected.empty())
+        LOG("Pipeline cache: " << pc.path << " ignored (" << pc.rejected << "), starting cold");
+    else
+        LOG("Pipeline cache: no " << pc.path << ", starting cold");
+}
+
+void pipeline_cache_report(Engine* e)
+{
+    PipelineCacheState& pc = e->pipelineCache;
+    if (pc.reported) return;
+    pc.reported = true;
+
+    if (!pc.warm) {
+        pc.coldCreateMs = (float)pc.createMs;
+        LOG("Pipelines: " << pc.pipelines << " created, " << pc.createMs << " ms CPU summed over threads (cache cold)");
+    }
+    else if (pc.coldCreateMs > 0.0f) {
+        LOG("Pipelines: " << pc.pipelines << " created, " << pc.createMs << " ms CPU summed over threads (cache warm, "
+            << pc.coldCreateMs << " ms cold, " << pc.coldCreateMs / std::max(pc.createMs, 0.001) << "x)");
+    }
+    else {
+        LOG("Pipelines: " << pc.pipelines << " created, " << pc.createMs << " ms CPU summed over threads (cache warm)");
+    }
+}
+
+// ─── Creation ─────────────────────────────────────────────────────────────────
+// Held only for the two adds; Engine must stay movable, so it lives here
+static std::mutex s_recordMutex;
+
+static void record_creation(PipelineCacheState& pc, std::chrono::high_resolution_clock::time_point start)
+{
+    const double ms = std::chrono::duration<double, std::milli>(
+        std::chrono::high_resolution_clock::now() - start).count();
+    std::lock_guard<std::mutex> lock(s_recordMutex);
+    pc.pipelines++;
+    pc.createMs += ms;
+}
+
+VkResult create_graphics_pipeline(Engine* e, const VkGraphicsPipelineCreateInfo& info, VkPipeline* pipeline)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    VkResult result = vkCreateGraphicsPipelines(e->device, e->pipelineCache.cache, 1, &info, nullptr, pipeline);
+    record_creation(e->pipelineCache, start);
+    return result;
+}
+
+VkResult create_compute_pipeline(Engine* e, const VkComputePipelineCreateInfo& info, VkPipeline* pipeline)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    VkResult result = vkCreateComputePipelines(e->device, e->pipelineCache.cache, 1, &info, nullptr, pipeline);
+    record_creation(e->pipelineCache, start);
+    return result;
+}
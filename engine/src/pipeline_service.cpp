@@ -0,0 +1,280 @@
+#include "pipeline_service.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+
+// ─── Hashing ──────────────────────────────────────────────────────────────────
+static void hash_bytes(uint64_t& hash, const void* data, size_t size)
+{
+    const uint8_t* bytes = (const uint8_t*)data;
+    for (size_t i = 0; i < size; ++i) {
+        hash ^= bytes[i];
+        hash *= 0x100000001b3ull;
+    }
+}
+
+template <typename T>
+static void hash_value(uint64_t& hash, const T& value)
+{
+    hash_bytes(hash, &value, sizeof(value));
+}
+
+static void hash_stage(uint64_t& hash, const VkPipelineShaderStageCreateInfo& stage)
+{
+    hash_value(hash, stage.stage);
+    hash_value(hash, stage.module);
+    hash_bytes(hash, stage.pName, std::strlen(stage.pName));
+}
+
+// Every field build_pipeline reads. The Vulkan structs are hashed member by
+// member — their sType/pNext and padding must not reach the hash.
+static uint64_t hash_builder(const PipelineBuilder& pb)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash_value(hash, VK_PIPELINE_BIND_POINT_GRAPHICS);
+    for (const VkPipelineShaderStageCreateInfo& stage : pb.shaderStages)
+        hash_stage(hash, stage);
+
+    hash_value(hash, pb.inputAssembly.topology);
+    hash_value(hash, pb.inputAssembly.primitiveRestartEnable);
+
+    const VkPipelineRasterizationStateCreateInfo& r = pb.rasterizer;
+    hash_value(hash, r.depthClampEnable);
+    hash_value(hash, r.rasterizerDiscardEnable);
+    hash_value(hash, r.polygonMode);
+    hash_value(hash, r.cullMode);
+    hash_value(hash, r.frontFace);
+    hash_value(hash, r.depthBiasEnable);
+    hash_value(hash, r.depthBiasConstantFactor);
+    hash_value(hash, r.depthBiasClamp);
+    hash_value(hash, r.depthBiasSlopeFactor);
+    hash_value(hash, r.lineWidth);
+
+    hash_value(hash, pb.colorBlendAttachment);    // plain enums and flags
+
+    const VkPipelineMultisampleStateCreateInfo& m = pb.multisampling;
+    hash_value(hash, m.rasterizationSamples);
+    hash_value(hash, m.sampleShadingEnable);
+    hash_value(hash, m.minSampleShading);
+    hash_value(hash, m.alphaToCoverageEnable);
+    hash_value(hash, m.alphaToOneEnable);
+
+    const VkPipelineDepthStencilStateCreateInfo& d = pb.depthStencil;
+    hash_value(hash, d.depthTestEnable);
+    hash_value(hash, d.depthWriteEnable);
+    hash_value(hash, d.depthCompareOp);
+    hash_value(hash, d.depthBoundsTestEnable);
+    hash_value(hash, d.stencilTestEnable);
+    hash_value(hash, d.front);
+    hash_value(hash, d.back);
+    hash_value(hash, d.minDepthBounds);
+    hash_value(hash, d.maxDepthBounds);
+
+    const VkPipelineRenderingCreateInfo& ri = pb.renderInfo;
+    hash_value(hash, ri.viewMask);
+    hash_value(hash, ri.colorAttachmentCount);
+    hash_bytes(hash, ri.pColorAttachmentFormats, ri.colorAttachmentCount * sizeof(VkFormat));
+    hash_value(hash, ri.depthAttachmentFormat);
+    hash_value(hash, ri.stencilAttachmentFormat);
+
+    const VkPipelineVertexInputStateCreateInfo& v = pb.vertexInputInfo;
+    hash_value(hash, v.vertexBindingDescriptionCount);
+    hash_bytes(hash, v.pVertexBindingDescriptions,
+        v.vertexBindingDescriptionCount * sizeof(VkVertexInputBindingDescription));
+    hash_value(hash, v.vertexAttributeDescriptionCount);
+    hash_bytes(hash, v.pVertexAttributeDescriptions,
+        v.vertexAttributeDescriptionCount * sizeof(VkVertexInputAttributeDescription));
+
+    hash_value(hash, pb.pipelineLayout);
+    return hash;
+}
+
+// ─── Builder copy ─────────────────────────────────────────────────────────────
+// A compile outlives the caller's builder, so the copy owns everything the
+// builder only points at: attachment formats, vertex layout, entry points
+struct GraphicsRequest {
+    PipelineBuilder                                pb;
+    std::vector<VkVertexInputBindingDescription>   bindings;
+    std::vector<VkVertexInputAttributeDescription> attributes;
+    std::vector<std::string>                       entryPoints;
+};
+
+static std::unique_ptr<GraphicsRequest> copy_builder(const PipelineBuilder& src)
+{
+    auto request = std::make_unique<GraphicsRequest>();
+    PipelineBuilder& pb = request->pb;
+    pb = src;
+
+    if (src.renderInfo.pColorAttachmentFormats == &src.colorAttachmentformat)
+        pb.renderInfo.pColorAttachmentFormats = &pb.colorAttachmentformat;
+    else if (src.renderInfo.colorAttachmentCount > 0)
+        pb.renderInfo.pColorAttachmentFormats = pb.colorAttachmentFormats.data();
+
+    const VkPipelineVertexInputStateCreateInfo& v = src.vertexInputInfo;
+    request->bindings.assign(v.pVertexBindingDescriptions,
+        v.pVertexBindingDescriptions + v.vertexBindingDescriptionCount);
+    request->attributes.assign(v.pVertexAttributeDescriptions,
+        v.pVertexAttributeDescriptions + v.vertexAttributeDescriptionCount);
+    pb.vertexInputInfo.pVertexBindingDescriptions = request->bindings.data();
+    pb.vertexInputInfo.pVertexAttributeDescriptions = request->attributes.data();
+
+    request->entryPoints.reserve(pb.shaderStages.size());
+    for (VkPipelineShaderStageCreateInfo& stage : pb.shaderStages) {
+        request->entryPoints.emplace_back(stage.pName);
+        stage.pName = request->entryPoints.back().c_str();
+    }
+    return request;
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_pipeline_service(Engine* e)
+{
+    e->pipelineService = std::make_unique<PipelineServiceState>();
+    PipelineServiceState& ps = *e->pipelineService;
+
+    // Every core: at startup the main thread mostly waits on these anyway
+    uint32_t cores = std::max(1u, std::thread::hardware_concurrency());
+    jobs_init(ps.pool, std::clamp(cores, 1u, 16u));
+
+    // Pushed before any pipeline user, so flushed after all of them
+    e->mainDeletionQueue.push_function([=]() {
+        PipelineServiceState& ps = *e->pipelineService;
+        jobs_shutdown(ps.pool);            // runs any compile still queued
+        for (VkPipeline pipeline : ps.built)
+            if (pipeline != VK_NULL_HANDLE)
+                vkDestroyPipeline(e->device, pipeline, nullptr);
+        for (auto& [path, module] : ps.shaders)
+            vkDestroyShaderModule(e->device, module, nullptr);
+        e->pipelineService.reset();
+        });
+
+    LOG("Pipeline service: " << ps.pool.workers.size() << " compile threads");
+}
+
+VkShaderModule pipeline_service_shader(Engine* e, const char* path)
+{
+    PipelineServiceState& ps = *e->pipelineService;
+    auto it = ps.shaders.find(path);
+    if (it != ps.shaders.end()) return it->second;
+
+    VkShaderModule module = load_shader_or_exit(e, path);
+    ps.shaders.emplace(path, module);
+    return module;
+}
+
+// ─── Requests ─────────────────────────────────────────────────────────────────
+// The future for `hash`, queueing `compile` on the pool if nobody asked yet
+template <typename Compile>
+static PipelineFuture request(Engine* e, uint64_t hash, Compile&& compile)
+{
+    PipelineServiceState& ps = *e->pipelineService;
+    std::lock_guard<std::mutex> lock(ps.mutex);
+
+    ps.requests++;
+    auto it = ps.pipelines.find(hash);
+    if (it != ps.pipelines.end()) {
+        ps.deduplicated++;
+        return it->second;
+    }
+    if (ps.requests == 1)
+        ps.firstRequest = std::chrono::high_resolution_clock::now();
+
+    auto promise = std::make_shared<std::promise<VkPipeline>>();
+    PipelineFuture future = promise->get_future().share();
+    ps.pipelines.emplace(hash, future);
+
+    jobs_submit(ps.pool, [e, promise, compile = std::forward<Compile>(compile)]() {
+        CPU_ZONE("compile pipeline");
+        auto start = std::chrono::high_resolution_clock::now();
+        VkPipeline pipeline = compile();
+        {
+            PipelineServiceState& ps = *e->pipelineService;
+            std::lock_guard<std::mutex> lock(ps.mutex);
+            ps.compileMs += std::chrono::duration<double, std::milli>(
+                std::chrono::high_resolution_clock::now() - start).count();
+            if (pipeline != VK_NULL_HANDLE) ps.built.push_back(pipeline);
+        }
+        promise->set_value(pipeline);
+        });
+    return future;
+}
+
+PipelineFuture pipeline_service_request(Engine* e, const PipelineBuilder& pb, const char* name)
+{
+    std::shared_ptr<GraphicsRequest> copy = copy_builder(pb);
+    return request(e, hash_builder(pb), [e, copy, name = std::string(name)]() {
+        VkPipeline pipeline = build_pipeline(e, copy->pb);
+        if (pipeline == VK_NULL_HANDLE)
+            LOG_ERROR("Failed to create " << name << " pipeline");
+        return pipeline;
+        });
+}
+
+PipelineFuture pipeline_service_request_compute(Engine* e, VkShaderModule shader,
+    VkPipelineLayout layout, const char* name)
+{
+    uint64_t hash = 0xcbf29ce484222325ull;
+    hash_value(hash, VK_PIPELINE_BIND_POINT_COMPUTE);
+    hash_value(hash, shader);
+    hash_value(hash, layout);
+
+    return request(e, hash, [e, shader, layout, name = std::string(name)]() {
+        VkComputePipelineCreateInfo info{ .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+        info.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+        info.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+        info.stage.module = shader;
+        info.stage.pName = "main";
+        info.layout = layout;
+
+        VkPipeline pipeline = VK_NULL_HANDLE;
+        if (create_compute_pipeline(e, info, &pipeline) != VK_SUCCESS) {
+            LOG_ERROR("Failed to create " << name << " pipeline");
+            return (VkPipeline)VK_NULL_HANDLE;
+        }
+        return pipeline;
+        });
+}
+
+void pipeline_service_build(Engine* e, PipelineFuture future, VkPipeline* target)
+{
+    e->pipelineService->targets.push_back({ target, std::move(future) });
+}
+
+// ─── Waiting ──────────────────────────────────────────────────────────────────
+void pipeline_service_wait(Engine* e)
+{
+    PipelineServiceState& ps = *e->pipelineService;
+    if (ps.targets.empty()) return;
+
+    bool failed = false;
+    for (PipelineServiceTarget& t : ps.targets) {
+        *t.target = t.future.get();
+        failed |= *t.target == VK_NULL_HANDLE;
+    }
+    const size_t resolved = ps.targets.size();
+    ps.targets.clear();
+    if (failed) std::exit(1);            // the compile job logged which one
+
+    // The first wait closes the startup batch — wall time against the time
+    // the same compiles would have taken one after another
+    if (ps.startupWallMs == 0.0) {
+        ps.startupWallMs = std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - ps.firstRequest).count();
+        std::lock_guard<std::mutex> lock(ps.mutex);
+        LOG("Pipeline service: " << resolved << " pipelines in " << ps.startupWallMs
+            << " ms on " << ps.pool.workers.size() << " threads (" << ps.compileMs
+            << " ms serial, " << ps.deduplicated << " of " << ps.requests << " requests deduplicated)");
+    }
+}
+
+VkPipeline pipeline_variant_get(const PipelineVariant& variant)
+{
+    if (variant.pending.valid() &&
+        variant.pending.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        VkPipeline pipeline = variant.pending.get();
+        if (pipeline != VK_NULL_HANDLE) return pipeline;
+    }
+    return variant.fallback.get();
+}
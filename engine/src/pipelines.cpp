@@ -1,6 +1,16 @@
 ﻿#include "engine.h"
 #include "graphics_pipeline.h"
 
+VkShaderModule load_shader_or_exit(Engine* e, const char* path)
+{
+    VkShaderModule module;
+    if (!e->util.load_shader_module(path, e->device, &module)) {
+        LOG_ERROR("Failed to load " << path);
+        std::exit(1);
+    }
+    return module;
+}
+
 void init_pipelines(Engine* e)
 {
     init_background_pipelines(e);
@@ -9,18 +19,8 @@ void init_pipelines(Engine* e)
 void init_background_pipelines(Engine* e)
 {
     // ── Load all compute shaders ──────────────────────────────────────────────
-    VkShaderModule computeDrawShader;
-    if (!e->util.load_shader_module("shaders/gradient.comp.spv", e->device, &computeDrawShader)) {
-        LOG_ERROR("Failed to load gradient.comp.spv");
-        std::exit(1);
-    }
-
-
-    VkShaderModule skyAtmoShader;
-    if (!e->util.load_shader_module("shaders/sky.comp.spv", e->device, &skyAtmoShader)) {
-        LOG_ERROR("Failed to load sky_atmo.comp.spv");
-        std::exit(1);
-    }
+    VkShaderModule computeDrawShader = pipeline_service_shader(e, "shaders/gradient.comp.spv");
+    VkShaderModule skyAtmoShader = pipeline_service_shader(e, "shaders/sky.comp.spv");
 
     // ── Pipeline layout (shared by all compute effects) ───────────────────────
     VkPushConstantRange push_constant_range{
@@ -40,32 +40,17 @@ void init_background_pipelines(Engine* e)
     VK_CHECK(vkCreatePipelineLayout(e->device, &pipelineLayoutInfo, nullptr,
         &e->gradientPipelineLayout));
 
-    // ── Helper lambda: build one compute pipeline from a shader module ────────
-    auto makeComputePipeline = [&](VkShaderModule mod) -> VkPipeline {
-        VkPipelineShaderStageCreateInfo stage{
-            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
-            .stage = VK_SHADER_STAGE_COMPUTE_BIT,
-            .module = mod,
-            .pName = "main"
-        };
-        VkComputePipelineCreateInfo info{
-            .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
-            .stage = stage,
-            .layout = e->gradientPipelineLayout
-        };
-        VkPipeline pipeline;
-        VK_CHECK(vkCreateComputePipelines(e->device, VK_NULL_HANDLE, 1, &info, nullptr, &pipeline));
-        return pipeline;
-        };
-
-    // ── Build the three compute pipelines ─────────────────────────────────────
-    e->gradientPipeline = makeComputePipeline(computeDrawShader);
-  
-    VkPipeline skyAtmoPipeline = makeComputePipeline(skyAtmoShader);
+    // ── Compute pipelines — the default sky is needed for the first frame,
+    // the gradient only once picked in the UI, so it compiles in the background
+    PipelineFuture skyAtmoPipeline = pipeline_service_request_compute(e,
+        skyAtmoShader, e->gradientPipelineLayout, "sky_atmo");
+    PipelineFuture gradientPipeline = pipeline_service_request_compute(e,
+        computeDrawShader, e->gradientPipelineLayout, "gradient");
 
     // ── Effect 0: gradient ────────────────────────────────────────────────────
     ComputeEffect gradient;
-    gradient.pipeline = e->gradientPipeline;
+    gradient.pipeline = VK_NULL_HANDLE;
+    gradient.variant = { gradientPipeline, skyAtmoPipeline };
     gradient.layout = e->gradientPipelineLayout;
     gradient.name = "gradient";
     gradient.effectData = {};
@@ -82,7 +67,7 @@ void init_background_pipelines(Engine* e)
     // data2.y   = exposure    (overall brightness multiplier)
     // data2.z   = horizonBlend (0.0 = no haze  →  1.0 = thick horizon haze)
     ComputeEffect skyAtmo;
-    skyAtmo.pipeline = skyAtmoPipeline;
+    skyAtmo.pipeline = VK_NULL_HANDLE;   // written by pipeline_service_wait
     skyAtmo.layout = e->gradientPipelineLayout;
     skyAtmo.name = "sky_atmo";
     skyAtmo.effectData = {};
@@ -99,41 +84,26 @@ void init_background_pipelines(Engine* e)
 
     e->backgroundEffects.push_back(gradient);   // index 0        // index 1
     e->backgroundEffects.push_back(skyAtmo);     // index 2
+    pipeline_service_build(e, skyAtmoPipeline, &e->backgroundEffects.back().pipeline);
 
     // Use the atmospheric sky by default
     e->currentBackgroundEffect = e->currentBackgroundEffect = (uint32_t)e->backgroundEffects.size() - 1;
 
-    // ── Deletion ──────────────────────────────────────────────────────────────
+    // ── Deletion — the pipelines belong to the pipeline service ───────────────
     e->mainDeletionQueue.push_function([=]() {
-        for (auto& effect : e->backgroundEffects)
-            if (effect.pipeline != VK_NULL_HANDLE)
-                vkDestroyPipeline(e->device, effect.pipeline, nullptr);
         if (e->gradientPipelineLayout != VK_NULL_HANDLE)
             vkDestroyPipelineLayout(e->device, e->gradientPipelineLayout, nullptr);
         e->backgroundEffects.clear();
         });
 
-    vkDestroyShaderModule(e->device, computeDrawShader, nullptr);
-  
-    vkDestroyShaderModule(e->device, skyAtmoShader, nullptr);
-
-    LOG("Background pipelines created: gradient | sky | sky_atmo");
+    LOG("Background pipelines requested: gradient | sky | sky_atmo");
 }
 
 void init_mesh_pipelines(Engine* e)
 {
     LOG("Building mesh pipeline...");
-    VkShaderModule meshVertShader;
-    if (!e->util.load_shader_module("shaders/colored_triangle_mesh.vert.spv", e->device, &meshVertShader)) {
-        LOG_ERROR("Failed to load vertex shader");
-        std::exit(1);
-    }
-
-    VkShaderModule meshFragShader;
-    if (!e->util.load_shader_module("shaders/tex_image.frag.spv", e->device, &meshFragShader)) {
-        LOG_ERROR("Failed to load fragment shader");
-        std::exit(1);
-    }
+    VkShaderModule meshVertShader = pipeline_service_shader(e, "shaders/colored_triangle_mesh.vert.spv");
+    VkShaderModule meshFragShader = pipeline_service_shader(e, "shaders/tex_image.frag.spv");
 
     VkPushConstantRange pushRange{};
     pushRange.offset = 0;
@@ -189,35 +159,28 @@ void init_mesh_pipelines(Engine* e)
     pb.vertexInputInfo = vertexInputInfo;
     pb.pipelineLayout = e->meshPipelineLayout;
 
-    e->meshPipeline = build_pipeline(e->device, pb);
-    if (e->meshPipeline == VK_NULL_HANDLE) {
-        LOG_ERROR("Failed to create mesh pipeline");
-        std::exit(1);
-    }
+    pipeline_service_build(e, pipeline_service_request(e, pb, "mesh"), &e->meshPipeline);
 
-    vkDestroyShaderModule(e->device, meshVertShader, nullptr);
-    vkDestroyShaderModule(e->device, meshFragShader, nullptr);
+    // TAA mode: single-sampled, velocity in a second colour attachment
+    set_multisampling_none(pb);
+    set_color_attachment_formats({ e->drawImage.imageFormat, TAA_VELOCITY_FORMAT }, pb);
+    pipeline_service_build(e, pipeline_service_request(e, pb, "TAA mesh"), &e->meshPipelineTaa);
 
     e->mainDeletionQueue.push_function([=]() {
         vkDestroyPipelineLayout(e->device, e->meshPipelineLayout, nullptr);
-        vkDestroyPipeline(e->device, e->meshPipeline, nullptr);
         });
 
-    LOG("Mesh pipeline created");
+    LOG("Mesh pipelines requested");
 }
 
 void init_shadow_pipeline(Engine* e)
 {
-    VkShaderModule shadowVertShader;
-    if (!e->util.load_shader_module("shaders/shadow.vert.spv", e->device, &shadowVertShader)) {
-        LOG_ERROR("Failed to load shadow.vert.spv");
-        std::exit(1);
-    }
+    VkShaderModule shadowVertShader = pipeline_service_shader(e, "shaders/shadow.vert.spv");
 
-    // Push constants — just lightViewProj + modelMatrix
+    // Push constants — lightViewProj + modelMatrix + instance buffer address
     VkPushConstantRange pushRange{};
     pushRange.offset = 0;
-    pushRange.size = sizeof(ShadowPushConstants);  // 128 bytes
+    pushRange.size = sizeof(ShadowPushConstants);  // 136 bytes
     pushRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;   // vertex only, no frag shader
 
     VkPipelineLayoutCreateInfo layoutInfo{};
@@ -267,18 +230,11 @@ void init_shadow_pipeline(Engine* e)
     pb.vertexInputInfo = vertexInput;
     pb.pipelineLayout = e->shadowPipelineLayout;
 
-    e->shadowPipeline = build_pipeline(e->device, pb);
-    if (e->shadowPipeline == VK_NULL_HANDLE) {
-        LOG_ERROR("Failed to create shadow pipeline");
-        std::exit(1);
-    }
-
-    vkDestroyShaderModule(e->device, shadowVertShader, nullptr);
+    pipeline_service_build(e, pipeline_service_request(e, pb, "shadow"), &e->shadowPipeline);
 
     e->mainDeletionQueue.push_function([=]() {
         vkDestroyPipelineLayout(e->device, e->shadowPipelineLayout, nullptr);
-        vkDestroyPipeline(e->device, e->shadowPipeline, nullptr);
         });
 
-    LOG("Shadow pipeline created");
+    LOG("Shadow pipeline requested");
 }
\ No newline at end of file
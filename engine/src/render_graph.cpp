@@ -0,0 +1,578 @@
+#include "render_graph.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <fstream>
+#include <numeric>
+
+// ─── Usages ───────────────────────────────────────────────────────────────────
+struct UsageInfo {
+    VkImageLayout         layout;
+    VkPipelineStageFlags2 stages;
+    VkAccessFlags2        access;
+};
+
+static UsageInfo usage_info(GraphUsage usage)
+{
+    switch (usage) {
+    case GraphUsage::ColorAttachment:
+        return { VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT,
+                 VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT };
+    case GraphUsage::DepthAttachment:
+        return { VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                 VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT,
+                 VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT };
+    case GraphUsage::DepthSampled:
+        return { VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+    case GraphUsage::SampledFragment:
+        return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+    case GraphUsage::SampledCompute:
+        return { VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_SAMPLED_READ_BIT };
+    case GraphUsage::StorageCompute:
+        return { VK_IMAGE_LAYOUT_GENERAL, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+                 VK_ACCESS_2_SHADER_STORAGE_READ_BIT | VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT };
+    case GraphUsage::TransferSrc:
+        return { VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                 VK_ACCESS_2_TRANSFER_READ_BIT };
+    case GraphUsage::TransferDst:
+        return { VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT,
+                 VK_ACCESS_2_TRANSFER_WRITE_BIT };
+    case GraphUsage::Present:
+        return { VK_IMAGE_LAYOUT_PRESENT_SRC_KHR, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+    }
+    return { VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE };
+}
+
+constexpr VkAccessFlags2 WRITE_ACCESS =
+    VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+    VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT;
+
+// ─── Transients ───────────────────────────────────────────────────────────────
+static void destroy_transient_image(Engine* e, TransientImage& t)
+{
+    AllocatedImage& img = *t.bind;
+    if (img.imageView != VK_NULL_HANDLE) vkDestroyImageView(e->device, img.imageView, nullptr);
+    if (img.image != VK_NULL_HANDLE)     vkDestroyImage(e->device, img.image, nullptr);
+    img.imageView = VK_NULL_HANDLE;
+    img.image = VK_NULL_HANDLE;
+    img.allocation = VK_NULL_HANDLE;     // memory belongs to the graph
+}
+
+void init_render_graph(Engine* e)
+{
+    e->mainDeletionQueue.push_function([=]() {
+        RenderGraphState& rg = e->renderGraph;
+        for (TransientImage& t : rg.transients) destroy_transient_image(e, t);
+        rg.transients.clear();
+        if (rg.memory != VK_NULL_HANDLE) vmaFreeMemory(e->allocator, rg.memory);
+        rg.memory = VK_NULL_HANDLE;
+        });
+}
+
+void render_graph_register_transient(Engine* e, const char* name, const VkImageCreateInfo& info,
+    VkImageAspectFlags aspect, AllocatedImage* bind, std::function<void(Engine*)> onCreate)
+{
+    RenderGraphState& rg = e->renderGraph;
+    auto it = std::find_if(rg.transients.begin(), rg.transients.end(),
+        [bind](const TransientImage& t) { return t.bind == bind; });
+
+    TransientImage* t;
+    if (it != rg.transients.end()) {
+        destroy_transient_image(e, *it);
+        t = &*it;
+    }
+    else {
+        t = &rg.transients.emplace_back();
+    }
+
+    t->name = name;
+    t->info = info;
+    t->aspect = aspect;
+    t->bind = bind;
+    t->onCreate = std::move(onCreate);
+
+    bind->imageFormat = info.format;
+    bind->imageExtent = info.extent;
+    bind->mipLevels = info.mipLevels;
+    rg.placedSignature = 0;
+}
+
+void render_graph_release_transient(Engine* e, AllocatedImage* bind)
+{
+    RenderGraphState& rg = e->renderGraph;
+    auto it = std::find_if(rg.transients.begin(), rg.transients.end(),
+        [bind](const TransientImage& t) { return t.bind == bind; });
+    if (it == rg.transients.end()) return;
+
+    destroy_transient_image(e, *it);
+    rg.transients.erase(it);
+    rg.placedSignature = 0;
+}
+
+static bool lifetimes_overlap(const TransientImage& a, const TransientImage& b)
+{
+    if (a.firstPass == UINT32_MAX || b.firstPass == UINT32_MAX) return false;   // unused this frame
+    return a.firstPass <= b.lastPass && b.firstPass <= a.lastPass;
+}
+
+static bool memory_overlaps(const TransientImage& a, const TransientImage& b)
+{
+    return a.offset < b.offset + b.requirements.size && b.offset < a.offset + a.requirements.size;
+}
+
+static VkDeviceSize align_up(VkDeviceSize v, VkDeviceSize alignment)
+{
+    return (v + alignment - 1) / alignment * alignment;
+}
+
+// FNV-1a over everything placement depends on
+static uint64_t placement_signature(const RenderGraphState& rg)
+{
+    uint64_t h = 14695981039346656037ull;
+    auto mix = [&h](const void* data, size_t size) {
+        const uint8_t* p = (const uint8_t*)data;
+        for (size_t i = 0; i < size; ++i) { h ^= p[i]; h *= 1099511628211ull; }
+        };
+    mix(&rg.aliasing, sizeof(rg.aliasing));
+    for (const TransientImage& t : rg.transients) {
+        mix(&t.info.format, sizeof(t.info.format));
+        mix(&t.info.extent, sizeof(t.info.extent));
+        mix(&t.info.samples, sizeof(t.info.samples));
+        mix(&t.info.usage, sizeof(t.info.usage));
+        mix(&t.firstPass, sizeof(t.firstPass));
+        mix(&t.lastPass, sizeof(t.lastPass));
+    }
+    return h ? h : 1;
+}
+
+// Largest first; each image goes to the lowest offset that is free of every
+// image already placed whose lifetime overlaps its own
+static void place_transients(Engine* e, uint64_t signature)
+{
+    RenderGraphState& rg = e->renderGraph;
+
+    // Earlier frames may still be using the old images
+    vkDeviceWaitIdle(e->device);
+    for (TransientImage& t : rg.transients) destroy_transient_image(e, t);
+    if (rg.memory != VK_NULL_HANDLE) vmaFreeMemory(e->allocator, rg.memory);
+    rg.memory = VK_NULL_HANDLE;
+    rg.memorySize = rg.unaliasedSize = 0;
+    rg.placedSignature = signature;
+    rg.placements++;
+    if (rg.transients.empty()) return;
+
+    uint32_t     typeBits = ~0u;
+    VkDeviceSize alignment = 1;
+    for (TransientImage& t : rg.transients) {
+        VK_CHECK(vkCreateImage(e->device, &t.info, nullptr, &t.bind->image));
+        vkGetImageMemoryRequirements(e->device, t.bind->image, &t.requirements);
+        typeBits &= t.requirements.memoryTypeBits;
+        alignment = std::max(alignment, t.requirements.alignment);
+    }
+    if (typeBits == 0) {
+        LOG_ERROR("Render graph: transient images share no memory type");
+        std::exit(1);
+    }
+
+    std::vector<uint32_t> order(rg.transients.size());
+    std::iota(order.begin(), order.end(), 0u);
+    std::sort(order.begin(), order.end(), [&rg](uint32_t a, uint32_t b) {
+        return rg.transients[a].requirements.size > rg.transients[b].requirements.size;
+        });
+
+    std::vector<uint32_t> placed;
+    for (uint32_t i : order) {
+        TransientImage& t = rg.transients[i];
+        t.offset = 0;
+        for (bool moved = true; moved; ) {
+            moved = false;
+            for (uint32_t j : placed) {
+                const TransientImage& o = rg.transients[j];
+                if (rg.aliasing && !lifetimes_overlap(t, o)) continue;
+                if (memory_overlaps(t, o)) {
+                    t.offset = align_up(o.offset + o.requirements.size, t.requirements.alignment);
+                    moved = true;
+                }
+            }
+        }
+        placed.push_back(i);
+        rg.memorySize = std::max(rg.memorySize, t.offset + t.requirements.size);
+        rg.unaliasedSize += align_up(t.requirements.size, alignment);
+    }
+
+    VkMemoryRequirements requirements{ rg.memorySize, alignment, typeBits };
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+    allocInfo.flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT;
+    VK_CHECK(vmaAllocateMemory(e->allocator, &requirements, &allocInfo, &rg.memory, nullptr));
+
+    for (TransientImage& t : rg.transients) {
+        VK_CHECK(vmaBindImageMemory2(e->allocator, rg.memory, t.offset, t.bind->image, nullptr));
+
+        VkImageViewCreateInfo viewInfo = imageview_create_info(t.info.format, t.bind->image, t.aspect);
+        VK_CHECK(vkCreateImageView(e->device, &viewInfo, nullptr, &t.bind->imageView));
+        if (t.onCreate) t.onCreate(e);
+    }
+
+    LOG("Render graph: " << rg.transients.size() << " transients in "
+        << rg.memorySize / (1024 * 1024) << " MB (" << rg.unaliasedSize / (1024 * 1024) << " MB unaliased)");
+}
+
+// ─── Declaration ──────────────────────────────────────────────────────────────
+void render_graph_begin(Engine* e)
+{
+    e->renderGraph.resources.clear();
+    e->renderGraph.passes.clear();
+}
+
+GraphHandle render_graph_import(Engine* e, const char* name, VkImage image, VkImageAspectFlags aspect,
+    VkImageLayout layout, VkPipelineStageFlags2 lastStages)
+{
+    GraphResource& r = e->renderGraph.resources.emplace_back();
+    r.name = name;
+    r.image = image;
+    r.aspect = aspect;
+    r.initialLayout = layout;
+    r.initialStages = lastStages;
+    return (GraphHandle)e->renderGraph.resources.size() - 1;
+}
+
+GraphHandle render_graph_transient(Engine* e, AllocatedImage* bind)
+{
+    RenderGraphState& rg = e->renderGraph;
+    auto it = std::find_if(rg.transients.begin(), rg.transients.end(),
+        [bind](const TransientImage& t) { return t.bind == bind; });
+    if (it == rg.transients.end()) {
+        LOG_ERROR("Render graph: image was never registered as a transient");
+        log_flush();
+        std::abort();
+    }
+
+    GraphResource& r = rg.resources.emplace_back();
+    r.name = it->name;
+    r.aspect = it->aspect;
+    r.transient = (int32_t)(it - rg.transients.begin());
+    return (GraphHandle)rg.resources.size() - 1;
+}
+
+void render_graph_export(Engine* e, GraphHandle resource, GraphUsage finalUsage)
+{
+    GraphResource& r = e->renderGraph.resources[resource];
+    r.exported = true;
+    r.finalUsage = finalUsage;
+}
+
+uint32_t render_graph_add_pass(Engine* e, const char* name, std::function<void(VkCommandBuffer)> record)
+{
+    GraphPass& p = e->renderGraph.passes.emplace_back();
+    p.name = name;
+    p.record = std::move(record);
+    return (uint32_t)e->renderGraph.passes.size() - 1;
+}
+
+void render_graph_read(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage)
+{
+    e->renderGraph.passes[pass].accesses.push_back({ resource, usage, true, false, false });
+}
+
+void render_graph_write(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage)
+{
+    e->renderGraph.passes[pass].accesses.push_back({ resource, usage, false, true, false });
+}
+
+void render_graph_modify(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage)
+{
+    e->renderGraph.passes[pass].accesses.push_back({ resource, usage, true, true, false });
+}
+
+void render_graph_external(Engine* e, uint32_t pass, GraphHandle resource, GraphUsage usage)
+{
+    e->renderGraph.passes[pass].accesses.push_back({ resource, usage, false, true, true });
+}
+
+void render_graph_side_effects(Engine* e, uint32_t pass)
+{
+    e->renderGraph.passes[pass].sideEffects = true;
+}
+
+// ─── Compile ──────────────────────────────────────────────────────────────────
+// Walks back from the sinks: a pass lives if it writes something a later live
+// pass (or the frame's output) still needs
+static void cull_passes(RenderGraphState& rg)
+{
+    std::vector<uint8_t> needed(rg.resources.size(), 0);
+    for (uint32_t i = 0; i < (uint32_t)rg.resources.size(); ++i)
+        needed[i] = rg.resources[i].exported;
+
+    rg.culledPasses = 0;
+    for (uint32_t p = (uint32_t)rg.passes.size(); p-- > 0; ) {
+        GraphPass& pass = rg.passes[p];
+        bool live = pass.sideEffects;
+        for (const GraphAccess& a : pass.accesses)
+            live = live || (a.writes && needed[a.resource]);
+
+        pass.culled = !live;
+        if (!live) { rg.culledPasses++; continue; }
+
+        // A full overwrite satisfies every later reader; loads and reads
+        // reach further back
+        for (const GraphAccess& a : pass.accesses)
+            if (a.writes && !a.reads) needed[a.resource] = 0;
+        for (const GraphAccess& a : pass.accesses)
+            if (a.reads) needed[a.resource] = 1;
+    }
+}
+
+static void compute_lifetimes(RenderGraphState& rg)
+{
+    for (TransientImage& t : rg.transients) {
+        t.firstPass = UINT32_MAX;
+        t.lastPass = 0;
+        t.tailStages = VK_PIPELINE_STAGE_2_NONE;
+        t.tailWrites = VK_ACCESS_2_NONE;
+    }
+    for (uint32_t p = 0; p < (uint32_t)rg.passes.size(); ++p) {
+        if (rg.passes[p].culled) continue;
+        for (const GraphAccess& a : rg.passes[p].accesses) {
+            int32_t ti = rg.resources[a.resource].transient;
+            if (ti < 0) continue;
+
+            TransientImage& t = rg.transients[ti];
+            const UsageInfo u = usage_info(a.usage);
+            t.firstPass = std::min(t.firstPass, p);
+            t.lastPass = std::max(t.lastPass, p);
+            t.tailStages = u.stages;
+            t.tailWrites = a.writes ? (u.access & WRITE_ACCESS) : VK_ACCESS_2_NONE;
+        }
+    }
+}
+
+// What the last access to an image left behind
+struct ResourceState {
+    VkImageLayout         layout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkPipelineStageFlags2 writeStages = VK_PIPELINE_STAGE_2_NONE;
+    VkAccessFlags2        writeAccess = VK_ACCESS_2_NONE;    // not yet made visible
+    VkPipelineStageFlags2 readStages = VK_PIPELINE_STAGE_2_NONE;
+    VkPipelineStageFlags2 visible = VK_PIPELINE_STAGE_2_NONE; // stages the last write is visible to
+};
+
+static std::vector<ResourceState> initial_states(const RenderGraphState& rg)
+{
+    std::vector<ResourceState> states(rg.resources.size());
+    for (uint32_t i = 0; i < (uint32_t)rg.resources.size(); ++i) {
+        const GraphResource& r = rg.resources[i];
+        ResourceState&       s = states[i];
+        if (r.transient < 0) {
+            s.layout = r.initialLayout;
+            s.readStages = r.initialStages;
+            continue;
+        }
+
+        // Contents are discarded, but the memory may still be in use by the
+        // previous frame — by this image or by one aliasing it
+        const TransientImage& t = rg.transients[r.transient];
+        for (const TransientImage& o : rg.transients) {
+            if (&o != &t && !memory_overlaps(t, o)) continue;
+            s.writeStages |= o.tailStages;
+            s.writeAccess |= o.tailWrites;
+        }
+    }
+    return states;
+}
+
+static void push_barrier(std::vector<VkImageMemoryBarrier2>& out, GraphPass* pass,
+    const GraphResource& r, GraphHandle handle, const ResourceState& from,
+    VkImageLayout newLayout, VkPipelineStageFlags2 srcStages, VkAccessFlags2 srcAccess,
+    VkPipelineStageFlags2 dstStages, VkAccessFlags2 dstAccess)
+{
+    VkImageMemoryBarrier2 b{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    b.image = r.image;
+    b.oldLayout = from.layout;
+    b.newLayout = newLayout;
+    b.srcStageMask = srcStages;
+    b.srcAccessMask = srcAccess;
+    b.dstStageMask = dstStages;
+    b.dstAccessMask = dstAccess;
+    b.subresourceRange = { r.aspect, 0, VK_REMAINING_MIP_LEVELS, 0, VK_REMAINING_ARRAY_LAYERS };
+    out.push_back(b);
+
+    if (pass) pass->barriers.push_back({ handle, from.layout, newLayout, srcStages, dstStages });
+}
+
+static void flush(VkCommandBuffer cmd, std::vector<VkImageMemoryBarrier2>& barriers, uint32_t& count)
+{
+    if (barriers.empty()) return;
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.imageMemoryBarrierCount = (uint32_t)barriers.size();
+    dep.pImageMemoryBarriers = barriers.data();
+    vkCmdPipelineBarrier2(cmd, &dep);
+    count += (uint32_t)barriers.size();
+    barriers.clear();
+}
+
+// ─── Execute ──────────────────────────────────────────────────────────────────
+void render_graph_execute(Engine* e, VkCommandBuffer cmd)
+{
+    CPU_ZONE("render_graph_execute");
+    RenderGraphState& rg = e->renderGraph;
+
+    cull_passes(rg);
+    compute_lifetimes(rg);
+    const uint64_t signature = placement_signature(rg);
+    if (signature != rg.placedSignature)
+        place_transients(e, signature);
+    for (GraphResource& r : rg.resources)
+        if (r.transient >= 0) r.image = rg.transients[r.transient].bind->image;
+
+    std::vector<ResourceState>         states = initial_states(rg);
+    std::vector<VkImageMemoryBarrier2> barriers;
+    uint32_t                           barrierCount = 0;
+
+    for (GraphPass& pass : rg.passes) {
+        pass.barriers.clear();
+        if (pass.culled) continue;
+
+        for (const GraphAccess& a : pass.accesses) {
+            const GraphResource& r = rg.resources[a.resource];
+            const UsageInfo      u = usage_info(a.usage);
+            ResourceState&       s = states[a.resource];
+
+            if (a.external) {
+                // Already visible to `usage` — the pass's own barriers saw to it
+                s = { u.layout, VK_PIPELINE_STAGE_2_NONE, VK_ACCESS_2_NONE, u.stages, u.stages };
+                continue;
+            }
+
+            const bool transition = u.layout != s.layout;
+            if (transition || a.writes) {
+                // WAR / WAW / layout change: wait for every earlier access
+                VkPipelineStageFlags2 src = s.writeStages | s.readStages;
+                if (transition || src != VK_PIPELINE_STAGE_2_NONE)
+                    push_barrier(barriers, &pass, r, a.resource, s, u.layout, src, s.writeAccess, u.stages, u.access);
+            }
+            else if (s.writeStages != VK_PIPELINE_STAGE_2_NONE && (u.stages & ~s.visible)) {
+                // RAW: make the last write visible to these stages
+                push_barrier(barriers, &pass, r, a.resource, s, u.layout, s.writeStages, s.writeAccess, u.stages, u.access);
+                s.visible |= u.stages;
+            }
+
+            if (a.writes)        s = { u.layout, u.stages, u.access & WRITE_ACCESS, VK_PIPELINE_STAGE_2_NONE, u.stages };
+            else if (transition) s = { u.layout, u.stages, VK_ACCESS_2_NONE, u.stages, u.stages };
+            else                 s.readStages |= u.stages;
+        }
+
+        // The scope takes in the pass's barriers, so waits land on the pass
+        gpu_profiler_begin(e, cmd, pass.name.c_str());
+        flush(cmd, barriers, barrierCount);
+        pass.record(cmd);
+        gpu_profiler_end(e, cmd);
+    }
+
+    // ── Exported images leave in their final layout
+    for (uint32_t i = 0; i < (uint32_t)rg.resources.size(); ++i) {
+        const GraphResource& r = rg.resources[i];
+        if (!r.exported) continue;
+
+        const UsageInfo      u = usage_info(r.finalUsage);
+        const ResourceState& s = states[i];
+        if (u.layout != s.layout)
+            push_barrier(barriers, nullptr, r, i, s, u.layout,
+                s.writeStages | s.readStages, s.writeAccess, u.stages, u.access);
+    }
+    flush(cmd, barriers, barrierCount);
+    rg.barriers = barrierCount;    // the UI draws mid-execute, so only publish a full count
+
+    if (rg.dumpRequested) {
+        rg.dumpRequested = false;
+        if (render_graph_dump(e, "render_graph.dot"))
+            LOG("Render graph written to render_graph.dot");
+    }
+}
+
+// ─── Dump ─────────────────────────────────────────────────────────────────────
+static const char* layout_name(VkImageLayout layout)
+{
+    switch (layout) {
+    case VK_IMAGE_LAYOUT_UNDEFINED:                 return "UNDEFINED";
+    case VK_IMAGE_LAYOUT_GENERAL:                   return "GENERAL";
+    case VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL:  return "COLOR_ATTACHMENT";
+    case VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL:  return "DEPTH_ATTACHMENT";
+    case VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL:   return "DEPTH_READ_ONLY";
+    case VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL:  return "SHADER_READ_ONLY";
+    case VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL:      return "TRANSFER_SRC";
+    case VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL:      return "TRANSFER_DST";
+    case VK_IMAGE_LAYOUT_PRESENT_SRC_KHR:           return "PRESENT_SRC";
+    default:                                        return "?";
+    }
+}
+
+static const char* usage_name(GraphUsage usage)
+{
+    switch (usage) {
+    case GraphUsage::ColorAttachment: return "color";
+    case GraphUsage::DepthAttachment: return "depth";
+    case GraphUsage::DepthSampled:    return "depth sampled";
+    case GraphUsage::SampledFragment: return "sampled (fs)";
+    case GraphUsage::SampledCompute:  return "sampled (cs)";
+    case GraphUsage::StorageCompute:  return "storage";
+    case GraphUsage::TransferSrc:     return "transfer src";
+    case GraphUsage::TransferDst:     return "transfer dst";
+    case GraphUsage::Present:         return "present";
+    }
+    return "?";
+}
+
+bool render_graph_dump(const Engine* e, const char* path)
+{
+    const RenderGraphState& rg = e->renderGraph;
+    std::ofstream out(path);
+    if (!out) {
+        LOG_ERROR("Render graph: cannot write " << path);
+        return false;
+    }
+
+    out << "// " << rg.passes.size() << " passes (" << rg.culledPasses << " culled), "
+        << rg.barriers << " barriers, transients " << rg.memorySize / (1024 * 1024) << " MB aliased / "
+        << rg.unaliasedSize / (1024 * 1024) << " MB unaliased\n";
+    out << "digraph frame {\n  rankdir=LR;\n  node [fontname=\"monospace\", fontsize=10];\n";
+
+    for (uint32_t i = 0; i < (uint32_t)rg.resources.size(); ++i) {
+        const GraphResource& r = rg.resources[i];
+        out << "  r" << i << " [shape=ellipse, label=\"" << r.name;
+        if (r.transient >= 0) {
+            const TransientImage& t = rg.transients[r.transient];
+            out << "\\ntransient @" << t.offset / (1024 * 1024) << " MB, "
+                << t.requirements.size / (1024 * 1024) << " MB\\npasses " << (int)t.firstPass << ".." << t.lastPass;
+        }
+        else {
+            out << "\\nimported";
+            if (r.exported) out << ", exported as " << usage_name(r.finalUsage);
+        }
+        out << "\"];\n";
+    }
+
+    for (uint32_t p = 0; p < (uint32_t)rg.passes.size(); ++p) {
+        const GraphPass& pass = rg.passes[p];
+        out << "  p" << p << " [shape=box, " << (pass.culled ? "style=dashed, color=gray, " : "")
+            << "label=\"" << p << ": " << pass.name << (pass.culled ? " (culled)" : "") << "\\l";
+        for (const GraphBarrier& b : pass.barriers)
+            out << "  " << rg.resources[b.resource].name << ": " << layout_name(b.oldLayout)
+                << " -> " << layout_name(b.newLayout) << std::hex
+                << " (0x" << b.srcStages << " -> 0x" << b.dstStages << ")" << std::dec << "\\l";
+        out << "\"];\n";
+
+        for (const GraphAccess& a : pass.accesses) {
+            if (a.reads)
+                out << "  r" << a.resource << " -> p" << p << " [label=\"" << usage_name(a.usage) << "\"];\n";
+            if (a.writes)
+                out << "  p" << p << " -> r" << a.resource << " [label=\"" << usage_name(a.usage)
+                    << (a.external ? ", self-synced" : "") << "\"];\n";
+        }
+    }
+    out << "}\n";
+    return true;
+}
@@ -0,0 +1,508 @@
+#include "render_queue.h"
+#include "engine.h"
+
+#include <chrono>
+#include <map>
+#include <tuple>
+#include <unordered_map>
+
+// ─── Keys ─────────────────────────────────────────────────────────────────────
+static inline uint64_t rq_bits(uint64_t value, uint32_t width, uint32_t shift)
+{
+    return (value & ((1ull << width) - 1)) << shift;
+}
+
+uint64_t make_sort_key(RenderPassId pass, RenderPipelineId pipeline,
+    uint32_t geometry, uint32_t material, float depth01)
+{
+    depth01 = std::clamp(depth01, 0.0f, 1.0f);
+    uint64_t key = rq_bits((uint64_t)pass, 2, 62) | rq_bits((uint64_t)pipeline, 6, 56);
+
+    switch (pass) {
+    case RenderPassId::Opaque: {
+        uint32_t d = (uint32_t)(depth01 * (float)((1u << 20) - 1));
+        key |= rq_bits(d >> 14, 6, 50);        // slice
+        key |= rq_bits(geometry, 16, 34);
+        key |= rq_bits(material, 20, 14);
+        key |= rq_bits(d, 14, 0);              // order inside the slice
+        break;
+    }
+    case RenderPassId::Transparent: {
+        uint32_t d = (uint32_t)((1.0f - depth01) * (float)((1u << 24) - 1));
+        key |= rq_bits(d, 24, 32);
+        key |= rq_bits(geometry, 16, 16);
+        key |= rq_bits(material, 16, 0);
+        break;
+    }
+    case RenderPassId::Shadow: {
+        uint32_t d = (uint32_t)(depth01 * (float)((1u << 24) - 1));
+        key |= rq_bits(geometry, 16, 40);
+        key |= rq_bits(d, 24, 16);
+        key |= rq_bits(material, 16, 0);
+        break;
+    }
+    }
+    return key;
+}
+
+static inline uint32_t rq_pipeline(uint64_t key) { return (uint32_t)((key >> 56) & 0x3F); }
+
+VkPipeline render_pipeline(const Engine* e, RenderPipelineId id)
+{
+    const bool taa = e->taa.mode == AntiAliasing::Taa;
+    const DepthPrepassState& dp = e->depthPrepass;
+    switch (id) {
+    case RenderPipelineId::Mesh:        return taa ? e->meshPipelineTaa : e->meshPipeline;
+    case RenderPipelineId::Shadow:      return e->shadowPipeline;
+    case RenderPipelineId::MeshEqual:   return taa ? dp.equalPipelineTaa : dp.equalPipeline;
+    case RenderPipelineId::Depth:       return taa ? dp.depthPipelineTaa : dp.depthPipeline;
+    case RenderPipelineId::DepthMasked: return taa ? dp.maskedPipelineTaa : dp.maskedPipeline;
+    }
+    return VK_NULL_HANDLE;
+}
+
+RenderPipelineId opaque_colour_pipeline(const Engine* e)
+{
+    return e->depthPrepass.enabled ? RenderPipelineId::MeshEqual : RenderPipelineId::Mesh;
+}
+
+// ─── Radix sort ───────────────────────────────────────────────────────────────
+void radix_sort_packets(std::vector<DrawPacket>& packets, std::vector<DrawPacket>& scratch)
+{
+    const size_t n = packets.size();
+    if (n < 2) return;
+    scratch.resize(n);
+
+    uint32_t histogram[8][256] = {};
+    for (const DrawPacket& p : packets)
+        for (uint32_t b = 0; b < 8; ++b)
+            histogram[b][(p.key >> (b * 8)) & 0xFF]++;
+
+    DrawPacket* src = packets.data();
+    DrawPacket* dst = scratch.data();
+
+    for (uint32_t b = 0; b < 8; ++b) {
+        uint32_t* h = histogram[b];
+        const uint32_t shift = b * 8;
+        if (h[(src[0].key >> shift) & 0xFF] == n) continue;   // byte is constant
+
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < 256; ++i) {
+            uint32_t count = h[i];
+            h[i] = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; ++i)
+            dst[h[(src[i].key >> shift) & 0xFF]++] = src[i];
+        std::swap(src, dst);
+    }
+
+    if (src != packets.data())
+        packets.swap(scratch);
+}
+
+// ─── Materials ────────────────────────────────────────────────────────────────
+// Dense ids for identical surface materials so the key groups them and the
+// submitter can skip pushing a material that is already live. Geometry ids do
+// the same for shared vertex/index buffers, so instances of one mesh sort
+// together and can be batched.
+void build_material_ids(Engine* e)
+{
+    RenderQueueState& rq = e->renderQueue;
+    using MaterialKey = std::tuple<uint32_t, uint32_t, uint32_t, uint32_t, uint32_t,
+        float, float, float, float, float, float>;
+    std::map<MaterialKey, uint32_t> ids;
+
+    rq.surfaceMaterial.clear();
+    for (auto& asset : e->testMeshes) {
+        for (auto& s : asset->surfaces) {
+            MaterialKey k{ s.albedoIndex, s.normalIndex, s.metallicRoughnessIndex, s.aoIndex, s.emissiveIndex,
+                s.metallicFactor, s.roughnessFactor,
+                s.colorFactor.r, s.colorFactor.g, s.colorFactor.b, s.colorFactor.a };
+            auto [it, inserted] = ids.try_emplace(k, (uint32_t)ids.size());
+            rq.surfaceMaterial.push_back(it->second);
+        }
+    }
+    rq.materialCount = (uint32_t)ids.size();
+
+    std::unordered_map<VkBuffer, uint32_t> geometryIds;
+    rq.assetGeometry.clear();
+    for (auto& asset : e->testMeshes) {
+        auto [it, inserted] = geometryIds.try_emplace(asset->meshBuffers.vertexBuffer.buffer,
+            (uint32_t)geometryIds.size());
+        rq.assetGeometry.push_back(it->second);
+    }
+    rq.geometryCount = (uint32_t)geometryIds.size();
+}
+
+// ─── Instancing ───────────────────────────────────────────────────────────────
+static AllocatedBuffer rq_create_instance_buffer(Engine* e, uint32_t capacity)
+{
+    AllocatedBuffer buffer = create_buffer(e->allocator, capacity * sizeof(glm::mat4),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+        VMA_MEMORY_USAGE_CPU_TO_GPU, e);
+    VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+
+    VkBufferDeviceAddressInfo info{ .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO };
+    info.buffer = buffer.buffer;
+    buffer.address = vkGetBufferDeviceAddress(e->device, &info);
+    return buffer;
+}
+
+static void rq_destroy_instance_buffer(Engine* e, AllocatedBuffer& buffer)
+{
+    vmaUnmapMemory(e->allocator, buffer.allocation);
+    destroy_buffer(buffer, e);
+    buffer = {};
+}
+
+void init_render_queues(Engine* e)
+{
+    RenderQueueState& rq = e->renderQueue;
+    rq.instanceBuffers.resize(FRAME_OVERLAP);
+    rq.instanceCapacity.assign(FRAME_OVERLAP, 4096);
+    for (uint32_t f = 0; f < FRAME_OVERLAP; ++f)
+        rq.instanceBuffers[f] = rq_create_instance_buffer(e, rq.instanceCapacity[f]);
+
+    e->mainDeletionQueue.push_function([=]() {
+        for (AllocatedBuffer& buffer : e->renderQueue.instanceBuffers)
+            rq_destroy_instance_buffer(e, buffer);
+        e->renderQueue.instanceBuffers.clear();
+        });
+}
+
+// Groups a sorted queue into instanced draws and writes their model matrices
+// at `models[cursor...]`. Every (pipeline, geometry, surface, material) in the
+// queue becomes one batch, whatever depth slices its copies sort into. A batch
+// draws at its first packet, so batches stay in key order — pipelines grouped,
+// front to back by nearest copy. Blended packets keep their back-to-front order
+// as single draws.
+static void rq_batch_queue(const Engine* e, RenderQueue& queue,
+    glm::mat4* models, uint32_t& cursor, VkDeviceAddress address)
+{
+    const RenderQueueState& rq = e->renderQueue;
+    const uint32_t n = (uint32_t)queue.packets.size();
+    queue.batches.clear();
+    queue.instances = address;
+
+    // (pipeline, geometry, surface, material) → batch index
+    std::unordered_map<uint64_t, uint32_t> batchOf;
+    std::vector<uint32_t>                  members(n);    // packet → batch
+
+    for (uint32_t i = 0; i < n; ++i) {
+        const DrawPacket& p = queue.packets[i];
+        if ((RenderPassId)(p.key >> 62) == RenderPassId::Transparent) {
+            members[i] = (uint32_t)queue.batches.size();
+            queue.batches.push_back({ i, 1, 0 });
+            continue;
+        }
+
+        const uint32_t material = rq.surfaceMaterial[e->culling.scene.assetFirstSurface[p.asset] + p.surface];
+        const uint64_t id = rq_bits(rq_pipeline(p.key), 6, 58) | rq_bits(rq.assetGeometry[p.asset], 16, 42)
+            | rq_bits(p.surface, 22, 20) | rq_bits(material, 20, 0);
+
+        auto [it, inserted] = batchOf.try_emplace(id, (uint32_t)queue.batches.size());
+        if (inserted) queue.batches.push_back({ i, 0, 0 });
+        queue.batches[it->second].count++;
+        members[i] = it->second;
+    }
+
+    // Lay each batch's matrices out contiguously
+    for (DrawBatch& b : queue.batches) {
+        b.firstInstance = cursor;
+        cursor += b.count;
+        b.count = 0;
+    }
+    for (uint32_t i = 0; i < n; ++i) {
+        DrawBatch& b = queue.batches[members[i]];
+        models[b.firstInstance + b.count++] = e->testMeshes[queue.packets[i].asset]->worldTransform;
+    }
+}
+
+static void rq_build_batches(Engine* e)
+{
+    RenderQueueState& rq = e->renderQueue;
+    std::vector<RenderQueue*> queues = { &rq.camera, &rq.depth };
+    for (RenderQueue& q : rq.shadow) queues.push_back(&q);
+    for (RenderQueue& q : rq.shadowStatic) queues.push_back(&q);
+
+    if (!rq.instancing || rq.instanceBuffers.empty()) {
+        for (RenderQueue* q : queues) {
+            q->batches.clear();
+            q->instances = 0;
+        }
+        return;
+    }
+
+    // This slot's fence has passed, so its buffer can be grown in place
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    uint32_t needed = 0;
+    for (RenderQueue* q : queues) needed += (uint32_t)q->packets.size();
+    if (needed > rq.instanceCapacity[slot]) {
+        uint32_t capacity = rq.instanceCapacity[slot];
+        while (capacity < needed) capacity *= 2;
+        rq_destroy_instance_buffer(e, rq.instanceBuffers[slot]);
+        rq.instanceBuffers[slot] = rq_create_instance_buffer(e, capacity);
+        rq.instanceCapacity[slot] = capacity;
+    }
+
+    const AllocatedBuffer& buffer = rq.instanceBuffers[slot];
+    glm::mat4* models = (glm::mat4*)buffer.info.pMappedData;
+    uint32_t   cursor = 0;
+    for (RenderQueue* q : queues)
+        rq_batch_queue(e, *q, models, cursor, buffer.address);
+    vmaFlushAllocation(e->allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+}
+
+// ─── Build ────────────────────────────────────────────────────────────────────
+void build_render_queues(Engine* e)
+{
+    CPU_ZONE("build_render_queues");
+    RenderQueueState& rq = e->renderQueue;
+    const CullScene& s = e->culling.scene;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (rq.surfaceMaterial.size() != s.count || rq.assetGeometry.size() != e->testMeshes.size())
+        build_material_ids(e);
+
+    rq.camera.packets.clear();
+    rq.depth.packets.clear();
+    for (RenderQueue& q : rq.shadow) q.packets.clear();
+    for (RenderQueue& q : rq.shadowStatic) q.packets.clear();
+    rq.camera.triangles = 0;
+    rq.depth.triangles = 0;
+
+    const bool             prepass = e->depthPrepass.enabled;
+    const RenderPipelineId colourPipeline = opaque_colour_pipeline(e);
+    const ShadowCascadeState& cascades = e->shadowCascades;
+    const ShadowCacheState&   shadowCache = e->shadowCache;
+
+    const glm::vec3 eye = e->mainCamera.position;
+    const float     logFar = std::log2(1.0f + 50000.0f);
+
+    uint32_t flat = 0;
+    for (uint32_t a = 0; a < (uint32_t)e->testMeshes.size(); ++a) {
+        const MeshAsset& mesh = *e->testMeshes[a];
+        for (uint32_t i = 0; i < (uint32_t)mesh.surfaces.size(); ++i, ++flat) {
+            const GeoSurface& surf = mesh.surfaces[i];
+            const uint32_t    material = rq.surfaceMaterial[flat];
+            const uint32_t    geometry = rq.assetGeometry[a];
+            const glm::vec3   center(s.sphereX[flat], s.sphereY[flat], s.sphereZ[flat]);
+
+            if (cull_is_visible(e->culling.camera, flat)) {
+                // Log distance keeps the slices useful from 0.05 to 50k units
+                float dist = glm::length(center - eye);
+                float depth = rq.frontToBack
+                    ? std::log2(1.0f + std::max(0.0f, dist - s.sphereR[flat])) / logFar : 0.0f;
+
+                // With the pre-pass on, masked surfaces are depth-tested like
+                // opaque ones and leave the blended pass
+                const bool depthTested = surf.opaque || (prepass && surf.masked);
+                if (prepass && depthTested) {
+                    RenderPipelineId pipeline = surf.masked ? RenderPipelineId::DepthMasked : RenderPipelineId::Depth;
+                    rq.depth.packets.push_back({
+                        make_sort_key(RenderPassId::Opaque, pipeline, geometry, material, depth), a, i });
+                    rq.depth.triangles += surf.count / 3;
+                }
+
+                // Static opaque surfaces are replayed from the draw cache
+                if (!draw_cache_owns(e, mesh, surf, false)) {
+                    uint64_t key;
+                    if (depthTested) {
+                        // Overdraw is already gone after a pre-pass — sort by state only
+                        key = make_sort_key(RenderPassId::Opaque, colourPipeline, geometry, material, prepass ? 0.0f : depth);
+                    }
+                    else {
+                        float far = rq.frontToBack ? std::log2(1.0f + dist) / logFar : 0.0f;
+                        key = make_sort_key(RenderPassId::Transparent, RenderPipelineId::Mesh, geometry, material, far);
+                    }
+                    rq.camera.packets.push_back({ key, a, i });
+                    rq.camera.triangles += surf.count / 3;
+                }
+            }
+
+            auto push_caster = [&](RenderQueue& q, uint32_t c) {
+                glm::vec4 clip = cascades.viewProj[c] * glm::vec4(center, 1.0f);
+                float depth = rq.frontToBack ? clip.z / clip.w : 0.0f;    // ZO clip, already 0..1
+                q.packets.push_back({
+                    make_sort_key(RenderPassId::Shadow, RenderPipelineId::Shadow, geometry, material, depth), a, i });
+                };
+
+            if (shadowCache.enabled && mesh.isStatic) {
+                // Only stale cache layers need static casters. Culled by the
+                // cascade alone — the layer outlives this frame's occluders
+                // and covers the fit margin the union view leaves out.
+                for (uint32_t c = 0; c < cascades.count; ++c)
+                    if (shadowCache.refreshStatic[c] && cull_is_visible(e->culling.cascades[c], flat))
+                        push_caster(rq.shadowStatic[c], c);
+            }
+            else if (cull_is_visible(e->culling.shadow, flat) && !draw_cache_owns(e, mesh, surf, true)) {
+                // The union view carries software occlusion; each cascade only
+                // gets the casters inside its own light frustum. Cascades the
+                // shadow cache leaves alone this frame get none.
+                for (uint32_t c = 0; c < cascades.count; ++c) {
+                    if (shadowCache.enabled && !shadowCache.due[c] && !shadowCache.refreshStatic[c]) continue;
+                    if (cull_is_visible(e->culling.cascades[c], flat))
+                        push_caster(rq.shadow[c], c);
+                }
+            }
+        }
+    }
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    radix_sort_packets(rq.camera.packets, rq.camera.scratch);
+    for (RenderQueue& q : rq.shadow)
+        radix_sort_packets(q.packets, q.scratch);
+    for (RenderQueue& q : rq.shadowStatic)
+        radix_sort_packets(q.packets, q.scratch);
+    radix_sort_packets(rq.depth.packets, rq.depth.scratch);
+    auto t2 = std::chrono::high_resolution_clock::now();
+    rq_build_batches(e);
+    auto t3 = std::chrono::high_resolution_clock::now();
+
+    rq.buildMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+    rq.sortMs = std::chrono::duration<float, std::milli>(t2 - t1).count();
+    rq.batchMs = std::chrono::duration<float, std::milli>(t3 - t2).count();
+}
+
+// ─── Submit ───────────────────────────────────────────────────────────────────
+static void rq_bind_geometry(VkCommandBuffer cmd, const MeshAsset& mesh)
+{
+    VkDeviceSize offset = 0;
+    vkCmdBindVertexBuffers(cmd, 0, 1, &mesh.meshBuffers.vertexBuffer.buffer, &offset);
+    vkCmdBindIndexBuffer(cmd, mesh.meshBuffers.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+}
+
+void submit_mesh_queue(Engine* e, VkCommandBuffer cmd, const RenderQueue& queue,
+    uint32_t begin, uint32_t end, RenderQueueStats& stats)
+{
+    if (begin >= end) return;
+
+    const RenderQueueState& rq = e->renderQueue;
+    const VkShaderStageFlags stages = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
+
+    // Model matrix, material block and per-frame lighting are pushed as three
+    // separate ranges so each only goes out when it actually changes
+    constexpr uint32_t modelOffset = offsetof(MeshPushConstants, modelMatrix);
+    constexpr uint32_t materialOffset = offsetof(MeshPushConstants, albedoIndex);
+    constexpr uint32_t frameOffset = offsetof(MeshPushConstants, sunDirection);
+
+    const bool instanced = !queue.batches.empty();
+
+    uint32_t lastPipeline = UINT32_MAX;
+    uint32_t lastAsset = UINT32_MAX;
+    VkBuffer lastBuffer = VK_NULL_HANDLE;
+    uint32_t lastMaterial = UINT32_MAX;
+
+    MeshPushConstants push{};
+    push.sunDirection = glm::normalize(e->sunDirection);
+    push.sunIntensity = e->sunIntensity;
+    push.sunColor = e->sunColor;
+    push.shadowMapIndex = e->shadowMapBindlessIndex;
+    push.shadowBias = e->shadowBias;
+    push.iblIrradianceIndex = e->iblIrradianceIndex;
+    push.iblPrefilterIndex = e->iblPrefilterIndex;
+    push.iblBrdfLutIndex = e->iblBrdfLutIndex;
+    push.instanceBuffer = instanced ? queue.instances : 0;
+
+    for (uint32_t i = begin; i < end; ++i) {
+        const DrawBatch   batch = instanced ? queue.batches[i] : DrawBatch{ i, 1, 0 };
+        const DrawPacket& p = queue.packets[batch.packet];
+        const MeshAsset&  mesh = *e->testMeshes[p.asset];
+        const GeoSurface& surf = mesh.surfaces[p.surface];
+
+        uint32_t pipeline = rq_pipeline(p.key);
+        if (pipeline != lastPipeline) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                render_pipeline(e, (RenderPipelineId)pipeline));
+            vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+                e->meshPipelineLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+            vkCmdPushConstants(cmd, e->meshPipelineLayout, stages, frameOffset,
+                sizeof(MeshPushConstants) - frameOffset, &push.sunDirection);
+            stats.pipelineBinds++;
+            stats.pushes++;
+            lastPipeline = pipeline;
+            lastAsset = lastMaterial = UINT32_MAX;
+            lastBuffer = VK_NULL_HANDLE;
+        }
+
+        if (mesh.meshBuffers.vertexBuffer.buffer != lastBuffer) {
+            rq_bind_geometry(cmd, mesh);
+            stats.bufferBinds++;
+            lastBuffer = mesh.meshBuffers.vertexBuffer.buffer;
+        }
+
+        // Batched draws read their matrices from the instance buffer
+        if (!instanced && p.asset != lastAsset) {
+            push.modelMatrix = mesh.worldTransform;
+            vkCmdPushConstants(cmd, e->meshPipelineLayout, stages, modelOffset,
+                sizeof(glm::mat4), &push.modelMatrix);
+            stats.pushes++;
+            lastAsset = p.asset;
+        }
+
+        uint32_t material = rq.surfaceMaterial[e->culling.scene.assetFirstSurface[p.asset] + p.surface];
+        if (material != lastMaterial) {
+            push.albedoIndex = surf.albedoIndex;
+            push.normalIndex = surf.normalIndex;
+            push.metalRoughIndex = surf.metallicRoughnessIndex;
+            push.aoIndex = surf.aoIndex;
+            push.emissiveIndex = surf.emissiveIndex;
+            push.metallicFactor = surf.metallicFactor;
+            push.roughnessFactor = surf.roughnessFactor;
+            push.normalStrength = 1.0f;
+            push.colorFactor = surf.colorFactor;
+            vkCmdPushConstants(cmd, e->meshPipelineLayout, stages, materialOffset,
+                frameOffset - materialOffset, &push.albedoIndex);
+            stats.pushes++;
+            lastMaterial = material;
+        }
+
+        vkCmdDrawIndexed(cmd, surf.count, batch.count, surf.startIndex, 0, batch.firstInstance);
+        stats.draws++;
+        stats.instances += batch.count;
+    }
+}
+
+void submit_shadow_queue(Engine* e, VkCommandBuffer cmd, const RenderQueue& queue, uint32_t cascade,
+    uint32_t begin, uint32_t end, RenderQueueStats& stats)
+{
+    if (begin >= end) return;
+
+    const bool      instanced = !queue.batches.empty();
+    VkDeviceAddress instances = instanced ? queue.instances : 0;
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, e->shadowPipeline);
+    vkCmdPushConstants(cmd, e->shadowPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+        offsetof(ShadowPushConstants, lightViewProj), sizeof(glm::mat4), &e->shadowCascades.viewProj[cascade]);
+    vkCmdPushConstants(cmd, e->shadowPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+        offsetof(ShadowPushConstants, instanceBuffer), sizeof(VkDeviceAddress), &instances);
+    stats.pipelineBinds++;
+    stats.pushes += 2;
+
+    uint32_t lastAsset = UINT32_MAX;
+    VkBuffer lastBuffer = VK_NULL_HANDLE;
+    for (uint32_t i = begin; i < end; ++i) {
+        const DrawBatch   batch = instanced ? queue.batches[i] : DrawBatch{ i, 1, 0 };
+        const DrawPacket& p = queue.packets[batch.packet];
+        const MeshAsset&  mesh = *e->testMeshes[p.asset];
+        const GeoSurface& surf = mesh.surfaces[p.surface];
+
+        if (mesh.meshBuffers.vertexBuffer.buffer != lastBuffer) {
+            rq_bind_geometry(cmd, mesh);
+            stats.bufferBinds++;
+            lastBuffer = mesh.meshBuffers.vertexBuffer.buffer;
+        }
+
+        if (!instanced && p.asset != lastAsset) {
+            vkCmdPushConstants(cmd, e->shadowPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+                offsetof(ShadowPushConstants, modelMatrix), sizeof(glm::mat4), &mesh.worldTransform);
+            stats.pushes++;
+            lastAsset = p.asset;
+        }
+
+        vkCmdDrawIndexed(cmd, surf.count, batch.count, surf.startIndex, 0, batch.firstInstance);
+        stats.draws++;
+        stats.instances += batch.count;
+    }
+}
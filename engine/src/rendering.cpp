@@ -3,41 +3,43 @@
 #include "imgui.h"
 #include <glm/ext/matrix_transform.hpp>
 #include <chrono>
+#include <cstdio>
 #include <glm/ext/matrix_clip_space.hpp>   // ← ADD THIS for glm::orthoZO
 
 void update_uniform_buffers(Engine* e)
 {
+    CPU_ZONE("update_uniform_buffers");
     FrameData& frame = get_current_frame(e);
     float aspect = (float)e->drawExtent.width / (float)e->drawExtent.height;
 
     // ── Camera ────────────────────────────────────────────────────────────────
     CameraData cam{};
     cam.view = e->mainCamera.getViewMatrix();
-    cam.projection = e->mainCamera.getProjectionMatrix(aspect);
+    cam.projection = e->mainCamera.getProjectionMatrix(aspect);   // jittered in TAA mode
     cam.projection[1][1] *= -1.0f;
     cam.viewProjection = cam.projection * cam.view;
-    cam.worldPosition = glm::vec4(e->mainCamera.position, 1.0f);
-
-    // ── Light matrix — MUST match push.sunDirection exactly ──────────────────
-    // Store on engine so draw_geometry and draw_shadow_pass both use same value
-    glm::vec3 sunDir = glm::normalize(glm::vec3(0.3f, 1.0f, 0.4f));
 
-    glm::mat4 lightView = glm::lookAt(
-        sunDir * 80.0f,          // sun position — far enough to cover whole scene
-        glm::vec3(0.0f),         // looking at scene centre
-        glm::vec3(0.0f, 1.0f, 0.0f)
-    );
-    glm::mat4 lightProj = glm::orthoZO(   // ← change THIS word only
-        -40.0f, 40.0f,
-        -40.0f, 40.0f,
-        1.0f, 300.0f
-    );
-    lightProj[1][1] *= -1.0f;    // Vulkan Y-flip — same as camera projection
+    // The frustum is symmetric, so the jitter is all there is in [2][0] / [2][1]
+    glm::mat4 unjittered = cam.projection;
+    unjittered[2][0] = unjittered[2][1] = 0.0f;
+    cam.unjitteredViewProj = unjittered * cam.view;
+    cam.prevViewProj = e->taa.prevViewProj;
+    e->taa.prevViewProj = cam.unjitteredViewProj;
+    e->cameraViewProj = cam.unjitteredViewProj;     // culling stays still under jitter
+    cam.worldPosition = glm::vec4(e->mainCamera.position, 1.0f);
 
-    e->lightViewProj = lightProj * lightView;
+    // ── Shadow cascades — fitted to this view along push.sunDirection ────────
+    update_shadow_cascades(e, cam.view, aspect);
+    const ShadowCascadeState& sc = e->shadowCascades;
 
-    // store on engine for shadow pass
-    cam.lightViewProj = e->lightViewProj;        // upload to UBO for PBR shader
+    cam.lightViewProj = e->lightViewProj;
+    for (uint32_t i = 0; i < MAX_SHADOW_CASCADES; ++i) {
+        cam.cascadeViewProj[i] = sc.viewProj[i];
+        cam.cascadeSplits[i] = sc.splitFar[i];
+        cam.cascadeTexel[i] = sc.texelWorld[i];
+    }
+    cam.cascadeParams = glm::vec4((float)sc.count, sc.blend, 0.0f, 0.0f);
+    write_cluster_camera_data(e, cam);
 
     memcpy(frame.cameraBuffer.info.pMappedData, &cam, sizeof(CameraData));
 
@@ -61,17 +63,29 @@ void update_uniform_buffers(Engine* e)
 
 void draw_geometry(Engine* e, VkCommandBuffer cmd)
 {
-    // Render geometry into 4x MSAA image, resolve into drawImage
-    // Background (compute) already wrote into drawImage; geometry resolves on top
-    VkRenderingAttachmentInfo colorAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
-    colorAttachment.imageView = e->msaaImage.imageView;
+    CPU_ZONE("draw_geometry");
+    // MSAA: render geometry into msaaImage, resolve into drawImage.
+    // TAA: single-sampled straight into drawImage, velocity as a second target.
+    const bool taa = e->taa.mode == AntiAliasing::Taa;
+    VkRenderingAttachmentInfo colorAttachments[2]{};
+    VkRenderingAttachmentInfo& colorAttachment = colorAttachments[0];
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
     colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
-    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;  // clear msaaImage each frame
-    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;  // clear each frame
     colorAttachment.clearValue = { {0.0f, 0.0f, 0.0f, 0.0f} };
-    colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
-    colorAttachment.resolveImageView = e->drawImage.imageView;
-    colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    if (taa) {
+        colorAttachment.imageView = e->drawImage.imageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+        colorAttachments[1] = colorAttachment;
+        colorAttachments[1].imageView = e->taa.velocity.imageView;
+    }
+    else {
+        colorAttachment.imageView = e->msaaImage.imageView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT;
+        colorAttachment.resolveImageView = e->drawImage.imageView;
+        colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    }
 
     VkRenderingAttachmentInfo depthAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
     depthAttachment.imageView = e->depthImage.imageView;
@@ -83,75 +97,84 @@ void draw_geometry(Engine* e, VkCommandBuffer cmd)
     VkRenderingInfo renderInfo{ .sType = VK_STRUCTURE_TYPE_RENDERING_INFO };
     renderInfo.renderArea = { {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
     renderInfo.layerCount = 1;
-    renderInfo.colorAttachmentCount = 1;
-    renderInfo.pColorAttachments = &colorAttachment;
+    renderInfo.colorAttachmentCount = taa ? 2 : 1;
+    renderInfo.pColorAttachments = colorAttachments;
     renderInfo.pDepthAttachment = &depthAttachment;
 
-    vkCmdBeginRendering(cmd, &renderInfo);
-    draw_skybox(e, cmd);
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, e->meshPipeline);
-    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
-        e->meshPipelineLayout, 0, 1, &e->bindlessSet, 0, nullptr);
-
-    VkViewport viewport{ 0, 0,
-        (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-
-    VkRect2D scissor{ {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
-
-    uint32_t drawCalls = 0;
-    uint32_t triangles = 0;
-
-    for (auto& asset : e->testMeshes) {
-        VkDeviceSize offset = 0;
-        vkCmdBindVertexBuffers(cmd, 0, 1, &asset->meshBuffers.vertexBuffer.buffer, &offset);
-        vkCmdBindIndexBuffer(cmd, asset->meshBuffers.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
-
-
-
-        for (auto& surface : asset->surfaces) {
-            MeshPushConstants push{};
-            push.modelMatrix = asset->worldTransform;
-            push.albedoIndex = surface.albedoIndex;
-            push.normalIndex = surface.normalIndex;
-            push.metalRoughIndex = surface.metallicRoughnessIndex;
-            push.aoIndex = surface.aoIndex;
-            push.emissiveIndex = surface.emissiveIndex;
-            push.metallicFactor = surface.metallicFactor;
-            push.roughnessFactor = surface.roughnessFactor;
-            push.normalStrength = 1.0f;
-            push.colorFactor = surface.colorFactor;
-            push.sunDirection = glm::normalize(e->sunDirection);
-            push.sunIntensity = e->sunIntensity;
-            push.sunColor = e->sunColor;
-            push.shadowMapIndex = e->shadowMapBindlessIndex;  // = 5
-            push.shadowBias = e->shadowBias;
-            push.iblIrradianceIndex = e->iblIrradianceIndex;
-            push.iblPrefilterIndex = e->iblPrefilterIndex;
-            push.iblBrdfLutIndex = e->iblBrdfLutIndex;
-
-            vkCmdPushConstants(cmd, e->meshPipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
-                0, sizeof(MeshPushConstants), &push);
-
-            vkCmdDrawIndexed(cmd, surface.count, 1, surface.startIndex, 0, 0);
-            drawCalls++;
-            triangles += surface.count / 3;
+    // Optional depth pre-pass — the colour pass then keeps its depth and
+    // shades opaque surfaces with an EQUAL test
+    if (e->depthPrepass.enabled) {
+        gpu_profiler_begin(e, cmd, "depth pre-pass");
+        draw_depth_prepass(e, cmd);
+        gpu_profiler_end(e, cmd);
+        depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    }
+    gpu_profiler_begin(e, cmd, "colour");
+
+    const RenderQueue& queue = e->renderQueue.camera;
+    RenderQueueStats&  stats = e->renderQueue.cameraStats;
+    stats = {};
+
+    auto set_viewport = [e](VkCommandBuffer c) {
+        VkViewport viewport{ 0, 0,
+            (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+        vkCmdSetViewport(c, 0, 1, &viewport);
+
+        VkRect2D scissor{ {0, 0}, {e->drawExtent.width, e->drawExtent.height} };
+        vkCmdSetScissor(c, 0, 1, &scissor);
+        };
+
+    uint32_t triangles = queue.triangles;
+
+    if (e->parallelRecord.enabled || e->drawCache.enabled) {
+        // Sky + packet ranges recorded as secondaries on the job system; the
+        // primary only executes them. Without parallel recording the dynamic
+        // packets go into a single secondary next to the cached one.
+        const uint32_t count = submit_count(queue);
+        const uint32_t batch = e->parallelRecord.enabled ? e->parallelRecord.batch : std::max(count, 1u);
+        std::vector<RenderQueueStats> rangeStats((count + batch - 1) / batch);
+
+        RecordTarget target = scene_record_target(e);
+        std::vector<VkCommandBuffer> secondaries;
+        record_secondaries(e, target, 1, 1,
+            [e](VkCommandBuffer c, uint32_t, uint32_t) { draw_skybox(e, c); }, secondaries);
+        if (e->drawCache.enabled) {
+            VkCommandBuffer cached = draw_cache_opaque(e, stats, triangles);
+            if (cached != VK_NULL_HANDLE) secondaries.push_back(cached);
         }
+        record_secondaries(e, target, count, batch,
+            [&](VkCommandBuffer c, uint32_t begin, uint32_t end) {
+                set_viewport(c);
+                submit_mesh_queue(e, c, queue, begin, end, rangeStats[begin / batch]);
+            }, secondaries);
+
+        renderInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        vkCmdBeginRendering(cmd, &renderInfo);
+        vkCmdExecuteCommands(cmd, (uint32_t)secondaries.size(), secondaries.data());
+
+        for (const RenderQueueStats& rs : rangeStats)
+            accumulate_stats(stats, rs);
+    }
+    else {
+        vkCmdBeginRendering(cmd, &renderInfo);
+        draw_skybox(e, cmd);
+        set_viewport(cmd);
+        submit_mesh_queue(e, cmd, queue, 0, submit_count(queue), stats);
     }
 
-    e->lastDrawCalls = drawCalls;
+    e->lastDrawCalls = stats.draws;
     e->lastTriangles = triangles;
 
 
     vkCmdEndRendering(cmd);
+    gpu_profiler_end(e, cmd);
 }
 
 void draw_background(VkCommandBuffer cmd, Engine* e)
 {
     ComputeEffect& effect = e->backgroundEffects[e->currentBackgroundEffect];
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, effect.pipeline);
+    VkPipeline pipeline = effect.pipeline != VK_NULL_HANDLE ? effect.pipeline : pipeline_variant_get(effect.variant);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
         e->gradientPipelineLayout, 0, 1, &e->bindlessSet, 0, nullptr);
     vkCmdPushConstants(cmd, e->gradientPipelineLayout,
@@ -164,7 +187,12 @@ void draw_background(VkCommandBuffer cmd, Engine* e)
 
 void draw_skybox(Engine* e, VkCommandBuffer cmd)
 {
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, e->skyboxPipeline);
+    // The visibility-buffer path draws the sky inside its shade pass
+    const bool taa = e->taa.mode == AntiAliasing::Taa;
+    VkPipeline pipeline = taa ? e->skyboxPipelineTaa : e->skyboxPipeline;
+    if (e->visibility.path == RenderPath::VisibilityBuffer)
+        pipeline = taa ? e->skyboxPipelineVisTaa : e->skyboxPipelineVis;
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
         e->skyboxPipelineLayout, 0, 1, &e->bindlessSet, 0, nullptr);
 
@@ -191,11 +219,15 @@ void draw_skybox(Engine* e, VkCommandBuffer cmd)
 
 void draw_imgui(VkCommandBuffer cmd, VkImageView targetImageView, Engine* e)
 {
-    ImGui_ImplVulkan_NewFrame();
-    ImGui_ImplGlfw_NewFrame();
-    ImGui::NewFrame();
-    debug_ui_render(e);
-    ImGui::Render();
+    CPU_ZONE("imgui");
+    {
+        CPU_ZONE("imgui build");
+        ImGui_ImplVulkan_NewFrame();
+        ImGui_ImplGlfw_NewFrame();
+        ImGui::NewFrame();
+        debug_ui_render(e);
+        ImGui::Render();
+    }
 
     VkRenderingAttachmentInfo colorAttachment = attachment_info(
         targetImageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
@@ -209,99 +241,226 @@ void draw_imgui(VkCommandBuffer cmd, VkImageView targetImageView, Engine* e)
 
 void engine_draw_frame(Engine* e)
 {
-    e->drawExtent.width = 3840;
-    e->drawExtent.height = 2160;
-  
+    telemetry_begin_frame(e);
+    CPU_PHASE(e, "engine_draw_frame");
+    const bool headless = e->headless.enabled;
 
     static auto lastTime = std::chrono::high_resolution_clock::now();
-    auto  now = std::chrono::high_resolution_clock::now();
-    e->deltaTime = std::chrono::duration<float>(now - lastTime).count();
-    lastTime = now;
-    e->skyTime += e->deltaTime;
+    if (headless) {
+        // No display to pace against, no input, no UI; time steps are fixed
+        e->deltaTime = e->headless.config.fixedDeltaTime;
+    }
+    else {
+        {
+            CPU_PHASE(e, "frame pacing");
+            frame_pacing_begin_frame(e);
+        }
 
-    debug_ui_update(e->deltaTime);
-    e->mainCamera.update(e->window);
+        auto  now = std::chrono::high_resolution_clock::now();
+        e->deltaTime = std::chrono::duration<float>(now - lastTime).count();
+        lastTime = now;
+
+        if (e->cameraPath.playing) {
+            e->deltaTime = e->cameraPath.step;
+        }
+        else {
+            CPU_PHASE(e, "input");
+            e->mainCamera.update(e->window);
+            camera_path_record_frame(e);
+        }
 
-    if (e->resize_requested) {
-        resize_swapchain(e);
-        if (e->resize_requested) return;
+        if (e->resize_requested) {
+            resize_swapchain(e);
+            if (e->resize_requested) return;
+        }
+        if (e->swapchain == VK_NULL_HANDLE || e->swapchainImages.empty()) return;
     }
-    if (e->swapchain == VK_NULL_HANDLE || e->swapchainImages.empty()) return;
+    e->skyTime += e->deltaTime;
 
     FrameData& frame = get_current_frame(e);
-    VK_CHECK(vkWaitForFences(e->device, 1, &frame.renderFence, VK_TRUE, UINT64_MAX));
-    VK_CHECK(vkResetFences(e->device, 1, &frame.renderFence));
+    {
+        CPU_PHASE(e, "wait for GPU");
+        frame_scheduler_begin_frame(e);
+    }
     VK_CHECK(vkResetCommandPool(e->device, frame.commandPool, 0));
+    gpu_profiler_begin_frame(e);         // first: the panels and dynamic resolution read its results
+    gpu_culling_begin_frame(e);
+    parallel_record_begin_frame(e);
+    dynamic_resolution_begin_frame(e);
+    taa_begin_frame(e);
+    visibility_buffer_begin_frame(e);
+    clustered_lighting_begin_frame(e);
+
+    uint32_t swapchainImageIndex = 0;
+    if (!headless) {
+        VkResult acquireResult;
+        {
+            CPU_PHASE(e, "acquire");
+            acquireResult = frame_scheduler_acquire(e, frame.swapchainSemaphore, &swapchainImageIndex);
+        }
 
-    uint32_t swapchainImageIndex;
-    VkResult acquireResult = vkAcquireNextImageKHR(
-        e->device, e->swapchain, UINT64_MAX,
-        frame.swapchainSemaphore, VK_NULL_HANDLE, &swapchainImageIndex);
-
-    if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR || acquireResult == VK_SUBOPTIMAL_KHR) {
-        e->resize_requested = true; return;
+        if (acquireResult == VK_ERROR_OUT_OF_DATE_KHR || acquireResult == VK_SUBOPTIMAL_KHR) {
+            e->resize_requested = true; return;
+        }
+        if (acquireResult != VK_SUCCESS) return;
     }
-    if (acquireResult != VK_SUCCESS) return;
 
+    const TelemetryClock::time_point recordStart = TelemetryClock::now();
     VkCommandBuffer cmd = frame.mainCommandBuffer;
     VK_CHECK(vkResetCommandBuffer(cmd, 0));
 
     VkCommandBufferBeginInfo beginInfo = command_buffer_info(VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT);
     VK_CHECK(vkBeginCommandBuffer(cmd, &beginInfo));
+    gpu_profiler_frame_begin(e, cmd);
 
     update_uniform_buffers(e);
+    run_frustum_culling(e);
+    run_software_occlusion(e);
+    shadow_cache_plan(e);
+    build_render_queues(e);
+    visibility_buffer_prepare(e);
+
+    // ── Frame graph ───────────────────────────────────────────────────────────
+    // The shadow map arrives in DEPTH_READ_ONLY from last frame's geometry; the
+    // swapchain image is available once the acquire semaphore's wait
+    // (COLOR_ATTACHMENT_OUTPUT) has passed. Headless, the offscreen target takes
+    // the swapchain image's place and leaves for the readback copy instead of
+    // present
+    const bool taa = e->taa.mode == AntiAliasing::Taa;
+    const bool vis = e->visibility.path == RenderPath::VisibilityBuffer;
+    render_graph_begin(e);
+    VkImage     swapImage = headless ? e->headless.target.image : e->swapchainImages[swapchainImageIndex];
+    VkImageView swapView = headless ? e->headless.target.imageView : e->swapchainImageViews[swapchainImageIndex];
+
+    // The target's last use was the previous frame's export barrier (ALL_TRANSFER)
+    GraphHandle swapchain = render_graph_import(e, "swapchain", swapImage, VK_IMAGE_ASPECT_COLOR_BIT,
+        VK_IMAGE_LAYOUT_UNDEFINED, headless ? VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT : VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
+    GraphHandle shadowMap = render_graph_import(e, "shadowMap", e->shadowMapImage.image, VK_IMAGE_ASPECT_DEPTH_BIT,
+        VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+    GraphHandle draw = render_graph_transient(e, &e->drawImage);
+    render_graph_export(e, swapchain, headless ? GraphUsage::TransferSrc : GraphUsage::Present);
+
+    // Per-cascade copies and clears are tracked inside the shadow pass itself
+    uint32_t shadow = render_graph_add_pass(e, "shadow", [e](VkCommandBuffer cmd) {
+        draw_shadow_pass(e, cmd);
+        });
+    render_graph_external(e, shadow, shadowMap, GraphUsage::DepthSampled);
+
+    // Fills the light grid every shading pass reads — buffers only
+    uint32_t lightCulling = render_graph_add_pass(e, "light culling", [e](VkCommandBuffer cmd) {
+        draw_cluster_light_culling(e, cmd);
+        });
+    render_graph_side_effects(e, lightCulling);
+
+    // The pass that fills drawImage (and velocity under TAA)
+    uint32_t geometry;
+    if (vis) {
+        VisibilityBufferState& v = e->visibility;
+        GraphHandle ids = render_graph_transient(e, &v.ids);
+        GraphHandle visDepth = render_graph_transient(e, &v.depth);
+
+        uint32_t visibility = render_graph_add_pass(e, "visibility", [e](VkCommandBuffer cmd) {
+            draw_visibility_ids(e, cmd);
+            });
+        render_graph_write(e, visibility, ids, GraphUsage::ColorAttachment);
+        render_graph_write(e, visibility, visDepth, GraphUsage::DepthAttachment);
+
+        // Its outputs are buffers the graph doesn't track
+        uint32_t binning = render_graph_add_pass(e, "material binning", [e](VkCommandBuffer cmd) {
+            draw_visibility_binning(e, cmd);
+            });
+        render_graph_read(e, binning, ids, GraphUsage::SampledCompute);
+        render_graph_side_effects(e, binning);
+
+        geometry = render_graph_add_pass(e, "material shade", [e](VkCommandBuffer cmd) {
+            draw_visibility_shade(e, cmd);
+            });
+        render_graph_read(e, geometry, ids, GraphUsage::SampledFragment);
+        render_graph_read(e, geometry, visDepth, GraphUsage::DepthAttachment);
+    }
+    else {
+        GraphHandle depth = render_graph_transient(e, &e->depthImage);
+        geometry = render_graph_add_pass(e, "geometry", [e](VkCommandBuffer cmd) {
+            if (e->gpuCulling.enabled) draw_geometry_gpu_culled(e, cmd);
+            else                       draw_geometry(e, cmd);
+            });
+        render_graph_write(e, geometry, depth, GraphUsage::DepthAttachment);
+    }
+    render_graph_read(e, geometry, shadowMap, GraphUsage::DepthSampled);
+    render_graph_write(e, geometry, draw, GraphUsage::ColorAttachment);    // MSAA resolve, or the TAA input
+
+    GraphHandle upscaleInput = draw;
+    uint32_t    upscaleSource = e->dynamicRes.sourceBindlessIndex;
+    if (taa) {
+        // History ping-pongs between two persistent images: last frame's is
+        // read in SHADER_READ_ONLY, this frame's is overwritten
+        TaaState&   t = e->taa;
+        GraphHandle velocity = render_graph_transient(e, &t.velocity);
+        GraphHandle historyPrev = render_graph_import(e, "history.prev", t.history[t.current ^ 1].image,
+            VK_IMAGE_ASPECT_COLOR_BIT, t.historyValid ? VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+        GraphHandle history = render_graph_import(e, "history", t.history[t.current].image,
+            VK_IMAGE_ASPECT_COLOR_BIT, VK_IMAGE_LAYOUT_UNDEFINED, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
+        render_graph_export(e, history, GraphUsage::SampledFragment);
+        render_graph_write(e, geometry, velocity, GraphUsage::ColorAttachment);
+
+        uint32_t resolve = render_graph_add_pass(e, "taa resolve", [e](VkCommandBuffer cmd) {
+            draw_taa_resolve(e, cmd);
+            });
+        render_graph_read(e, resolve, draw, GraphUsage::SampledFragment);
+        render_graph_read(e, resolve, velocity, GraphUsage::SampledFragment);
+        render_graph_read(e, resolve, historyPrev, GraphUsage::SampledFragment);
+        render_graph_write(e, resolve, history, GraphUsage::ColorAttachment);
+
+        upscaleInput = history;
+        upscaleSource = t.historyBindlessIndex[t.current];
+    }
+    else if (!vis) {
+        GraphHandle msaa = render_graph_transient(e, &e->msaaImage);
+        render_graph_write(e, geometry, msaa, GraphUsage::ColorAttachment);
+    }
 
-    draw_shadow_pass(e, cmd);
-
-    transition_image(cmd, e->drawImage.image, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-    transition_image(cmd, e->msaaImage.image,
-        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    VkImageMemoryBarrier2 depthBarrier{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-    depthBarrier.image = e->depthImage.image;
-    depthBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL_KHR;
-    depthBarrier.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-    depthBarrier.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
-    depthBarrier.srcAccessMask = 0;
-    depthBarrier.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT
-        | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    depthBarrier.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
-
-    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-    dep.imageMemoryBarrierCount = 1;
-    dep.pImageMemoryBarriers = &depthBarrier;
-    vkCmdPipelineBarrier2(cmd, &dep);
-
-    draw_geometry(e, cmd);
-
-    transition_image(cmd, e->drawImage.image,
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
-    transition_image(cmd, e->swapchainImages[swapchainImageIndex],
-        VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL);
-
-    copy_image_to_image(cmd,
-        e->drawImage.image, e->swapchainImages[swapchainImageIndex],
-        e->drawImage.imageExtent, e->swapchainExtent);
-
-    transition_image(cmd, e->swapchainImages[swapchainImageIndex],
-        VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-    draw_imgui(cmd, e->swapchainImageViews[swapchainImageIndex], e);
+    uint32_t upscale = render_graph_add_pass(e, "upscale", [e, swapView, upscaleSource](VkCommandBuffer cmd) {
+        draw_upscale(e, cmd, swapView, upscaleSource);
+        });
+    render_graph_read(e, upscale, upscaleInput, GraphUsage::SampledFragment);
+    render_graph_write(e, upscale, swapchain, GraphUsage::ColorAttachment);
+
+    if (!headless) {
+        uint32_t imgui = render_graph_add_pass(e, "imgui", [e, swapView](VkCommandBuffer cmd) {
+            draw_imgui(cmd, swapView, e);
+            });
+        render_graph_modify(e, imgui, swapchain, GraphUsage::ColorAttachment);
+    }
 
-    transition_image(cmd, e->swapchainImages[swapchainImageIndex],
-        VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
+    render_graph_execute(e, cmd);
+    if (headless) headless_record_readback(e, cmd);
+    gpu_profiler_frame_end(e, cmd);
 
     VK_CHECK(vkEndCommandBuffer(cmd));
+    telemetry_cpu(e, "record", std::chrono::duration<float, std::milli>(TelemetryClock::now() - recordStart).count());
 
     VkCommandBufferSubmitInfo cmdInfo = command_buffer_submit_info(cmd);
     VkSemaphoreSubmitInfo     waitInfo = semaphore_submit_info(
         VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT, frame.swapchainSemaphore);
-    VkSemaphoreSubmitInfo     signalInfo = semaphore_submit_info(
-        VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, frame.renderSemaphore);
-
-    VkSubmitInfo2 submitInfo = submit_info(&cmdInfo, &signalInfo, &waitInfo);
-    VK_CHECK(vkQueueSubmit2(e->graphicsQueue, 1, &submitInfo, frame.renderFence));
+    // Binary for present, timeline for the next frame that reuses this slot.
+    // Headless there's no acquire to wait on and no present to signal
+    VkSemaphoreSubmitInfo     signalInfos[] = {
+        semaphore_submit_info(VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT, frame.renderSemaphore),
+        frame_scheduler_signal(e, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT),
+    };
+    e->scheduler.slotValue[e->frameNumber % FRAME_OVERLAP] = signalInfos[1].value;
+
+    VkSubmitInfo2 submitInfo = headless
+        ? submit_info(&cmdInfo, &signalInfos[1], nullptr)
+        : submit_info(&cmdInfo, signalInfos, &waitInfo);
+    if (!headless) submitInfo.signalSemaphoreInfoCount = 2;
+    VK_CHECK(vkQueueSubmit2(e->graphicsQueue, 1, &submitInfo, VK_NULL_HANDLE));
+
+    if (headless) {
+        e->frameNumber++;
+        return;
+    }
 
     VkPresentInfoKHR presentInfo{};
     presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
@@ -310,16 +469,17 @@ void engine_draw_frame(Engine* e)
     presentInfo.swapchainCount = 1;
     presentInfo.pSwapchains = &e->swapchain;
     presentInfo.pImageIndices = &swapchainImageIndex;
+    frame_pacing_present(e, presentInfo);
 
-    VkResult presentResult = vkQueuePresentKHR(e->graphicsQueue, &presentInfo);
+    VkResult presentResult;
+    {
+        CPU_PHASE(e, "present");
+        presentResult = vkQueuePresentKHR(e->graphicsQueue, &presentInfo);
+    }
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR)
         e->resize_requested = true;
 
     e->frameNumber++;
-    printf("drawExtent: %ux%u | MSAA: %d | Shadow: 4096\n",
-        e->drawExtent.width,
-        e->drawExtent.height,
-        (int)e->msaaSamples);
 }
 
 VkRenderingAttachmentInfo attachment_info(VkImageView view, VkClearValue* clear, VkImageLayout layout)
@@ -334,73 +494,115 @@ VkRenderingAttachmentInfo attachment_info(VkImageView view, VkClearValue* clear,
     return info;
 }
 
-void draw_shadow_pass(Engine* e, VkCommandBuffer cmd)
+// One cascade = one layer of shadowMapImage (or of the shadow cache), rendered
+// as its own pass
+void draw_shadow_layer(Engine* e, VkCommandBuffer cmd, VkImageView target, const RenderQueue& queue,
+    uint32_t cascade, VkAttachmentLoadOp loadOp, bool withDrawCache, RenderQueueStats& stats)
 {
-    // ── Transition shadow map to depth write ──────────────────────────────────
-    VkImageMemoryBarrier2 toWrite{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
-    toWrite.image = e->shadowMapImage.image;
-    toWrite.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    toWrite.newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
-    toWrite.srcStageMask = VK_PIPELINE_STAGE_2_NONE;
-    toWrite.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
-    toWrite.srcAccessMask = 0;
-    toWrite.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
-    toWrite.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+    const VkExtent3D size = e->shadowMapImage.imageExtent;
 
-    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
-    dep.imageMemoryBarrierCount = 1;
-    dep.pImageMemoryBarriers = &toWrite;
-    vkCmdPipelineBarrier2(cmd, &dep);
-
-    // ── Begin depth-only rendering ────────────────────────────────────────────
     VkRenderingAttachmentInfo depthAttachment{};
     depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO;
-    depthAttachment.imageView = e->shadowMapImage.imageView;
+    depthAttachment.imageView = target;
     depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
-    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.loadOp = loadOp;
     depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
     depthAttachment.clearValue.depthStencil.depth = 1.0f;
 
     VkRenderingInfo renderInfo{};
     renderInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO;
-    renderInfo.renderArea = { {0,0}, {2048, 2048} };
+    renderInfo.renderArea = { {0,0}, {size.width, size.height} };
     renderInfo.layerCount = 1;
     renderInfo.colorAttachmentCount = 0;              // no colour
     renderInfo.pColorAttachments = nullptr;
     renderInfo.pDepthAttachment = &depthAttachment;
 
-    vkCmdBeginRendering(cmd, &renderInfo);
-    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, e->shadowPipeline);
+    // Whole layer — the cascade fit already spends every texel
+    auto set_viewport = [size](VkCommandBuffer c) {
+        VkViewport viewport{ 0, 0, (float)size.width, (float)size.height, 0.0f, 1.0f };
+        vkCmdSetViewport(c, 0, 1, &viewport);
+        VkRect2D scissor{ {0,0}, {size.width, size.height} };
+        vkCmdSetScissor(c, 0, 1, &scissor);
+        };
 
-    // Shadow map viewport — fixed 2048x2048
-    VkViewport viewport{ 0, 0, 2048, 2048, 0.0f, 1.0f };
-    vkCmdSetViewport(cmd, 0, 1, &viewport);
-    VkRect2D scissor{ {0,0}, {2048, 2048} };
-    vkCmdSetScissor(cmd, 0, 1, &scissor);
-
-    // ── Draw all meshes from sun's POV ────────────────────────────────────────
+    // ── Draw this cascade's casters from the sun's POV ────────────────────────
     // NO descriptor set bind — shadowPipelineLayout has no sets
-    for (auto& asset : e->testMeshes) {
-        VkDeviceSize offset = 0;
-        vkCmdBindVertexBuffers(cmd, 0, 1,
-            &asset->meshBuffers.vertexBuffer.buffer, &offset);
-        vkCmdBindIndexBuffer(cmd, asset->meshBuffers.indexBuffer.buffer,
-            0, VK_INDEX_TYPE_UINT32);
-
-        for (auto& surface : asset->surfaces) {
-            ShadowPushConstants push{};
-            push.lightViewProj = e->lightViewProj;
-            push.modelMatrix = asset->worldTransform;
-
-            vkCmdPushConstants(cmd, e->shadowPipelineLayout,
-                VK_SHADER_STAGE_VERTEX_BIT,
-                0, sizeof(ShadowPushConstants), &push);
-
-            vkCmdDrawIndexed(cmd, surface.count, 1, surface.startIndex, 0, 0);
+    const uint32_t count = submit_count(queue);
+    withDrawCache = withDrawCache && e->drawCache.enabled;
+
+    if ((e->parallelRecord.enabled && count > 0) || withDrawCache) {
+        const uint32_t batch = e->parallelRecord.enabled ? e->parallelRecord.batch : std::max(count, 1u);
+        std::vector<RenderQueueStats> rangeStats((count + batch - 1) / batch);
+
+        RecordTarget target{ {}, e->shadowMapImage.imageFormat, VK_SAMPLE_COUNT_1_BIT };
+        std::vector<VkCommandBuffer> secondaries;
+        if (withDrawCache) {
+            VkCommandBuffer cached = draw_cache_shadow(e, cascade, stats);
+            if (cached != VK_NULL_HANDLE) secondaries.push_back(cached);
         }
+        record_secondaries(e, target, count, batch,
+            [&](VkCommandBuffer c, uint32_t begin, uint32_t end) {
+                set_viewport(c);
+                submit_shadow_queue(e, c, queue, cascade, begin, end, rangeStats[begin / batch]);
+            }, secondaries);
+
+        renderInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT;
+        vkCmdBeginRendering(cmd, &renderInfo);
+        if (!secondaries.empty())
+            vkCmdExecuteCommands(cmd, (uint32_t)secondaries.size(), secondaries.data());
+
+        for (const RenderQueueStats& rs : rangeStats)
+            accumulate_stats(stats, rs);
+    }
+    else {
+        vkCmdBeginRendering(cmd, &renderInfo);
+        set_viewport(cmd);
+        submit_shadow_queue(e, cmd, queue, cascade, 0, count, stats);
     }
 
     vkCmdEndRendering(cmd);
+}
+
+void draw_shadow_pass(Engine* e, VkCommandBuffer cmd)
+{
+    if (e->shadowCache.enabled) {
+        draw_cached_shadow_pass(e, cmd);
+        return;
+    }
+
+    const VkImageSubresourceRange layers = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, MAX_SHADOW_CASCADES };
+
+    // ── Transition every cascade layer to depth write ─────────────────────────
+    VkImageMemoryBarrier2 toWrite{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    toWrite.image = e->shadowMapImage.image;
+    toWrite.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toWrite.newLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    toWrite.srcStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;   // last frame's lighting reads
+    toWrite.dstStageMask = VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT;
+    toWrite.srcAccessMask = 0;
+    toWrite.dstAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    toWrite.subresourceRange = layers;
+
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.imageMemoryBarrierCount = 1;
+    dep.pImageMemoryBarriers = &toWrite;
+    vkCmdPipelineBarrier2(cmd, &dep);
+
+    RenderQueueStats& total = e->renderQueue.shadowStats;
+    total = {};
+    for (uint32_t c = 0; c < e->shadowCascades.count; ++c) {
+        RenderQueueStats& stats = e->renderQueue.cascadeStats[c];
+        stats = {};
+        char scope[16];
+        std::snprintf(scope, sizeof(scope), "cascade %u", c);
+        gpu_profiler_begin(e, cmd, scope);
+        draw_shadow_layer(e, cmd, e->shadowCascades.layerViews[c], e->renderQueue.shadow[c], c,
+            VK_ATTACHMENT_LOAD_OP_CLEAR, true, stats);
+        gpu_profiler_end(e, cmd);
+        accumulate_stats(total, stats);
+    }
+    for (uint32_t c = e->shadowCascades.count; c < MAX_SHADOW_CASCADES; ++c)
+        e->renderQueue.cascadeStats[c] = {};
 
     // ── Transition to shader read for PBR pass ────────────────────────────────
     VkImageMemoryBarrier2 toRead{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
@@ -411,10 +613,16 @@ void draw_shadow_pass(Engine* e, VkCommandBuffer cmd)
     toRead.dstStageMask = VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT;
     toRead.srcAccessMask = VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
     toRead.dstAccessMask = VK_ACCESS_2_SHADER_READ_BIT;
-    toRead.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1 };
+    toRead.subresourceRange = layers;
 
     VkDependencyInfo dep2{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
     dep2.imageMemoryBarrierCount = 1;
     dep2.pImageMemoryBarriers = &toRead;
     vkCmdPipelineBarrier2(cmd, &dep2);
+
+    // Every layer was overwritten, so none of them matches the cache any more
+    for (uint32_t c = 0; c < MAX_SHADOW_CASCADES; ++c) {
+        e->shadowCache.mapLayout[c] = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+        e->shadowCache.mapIsCache[c] = false;
+    }
 }
@@ -0,0 +1,112 @@
+#include "shader_bundle.h"
+#include "types.h"
+
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// ─── Mapping ──────────────────────────────────────────────────────────────────
+static bool map_file(ShaderBundle& bundle, const char* path)
+{
+#ifdef _WIN32
+    HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+
+    LARGE_INTEGER size{};
+    GetFileSizeEx(file, &size);
+    HANDLE mapping = size.QuadPart > 0
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    CloseHandle(file);                 // the mapping keeps the file open
+    if (!mapping) return false;
+
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        CloseHandle(mapping);
+        return false;
+    }
+    bundle.data = (const std::byte*)view;
+    bundle.size = (size_t)size.QuadPart;
+    bundle.mapping = mapping;
+#else
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) return false;
+
+    struct stat st{};
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return false;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);                         // the mapping keeps the file open
+    if (view == MAP_FAILED) return false;
+
+    bundle.data = (const std::byte*)view;
+    bundle.size = (size_t)st.st_size;
+#endif
+    return true;
+}
+
+void shader_bundle_close(ShaderBundle& bundle)
+{
+    if (bundle.data) {
+#ifdef _WIN32
+        UnmapViewOfFile(bundle.data);
+        CloseHandle((HANDLE)bundle.mapping);
+#else
+        munmap((void*)bundle.data, bundle.size);
+#endif
+    }
+    bundle = ShaderBundle{};
+}
+
+// ─── Open ─────────────────────────────────────────────────────────────────────
+bool shader_bundle_open(ShaderBundle& bundle, const char* path)
+{
+    shader_bundle_close(bundle);
+    if (!map_file(bundle, path)) return false;
+
+    auto reject = [&](const char* why) {
+        LOG_ERROR("Shader bundle " << path << ": " << why << " — using loose .spv files");
+        shader_bundle_close(bundle);
+        return false;
+    };
+
+    ShaderBundleHeader header;
+    if (bundle.size < sizeof(header)) return reject("truncated header");
+    std::memcpy(&header, bundle.data, sizeof(header));
+    if (std::memcmp(header.magic, SHADER_BUNDLE_MAGIC, 4) != 0) return reject("bad magic");
+    if (header.version != SHADER_BUNDLE_VERSION) return reject("version mismatch");
+    if (header.totalSize != bundle.size) return reject("size mismatch");
+    if (sizeof(header) + (size_t)header.count * sizeof(ShaderBundleEntry) > bundle.size)
+        return reject("truncated entry table");
+
+    const auto* table = (const ShaderBundleEntry*)(bundle.data + sizeof(header));
+    bundle.entries.reserve(header.count);
+    for (uint32_t i = 0; i < header.count; ++i) {
+        const ShaderBundleEntry& entry = table[i];
+        if (entry.name[SHADER_BUNDLE_NAME_SIZE - 1] != '\0') return reject("unterminated name");
+        if (entry.offset % 4 != 0 || entry.size % 4 != 0 ||
+            (size_t)entry.offset + entry.size > bundle.size)
+            return reject("entry out of bounds");
+
+        bundle.entries.emplace(entry.name, std::span<const uint32_t>(
+            (const uint32_t*)(bundle.data + entry.offset), entry.size / 4));
+    }
+
+    LOG("Shader bundle: " << header.count << " shaders, " << bundle.size / 1024 << " KB mapped");
+    return true;
+}
+
+std::span<const uint32_t> shader_bundle_find(const ShaderBundle& bundle, const char* name)
+{
+    auto it = bundle.entries.find(name);
+    return it != bundle.entries.end() ? it->second : std::span<const uint32_t>{};
+}
@@ -0,0 +1,212 @@
+#include "shadow_cache.h"
+#include "engine.h"
+
+#include <algorithm>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_shadow_cache(Engine* e)
+{
+    ShadowCacheState& cache = e->shadowCache;
+    cache.cacheImage.imageFormat = e->shadowMapImage.imageFormat;
+    cache.cacheImage.imageExtent = e->shadowMapImage.imageExtent;
+
+    // Rendered into, then only ever copied out of
+    VkImageCreateInfo imgInfo = image_create_info(cache.cacheImage.imageFormat,
+        VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+        cache.cacheImage.imageExtent);
+    imgInfo.arrayLayers = MAX_SHADOW_CASCADES;
+
+    VmaAllocationCreateInfo allocInfo{};
+    allocInfo.usage = VMA_MEMORY_USAGE_GPU_ONLY;
+    allocInfo.requiredFlags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+
+    VK_CHECK(vmaCreateImage(e->allocator, &imgInfo, &allocInfo,
+        &cache.cacheImage.image, &cache.cacheImage.allocation, nullptr));
+
+    for (uint32_t i = 0; i < MAX_SHADOW_CASCADES; ++i) {
+        VkImageViewCreateInfo viewInfo = imageview_create_info(cache.cacheImage.imageFormat,
+            cache.cacheImage.image, VK_IMAGE_ASPECT_DEPTH_BIT);
+        viewInfo.subresourceRange.baseArrayLayer = i;
+        VK_CHECK(vkCreateImageView(e->device, &viewInfo, nullptr, &cache.layerViews[i]));
+
+        cache.mapLayout[i] = VK_IMAGE_LAYOUT_UNDEFINED;
+        cache.cacheViewProj[i] = glm::mat4(1.0f);
+    }
+
+    e->mainDeletionQueue.push_function([=]() {
+        for (VkImageView view : e->shadowCache.layerViews)
+            vkDestroyImageView(e->device, view, nullptr);
+        destroy_image(e->shadowCache.cacheImage, e);
+        });
+
+    LOG("Shadow cache created " << cache.cacheImage.imageExtent.width << "x"
+        << cache.cacheImage.imageExtent.height << "x" << MAX_SHADOW_CASCADES);
+}
+
+// ─── Schedule ─────────────────────────────────────────────────────────────────
+bool shadow_cache_due(const Engine* e, uint32_t cascade)
+{
+    const ShadowCacheState& cache = e->shadowCache;
+    if (!cache.enabled || !cache.stagger) return true;
+
+    // Offset by the cascade index so the far cascades don't all land together
+    const uint32_t period = 1u << std::min(cascade, 3u);
+    return ((uint32_t)e->frameNumber + cascade) % period == 0;
+}
+
+void shadow_cache_plan(Engine* e)
+{
+    ShadowCacheState&         cache = e->shadowCache;
+    const ShadowCascadeState& sc = e->shadowCascades;
+    const uint64_t            version = e->drawCache.sceneVersion;
+
+    for (uint32_t c = 0; c < MAX_SHADOW_CASCADES; ++c) {
+        const bool active = cache.enabled && c < sc.count;
+        cache.due[c] = active && shadow_cache_due(e, c);
+        cache.refreshStatic[c] = active
+            && (cache.cacheVersion[c] != version || cache.cacheViewProj[c] != sc.viewProj[c]);
+    }
+}
+
+// ─── Recording ────────────────────────────────────────────────────────────────
+static VkImageMemoryBarrier2 layer_barrier(VkImage image, uint32_t layer,
+    VkImageLayout from, VkImageLayout to,
+    VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+    VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    VkImageMemoryBarrier2 b{ .sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2 };
+    b.image = image;
+    b.oldLayout = from;
+    b.newLayout = to;
+    b.srcStageMask = srcStage;
+    b.srcAccessMask = srcAccess;
+    b.dstStageMask = dstStage;
+    b.dstAccessMask = dstAccess;
+    b.subresourceRange = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, layer, 1 };
+    return b;
+}
+
+static void flush_barriers(VkCommandBuffer cmd, std::vector<VkImageMemoryBarrier2>& barriers)
+{
+    if (barriers.empty()) return;
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.imageMemoryBarrierCount = (uint32_t)barriers.size();
+    dep.pImageMemoryBarriers = barriers.data();
+    vkCmdPipelineBarrier2(cmd, &dep);
+    barriers.clear();
+}
+
+constexpr VkPipelineStageFlags2 DEPTH_TESTS =
+    VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT;
+
+void draw_cached_shadow_pass(Engine* e, VkCommandBuffer cmd)
+{
+    ShadowCacheState&   cache = e->shadowCache;
+    ShadowCascadeState& sc = e->shadowCascades;
+    RenderQueueState&   rq = e->renderQueue;
+    const VkImage       map = e->shadowMapImage.image;
+    const VkImage       cached = cache.cacheImage.image;
+
+    bool copy[MAX_SHADOW_CASCADES] = {};
+    bool dynamic[MAX_SHADOW_CASCADES] = {};
+    for (uint32_t c = 0; c < sc.count; ++c) {
+        dynamic[c] = !rq.shadow[c].packets.empty();
+        copy[c] = cache.refreshStatic[c] || (cache.due[c] && (dynamic[c] || !cache.mapIsCache[c]));
+        rq.cascadeStats[c] = {};
+    }
+    for (uint32_t c = sc.count; c < MAX_SHADOW_CASCADES; ++c)
+        rq.cascadeStats[c] = {};
+
+    std::vector<VkImageMemoryBarrier2> barriers;
+
+    // ── A: re-render stale cache layers ───────────────────────────────────────
+    // Cleared, so the old contents can be discarded; the only earlier access
+    // is a previous frame's copy out of the layer
+    for (uint32_t c = 0; c < sc.count; ++c)
+        if (cache.refreshStatic[c])
+            barriers.push_back(layer_barrier(cached, c, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_2_COPY_BIT, 0,
+                DEPTH_TESTS, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT));
+    flush_barriers(cmd, barriers);
+
+    for (uint32_t c = 0; c < sc.count; ++c) {
+        if (!cache.refreshStatic[c]) continue;
+        draw_shadow_layer(e, cmd, cache.layerViews[c], rq.shadowStatic[c], c,
+            VK_ATTACHMENT_LOAD_OP_CLEAR, false, rq.cascadeStats[c]);
+
+        cache.cacheViewProj[c] = sc.viewProj[c];
+        cache.cacheVersion[c] = e->drawCache.sceneVersion;
+        barriers.push_back(layer_barrier(cached, c, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_READ_BIT));
+    }
+
+    // ── B: copy cache layers into the shadow map ──────────────────────────────
+    // Overwritten whole, so the old contents can be discarded; wait for the
+    // previous frame's lighting pass to stop sampling them
+    for (uint32_t c = 0; c < sc.count; ++c)
+        if (copy[c])
+            barriers.push_back(layer_barrier(map, c, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, 0,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT));
+    flush_barriers(cmd, barriers);
+
+    const VkExtent3D size = e->shadowMapImage.imageExtent;
+    for (uint32_t c = 0; c < sc.count; ++c) {
+        if (!copy[c]) continue;
+
+        VkImageCopy region{};
+        region.srcSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, c, 1 };
+        region.dstSubresource = { VK_IMAGE_ASPECT_DEPTH_BIT, 0, c, 1 };
+        region.extent = size;
+        vkCmdCopyImage(cmd, cached, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+            map, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+
+        if (dynamic[c])
+            barriers.push_back(layer_barrier(map, c, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                DEPTH_TESTS, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT));
+        else
+            barriers.push_back(layer_barrier(map, c, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+                VK_PIPELINE_STAGE_2_COPY_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+                VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT));
+    }
+    flush_barriers(cmd, barriers);
+
+    // ── C: dynamic casters over the copy ──────────────────────────────────────
+    for (uint32_t c = 0; c < sc.count; ++c) {
+        if (!copy[c] || !dynamic[c]) continue;
+        draw_shadow_layer(e, cmd, sc.layerViews[c], rq.shadow[c], c,
+            VK_ATTACHMENT_LOAD_OP_LOAD, false, rq.cascadeStats[c]);
+        barriers.push_back(layer_barrier(map, c, VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT));
+    }
+
+    // Layers that have never been written (first frame, inactive cascades)
+    // still need a layout the array view can be sampled in
+    for (uint32_t c = 0; c < MAX_SHADOW_CASCADES; ++c) {
+        if ((c < sc.count && copy[c]) || cache.mapLayout[c] == VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL) continue;
+        barriers.push_back(layer_barrier(map, c, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL,
+            VK_PIPELINE_STAGE_2_NONE, 0,
+            VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT));
+    }
+    flush_barriers(cmd, barriers);
+
+    // ── Bookkeeping ───────────────────────────────────────────────────────────
+    rq.shadowStats = {};
+    for (uint32_t c = 0; c < MAX_SHADOW_CASCADES; ++c) {
+        cache.mapLayout[c] = VK_IMAGE_LAYOUT_DEPTH_READ_ONLY_OPTIMAL;
+        if (c >= sc.count) {
+            cache.mapIsCache[c] = false;
+            continue;
+        }
+        accumulate_stats(rq.shadowStats, rq.cascadeStats[c]);
+
+        if (copy[c]) cache.mapIsCache[c] = !dynamic[c];
+        cache.result[c] = cache.refreshStatic[c] ? ShadowCacheResult::Refreshed
+            : copy[c] ? ShadowCacheResult::Copied : ShadowCacheResult::Reused;
+        if (cache.refreshStatic[c]) cache.misses++;
+        else                        cache.hits++;
+    }
+}
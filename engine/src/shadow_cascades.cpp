@@ -0,0 +1,161 @@
+#include "shadow_cascades.h"
+#include "shadow_cache.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <glm/ext/matrix_clip_space.hpp>
+#include <glm/ext/matrix_transform.hpp>
+
+static_assert(sizeof(CameraData::cascadeViewProj) == MAX_SHADOW_CASCADES * sizeof(glm::mat4),
+    "CameraData must carry one matrix per cascade");
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_shadow_cascades(Engine* e)
+{
+    ShadowCascadeState& sc = e->shadowCascades;
+    for (glm::mat4& m : sc.viewProj) m = glm::mat4(1.0f);
+}
+
+// ─── Fitting ──────────────────────────────────────────────────────────────────
+// Bounding sphere of the view-frustum slice between view depths nearZ and farZ.
+// It only depends on the slice's shape, so turning the camera never resizes it.
+static void slice_sphere(const glm::mat4& invView, float tanHalfY, float aspect,
+    float nearZ, float farZ, glm::vec3& center, float& radius)
+{
+    glm::vec3 corners[8];
+    uint32_t  n = 0;
+    for (float d : { nearZ, farZ }) {
+        const float y = d * tanHalfY;
+        const float x = y * aspect;
+        for (float sx : { -1.0f, 1.0f })
+            for (float sy : { -1.0f, 1.0f })
+                corners[n++] = glm::vec3(invView * glm::vec4(sx * x, sy * y, -d, 1.0f));
+    }
+
+    center = glm::vec3(0.0f);
+    for (const glm::vec3& c : corners) center += c;
+    center /= 8.0f;
+
+    radius = 0.0f;
+    for (const glm::vec3& c : corners) radius = std::max(radius, glm::length(c - center));
+    // Quantised so float noise can't change the extent from frame to frame
+    radius = std::ceil(radius * 16.0f) / 16.0f;
+}
+
+// Light-space box around a sphere, centre snapped to the texel grid. Light
+// space looks down -z; the depth range reaches from the scene's nearest to its
+// farthest point along the light, so every caster of the slice is inside.
+static ShadowCascadeFit fit_light_box(const glm::vec3& centerLS, float sphere, float radius,
+    float sceneMinZ, float sceneMaxZ, float resolution)
+{
+    const float texel = 2.0f * radius / resolution;
+
+    ShadowCascadeFit f;
+    f.center = glm::floor(glm::vec2(centerLS) / texel) * texel;
+    f.radius = radius;
+    f.zNear = -std::max(sceneMaxZ, centerLS.z + radius) - 1.0f;
+    f.zFar = -std::min(sceneMinZ, centerLS.z - radius) + 1.0f;
+    f.sphere = sphere;
+    return f;
+}
+
+static glm::mat4 light_box_matrix(const glm::mat4& lightView, const ShadowCascadeFit& f)
+{
+    glm::mat4 proj = glm::orthoZO(f.center.x - f.radius, f.center.x + f.radius,
+        f.center.y - f.radius, f.center.y + f.radius, f.zNear, f.zFar);
+    proj[1][1] *= -1.0f;    // Vulkan Y-flip — same as camera projection
+    return proj * lightView;
+}
+
+static bool light_box_covers(const ShadowCascadeFit& f, const glm::vec3& centerLS, float radius)
+{
+    const glm::vec2 d = glm::abs(glm::vec2(centerLS) - f.center);
+    return std::max(d.x, d.y) + radius <= f.radius
+        && -centerLS.z - radius >= f.zNear && -centerLS.z + radius <= f.zFar;
+}
+
+void update_shadow_cascades(Engine* e, const glm::mat4& view, float aspect)
+{
+    ShadowCascadeState& sc = e->shadowCascades;
+    sc.count = std::clamp(sc.count, 1u, MAX_SHADOW_CASCADES);
+
+    // Rotation only — translation would move the snapping grid with the light
+    const glm::vec3 toSun = glm::normalize(e->sunDirection);
+    const glm::vec3 up = std::fabs(toSun.y) > 0.99f ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+    const glm::mat4 lightView = glm::lookAt(glm::vec3(0.0f), -toSun, up);
+
+    // ── Scene depth range along the light
+    const CullScene& s = e->culling.scene;
+    float sceneMinZ = -1.0f, sceneMaxZ = 1.0f;
+    if (s.count > 0) {
+        sceneMinZ = FLT_MAX;
+        sceneMaxZ = -FLT_MAX;
+        for (uint32_t i = 0; i < 8; ++i) {
+            glm::vec3 corner((i & 1) ? s.worldMax.x : s.worldMin.x,
+                             (i & 2) ? s.worldMax.y : s.worldMin.y,
+                             (i & 4) ? s.worldMax.z : s.worldMin.z);
+            float z = (lightView * glm::vec4(corner, 1.0f)).z;
+            sceneMinZ = std::min(sceneMinZ, z);
+            sceneMaxZ = std::max(sceneMaxZ, z);
+        }
+    }
+
+    // A new light direction or scene bounds invalidates every sticky fit
+    const bool sticky = e->shadowCache.enabled;
+    const bool refitAll = !sticky || toSun != sc.fitToSun || e->drawCache.sceneVersion != sc.fitVersion;
+    sc.fitToSun = toSun;
+    sc.fitVersion = e->drawCache.sceneVersion;
+    const float pad = sticky ? 1.0f + e->shadowCache.margin : 1.0f;
+
+    // ── Practical split scheme
+    const float     nearZ = 0.05f;     // Camera::getProjectionMatrix default
+    const float     farZ = std::max(sc.distance, nearZ + 1.0f);
+    const float     tanHalfY = std::tan(glm::radians(e->mainCamera.fov) * 0.5f);
+    const glm::mat4 invView = glm::inverse(view);
+    const float     resolution = (float)e->shadowMapImage.imageExtent.width;
+
+    float sliceNear = nearZ;
+    for (uint32_t i = 0; i < sc.count; ++i) {
+        const float p = (float)(i + 1) / (float)sc.count;
+        const float logSplit = nearZ * std::pow(farZ / nearZ, p);
+        const float uniformSplit = nearZ + (farZ - nearZ) * p;
+        const float split = glm::mix(uniformSplit, logSplit, sc.lambda);
+
+        glm::vec3 center;
+        float     radius;
+        slice_sphere(invView, tanHalfY, aspect, sliceNear, split, center, radius);
+        const glm::vec3 centerLS = glm::vec3(lightView * glm::vec4(center, 1.0f));
+
+        // Off-schedule cascades hold their box even if the slice has drifted
+        // out of it; the margin hides the few frames until their turn
+        const ShadowCascadeFit& old = sc.fit[i];
+        const bool keep = !refitAll && old.sphere == radius
+            && (light_box_covers(old, centerLS, radius) || !shadow_cache_due(e, i));
+        if (!keep) {
+            const float padded = std::ceil(radius * pad * 16.0f) / 16.0f;
+            sc.fit[i] = fit_light_box(centerLS, radius, padded, sceneMinZ, sceneMaxZ, resolution);
+            sc.viewProj[i] = light_box_matrix(lightView, sc.fit[i]);
+            sc.texelWorld[i] = 2.0f * padded / resolution;
+        }
+        sc.changed[i] = !keep;
+        sc.splitFar[i] = split;
+        sliceNear = split;
+    }
+    for (uint32_t i = sc.count; i < MAX_SHADOW_CASCADES; ++i) {
+        sc.viewProj[i] = sc.viewProj[sc.count - 1];
+        sc.splitFar[i] = sc.splitFar[sc.count - 1];
+        sc.texelWorld[i] = sc.texelWorld[sc.count - 1];
+        sc.fit[i] = {};          // refit if it comes back
+        sc.changed[i] = false;
+    }
+
+    // ── One frustum around every cascade's receivers
+    glm::vec3 center;
+    float     radius;
+    slice_sphere(invView, tanHalfY, aspect, nearZ, farZ, center, radius);
+    const glm::vec3 centerLS = glm::vec3(lightView * glm::vec4(center, 1.0f));
+    e->lightViewProj = light_box_matrix(lightView,
+        fit_light_box(centerLS, radius, radius, sceneMinZ, sceneMaxZ, resolution));
+}
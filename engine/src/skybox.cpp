@@ -6,17 +6,8 @@ void init_skybox_pipelines(Engine* e)
 
 
 
-    VkShaderModule skyboxVertShader;
-    if (!e->util.load_shader_module("shaders/skybox.vert.spv", e->device, &skyboxVertShader)) {
-        LOG_ERROR("Failed to load vertex shader");
-        std::exit(1);
-    }
-
-    VkShaderModule skyboxFragShader;
-    if (!e->util.load_shader_module("shaders/skybox_cloud.frag.spv", e->device, &skyboxFragShader)) {
-        LOG_ERROR("Failed to load fragment shader");
-        std::exit(1);
-    }
+    VkShaderModule skyboxVertShader = pipeline_service_shader(e, "shaders/skybox.vert.spv");
+    VkShaderModule skyboxFragShader = pipeline_service_shader(e, "shaders/skybox_cloud.frag.spv");
 
     VkPushConstantRange pushRange{};
     pushRange.offset = 0;
@@ -47,21 +38,24 @@ void init_skybox_pipelines(Engine* e)
     pb.pipelineLayout = e->skyboxPipelineLayout;
     pb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 
-    e->skyboxPipeline = build_pipeline(e->device, pb);
-    if (e->skyboxPipeline == VK_NULL_HANDLE) {
-        LOG_ERROR("Failed to create skybox pipeline");
-        std::exit(1);
-    }
-
+    pipeline_service_build(e, pipeline_service_request(e, pb, "skybox"), &e->skyboxPipeline);
 
+    // TAA mode: single-sampled, velocity in a second colour attachment
+    set_multisampling_none(pb);
+    set_color_attachment_formats({ e->drawImage.imageFormat, TAA_VELOCITY_FORMAT }, pb);
+    pipeline_service_build(e, pipeline_service_request(e, pb, "TAA skybox"), &e->skyboxPipelineTaa);
 
-    vkDestroyShaderModule(e->device, skyboxVertShader, nullptr);
-    vkDestroyShaderModule(e->device, skyboxFragShader, nullptr);
+    // Visibility-buffer shade pass: depth-tested against the visibility depth,
+    // so the sky is only shaded where no surface was drawn
+    enable_depthtest(pb, VK_COMPARE_OP_LESS_OR_EQUAL);
+    pb.depthStencil.depthWriteEnable = VK_FALSE;
+    pipeline_service_build(e, pipeline_service_request(e, pb, "TAA visibility skybox"), &e->skyboxPipelineVisTaa);
+    set_color_attachment_format(e->drawImage.imageFormat, pb);
+    pipeline_service_build(e, pipeline_service_request(e, pb, "visibility skybox"), &e->skyboxPipelineVis);
 
     e->mainDeletionQueue.push_function([=]() {
         vkDestroyPipelineLayout(e->device, e->skyboxPipelineLayout, nullptr);
-        vkDestroyPipeline(e->device, e->skyboxPipeline, nullptr);
         });
 
-    LOG("Skybox pipeline created");
+    LOG("Skybox pipelines requested");
 }
\ No newline at end of file
@@ -0,0 +1,398 @@
+#include "software_occlusion.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <chrono>
+#include <limits>
+
+// Same compile-time kernel choice as culling.cpp: 8 pixels per step with AVX2,
+// 4 with SSE2, one at a time otherwise.
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define SWOC_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define SWOC_SSE2 1
+#endif
+
+static constexpr float SWOC_CLEAR = std::numeric_limits<float>::max();
+static constexpr float SWOC_MIN_W = 1e-3f;   // anything this close to the eye is "visible"
+
+// ─── Triangle setup ───────────────────────────────────────────────────────────
+// Edge functions E(x, y) = A x + B y + C, oriented so the inside is >= 0 for
+// either winding, and z as a plane over screen space.
+struct SwocTri {
+    float ea[3], eb[3], ec[3];
+    float za, zb, zc;
+    int   minX, maxX, minY, maxY;
+    bool  valid;
+};
+
+static void swoc_setup_tri(const glm::vec4 clip[3], uint32_t width, uint32_t height, SwocTri& t)
+{
+    t.valid = false;
+    // Triangles reaching behind the eye are dropped, not clipped — fewer
+    // occluders is always safe
+    for (int k = 0; k < 3; ++k)
+        if (clip[k].w <= SWOC_MIN_W) return;
+
+    float x[3], y[3], z[3];
+    for (int k = 0; k < 3; ++k) {
+        float invW = 1.0f / clip[k].w;
+        x[k] = (clip[k].x * invW * 0.5f + 0.5f) * (float)width;
+        y[k] = (clip[k].y * invW * 0.5f + 0.5f) * (float)height;
+        z[k] = clip[k].z * invW;
+    }
+
+    float minX = std::min({ x[0], x[1], x[2] }), maxX = std::max({ x[0], x[1], x[2] });
+    float minY = std::min({ y[0], y[1], y[2] }), maxY = std::max({ y[0], y[1], y[2] });
+    t.minX = (int)std::floor(std::clamp(minX, 0.0f, (float)width));
+    t.maxX = (int)std::ceil(std::clamp(maxX, -1.0f, (float)width - 1.0f));
+    t.minY = (int)std::floor(std::clamp(minY, 0.0f, (float)height));
+    t.maxY = (int)std::ceil(std::clamp(maxY, -1.0f, (float)height - 1.0f));
+    if (t.minX > t.maxX || t.minY > t.maxY) return;
+
+    // Edge k is opposite vertex k
+    for (int k = 0; k < 3; ++k) {
+        int a = (k + 1) % 3, b = (k + 2) % 3;
+        t.ea[k] = y[a] - y[b];
+        t.eb[k] = x[b] - x[a];
+        t.ec[k] = x[a] * y[b] - x[b] * y[a];
+    }
+
+    float area = t.ea[0] * x[0] + t.eb[0] * y[0] + t.ec[0];
+    if (std::fabs(area) < 1e-6f) return;
+    if (area < 0.0f) {
+        for (int k = 0; k < 3; ++k) { t.ea[k] = -t.ea[k]; t.eb[k] = -t.eb[k]; t.ec[k] = -t.ec[k]; }
+        area = -area;
+    }
+
+    // z = sum(E_k * z_k) / area, expanded into plane coefficients
+    float invArea = 1.0f / area;
+    t.za = (t.ea[0] * z[0] + t.ea[1] * z[1] + t.ea[2] * z[2]) * invArea;
+    t.zb = (t.eb[0] * z[0] + t.eb[1] * z[1] + t.eb[2] * z[2]) * invArea;
+    t.zc = (t.ec[0] * z[0] + t.ec[1] * z[1] + t.ec[2] * z[2]) * invArea;
+    t.valid = true;
+}
+
+// ─── Span kernels ─────────────────────────────────────────────────────────────
+// Rasterizes pixel centres [x0, x1) of one row. x0 is lane-aligned and the row
+// width is a multiple of the lane count, so loads never leave the row; lanes
+// outside the triangle are masked off by the edge test.
+#if defined(SWOC_AVX2)
+static void swoc_span(float* row, int x0, int x1, float py, const SwocTri& t)
+{
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256 step = _mm256_set1_ps(8.0f);
+    __m256 px = _mm256_add_ps(_mm256_set1_ps((float)x0 + 0.5f),
+        _mm256_setr_ps(0, 1, 2, 3, 4, 5, 6, 7));
+
+    __m256 a[3], c[3];
+    for (int k = 0; k < 3; ++k) {
+        a[k] = _mm256_set1_ps(t.ea[k]);
+        c[k] = _mm256_set1_ps(t.eb[k] * py + t.ec[k]);
+    }
+    const __m256 za = _mm256_set1_ps(t.za);
+    const __m256 zc = _mm256_set1_ps(t.zb * py + t.zc);
+
+    for (int x = x0; x < x1; x += 8) {
+        __m256 inside = _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a[0], px), c[0]), zero, _CMP_GE_OQ);
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a[1], px), c[1]), zero, _CMP_GE_OQ));
+        inside = _mm256_and_ps(inside, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(a[2], px), c[2]), zero, _CMP_GE_OQ));
+
+        if (_mm256_movemask_ps(inside)) {
+            __m256 z = _mm256_add_ps(_mm256_mul_ps(za, px), zc);
+            __m256 old = _mm256_loadu_ps(row + x);
+            _mm256_storeu_ps(row + x, _mm256_blendv_ps(old, _mm256_min_ps(old, z), inside));
+        }
+        px = _mm256_add_ps(px, step);
+    }
+}
+
+static constexpr int SWOC_LANES = 8;
+const char* swoc_simd_name() { return "AVX2"; }
+
+#elif defined(SWOC_SSE2)
+static void swoc_span(float* row, int x0, int x1, float py, const SwocTri& t)
+{
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 step = _mm_set1_ps(4.0f);
+    __m128 px = _mm_add_ps(_mm_set1_ps((float)x0 + 0.5f), _mm_setr_ps(0, 1, 2, 3));
+
+    __m128 a[3], c[3];
+    for (int k = 0; k < 3; ++k) {
+        a[k] = _mm_set1_ps(t.ea[k]);
+        c[k] = _mm_set1_ps(t.eb[k] * py + t.ec[k]);
+    }
+    const __m128 za = _mm_set1_ps(t.za);
+    const __m128 zc = _mm_set1_ps(t.zb * py + t.zc);
+
+    for (int x = x0; x < x1; x += 4) {
+        __m128 inside = _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[0], px), c[0]), zero);
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[1], px), c[1]), zero));
+        inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(_mm_mul_ps(a[2], px), c[2]), zero));
+
+        if (_mm_movemask_ps(inside)) {
+            __m128 z = _mm_add_ps(_mm_mul_ps(za, px), zc);
+            __m128 old = _mm_loadu_ps(row + x);
+            __m128 nearer = _mm_min_ps(old, z);
+            _mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+        }
+        px = _mm_add_ps(px, step);
+    }
+}
+
+static constexpr int SWOC_LANES = 4;
+const char* swoc_simd_name() { return "SSE2"; }
+
+#else
+static void swoc_span(float* row, int x0, int x1, float py, const SwocTri& t)
+{
+    for (int x = x0; x < x1; ++x) {
+        float px = (float)x + 0.5f;
+        bool inside = true;
+        for (int k = 0; k < 3; ++k)
+            inside = inside && (t.ea[k] * px + t.eb[k] * py + t.ec[k] >= 0.0f);
+        if (inside)
+            row[x] = std::min(row[x], t.za * px + t.zb * py + t.zc);
+    }
+}
+
+static constexpr int SWOC_LANES = 1;
+const char* swoc_simd_name() { return "scalar"; }
+#endif
+
+// ─── Projection helpers ───────────────────────────────────────────────────────
+struct SwocRect {
+    int   x0, y0, x1, y1;    // inclusive pixel range, clamped to the raster
+    float nearestZ;
+    bool  crossesEye;        // a corner sits behind the near limit
+};
+
+static SwocRect swoc_project_box(const glm::mat4& vp, const glm::vec3& c, const glm::vec3& h,
+    uint32_t width, uint32_t height)
+{
+    SwocRect r{};
+    float minX = SWOC_CLEAR, minY = SWOC_CLEAR, maxX = -SWOC_CLEAR, maxY = -SWOC_CLEAR;
+    r.nearestZ = SWOC_CLEAR;
+
+    for (int i = 0; i < 8; ++i) {
+        glm::vec3 p = c + glm::vec3((i & 1) ? h.x : -h.x, (i & 2) ? h.y : -h.y, (i & 4) ? h.z : -h.z);
+        glm::vec4 clip = vp * glm::vec4(p, 1.0f);
+        if (clip.w <= SWOC_MIN_W) { r.crossesEye = true; return r; }
+
+        float invW = 1.0f / clip.w;
+        float sx = (clip.x * invW * 0.5f + 0.5f) * (float)width;
+        float sy = (clip.y * invW * 0.5f + 0.5f) * (float)height;
+        minX = std::min(minX, sx); maxX = std::max(maxX, sx);
+        minY = std::min(minY, sy); maxY = std::max(maxY, sy);
+        r.nearestZ = std::min(r.nearestZ, clip.z * invW);
+    }
+
+    // Clamp in float first — near-eye corners project to huge coordinates
+    r.x0 = (int)std::floor(std::clamp(minX, 0.0f, (float)width));
+    r.y0 = (int)std::floor(std::clamp(minY, 0.0f, (float)height));
+    r.x1 = (int)std::floor(std::clamp(maxX, -1.0f, (float)width - 1.0f));
+    r.y1 = (int)std::floor(std::clamp(maxY, -1.0f, (float)height - 1.0f));
+    return r;
+}
+
+// Visible unless every pixel under the box already holds something nearer
+static bool swoc_box_visible(const DepthRaster& d, const SwocRect& r)
+{
+    if (r.crossesEye || r.x0 > r.x1 || r.y0 > r.y1) return true;
+
+    const int tx0 = r.x0 / SWOC_TILE, tx1 = r.x1 / SWOC_TILE;
+    const int ty0 = r.y0 / SWOC_TILE, ty1 = r.y1 / SWOC_TILE;
+
+    for (int ty = ty0; ty <= ty1; ++ty) {
+        for (int tx = tx0; tx <= tx1; ++tx) {
+            if (r.nearestZ > d.tileMax[ty * d.tilesX + tx]) continue;   // whole tile hides it
+
+            int px0 = std::max(r.x0, tx * (int)SWOC_TILE), px1 = std::min(r.x1, tx * (int)SWOC_TILE + (int)SWOC_TILE - 1);
+            int py0 = std::max(r.y0, ty * (int)SWOC_TILE), py1 = std::min(r.y1, ty * (int)SWOC_TILE + (int)SWOC_TILE - 1);
+            for (int y = py0; y <= py1; ++y) {
+                const float* row = &d.depth[(size_t)y * d.width];
+                for (int x = px0; x <= px1; ++x)
+                    if (r.nearestZ <= row[x]) return true;
+            }
+        }
+    }
+    return false;
+}
+
+static inline glm::vec3 swoc_center(const CullScene& s, uint32_t i) { return { s.aabbCX[i], s.aabbCY[i], s.aabbCZ[i] }; }
+static inline glm::vec3 swoc_extent(const CullScene& s, uint32_t i) { return { s.aabbEX[i], s.aabbEY[i], s.aabbEZ[i] }; }
+
+// ─── Occluder set ─────────────────────────────────────────────────────────────
+void build_occluder_set(Engine* e)
+{
+    SoftwareOcclusionState& so = e->swOcclusion;
+    const CullScene& s = e->culling.scene;
+
+    so.candidates.clear();
+    for (uint32_t a = 0; a < (uint32_t)e->testMeshes.size(); ++a) {
+        const MeshAsset& mesh = *e->testMeshes[a];
+        for (uint32_t i = 0; i < (uint32_t)mesh.surfaces.size(); ++i)
+            if (mesh.surfaces[i].occluderIndexCount > 0)
+                so.candidates.push_back({ s.assetFirstSurface[a] + i, a, i });
+    }
+
+    // Largest first, so the per-frame pick can stop at maxOccluders
+    std::sort(so.candidates.begin(), so.candidates.end(),
+        [&](const OccluderCandidate& l, const OccluderCandidate& r) {
+            return s.sphereR[l.flatIndex] > s.sphereR[r.flatIndex];
+        });
+    so.builtSurfaces = s.count;
+
+    LOG("Occluder candidates: " << so.candidates.size() << " of " << s.count
+        << " surfaces (" << swoc_simd_name() << ")");
+}
+
+// ─── Per-view raster + test ───────────────────────────────────────────────────
+static void swoc_dispatch(Engine* e, uint32_t count, uint32_t batch, const JobRangeFn& fn)
+{
+    if (e->jobs && count > batch)
+        jobs_parallel_for(*e->jobs, count, batch, fn);
+    else
+        fn(0, count, 0);
+}
+
+static void swoc_rasterize_view(Engine* e, const glm::mat4& vp, const CullView& view,
+    uint32_t width, uint32_t height, OcclusionView& out)
+{
+    SoftwareOcclusionState& so = e->swOcclusion;
+    const CullScene& s = e->culling.scene;
+    DepthRaster& d = out.raster;
+
+    if (d.width != width || d.height != height) {
+        d.width = width;
+        d.height = height;
+        d.tilesX = width / SWOC_TILE;
+        d.tilesY = height / SWOC_TILE;
+        d.depth.resize((size_t)width * height);
+        d.tileMax.resize((size_t)d.tilesX * d.tilesY);
+    }
+
+    // ── Pick occluders: frustum-visible and big enough on screen
+    std::vector<const OccluderCandidate*> picked;
+    const float minArea = so.minOccluderArea * (float)(width * height);
+    for (const OccluderCandidate& c : so.candidates) {
+        if (picked.size() >= so.maxOccluders) break;
+        if (!cull_is_visible(view, c.flatIndex)) continue;
+
+        SwocRect r = swoc_project_box(vp, swoc_center(s, c.flatIndex), swoc_extent(s, c.flatIndex), width, height);
+        float area = r.crossesEye ? SWOC_CLEAR
+            : (float)std::max(0, r.x1 - r.x0 + 1) * (float)std::max(0, r.y1 - r.y0 + 1);
+        if (area >= minArea) picked.push_back(&c);
+    }
+
+    std::vector<uint32_t> firstTri(picked.size() + 1, 0);
+    for (size_t i = 0; i < picked.size(); ++i) {
+        const MeshAsset& mesh = *e->testMeshes[picked[i]->asset];
+        firstTri[i + 1] = firstTri[i] + mesh.surfaces[picked[i]->surface].occluderIndexCount / 3;
+    }
+
+    // ── Setup, one job per occluder
+    std::vector<SwocTri> tris(firstTri.back());
+    swoc_dispatch(e, (uint32_t)picked.size(), 4, [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            const MeshAsset& mesh = *e->testMeshes[picked[i]->asset];
+            const GeoSurface& surf = mesh.surfaces[picked[i]->surface];
+            const glm::mat4 mvp = vp * mesh.worldTransform;
+
+            for (uint32_t t = 0; t < surf.occluderIndexCount / 3; ++t) {
+                glm::vec4 clip[3];
+                for (int k = 0; k < 3; ++k)
+                    clip[k] = mvp * glm::vec4(mesh.occluderPositions[mesh.occluderIndices[surf.occluderFirstIndex + t * 3 + k]], 1.0f);
+                swoc_setup_tri(clip, width, height, tris[firstTri[i] + t]);
+            }
+        }
+        });
+
+    // ── Raster, one job per band of rows; each band finishes its own tiles
+    const uint32_t bands = (height + SWOC_BAND_ROWS - 1) / SWOC_BAND_ROWS;
+    swoc_dispatch(e, bands, 1, [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t b = begin; b < end; ++b) {
+            const int y0 = (int)(b * SWOC_BAND_ROWS);
+            const int y1 = std::min((int)height, y0 + (int)SWOC_BAND_ROWS);
+            std::fill(d.depth.begin() + (size_t)y0 * width, d.depth.begin() + (size_t)y1 * width, SWOC_CLEAR);
+
+            for (const SwocTri& t : tris) {
+                if (!t.valid || t.maxY < y0 || t.minY >= y1) continue;
+                const int x0 = t.minX / SWOC_LANES * SWOC_LANES;
+                const int x1 = std::min((int)width, t.maxX + 1);
+                for (int y = std::max(y0, t.minY); y <= std::min(y1 - 1, t.maxY); ++y)
+                    swoc_span(&d.depth[(size_t)y * width], x0, x1, (float)y + 0.5f, t);
+            }
+
+            for (int ty = y0 / (int)SWOC_TILE; ty < y1 / (int)SWOC_TILE; ++ty) {
+                for (uint32_t tx = 0; tx < d.tilesX; ++tx) {
+                    float farthest = -SWOC_CLEAR;
+                    for (uint32_t y = ty * SWOC_TILE; y < (ty + 1) * SWOC_TILE; ++y) {
+                        const float* row = &d.depth[(size_t)y * width + tx * SWOC_TILE];
+                        for (uint32_t x = 0; x < SWOC_TILE; ++x)
+                            farthest = std::max(farthest, row[x]);
+                    }
+                    d.tileMax[ty * d.tilesX + tx] = farthest;
+                }
+            }
+        }
+        });
+
+    out.occluders = (uint32_t)picked.size();
+    out.triangles = 0;
+    for (const SwocTri& t : tris) out.triangles += t.valid ? 1 : 0;
+}
+
+static void swoc_test_view(Engine* e, const glm::mat4& vp, OcclusionView& occ, CullView& view)
+{
+    const CullScene& s = e->culling.scene;
+    uint8_t* visible = view.visible.data();
+
+    swoc_dispatch(e, s.count, 256, [&](uint32_t begin, uint32_t end, uint32_t) {
+        for (uint32_t i = begin; i < end; ++i) {
+            if (!visible[i]) continue;
+            SwocRect r = swoc_project_box(vp, swoc_center(s, i), swoc_extent(s, i),
+                occ.raster.width, occ.raster.height);
+            if (!swoc_box_visible(occ.raster, r)) visible[i] = 0;
+        }
+        });
+
+    uint32_t count = 0;
+    for (uint32_t i = 0; i < s.count; ++i)
+        count += visible[i];
+    occ.culled = view.visibleCount - count;
+    view.visibleCount = count;
+}
+
+void run_software_occlusion(Engine* e)
+{
+    CPU_ZONE("run_software_occlusion");
+    SoftwareOcclusionState& so = e->swOcclusion;
+    CullingState& c = e->culling;
+
+    so.camera.culled = so.shadow.culled = 0;
+    if (!so.enabled) { so.rasterMs = so.testMs = 0.0f; return; }
+
+    if (so.builtSurfaces != c.scene.count)
+        build_occluder_set(e);
+
+    // The colour pass already has GPU occlusion when that path is on
+    const bool doCamera = !e->gpuCulling.enabled;
+    const bool doShadow = so.shadowView;
+
+    auto t0 = std::chrono::high_resolution_clock::now();
+    if (doCamera)
+        swoc_rasterize_view(e, e->cameraViewProj, c.camera, SWOC_WIDTH, SWOC_HEIGHT, so.camera);
+    if (doShadow)
+        swoc_rasterize_view(e, e->lightViewProj, c.shadow, SWOC_SHADOW_SIZE, SWOC_SHADOW_SIZE, so.shadow);
+
+    auto t1 = std::chrono::high_resolution_clock::now();
+    if (doCamera) swoc_test_view(e, e->cameraViewProj, so.camera, c.camera);
+    if (doShadow) swoc_test_view(e, e->lightViewProj, so.shadow, c.shadow);
+    auto t2 = std::chrono::high_resolution_clock::now();
+
+    so.rasterMs = std::chrono::duration<float, std::milli>(t1 - t0).count();
+    so.testMs = std::chrono::duration<float, std::milli>(t2 - t1).count();
+}
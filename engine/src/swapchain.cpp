@@ -36,18 +36,26 @@ static void build_swapchain(Engine* e, uint32_t width, uint32_t height) {
     width  = std::clamp(width,  caps.minImageExtent.width,  caps.maxImageExtent.width);
     height = std::clamp(height, caps.minImageExtent.height, caps.maxImageExtent.height);
 
+    // Offer the debug UI only what the surface can do; FIFO always is
+    FramePacingState& fp = e->framePacing;
+    uint32_t modeCount = 0;
+    VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(e->physicalDevice, e->surface, &modeCount, nullptr));
+    fp.supportedModes.resize(modeCount);
+    VK_CHECK(vkGetPhysicalDeviceSurfacePresentModesKHR(e->physicalDevice, e->surface, &modeCount, fp.supportedModes.data()));
+
     auto vkbSwapchain = vkb::SwapchainBuilder{ e->physicalDevice, e->device, e->surface }
         .set_desired_format(VkSurfaceFormatKHR{
             .format     = VK_FORMAT_B8G8R8A8_UNORM,
             .colorSpace = VK_COLOR_SPACE_SRGB_NONLINEAR_KHR })
-        .set_desired_present_mode(VK_PRESENT_MODE_FIFO_KHR)
+        .set_desired_present_mode(fp.presentMode)
+        .add_fallback_present_mode(VK_PRESENT_MODE_FIFO_KHR)
         .set_desired_extent(width, height)
         .add_image_usage_flags(VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT |
                                VK_IMAGE_USAGE_TRANSFER_DST_BIT)
         .build();
 
     if (!vkbSwapchain) {
-        std::printf("❌ Failed to build swapchain\n");
+        LOG_CAT(Vulkan, Error, "Failed to build swapchain");
         std::exit(1);
     }
 
@@ -56,6 +64,7 @@ static void build_swapchain(Engine* e, uint32_t width, uint32_t height) {
     e->swapchainImageViews  = vkbSwapchain->get_image_views().value();
     e->swapchainImageFormat = vkbSwapchain->image_format;
     e->swapchainExtent      = vkbSwapchain->extent; // authoritative pixel size on ALL platforms
+    fp.activePresentMode    = vkbSwapchain->present_mode;
 
     VkSemaphoreCreateInfo semInfo{ .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO };
     e->imageAvailableSemaphores.resize(e->swapchainImages.size());
@@ -75,8 +84,8 @@ static void build_swapchain(Engine* e, uint32_t width, uint32_t height) {
                                     + e->memoryStats.imageMemoryBytes
                                     + e->memoryStats.bufferMemoryBytes;
 
-    std::printf("✅ Swapchain %ux%u (%zu images)\n",
-        e->swapchainExtent.width, e->swapchainExtent.height, e->swapchainImages.size());
+    LOG_CAT(Vulkan, Info, "✅ Swapchain " << e->swapchainExtent.width << "x" << e->swapchainExtent.height
+        << " (" << e->swapchainImages.size() << " images, " << present_mode_name(fp.activePresentMode) << ")");
 }
 
 // ─── Init (first time) ───────────────────────────────────────────────────────
@@ -107,20 +116,14 @@ void resize_swapchain(Engine* e) {
     destroy_swapchain(e);
     build_swapchain(e, oldW, oldH);
 
-    // 2. DON'T resize these to the swapchain extent if you want 4K!
-    // If you destroy and recreate them based on e->swapchainExtent (2560),
-    // but your draw loop still uses 3840, you will crash.
-
-    // Check if we actually need to recreate 4K buffers. 
-    // Usually, you only do this if you actually want to change internal resolution.
-    if (e->drawExtent.width != 3840 || e->drawExtent.height != 2160) {
+    // 2. DON'T resize the draw targets to the swapchain extent — they stay 4K.
+    // Dynamic resolution renders into a drawExtent sub-rect of them and the
+    // upscale pass scales that to whatever size the swapchain has.
+    if (e->drawImage.imageExtent.width != 3840 || e->drawImage.imageExtent.height != 2160) {
         destroy_draw_image(e);
         destroy_depth_image(e);
 
-        e->drawExtent.width = 3840;
-        e->drawExtent.height = 2160;
-
-        create_draw_image(e, e->drawExtent.width, e->drawExtent.height);
-        init_depth_image(e, e->drawExtent.width, e->drawExtent.height);
+        create_draw_image(e, 3840, 2160);
+        init_depth_image(e, 3840, 2160);
     }
 }
@@ -0,0 +1,214 @@
+#include "taa.h"
+#include "engine.h"
+#include "graphics_pipeline.h"
+
+#include <algorithm>
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+static void destroy_history(Engine* e)
+{
+    TaaState& t = e->taa;
+    for (AllocatedImage& h : t.history) {
+        if (h.image == VK_NULL_HANDLE) continue;
+        destroy_image(h, e);
+        h = {};
+    }
+    t.historyBytes = 0;
+    t.historyValid = false;
+}
+
+// Full draw-image size, so a dynamic-resolution extent always fits
+static void create_history(Engine* e)
+{
+    TaaState& t = e->taa;
+    destroy_history(e);
+    for (uint32_t i = 0; i < 2; ++i) {
+        t.history[i] = create_image(e, e->drawImage.imageExtent, e->drawImage.imageFormat,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT);
+        upload_texture_to_bindless(e, t.history[i], e->defaultSamplerLinear, t.historyBindlessIndex[i]);
+
+        VmaAllocationInfo info;
+        vmaGetAllocationInfo(e->allocator, t.history[i].allocation, &info);
+        t.historyBytes += info.size;
+    }
+}
+
+void init_taa(Engine* e)
+{
+    TaaState& t = e->taa;
+    t.msaaSamples = e->msaaSamples;
+
+    VkShaderModule vert = load_shader_or_exit(e, "shaders/upscale.vert.spv");
+    VkShaderModule frag = load_shader_or_exit(e, "shaders/taa_resolve.frag.spv");
+
+    VkPushConstantRange pushRange{ VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(TaaPushConstants) };
+    VkPipelineLayoutCreateInfo layoutInfo = e->util.pipeline_layout_create_info();
+    layoutInfo.setLayoutCount = 1;
+    layoutInfo.pSetLayouts = &e->bindlessLayout;
+    layoutInfo.pushConstantRangeCount = 1;
+    layoutInfo.pPushConstantRanges = &pushRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &layoutInfo, nullptr, &t.resolveLayout));
+
+    PipelineBuilder pb;
+    set_shaders(vert, frag, pb);
+    set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, pb);
+    set_polygon_mode(VK_POLYGON_MODE_FILL, pb);
+    set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, pb);
+    set_multisampling_none(pb);
+    disable_blending(pb);
+    disable_depthtest(pb);
+    set_color_attachment_format(e->drawImage.imageFormat, pb);
+    set_depth_format(VK_FORMAT_UNDEFINED, pb);
+    pb.pipelineLayout = t.resolveLayout;
+    pb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+
+    t.resolvePipeline = build_pipeline(e, pb);
+    if (t.resolvePipeline == VK_NULL_HANDLE) {
+        LOG_ERROR("Failed to create TAA resolve pipeline");
+        std::exit(1);
+    }
+    vkDestroyShaderModule(e->device, vert, nullptr);
+    vkDestroyShaderModule(e->device, frag, nullptr);
+
+    e->mainDeletionQueue.push_function([=]() {
+        destroy_history(e);
+        vkDestroyPipeline(e->device, e->taa.resolvePipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, e->taa.resolveLayout, nullptr);
+        });
+
+    LOG("TAA: resolve pipeline created, history at slots "
+        << t.historyBindlessIndex[0] << "/" << t.historyBindlessIndex[1]);
+}
+
+// ─── Mode switch ──────────────────────────────────────────────────────────────
+static void apply_mode(Engine* e, AntiAliasing mode)
+{
+    TaaState& t = e->taa;
+    vkDeviceWaitIdle(e->device);
+    t.mode = mode;
+
+    // Re-register the scene targets at the new sample count; the graph
+    // re-places its transients on the next execute
+    const bool       taa = mode == AntiAliasing::Taa;
+    const VkExtent3D full = e->drawImage.imageExtent;
+    const VkExtent2D extent = e->drawExtent;
+    e->msaaSamples = taa ? VK_SAMPLE_COUNT_1_BIT : t.msaaSamples;
+    create_draw_image(e, full.width, full.height);
+    init_depth_image(e, full.width, full.height);
+    e->drawExtent = extent;
+
+    if (taa) {
+        VkImageCreateInfo info = image_create_info(TAA_VELOCITY_FORMAT,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, full);
+        render_graph_register_transient(e, "velocity", info, VK_IMAGE_ASPECT_COLOR_BIT, &t.velocity,
+            [](Engine* e) {
+                upload_texture_to_bindless(e, e->taa.velocity, e->defaultSamplerNearest,
+                    e->taa.velocityBindlessIndex);
+            });
+        create_history(e);
+    }
+    else {
+        render_graph_release_transient(e, &t.velocity);
+        destroy_history(e);
+    }
+
+    // GPU timings still in flight belong to the old mode
+    DynamicResolutionState& dr = e->dynamicRes;
+    dr.discardBefore = e->frameNumber;
+    dr.smoothedMs = 0.0f;
+
+    LOG("Anti-aliasing: " << (taa ? "TAA" : "MSAA") << ", " << (int)e->msaaSamples << " sample(s)");
+}
+
+// ─── Per frame ────────────────────────────────────────────────────────────────
+static float halton(uint32_t index, uint32_t base)
+{
+    float f = 1.0f, r = 0.0f;
+    for (; index > 0; index /= base) {
+        f /= (float)base;
+        r += f * (float)(index % base);
+    }
+    return r;
+}
+
+void taa_begin_frame(Engine* e)
+{
+    TaaState& t = e->taa;
+    if (t.requested != t.mode)
+        apply_mode(e, t.requested);
+
+    const bool taa = t.mode == AntiAliasing::Taa;
+    if (taa) e->gpuCulling.enabled = false;
+
+    // ── Jitter: one Halton(2,3) point per frame, ±half a pixel of drawExtent
+    glm::vec2 jitter(0.0f);
+    if (taa) {
+        const uint32_t i = t.frameIndex++ % TAA_JITTER_PHASES + 1;
+        const glm::vec2 offset(halton(i, 2) - 0.5f, halton(i, 3) - 0.5f);
+        jitter = 2.0f * offset / glm::vec2(e->drawExtent.width, e->drawExtent.height)
+            * std::clamp(t.jitterScale, 0.0f, 1.0f);
+
+        t.current ^= 1;
+        if (e->drawExtent.width != t.historyExtent.width || e->drawExtent.height != t.historyExtent.height)
+            t.historyValid = false;
+    }
+    e->mainCamera.jitter = jitter;
+
+    // ── Cost of the active mode, for the side-by-side in the debug UI
+    const DynamicResolutionState& dr = e->dynamicRes;
+    if (dr.smoothedMs > 0.0f) {
+        AntiAliasingStats& s = t.stats[(uint32_t)t.mode];
+        s.sampled = true;
+        s.transientBytes = e->renderGraph.memorySize;
+        s.historyBytes = t.historyBytes;
+        s.gpuMs = dr.smoothedMs;
+        s.renderScale = (float)e->drawExtent.width / (float)std::max(1u, e->drawImage.imageExtent.width);
+    }
+}
+
+RecordTarget scene_record_target(const Engine* e)
+{
+    if (e->taa.mode == AntiAliasing::Taa)
+        return { { e->drawImage.imageFormat, TAA_VELOCITY_FORMAT }, e->depthImage.imageFormat, VK_SAMPLE_COUNT_1_BIT };
+    return { { e->drawImage.imageFormat }, e->depthImage.imageFormat, e->msaaSamples };
+}
+
+// ─── Resolve ──────────────────────────────────────────────────────────────────
+void draw_taa_resolve(Engine* e, VkCommandBuffer cmd)
+{
+    TaaState& t = e->taa;
+
+    // Only the drawExtent sub-rect is read back next frame
+    VkRenderingAttachmentInfo colorAttachment = attachment_info(
+        t.history[t.current].imageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    VkRenderingInfo renderInfo = e->util.rendering_info(e->drawExtent, &colorAttachment, nullptr);
+
+    vkCmdBeginRendering(cmd, &renderInfo);
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, t.resolvePipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+        t.resolveLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+    VkViewport viewport{ 0, 0,
+        (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+    vkCmdSetViewport(cmd, 0, 1, &viewport);
+    VkRect2D scissor{ {0, 0}, e->drawExtent };
+    vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+    const VkExtent3D historySize = t.history[t.current].imageExtent;
+    TaaPushConstants push{};
+    push.srcSize = glm::vec2(e->drawExtent.width, e->drawExtent.height);
+    push.historySize = glm::vec2(historySize.width, historySize.height);
+    push.colorIndex = e->dynamicRes.sourceBindlessIndex;
+    push.velocityIndex = t.velocityBindlessIndex;
+    push.historyIndex = t.historyBindlessIndex[t.current ^ 1];
+    push.feedback = std::clamp(t.feedback, 0.0f, 0.98f);
+    push.historyValid = t.historyValid ? 1u : 0u;
+    vkCmdPushConstants(cmd, t.resolveLayout, VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(push), &push);
+
+    vkCmdDraw(cmd, 3, 1, 0, 0);
+    vkCmdEndRendering(cmd);
+
+    t.historyValid = true;
+    t.historyExtent = e->drawExtent;
+}
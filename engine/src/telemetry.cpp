@@ -0,0 +1,232 @@
+#include "telemetry.h"
+#include "engine.h"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdio>
+
+// ─── Histogram ────────────────────────────────────────────────────────────────
+// Below 2 * SUB_BUCKETS µs a bucket is one µs. Above, the top SUB_BITS + 1
+// bits of the value pick the bucket within its power of two
+static uint32_t telemetry_bucket(float ms)
+{
+    constexpr uint64_t maxUs = (2ull << TELEMETRY_MAX_MSB) - 1;
+    const uint64_t us = (uint64_t)std::clamp(ms * 1000.0f + 0.5f, 0.0f, (float)maxUs);
+    if (us < 2 * TELEMETRY_SUB_BUCKETS) return (uint32_t)us;
+
+    const uint32_t msb = (uint32_t)std::bit_width(us) - 1;
+    const uint32_t shift = msb - TELEMETRY_SUB_BITS;
+    return (shift + 1) * TELEMETRY_SUB_BUCKETS + (uint32_t)(us >> shift) - TELEMETRY_SUB_BUCKETS;
+}
+
+// The middle of a bucket's range, in ms
+static float telemetry_bucket_ms(uint32_t bucket)
+{
+    if (bucket < 2 * TELEMETRY_SUB_BUCKETS) return (float)bucket / 1000.0f;
+    const uint32_t shift = bucket / TELEMETRY_SUB_BUCKETS - 1;
+    const uint64_t low = (uint64_t)(bucket % TELEMETRY_SUB_BUCKETS + TELEMETRY_SUB_BUCKETS) << shift;
+    return ((float)low + (float)(1ull << shift) * 0.5f) / 1000.0f;
+}
+
+void TelemetryHistogram::add(float ms)
+{
+    counts[telemetry_bucket(ms)]++;
+    total++;
+}
+
+void TelemetryHistogram::remove(float ms)
+{
+    counts[telemetry_bucket(ms)]--;
+    total--;
+}
+
+void TelemetryHistogram::clear()
+{
+    std::fill(std::begin(counts), std::end(counts), 0u);
+    total = 0;
+}
+
+// Min, max and nearest-rank percentiles in one walk over the buckets
+static void telemetry_fill_stats(const TelemetryHistogram& h, double sum, TelemetryStats& s)
+{
+    s = {};
+    s.count = h.total;
+    if (!h.total) return;
+    s.avg = (float)(sum / (double)h.total);
+
+    auto rank = [&](double p) { return std::max<uint64_t>((uint64_t)std::ceil(p * (double)h.total), 1); };
+    const uint64_t r50 = rank(0.50), r95 = rank(0.95), r99 = rank(0.99);
+
+    uint64_t seen = 0;
+    bool     first = true;
+    for (uint32_t b = 0; b < TELEMETRY_BUCKETS; ++b) {
+        if (!h.counts[b]) continue;
+        const float ms = telemetry_bucket_ms(b);
+        if (first) { s.min = ms; first = false; }
+        const uint64_t before = seen;
+        seen += h.counts[b];
+        if (before < r50 && seen >= r50) s.p50 = ms;
+        if (before < r95 && seen >= r95) s.p95 = ms;
+        if (before < r99 && seen >= r99) s.p99 = ms;
+        if (seen == h.total) { s.max = ms; break; }
+    }
+}
+
+// ─── Series ───────────────────────────────────────────────────────────────────
+static TelemetrySeries* telemetry_series(Engine* e, TelemetryKind kind, const char* name)
+{
+    TelemetryState& t = e->telemetry;
+    for (auto& s : t.series)
+        if (s->kind == kind && s->name == name) return s.get();
+
+    if (t.series.size() >= TELEMETRY_MAX_SERIES) {
+        LOG_RATE(Profiler, Warn, 10.0, "Telemetry: more than " << TELEMETRY_MAX_SERIES
+            << " series, dropping " << name);
+        return nullptr;
+    }
+    auto& s = t.series.emplace_back(std::make_unique<TelemetrySeries>());
+    s->name = name;
+    s->kind = kind;
+    return s.get();
+}
+
+// Returns the evicted sample, or a negative value if the ring wasn't full
+static float telemetry_push(TelemetrySeries& s, float ms)
+{
+    float evicted = -1.0f;
+    if (s.count == TELEMETRY_WINDOW) {
+        evicted = s.samples[s.next];
+        s.window.remove(evicted);
+        s.windowSum -= evicted;
+    }
+    else {
+        s.count++;
+    }
+    s.samples[s.next] = ms;
+    s.next = (s.next + 1) % TELEMETRY_WINDOW;
+    s.last = ms;
+
+    s.window.add(ms);
+    s.lifetime.add(ms);
+    s.windowSum += ms;
+    s.lifetimeSum += ms;
+    telemetry_fill_stats(s.window, s.windowSum, s.windowStats);
+    if (s.lifetime.total % TELEMETRY_LIFETIME_REFRESH == 1)
+        telemetry_fill_stats(s.lifetime, s.lifetimeSum, s.lifetimeStats);
+    return evicted;
+}
+
+void telemetry_cpu(Engine* e, const char* name, float ms)
+{
+    if (!e->telemetry.enabled) return;
+    if (TelemetrySeries* s = telemetry_series(e, TelemetryKind::Cpu, name)) {
+        s->pending += ms;
+        s->hasPending = true;
+    }
+}
+
+void telemetry_gpu(Engine* e, const char* name, float ms)
+{
+    if (!e->telemetry.enabled) return;
+    if (TelemetrySeries* s = telemetry_series(e, TelemetryKind::Gpu, name)) {
+        s->pending += ms;
+        s->hasPending = true;
+    }
+}
+
+const TelemetrySeries* telemetry_find(const Engine* e, TelemetryKind kind, std::string_view name)
+{
+    for (const auto& s : e->telemetry.series)
+        if (s->kind == kind && s->name == name) return s.get();
+    return nullptr;
+}
+
+// ─── Frame ────────────────────────────────────────────────────────────────────
+static void telemetry_frame_interval(Engine* e, float ms)
+{
+    TelemetryState& t = e->telemetry;
+    if (!t.frame) t.frame = telemetry_series(e, TelemetryKind::Frame, "frame");
+    if (!t.frame) return;
+
+    // Judged against the window before this frame joins it
+    const TelemetryStats& before = t.frame->windowStats;
+    const bool hitch = before.count >= t.hitchMinSamples && ms > t.hitchMinMs
+        && ms > t.hitchFactor * before.p50;
+    const float median = before.p50;
+
+    const uint32_t slot = t.frame->next;
+    if (telemetry_push(*t.frame, ms) >= 0.0f && t.hitchFlags[slot])
+        t.hitchesInWindow--;
+    t.hitchFlags[slot] = hitch;
+
+    if (hitch) {
+        t.hitches++;
+        t.hitchesInWindow++;
+        t.lastHitchFrame = t.frames;
+        t.lastHitchMs = ms;
+        LOG_RATE(Render, Warn, 1.0, "Hitch: frame " << t.frames << " took " << ms << " ms (median "
+            << median << " ms)");
+    }
+}
+
+void telemetry_begin_frame(Engine* e)
+{
+    TelemetryState& t = e->telemetry;
+    if (!t.enabled) return;
+
+    const TelemetryClock::time_point now = TelemetryClock::now();
+    if (t.started)
+        telemetry_frame_interval(e, std::chrono::duration<float, std::milli>(now - t.frameStart).count());
+    t.started = true;
+    t.frameStart = now;
+    t.frames++;
+
+    for (auto& s : t.series) {
+        if (!s->hasPending) continue;
+        telemetry_push(*s, s->pending);
+        s->pending = 0.0f;
+        s->hasPending = false;
+    }
+}
+
+void telemetry_reset(Engine* e)
+{
+    TelemetryState& t = e->telemetry;
+    for (auto& s : t.series) {
+        TelemetrySeries& r = *s;
+        r.next = r.count = 0;
+        r.last = 0.0f;
+        r.window.clear();
+        r.lifetime.clear();
+        r.windowSum = r.lifetimeSum = 0.0;
+        r.windowStats = {};
+        r.lifetimeStats = {};
+        r.pending = 0.0f;
+        r.hasPending = false;
+    }
+    t.hitches = 0;
+    t.hitchesInWindow = 0;
+    std::fill(std::begin(t.hitchFlags), std::end(t.hitchFlags), (uint8_t)0);
+    t.started = false;
+}
+
+// ─── Summary ──────────────────────────────────────────────────────────────────
+void telemetry_log_summary(const Engine* e)
+{
+    const TelemetryState& t = e->telemetry;
+    if (!t.frame || !t.frame->lifetimeStats.count) return;
+
+    static const char* kinds[] = { "frame", "cpu", "gpu" };
+    LOG_CAT(Profiler, Info, "Telemetry: " << t.frame->lifetimeStats.count << " frames, " << t.hitches
+        << " hitches (ms: window avg/p50/p95/p99 | lifetime p50/p99/max)");
+    for (const auto& s : t.series) {
+        const TelemetryStats& w = s->windowStats;
+        const TelemetryStats& l = s->lifetimeStats;
+        if (!l.count) continue;
+        char line[160];
+        std::snprintf(line, sizeof(line), "  %-5s %-20s %7.2f %7.2f %7.2f %7.2f | %7.2f %7.2f %7.2f",
+            kinds[(size_t)s->kind], s->name.c_str(), w.avg, w.p50, w.p95, w.p99, l.p50, l.p99, l.max);
+        LOG_CAT(Profiler, Info, line);
+    }
+}
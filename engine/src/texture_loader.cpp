@@ -9,7 +9,7 @@ bool load_texture_from_file(const char* path, Engine* e, AllocatedImage& outImag
     int texWidth = 0, texHeight = 0, texChannels = 0;
     stbi_uc* pixels = stbi_load(path, &texWidth, &texHeight, &texChannels, STBI_rgb_alpha);
     if (!pixels) {
-        std::cerr << "❌ Failed to load texture: " << path << std::endl;
+        LOG_CAT(Loader, Error, "Failed to load texture: " << path);
         return false;
     }
 
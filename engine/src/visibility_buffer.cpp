@@ -0,0 +1,605 @@
+#include "visibility_buffer.h"
+#include "engine.h"
+#include "graphics_pipeline.h"
+
+#include <algorithm>
+#include <bit>
+
+// ─── Helpers ──────────────────────────────────────────────────────────────────
+static VkPipeline vis_graphics_pipeline(Engine* e, PipelineBuilder& pb, const char* what)
+{
+    VkPipeline pipeline = build_pipeline(e, pb);
+    if (pipeline == VK_NULL_HANDLE) {
+        LOG_ERROR("Failed to create " << what << " pipeline");
+        std::exit(1);
+    }
+    return pipeline;
+}
+
+static VkDeviceAddress vis_buffer_address(Engine* e, const AllocatedBuffer& buffer)
+{
+    VkBufferDeviceAddressInfo info{ .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO };
+    info.buffer = buffer.buffer;
+    return vkGetBufferDeviceAddress(e->device, &info);
+}
+
+static void vis_memory_barrier(VkCommandBuffer cmd,
+    VkPipelineStageFlags2 srcStage, VkAccessFlags2 srcAccess,
+    VkPipelineStageFlags2 dstStage, VkAccessFlags2 dstAccess)
+{
+    VkMemoryBarrier2 barrier{ .sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2 };
+    barrier.srcStageMask = srcStage;
+    barrier.srcAccessMask = srcAccess;
+    barrier.dstStageMask = dstStage;
+    barrier.dstAccessMask = dstAccess;
+
+    VkDependencyInfo dep{ .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO };
+    dep.memoryBarrierCount = 1;
+    dep.pMemoryBarriers = &barrier;
+    vkCmdPipelineBarrier2(cmd, &dep);
+}
+
+static void vis_destroy_items(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+    if (v.itemBuffer.buffer != VK_NULL_HANDLE) destroy_buffer(v.itemBuffer, e);
+    v.itemBuffer = {};
+    for (AllocatedBuffer& buffer : v.commandBuffers) {
+        vmaUnmapMemory(e->allocator, buffer.allocation);
+        destroy_buffer(buffer, e);
+    }
+    v.commandBuffers.clear();
+    v.itemsBuilt = false;
+}
+
+static void vis_destroy_scratch(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+    for (AllocatedBuffer* b : { &v.tileKeys, &v.tileOffsets, &v.tileList, &v.binCounts, &v.binStarts, &v.drawArgs }) {
+        if (b->buffer != VK_NULL_HANDLE) destroy_buffer(*b, e);
+        *b = {};
+    }
+    v.tileCapacity = v.binCapacity = 0;
+}
+
+// Tile buffers cover the full draw image, so any dynamic-resolution extent fits
+static void vis_create_scratch(Engine* e, uint32_t bins)
+{
+    VisibilityBufferState& v = e->visibility;
+    vis_destroy_scratch(e);
+
+    const VkExtent3D full = e->drawImage.imageExtent;
+    v.tileCapacity = ((full.width + VIS_TILE_SIZE - 1) / VIS_TILE_SIZE)
+        * ((full.height + VIS_TILE_SIZE - 1) / VIS_TILE_SIZE);
+    v.binCapacity = std::max(bins, 64u);
+
+    const VkBufferUsageFlags usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT |
+        VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    for (AllocatedBuffer* b : { &v.tileKeys, &v.tileOffsets, &v.tileList })
+        *b = create_buffer(e->allocator, v.tileCapacity * sizeof(uint32_t), usage, VMA_MEMORY_USAGE_GPU_ONLY, e);
+    for (AllocatedBuffer* b : { &v.binCounts, &v.binStarts })
+        *b = create_buffer(e->allocator, v.binCapacity * sizeof(uint32_t), usage, VMA_MEMORY_USAGE_GPU_ONLY, e);
+    v.drawArgs = create_buffer(e->allocator, sizeof(VkDrawIndirectCommand),
+        usage | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_GPU_ONLY, e);
+
+    for (AllocatedBuffer* b : { &v.tileKeys, &v.tileOffsets, &v.tileList, &v.binCounts, &v.binStarts, &v.drawArgs })
+        b->address = vis_buffer_address(e, *b);
+}
+
+// ─── Init ─────────────────────────────────────────────────────────────────────
+void init_visibility_buffer(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+
+    // ── Visibility: minimal pipeline, vertices pulled through BDA
+    VkPushConstantRange idRange{ VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(VisIdPushConstants) };
+    VkPipelineLayoutCreateInfo idLayoutInfo = e->util.pipeline_layout_create_info();
+    idLayoutInfo.setLayoutCount = 1;
+    idLayoutInfo.pSetLayouts = &e->bindlessLayout;
+    idLayoutInfo.pushConstantRangeCount = 1;
+    idLayoutInfo.pPushConstantRanges = &idRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &idLayoutInfo, nullptr, &v.idLayout));
+
+    VkShaderModule idVert = load_shader_or_exit(e, "shaders/vis_id.vert.spv");
+    VkShaderModule idFrag = load_shader_or_exit(e, "shaders/vis_id.frag.spv");
+    VkShaderModule idMaskedFrag = load_shader_or_exit(e, "shaders/vis_id_masked.frag.spv");
+
+    PipelineBuilder pb;
+    set_shaders(idVert, idFrag, pb);
+    set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, pb);
+    set_polygon_mode(VK_POLYGON_MODE_FILL, pb);
+    set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, pb);
+    set_multisampling_none(pb);
+    disable_blending(pb);
+    enable_depthtest(pb, VK_COMPARE_OP_LESS_OR_EQUAL);
+    set_color_attachment_format(VIS_ID_FORMAT, pb);
+    set_depth_format(e->depthImage.imageFormat, pb);
+    pb.pipelineLayout = v.idLayout;
+    pb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    v.idPipeline = vis_graphics_pipeline(e, pb, "visibility");
+
+    set_shaders(idVert, idMaskedFrag, pb);
+    v.idMaskedPipeline = vis_graphics_pipeline(e, pb, "masked visibility");
+
+    vkDestroyShaderModule(e->device, idVert, nullptr);
+    vkDestroyShaderModule(e->device, idFrag, nullptr);
+    vkDestroyShaderModule(e->device, idMaskedFrag, nullptr);
+
+    // ── Binning compute
+    VkPushConstantRange binRange{ VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(VisBinPushConstants) };
+    VkPipelineLayoutCreateInfo binLayoutInfo = e->util.pipeline_layout_create_info();
+    binLayoutInfo.setLayoutCount = 1;
+    binLayoutInfo.pSetLayouts = &e->bindlessLayout;
+    binLayoutInfo.pushConstantRangeCount = 1;
+    binLayoutInfo.pPushConstantRanges = &binRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &binLayoutInfo, nullptr, &v.binLayout));
+
+    VkShaderModule binShader = load_shader_or_exit(e, "shaders/vis_bin.comp.spv");
+    VkComputePipelineCreateInfo binInfo{ .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO };
+    binInfo.stage = { .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO };
+    binInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    binInfo.stage.module = binShader;
+    binInfo.stage.pName = "main";
+    binInfo.layout = v.binLayout;
+    VK_CHECK(create_compute_pipeline(e, binInfo, &v.binPipeline));
+    vkDestroyShaderModule(e->device, binShader, nullptr);
+
+    // ── Shade: tile quads, no depth test (the sky before them uses it)
+    VkPushConstantRange shadeRange{ VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT, 0, sizeof(VisShadePushConstants) };
+    VkPipelineLayoutCreateInfo shadeLayoutInfo = e->util.pipeline_layout_create_info();
+    shadeLayoutInfo.setLayoutCount = 1;
+    shadeLayoutInfo.pSetLayouts = &e->bindlessLayout;
+    shadeLayoutInfo.pushConstantRangeCount = 1;
+    shadeLayoutInfo.pPushConstantRanges = &shadeRange;
+    VK_CHECK(vkCreatePipelineLayout(e->device, &shadeLayoutInfo, nullptr, &v.shadeLayout));
+
+    VkShaderModule shadeVert = load_shader_or_exit(e, "shaders/vis_shade.vert.spv");
+    VkShaderModule shadeFrag = load_shader_or_exit(e, "shaders/vis_shade.frag.spv");
+
+    PipelineBuilder spb;
+    set_shaders(shadeVert, shadeFrag, spb);
+    set_input_topology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, spb);
+    set_polygon_mode(VK_POLYGON_MODE_FILL, spb);
+    set_cull_mode(VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, spb);
+    set_multisampling_none(spb);
+    disable_blending(spb);
+    disable_depthtest(spb);
+    set_color_attachment_format(e->drawImage.imageFormat, spb);
+    set_depth_format(e->depthImage.imageFormat, spb);
+    spb.pipelineLayout = v.shadeLayout;
+    spb.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    v.shadePipeline = vis_graphics_pipeline(e, spb, "visibility shade");
+
+    set_color_attachment_formats({ e->drawImage.imageFormat, TAA_VELOCITY_FORMAT }, spb);
+    v.shadePipelineTaa = vis_graphics_pipeline(e, spb, "TAA visibility shade");
+
+    vkDestroyShaderModule(e->device, shadeVert, nullptr);
+    vkDestroyShaderModule(e->device, shadeFrag, nullptr);
+
+    // ── Tile counts
+    v.frameRecorded.assign(FRAME_OVERLAP, 0);
+
+    v.statsBuffers.resize(FRAME_OVERLAP);
+    for (AllocatedBuffer& buffer : v.statsBuffers) {
+        buffer = create_buffer(e->allocator, 2 * sizeof(uint32_t),
+            VK_BUFFER_USAGE_TRANSFER_DST_BIT, VMA_MEMORY_USAGE_GPU_TO_CPU, e);
+        VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+    }
+
+    e->mainDeletionQueue.push_function([=]() {
+        VisibilityBufferState& v = e->visibility;
+        vis_destroy_items(e);
+        vis_destroy_scratch(e);
+        for (AllocatedBuffer& buffer : v.statsBuffers) {
+            vmaUnmapMemory(e->allocator, buffer.allocation);
+            destroy_buffer(buffer, e);
+        }
+        vkDestroyPipeline(e->device, v.shadePipelineTaa, nullptr);
+        vkDestroyPipeline(e->device, v.shadePipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, v.shadeLayout, nullptr);
+        vkDestroyPipeline(e->device, v.binPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, v.binLayout, nullptr);
+        vkDestroyPipeline(e->device, v.idMaskedPipeline, nullptr);
+        vkDestroyPipeline(e->device, v.idPipeline, nullptr);
+        vkDestroyPipelineLayout(e->device, v.idLayout, nullptr);
+        });
+
+    LOG("Visibility buffer: pipelines created, ids at slot " << v.idBindlessIndex);
+}
+
+// ─── Path switch ──────────────────────────────────────────────────────────────
+static void apply_path(Engine* e, RenderPath path)
+{
+    VisibilityBufferState& v = e->visibility;
+    vkDeviceWaitIdle(e->device);
+    v.path = path;
+
+    if (path == RenderPath::VisibilityBuffer) {
+        const VkExtent3D full = e->drawImage.imageExtent;
+        VkImageCreateInfo idInfo = image_create_info(VIS_ID_FORMAT,
+            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, full);
+        render_graph_register_transient(e, "visIds", idInfo, VK_IMAGE_ASPECT_COLOR_BIT, &v.ids,
+            [](Engine* e) {
+                upload_texture_to_bindless(e, e->visibility.ids, e->defaultSamplerNearest,
+                    e->visibility.idBindlessIndex);
+            });
+
+        VkImageCreateInfo depthInfo = image_create_info(e->depthImage.imageFormat,
+            VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, full);
+        render_graph_register_transient(e, "visDepth", depthInfo, VK_IMAGE_ASPECT_DEPTH_BIT, &v.depth);
+    }
+    else {
+        render_graph_release_transient(e, &v.ids);
+        render_graph_release_transient(e, &v.depth);
+    }
+
+    // GPU timings still in flight belong to the old path
+    DynamicResolutionState& dr = e->dynamicRes;
+    dr.discardBefore = e->frameNumber;
+    dr.smoothedMs = 0.0f;
+
+    LOG("Render path: " << (path == RenderPath::VisibilityBuffer ? "visibility buffer" : "forward"));
+}
+
+// ─── Items ────────────────────────────────────────────────────────────────────
+// One item per surface in CullScene flat order, so the frustum culling result
+// and the render queue material ids index it directly
+static bool build_vis_items(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+    RenderQueueState&      rq = e->renderQueue;
+
+    // Frames in flight may still read the old items — retired by timeline value
+    if (v.itemsBuilt) {
+        frame_scheduler_retire(e, [e, items = v.itemBuffer, commands = v.commandBuffers]() {
+            if (items.buffer != VK_NULL_HANDLE) destroy_buffer(items, e);
+            for (const AllocatedBuffer& buffer : commands) {
+                vmaUnmapMemory(e->allocator, buffer.allocation);
+                destroy_buffer(buffer, e);
+            }
+            });
+        v.itemBuffer = {};
+        v.commandBuffers.clear();
+        v.itemsBuilt = false;
+    }
+    if (rq.surfaceMaterial.size() != e->culling.scene.count)
+        build_material_ids(e);
+
+    std::vector<VisItem> items;
+    v.itemMasked.clear();
+    uint32_t maxTriangles = 1;
+    for (const auto& asset : e->testMeshes) {
+        const MeshAsset& mesh = *asset;
+        for (const GeoSurface& s : mesh.surfaces) {
+            VisItem item{};
+            item.modelMatrix = mesh.worldTransform;
+            item.vertices = mesh.meshBuffers.vertexBufferAddress;
+            item.indices = mesh.meshBuffers.indexBufferAddress;
+            item.firstIndex = s.startIndex;
+            item.indexCount = s.count;
+            item.material = rq.surfaceMaterial[items.size()];
+            item.albedoIndex = s.albedoIndex;
+            item.normalIndex = s.normalIndex;
+            item.metalRoughIndex = s.metallicRoughnessIndex;
+            item.aoIndex = s.aoIndex;
+            item.emissiveIndex = s.emissiveIndex;
+            item.metallicFactor = s.metallicFactor;
+            item.roughnessFactor = s.roughnessFactor;
+            item.normalStrength = 1.0f;
+            item.colorFactor = s.colorFactor;
+            items.push_back(item);
+
+            v.itemMasked.push_back(s.opaque ? 0 : 1);
+            maxTriangles = std::max(maxTriangles, s.count / 3);
+        }
+    }
+
+    // Item index above the triangle bits; all-ones stays free for "no surface"
+    v.triangleBits = (uint32_t)std::bit_width(maxTriangles - 1);
+    v.itemCount = (uint32_t)items.size();
+    v.materialCount = rq.materialCount;
+    if ((uint64_t)v.itemCount >= (1ull << (32 - v.triangleBits))) {
+        LOG_ERROR("Visibility buffer: " << v.itemCount << " items x " << maxTriangles
+            << " triangles don't fit a 32-bit id");
+        return false;
+    }
+
+    if (v.materialCount + 1 > v.binCapacity || v.tileCapacity == 0) {
+        vkDeviceWaitIdle(e->device);
+        vis_create_scratch(e, v.materialCount + 1);
+    }
+
+    if (v.itemCount > 0) {
+        const size_t itemBytes = items.size() * sizeof(VisItem);
+        v.itemBuffer = create_buffer(e->allocator, itemBytes,
+            VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+            VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT,
+            VMA_MEMORY_USAGE_GPU_ONLY, e);
+        v.itemBuffer.address = vis_buffer_address(e, v.itemBuffer);
+
+        AllocatedBuffer staging = create_buffer(e->allocator, itemBytes,
+            VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VMA_MEMORY_USAGE_CPU_ONLY, e);
+        void* data;
+        VK_CHECK(vmaMapMemory(e->allocator, staging.allocation, &data));
+        memcpy(data, items.data(), itemBytes);
+        vmaUnmapMemory(e->allocator, staging.allocation);
+
+        immediate_submit([&](VkCommandBuffer cmd) {
+            VkBufferCopy copy{ .size = itemBytes };
+            vkCmdCopyBuffer(cmd, staging.buffer, v.itemBuffer.buffer, 1, &copy);
+            }, e);
+        destroy_buffer(staging, e);
+
+        // Worst case every item is visible
+        v.commandBuffers.resize(FRAME_OVERLAP);
+        for (AllocatedBuffer& buffer : v.commandBuffers) {
+            buffer = create_buffer(e->allocator, v.itemCount * sizeof(VkDrawIndexedIndirectCommand),
+                VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT, VMA_MEMORY_USAGE_CPU_TO_GPU, e);
+            VK_CHECK(vmaMapMemory(e->allocator, buffer.allocation, &buffer.info.pMappedData));
+        }
+    }
+
+    v.itemsBuilt = true;
+    v.builtSceneVersion = e->drawCache.sceneVersion;
+
+    LOG("Visibility buffer items: " << v.itemCount << ", " << v.materialCount << " materials, "
+        << v.triangleBits << " triangle bits");
+    return true;
+}
+
+// ─── Per frame ────────────────────────────────────────────────────────────────
+void visibility_buffer_begin_frame(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+    if (v.frameRecorded.empty()) return;
+
+    if (v.requested != v.path)
+        apply_path(e, v.requested);
+
+    // ── Readback of the slot that just signalled
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    if (v.frameRecorded[slot]) {
+        const AllocatedBuffer& buffer = v.statsBuffers[slot];
+        vmaInvalidateAllocation(e->allocator, buffer.allocation, 0, VK_WHOLE_SIZE);
+        const uint32_t* counts = (const uint32_t*)buffer.info.pMappedData;
+        v.tiles = counts[0];
+        v.mixedTiles = counts[1];
+        v.frameRecorded[slot] = 0;
+    }
+
+    if (v.path == RenderPath::VisibilityBuffer
+        && (!v.itemsBuilt || v.builtSceneVersion != e->drawCache.sceneVersion
+            || v.itemCount != e->culling.scene.count)) {
+        if (!build_vis_items(e)) {
+            v.requested = RenderPath::Forward;
+            apply_path(e, RenderPath::Forward);
+        }
+    }
+
+    // ── Cost of the active path, for the side-by-side in the debug UI
+    const DynamicResolutionState& dr = e->dynamicRes;
+    if (dr.smoothedMs > 0.0f) {
+        RenderPathStats& s = v.stats[(uint32_t)v.path];
+        s.sampled = true;
+        s.gpuMs = dr.smoothedMs;
+        s.renderScale = (float)e->drawExtent.width / (float)std::max(1u, e->drawImage.imageExtent.width);
+        s.drawCalls = e->lastDrawCalls;
+        s.triangles = e->lastTriangles;
+    }
+}
+
+void visibility_buffer_prepare(Engine* e)
+{
+    VisibilityBufferState& v = e->visibility;
+    if (v.path != RenderPath::VisibilityBuffer || !v.itemsBuilt) return;
+
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    const CullView& view = e->culling.camera;
+    const CullScene& scene = e->culling.scene;
+    VkDrawIndexedIndirectCommand* commands = v.itemCount > 0
+        ? (VkDrawIndexedIndirectCommand*)v.commandBuffers[slot].info.pMappedData : nullptr;
+
+    // firstInstance carries the item index to the vertex shader
+    v.assetDraws.assign(e->testMeshes.size(), {});
+    uint32_t count = 0, draws = 0, triangles = 0;
+    for (uint8_t masked = 0; masked < 2; ++masked) {
+        for (uint32_t a = 0; a < (uint32_t)e->testMeshes.size(); ++a) {
+            const MeshAsset& mesh = *e->testMeshes[a];
+            const uint32_t   first = count;
+            for (uint32_t i = 0; i < (uint32_t)mesh.surfaces.size(); ++i) {
+                const uint32_t flat = scene.assetFirstSurface[a] + i;
+                if (v.itemMasked[flat] != masked || !cull_is_visible(view, flat)) continue;
+
+                const GeoSurface& s = mesh.surfaces[i];
+                commands[count++] = { s.count, 1, s.startIndex, 0, flat };
+                triangles += s.count / 3;
+            }
+
+            VisAssetDraws& d = v.assetDraws[a];
+            (masked ? d.maskedFirst : d.opaqueFirst) = first;
+            (masked ? d.maskedCount : d.opaqueCount) = count - first;
+            draws += count > first ? 1 : 0;
+        }
+    }
+
+    e->lastDrawCalls = draws;
+    e->lastTriangles = triangles;
+}
+
+// ─── Visibility ───────────────────────────────────────────────────────────────
+void draw_visibility_ids(Engine* e, VkCommandBuffer cmd)
+{
+    VisibilityBufferState& v = e->visibility;
+
+    VkClearValue idClear{};
+    idClear.color.uint32[0] = VIS_INVALID_ID;
+    VkRenderingAttachmentInfo idAttachment = attachment_info(
+        v.ids.imageView, &idClear, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+
+    VkRenderingAttachmentInfo depthAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    depthAttachment.imageView = v.depth.imageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    depthAttachment.clearValue.depthStencil.depth = 1.0f;
+
+    VkRenderingInfo renderInfo = e->util.rendering_info(e->drawExtent, &idAttachment, &depthAttachment);
+    vkCmdBeginRendering(cmd, &renderInfo);
+
+    if (v.itemsBuilt && v.itemCount > 0) {
+        VkViewport viewport{ 0, 0,
+            (float)e->drawExtent.width, (float)e->drawExtent.height, 0.0f, 1.0f };
+        vkCmdSetViewport(cmd, 0, 1, &viewport);
+        VkRect2D scissor{ {0, 0}, e->drawExtent };
+        vkCmdSetScissor(cmd, 0, 1, &scissor);
+
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+            v.idLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+        VisIdPushConstants push{ v.itemBuffer.address, v.triangleBits };
+        vkCmdPushConstants(cmd, v.idLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, sizeof(push), &push);
+
+        // One multi-draw per asset and pipeline — the index buffer is the only
+        // per-asset binding
+        const VkBuffer commands = v.commandBuffers[e->frameNumber % FRAME_OVERLAP].buffer;
+        const uint32_t stride = sizeof(VkDrawIndexedIndirectCommand);
+        for (uint8_t masked = 0; masked < 2; ++masked) {
+            vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, masked ? v.idMaskedPipeline : v.idPipeline);
+            for (uint32_t a = 0; a < (uint32_t)v.assetDraws.size(); ++a) {
+                const VisAssetDraws& d = v.assetDraws[a];
+                const uint32_t first = masked ? d.maskedFirst : d.opaqueFirst;
+                const uint32_t count = masked ? d.maskedCount : d.opaqueCount;
+                if (count == 0) continue;
+
+                vkCmdBindIndexBuffer(cmd, e->testMeshes[a]->meshBuffers.indexBuffer.buffer, 0, VK_INDEX_TYPE_UINT32);
+                vkCmdDrawIndexedIndirect(cmd, commands, (VkDeviceSize)first * stride, count, stride);
+            }
+        }
+    }
+
+    vkCmdEndRendering(cmd);
+}
+
+// ─── Binning ──────────────────────────────────────────────────────────────────
+void draw_visibility_binning(Engine* e, VkCommandBuffer cmd)
+{
+    VisibilityBufferState& v = e->visibility;
+    const glm::uvec2 tiles((e->drawExtent.width + VIS_TILE_SIZE - 1) / VIS_TILE_SIZE,
+        (e->drawExtent.height + VIS_TILE_SIZE - 1) / VIS_TILE_SIZE);
+    const uint32_t bins = v.materialCount + 1;
+
+    // Last frame's shade draw and stats copy are done with the scratch buffers
+    vis_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT |
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT,
+        VK_ACCESS_2_SHADER_WRITE_BIT | VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+        VK_ACCESS_2_TRANSFER_WRITE_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+    vkCmdFillBuffer(cmd, v.binCounts.buffer, 0, bins * sizeof(uint32_t), 0);
+    vis_memory_barrier(cmd,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT, VK_ACCESS_2_TRANSFER_WRITE_BIT,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+
+    vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, v.binPipeline);
+    vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE,
+        v.binLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+    VisBinPushConstants push{};
+    push.items = v.itemBuffer.address;
+    push.tileKeys = v.tileKeys.address;
+    push.tileOffsets = v.tileOffsets.address;
+    push.tileList = v.tileList.address;
+    push.binCounts = v.binCounts.address;
+    push.binStarts = v.binStarts.address;
+    push.drawArgs = v.drawArgs.address;
+    push.tiles = tiles;
+    push.extent = glm::uvec2(e->drawExtent.width, e->drawExtent.height);
+    push.idIndex = v.idBindlessIndex;
+    push.triangleBits = v.triangleBits;
+    push.materialCount = v.materialCount;
+
+    const uint32_t groups[3][2] = { { tiles.x, tiles.y }, { 1, 1 }, { (tiles.x * tiles.y + 63) / 64, 1 } };
+    for (uint32_t phase = 0; phase < 3; ++phase) {
+        push.phase = phase;
+        vkCmdPushConstants(cmd, v.binLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(push), &push);
+        vkCmdDispatch(cmd, groups[phase][0], groups[phase][1], 1);
+
+        const bool last = phase == 2;
+        vis_memory_barrier(cmd,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT, VK_ACCESS_2_SHADER_WRITE_BIT,
+            last ? VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_2_TRANSFER_BIT
+                 : VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT,
+            last ? VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_TRANSFER_READ_BIT
+                 : VK_ACCESS_2_SHADER_READ_BIT | VK_ACCESS_2_SHADER_WRITE_BIT);
+    }
+
+    // Listed tiles (the draw's instance count) and mixed-material tiles for the UI
+    const uint32_t slot = e->frameNumber % FRAME_OVERLAP;
+    const AllocatedBuffer& stats = v.statsBuffers[slot];
+    VkBufferCopy copies[2] = {
+        { offsetof(VkDrawIndirectCommand, instanceCount), 0, sizeof(uint32_t) },
+        { v.materialCount * sizeof(uint32_t), sizeof(uint32_t), sizeof(uint32_t) },
+    };
+    vkCmdCopyBuffer(cmd, v.drawArgs.buffer, stats.buffer, 1, &copies[0]);
+    vkCmdCopyBuffer(cmd, v.binCounts.buffer, stats.buffer, 1, &copies[1]);
+    v.frameRecorded[slot] = 1;
+}
+
+// ─── Shade ────────────────────────────────────────────────────────────────────
+void draw_visibility_shade(Engine* e, VkCommandBuffer cmd)
+{
+    VisibilityBufferState& v = e->visibility;
+    const bool taa = e->taa.mode == AntiAliasing::Taa;
+
+    // Sky + tiles cover every pixel of the drawExtent — nothing to load
+    VkRenderingAttachmentInfo colorAttachments[2]{};
+    colorAttachments[0] = attachment_info(e->drawImage.imageView, nullptr, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
+    colorAttachments[0].loadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+    colorAttachments[1] = colorAttachments[0];
+    colorAttachments[1].imageView = e->taa.velocity.imageView;
+
+    VkRenderingAttachmentInfo depthAttachment{ .sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO };
+    depthAttachment.imageView = v.depth.imageView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_NONE;
+
+    VkRenderingInfo renderInfo{ .sType = VK_STRUCTURE_TYPE_RENDERING_INFO };
+    renderInfo.renderArea = { {0, 0}, e->drawExtent };
+    renderInfo.layerCount = 1;
+    renderInfo.colorAttachmentCount = taa ? 2 : 1;
+    renderInfo.pColorAttachments = colorAttachments;
+    renderInfo.pDepthAttachment = &depthAttachment;
+
+    vkCmdBeginRendering(cmd, &renderInfo);
+    draw_skybox(e, cmd);       // depth-tested, so only where no surface was drawn
+
+    if (v.itemsBuilt && v.itemCount > 0) {
+        vkCmdBindPipeline(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, taa ? v.shadePipelineTaa : v.shadePipeline);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS,
+            v.shadeLayout, 0, 1, &e->bindlessSet, 0, nullptr);
+
+        VisShadePushConstants push{};
+        push.items = v.itemBuffer.address;
+        push.tileList = v.tileList.address;
+        push.viewSize = glm::vec2(e->drawExtent.width, e->drawExtent.height);
+        push.tilesX = (e->drawExtent.width + VIS_TILE_SIZE - 1) / VIS_TILE_SIZE;
+        push.idIndex = v.idBindlessIndex;
+        push.triangleBits = v.triangleBits;
+        push.sunDirection = glm::normalize(e->sunDirection);
+        push.sunColor = e->sunColor;
+        push.sunIntensity = e->sunIntensity;
+        push.shadowMapIndex = e->shadowMapBindlessIndex;
+        push.shadowBias = e->shadowBias;
+        push.iblIrradianceIndex = e->iblIrradianceIndex;
+        push.iblPrefilterIndex = e->iblPrefilterIndex;
+        push.iblBrdfLutIndex = e->iblBrdfLutIndex;
+        vkCmdPushConstants(cmd, v.shadeLayout, VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT,
+            0, sizeof(push), &push);
+
+        vkCmdDrawIndirect(cmd, v.drawArgs.buffer, 0, 1, sizeof(VkDrawIndirectCommand));
+    }
+
+    vkCmdEndRendering(cmd);
+}
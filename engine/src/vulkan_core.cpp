@@ -9,7 +9,7 @@
 template<typename T>
 T get_or_abort(vkb::Result<T> result, const char* step) {
     if (!result) {
-        std::printf("Vulkan Error in %s: %s\n", step, result.error().message().c_str());
+        LOG_CAT(Vulkan, Error, "Vulkan error in " << step << ": " << result.error().message());
         std::exit(1);
     }
     return result.value();
@@ -22,6 +22,7 @@ void init_vulkan(Engine* e) {
         .request_validation_layers(true)
         .use_default_debug_messenger()
         .require_api_version(1, 3, 0)
+        .set_headless(e->headless.enabled)          // no surface extensions
         .enable_extension(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
 
 #if defined(__APPLE__)
@@ -35,16 +36,19 @@ void init_vulkan(Engine* e) {
     e->debug_messenger = vkb_inst.debug_messenger;
 
     // ── 2. Window & Surface ───────────────────────────────────────────────────
-    if (!glfwInit() || !glfwVulkanSupported()) {
-        std::printf("GLFW Vulkan init failed\n");
-        std::exit(1);
-    }
-    glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
-    e->window = glfwCreateWindow(e->width, e->height, "Synchrona Engine", nullptr, nullptr);
-
-    if (glfwCreateWindowSurface(e->instance, e->window, nullptr, &e->surface) != VK_SUCCESS) {
-        std::printf("Failed to create Vulkan surface\n");
-        std::exit(1);
+    // Headless: neither; the selector below then doesn't require present support
+    if (!e->headless.enabled) {
+        if (!glfwInit() || !glfwVulkanSupported()) {
+            LOG_CAT(Vulkan, Error, "GLFW Vulkan init failed");
+            std::exit(1);
+        }
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+        e->window = glfwCreateWindow(e->width, e->height, "Synchrona Engine", nullptr, nullptr);
+
+        if (glfwCreateWindowSurface(e->instance, e->window, nullptr, &e->surface) != VK_SUCCESS) {
+            LOG_CAT(Vulkan, Error, "Failed to create Vulkan surface");
+            std::exit(1);
+        }
     }
 
     // ── 3. Physical Device Selection ──────────────────────────────────────────
@@ -52,15 +56,14 @@ void init_vulkan(Engine* e) {
     VkPhysicalDeviceFeatures coreFeatures{};
     coreFeatures.samplerAnisotropy = VK_TRUE;
     coreFeatures.shaderInt64 = VK_TRUE;
+    coreFeatures.multiDrawIndirect = VK_TRUE;          // GPU-driven culling
+    coreFeatures.drawIndirectFirstInstance = VK_TRUE;  // firstInstance = draw item
 
     vkb::PhysicalDeviceSelector selector{ vkb_inst, e->surface };
     selector.set_minimum_version(1, 3)
-        .set_required_features(coreFeatures)
-        .add_required_extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME)
-        // Ray Tracing Extensions
-        .add_required_extension(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME)
-        .add_required_extension(VK_KHR_RAY_QUERY_EXTENSION_NAME)
-        .add_required_extension(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME);
+        .set_required_features(coreFeatures);
+    if (!e->headless.enabled)
+        selector.add_required_extension(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
 
 #if defined(__APPLE__)
     selector.add_required_extension(VK_KHR_PORTABILITY_SUBSET_EXTENSION_NAME);
@@ -70,6 +73,44 @@ void init_vulkan(Engine* e) {
     vkb::PhysicalDevice physicalDevice = get_or_abort(phys_ret, "Physical device selection");
     e->physicalDevice = physicalDevice.physical_device;
 
+    // Optional: ray tracing. Only the TLAS build uses it, so without it (software
+    // rasterisers, older GPUs) the scene simply has no acceleration structures
+    VkPhysicalDeviceRayQueryFeaturesKHR rayQuerySupport{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_RAY_QUERY_FEATURES_KHR };
+    VkPhysicalDeviceAccelerationStructureFeaturesKHR asSupport{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR, .pNext = &rayQuerySupport };
+    VkPhysicalDeviceVulkan12Features features12Support{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES };
+    if (physicalDevice.is_extension_present(VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME) &&
+        physicalDevice.is_extension_present(VK_KHR_RAY_QUERY_EXTENSION_NAME) &&
+        physicalDevice.is_extension_present(VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME))
+        features12Support.pNext = &asSupport;
+    VkPhysicalDeviceFeatures2 supportQuery{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &features12Support };
+    vkGetPhysicalDeviceFeatures2(e->physicalDevice, &supportQuery);
+    e->rayTracingSupported = asSupport.accelerationStructure && rayQuerySupport.rayQuery;
+    if (e->rayTracingSupported)
+        physicalDevice.enable_extensions_if_present({ VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
+            VK_KHR_RAY_QUERY_EXTENSION_NAME, VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME });
+
+    // Optional: pipeline statistics for the GPU profiler's per-pass counters.
+    // A pass's query stays active across vkCmdExecuteCommands, which needs
+    // inheritedQueries as well — without both, no statistics at all
+    VkPhysicalDeviceFeatures statisticsFeatures{};
+    statisticsFeatures.pipelineStatisticsQuery = VK_TRUE;
+    statisticsFeatures.inheritedQueries = VK_TRUE;
+    e->gpuProfiler.statisticsSupported = physicalDevice.enable_features_if_present(statisticsFeatures);
+
+    // Optional: present id + present wait, for measured latency (frame_pacing.cpp).
+    // The extensions alone aren't enough — both features must be there too
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR };
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR };
+    if (physicalDevice.is_extension_present(VK_KHR_PRESENT_ID_EXTENSION_NAME) &&
+        physicalDevice.is_extension_present(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        presentWaitFeatures.pNext = &presentIdFeatures;
+        VkPhysicalDeviceFeatures2 query{ .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2, .pNext = &presentWaitFeatures };
+        vkGetPhysicalDeviceFeatures2(e->physicalDevice, &query);
+        e->framePacing.presentWaitSupported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+    if (e->framePacing.presentWaitSupported)
+        physicalDevice.enable_extensions_if_present({ VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME });
+
     // ── 4. Logical Device & Feature Chaining ──────────────────────────────────
 
     // 4a. Ray Query
@@ -90,7 +131,7 @@ void init_vulkan(Engine* e) {
     features12.scalarBlockLayout = VK_TRUE; // Fixed: Moved from standalone struct
     features12.runtimeDescriptorArray = VK_TRUE;
     features12.descriptorIndexing = VK_TRUE;
-    features12.bufferDeviceAddressCaptureReplay = VK_TRUE;
+    features12.bufferDeviceAddressCaptureReplay = features12Support.bufferDeviceAddressCaptureReplay;
 
     // Fixed: Enabling all Bindless bits required for Sponza's texture arrays
     features12.descriptorBindingPartiallyBound = VK_TRUE;
@@ -98,7 +139,9 @@ void init_vulkan(Engine* e) {
     features12.descriptorBindingStorageImageUpdateAfterBind = VK_TRUE;
     features12.descriptorBindingUniformBufferUpdateAfterBind = VK_TRUE;
     features12.shaderSampledImageArrayNonUniformIndexing = VK_TRUE;
-    features12.pNext = &asFeatures;
+    features12.drawIndirectCount = VK_TRUE;
+    features12.timelineSemaphore = VK_TRUE;             // frame scheduler
+    features12.pNext = e->rayTracingSupported ? &asFeatures : nullptr;
 
     // 4d. Vulkan 1.3 Features
     VkPhysicalDeviceVulkan13Features features13{};
@@ -108,9 +151,16 @@ void init_vulkan(Engine* e) {
     features13.shaderDemoteToHelperInvocation = VK_TRUE;
     features13.pNext = &features12;
 
-    // Build the device with the head of the chain (features13)
+    // Present id/wait sit in front of features13 when supported
     vkb::DeviceBuilder deviceBuilder{ physicalDevice };
-    auto dev_ret = deviceBuilder.add_pNext(&features13).build();
+    if (e->framePacing.presentWaitSupported) {
+        presentIdFeatures.pNext = &features13;
+        deviceBuilder.add_pNext(&presentWaitFeatures);
+    }
+    else {
+        deviceBuilder.add_pNext(&features13);
+    }
+    auto dev_ret = deviceBuilder.build();
     vkb::Device vkbDevice = get_or_abort(dev_ret, "Logical device creation");
 
     e->device = vkbDevice.device;
@@ -125,9 +175,10 @@ void init_vulkan(Engine* e) {
     allocatorInfo.flags = VMA_ALLOCATOR_CREATE_BUFFER_DEVICE_ADDRESS_BIT;
 
     if (vmaCreateAllocator(&allocatorInfo, &e->allocator) != VK_SUCCESS) {
-        std::printf("Failed to create VMA allocator\n");
+        LOG_CAT(Vulkan, Error, "Failed to create VMA allocator");
         std::exit(1);
     }
 
-    std::printf("Vulkan initialized successfully on %s\n", physicalDevice.properties.deviceName);
+    LOG_CAT(Vulkan, Info, "Vulkan initialized successfully on " << physicalDevice.properties.deviceName
+        << " (ray tracing " << (e->rayTracingSupported ? "available" : "unavailable") << ")");
 }
\ No newline at end of file
@@ -0,0 +1,79 @@
+// Packs compiled SPIR-V into one bundle for the engine to memory-map — see
+// include/shader_bundle.h for the layout.
+//
+//   shader_bundler <out.bundle> <a.spv> [b.spv ...]
+//
+// Each blob is named "shaders/<file name>", the path the engine loads it by.
+
+#include "shader_bundle.h"
+
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+int main(int argc, char** argv)
+{
+    if (argc < 2) {
+        std::fprintf(stderr, "usage: shader_bundler <out.bundle> <a.spv> [b.spv ...]\n");
+        return 1;
+    }
+
+    std::vector<ShaderBundleEntry>     entries;
+    std::vector<std::vector<char>>     blobs;
+    for (int i = 2; i < argc; ++i) {
+        const std::filesystem::path path = argv[i];
+        const std::string name = "shaders/" + path.filename().string();
+        if (name.size() >= SHADER_BUNDLE_NAME_SIZE) {
+            std::fprintf(stderr, "shader_bundler: name too long: %s\n", name.c_str());
+            return 1;
+        }
+
+        std::ifstream file(path, std::ios::binary | std::ios::ate);
+        if (!file) {
+            std::fprintf(stderr, "shader_bundler: cannot read %s\n", argv[i]);
+            return 1;
+        }
+        std::vector<char> blob((size_t)file.tellg());
+        file.seekg(0);
+        file.read(blob.data(), (std::streamsize)blob.size());
+        if (blob.size() % 4 != 0) {
+            std::fprintf(stderr, "shader_bundler: %s is not SPIR-V (size %% 4 != 0)\n", argv[i]);
+            return 1;
+        }
+
+        ShaderBundleEntry entry{};
+        std::memcpy(entry.name, name.c_str(), name.size());
+        entry.size = (uint32_t)blob.size();
+        entries.push_back(entry);
+        blobs.push_back(std::move(blob));
+    }
+
+    // Blobs follow the table; SPIR-V sizes are multiples of 4, so every
+    // offset stays word aligned
+    uint32_t offset = (uint32_t)(sizeof(ShaderBundleHeader) + entries.size() * sizeof(ShaderBundleEntry));
+    for (ShaderBundleEntry& entry : entries) {
+        entry.offset = offset;
+        offset += entry.size;
+    }
+
+    ShaderBundleHeader header{};
+    std::memcpy(header.magic, SHADER_BUNDLE_MAGIC, 4);
+    header.version = SHADER_BUNDLE_VERSION;
+    header.count = (uint32_t)entries.size();
+    header.totalSize = offset;
+
+    std::ofstream out(argv[1], std::ios::binary | std::ios::trunc);
+    if (!out) {
+        std::fprintf(stderr, "shader_bundler: cannot write %s\n", argv[1]);
+        return 1;
+    }
+    out.write((const char*)&header, sizeof(header));
+    out.write((const char*)entries.data(), (std::streamsize)(entries.size() * sizeof(ShaderBundleEntry)));
+    for (const std::vector<char>& blob : blobs)
+        out.write(blob.data(), (std::streamsize)blob.size());
+
+    std::printf("shader_bundler: %zu shaders, %u bytes -> %s\n", entries.size(), offset, argv[1]);
+    return out ? 0 : 1;
+}
@@ -3,21 +3,79 @@
 #include "backends/imgui_impl_glfw.h"
 #include "backends/imgui_impl_vulkan.h"
 #include <imgui.h>
+#include <cstdlib>
+#include <cstring>
 
 
-int main()
+int main(int argc, char** argv)
 {
     Engine engineInstance;
     engine = &engineInstance;
+
+    // --trace <frames>: CPU trace of startup, loading and the first frames
+    // --headless <frames>: render offscreen with no window, write the last
+    //   frame and timings (--output <image.ppm>, --stats <stats.json>)
+    // --benchmark <manifest>: replay camera paths through every scene of the
+    //   manifest and write <prefix>.json/.csv (--report <prefix>); offscreen
+    //   with --headless, whose frame count the paths' lengths replace
+    // --log <file>: log file, synchrona.log by default; --log-level <trace|
+    //   debug|info|warn|error> for every category
+    HeadlessConfig headless;
+    std::string logFile = "synchrona.log";
+    BenchmarkConfig benchmark;
+    bool headlessRun = false, benchmarkRun = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace") == 0)
+            cpu_profiler_capture((uint32_t)std::atoi(argv[i + 1]), "cpu_trace.json");
+        else if (std::strcmp(argv[i], "--headless") == 0) {
+            headlessRun = true;
+            headless.frames = (uint32_t)std::atoi(argv[i + 1]);
+        }
+        else if (std::strcmp(argv[i], "--output") == 0)
+            headless.imagePath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--stats") == 0)
+            headless.statsPath = argv[i + 1];
+        else if (std::strcmp(argv[i], "--benchmark") == 0) {
+            benchmarkRun = true;
+            benchmark.manifest = argv[i + 1];
+        }
+        else if (std::strcmp(argv[i], "--report") == 0)
+            benchmark.outputPrefix = argv[i + 1];
+        else if (std::strcmp(argv[i], "--log") == 0)
+            logFile = argv[i + 1];
+        else if (std::strcmp(argv[i], "--log-level") == 0) {
+            for (int level = 0; level < (int)LogLevel::Count; ++level)
+                if (std::strcmp(argv[i + 1], log_level_name((LogLevel)level)) == 0)
+                    log_set_level((LogLevel)level);
+        }
+    }
+    log_set_file(logFile);
+
+    if (benchmarkRun) {
+        benchmark.headless = headlessRun;
+        benchmark.width = headless.width;
+        benchmark.height = headless.height;
+        return benchmark_run(engine, benchmark);
+    }
+    if (headlessRun) {
+        init_headless(engine, headless);
+        const int result = headless_run(engine);
+        engine_cleanup(engine);
+        return result;
+    }
      
     glfwWindowHint(GLFW_SCALE_TO_MONITOR, GLFW_FALSE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
     
     init(engine, 3840, 2160);
-    glfwSwapInterval(0);
     while (!glfwWindowShouldClose(engine->window))
     {
-        glfwPollEvents();
+        cpu_profiler_frame();
+        CPU_ZONE("frame");
+        {
+            CPU_ZONE("input");
+            glfwPollEvents();
+        }
 
         // Skip rendering while the window is minimised
         if (glfwGetWindowAttrib(engine->window, GLFW_ICONIFIED) != 0)